@@ -149,6 +149,13 @@ protected:
     std::vector<ScopePath> _scopes;
     // possible altered nodes due to scope conditionals (altered node <-> clone of original)
     std::list<std::pair<Node*, Node* > > _alteredNodes;
+    /**
+     * the nodes which use each node in an expression (for each expression
+     * used in solveFor() and isSolvable()), so that the paths from the
+     * expression to one of its variables can be determined without
+     * searching the complete expression
+     */
+    std::map<const Node*, std::unordered_map<const Node*, std::vector<Node*> > > _pathGraphCache;
     // the language used for source code generation
     Language<Base>* _lang;
     // the lowest ID used for temporary variables
@@ -244,6 +251,12 @@ public:
      */
     size_t getIndependentVariableIndex(const Node& var) const;
 
+    /**
+     * Provides the independent variables defined with makeVariable()
+     * (ordered by their index).
+     */
+    inline const std::vector<Node*>& getIndependentVariables() const;
+
     /**
      * Provides variable IDs that were assigned to operation nodes.
      * Zero means that no variable is assigned.
@@ -351,6 +364,15 @@ public:
                                           size_t& bifurcations,
                                           size_t maxBifurcations = (std::numeric_limits<size_t>::max)());
 
+    /**
+     * Removes all the information saved to speed up solveFor() and
+     * isSolvable().
+     * It must be called if the operation graph of an expression previously
+     * provided to these methods is modified directly (it is not required
+     * for substituteIndependent()).
+     */
+    inline void clearPathGraphCache();
+
     /**************************************************************************
      *                       Source code generation
      *************************************************************************/
@@ -538,6 +560,18 @@ public:
 
     inline size_t addLoopIndependentIndexPattern(IndexPattern& pattern, size_t hint);
 
+    /**
+     * Provides the index patterns referenced by the LoopIndexedDep nodes
+     * (the position is stored in the first information element).
+     */
+    inline const std::vector<IndexPattern*>& getLoopDependentIndexPatterns() const;
+
+    /**
+     * Provides the index patterns referenced by the LoopIndexedIndep nodes
+     * (the position is stored in the second information element).
+     */
+    inline const std::vector<IndexPattern*>& getLoopIndependentIndexPatterns() const;
+
     /***********************************************************************
      *                           Index patterns
      **********************************************************************/
@@ -790,6 +824,31 @@ protected:
     static inline std::vector<SourceCodePath> findPathsFromNode(const std::vector<SourceCodePath> nodePaths,
                                                                 Node& node);
 
+    /**
+     * Provides the nodes which use each node in an expression.
+     * The information is saved and reused in subsequent calls.
+     *
+     * @param expression the root of the expression
+     */
+    inline const std::unordered_map<const Node*, std::vector<Node*> >& findExpressionUsage(Node& expression);
+
+    /**
+     * Similar to findPathGraph() but only the operations in the expression
+     * which depend on the target are visited (using the saved node usage
+     * in the expression).
+     */
+    inline BidirGraph<Base> findCachedPathGraph(Node& expression,
+                                                Node& target,
+                                                size_t& bifurcations,
+                                                size_t maxBifurcations = (std::numeric_limits<size_t>::max)());
+
+    /**
+     * Removes the saved information for the expressions which use a node.
+     *
+     * @param node the node that was modified
+     */
+    inline void invalidatePathGraphs(const Node& node);
+
     /**************************************************************************
      *                        Operation graph manipulation
      *************************************************************************/
@@ -893,6 +952,7 @@ protected:
     friend class CGAbstractAtomicFun<Base>;
     friend class BaseAbstractAtomicFun<Base>;
     friend class LoopModel<Base>;
+    friend class OperationGraphReader<Base>;
 
 };
 
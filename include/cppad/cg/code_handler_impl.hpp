@@ -149,6 +149,11 @@ size_t CodeHandler<Base>::getIndependentVariableIndex(const Node& var) const {
     return it - _independentVariables.begin();
 }
 
+template<class Base>
+inline const std::vector<OperationNode<Base>*>& CodeHandler<Base>::getIndependentVariables() const {
+    return _independentVariables;
+}
+
 template<class Base>
 inline size_t CodeHandler<Base>::getOperationTreeVisitId() const {
     return _idVisit;
@@ -296,6 +301,7 @@ void CodeHandler<Base>::generateCode(std::ostream& out,
     _scopes.reserve(4);
     _scopes.resize(1);
     _alteredNodes.clear();
+    _pathGraphCache.clear(); // the graph might be modified
     _evaluationOrder.adjustSize();
     _lastUsageOrder.adjustSize();
     _totalUseCount.adjustSize();
@@ -504,6 +510,8 @@ void CodeHandler<Base>::reset() {
 
     _loops.reset();
 
+    _pathGraphCache.clear();
+
     _used = false;
 }
 
@@ -656,6 +664,8 @@ inline void CodeHandler<Base>::deleteManagedNodes(size_t start, size_t end) {
     start = std::min<size_t>(start, _codeBlocks.size());
     end = std::min<size_t>(end, _codeBlocks.size());
 
+    _pathGraphCache.clear();
+
     for (size_t i = start; i < end; ++i) {
         delete _codeBlocks[i];
     }
@@ -44,6 +44,16 @@ inline size_t CodeHandler<Base>::addLoopIndependentIndexPattern(IndexPattern& pa
     return _loops.addIndependentIndexPattern(pattern, hint);
 }
 
+template<class Base>
+inline const std::vector<IndexPattern*>& CodeHandler<Base>::getLoopDependentIndexPatterns() const {
+    return _loops.dependentIndexPatterns;
+}
+
+template<class Base>
+inline const std::vector<IndexPattern*>& CodeHandler<Base>::getLoopIndependentIndexPatterns() const {
+    return _loops.independentIndexPatterns;
+}
+
 template<class Base>
 inline void CodeHandler<Base>::LoopData::prepare4NewSourceGen() {
     indexes.clear();
@@ -23,6 +23,7 @@
 #include <array>
 #include <assert.h>
 #include <cstddef>
+#include <cstdint>
 #include <errno.h>
 #include <fstream>
 #include <iomanip>
@@ -46,7 +47,14 @@
 #include <string.h>
 #include <chrono>
 #include <thread>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <condition_variable>
 #include <functional>
+#include <unordered_map>
+#include <unordered_set>
+#include <type_traits>
 
 // ---------------------------------------------------------------------------
 // operating system detection
@@ -160,6 +168,9 @@
 #include <cppad/cg/evaluator/evaluator_ad.hpp>
 #include <cppad/cg/evaluator/evaluator_adcg.hpp>
 #include <cppad/cg/evaluator/evaluator_cg.hpp>
+#include <cppad/cg/evaluator/lane_array.hpp>
+#include <cppad/cg/evaluator/evaluator_lanes.hpp>
+#include <cppad/cg/evaluator/evaluator_parallel.hpp>
 #include <cppad/cg/operation_path_node.hpp>
 #include <cppad/cg/operation_path.hpp>
 #include <cppad/cg/solver.hpp>
@@ -174,8 +185,15 @@
 #include <cppad/cg/abstract_atomic_fun.hpp>
 #include <cppad/cg/atomic_fun.hpp>
 #include <cppad/cg/atomic_fun_bridge.hpp>
+#include <cppad/cg/model/atomic_array_function.hpp>
 #include <cppad/cg/model/atomic_generic_model.hpp>
 
+// ---------------------------------------------------------------------------
+// operation graph serialization
+#include <cppad/cg/operation_graph_format.hpp>
+#include <cppad/cg/operation_graph_writer.hpp>
+#include <cppad/cg/operation_graph_reader.hpp>
+
 // ---------------------------------------------------------------------------
 // loop/pattern detection
 #include <cppad/cg/patterns/independent_node_sorter.hpp>
@@ -185,6 +203,7 @@
 #include <cppad/cg/patterns/loop_free_model.hpp>
 #include <cppad/cg/patterns/equation_pattern.hpp>
 #include <cppad/cg/patterns/loop.hpp>
+#include <cppad/cg/patterns/related_dependents_finder.hpp>
 #include <cppad/cg/patterns/dependent_pattern_matcher.hpp>
 
 // ---------------------------------------------------------------------------
@@ -200,8 +219,14 @@
 #include <cppad/cg/lang/c/lang_c_default_hessian_var_name_gen.hpp>
 #include <cppad/cg/lang/c/lang_c_default_reverse2_var_name_gen.hpp>
 #include <cppad/cg/lang/c/lang_c_custom_var_name_gen.hpp>
+#include <cppad/cg/lang/c/lang_c_parameter_var_name_gen.hpp>
 #include <cppad/cg/lang/c/lang_c_util.hpp>
 
+// ---------------------------------------------------------------------------
+// bytecode interpreter
+#include <cppad/cg/lang/bytecode/bytecode_program.hpp>
+#include <cppad/cg/lang/bytecode/language_bytecode.hpp>
+
 //
 #include <cppad/cg/model/threadpool/multi_threading_type.hpp>
 #include <cppad/cg/model/threadpool/thread_pool_schedule_strategy.hpp>
@@ -211,8 +236,12 @@
 #include <cppad/cg/model/model_library_processor.hpp>
 #include <cppad/cg/model/model_library.hpp>
 #include <cppad/cg/model/generic_model.hpp>
+#include <cppad/cg/model/sparse_scatter_plan.hpp>
 #include <cppad/cg/model/functor_generic_model.hpp>
+#include <cppad/cg/model/functor_generic_model_context.hpp>
 #include <cppad/cg/model/functor_model_library.hpp>
+#include <cppad/cg/model/reloadable_generic_model.hpp>
+#include <cppad/cg/model/bytecode_generic_model.hpp>
 #include <cppad/cg/model/save_files_model_library_processor.hpp>
 
 // automated static library creation
@@ -239,8 +268,10 @@
 #include <cppad/cg/model/model_c_source_gen_for1.hpp>
 #include <cppad/cg/model/model_c_source_gen_rev1.hpp>
 #include <cppad/cg/model/model_c_source_gen_rev2.hpp>
+#include <cppad/cg/model/model_c_source_gen_atomic.hpp>
 #include <cppad/cg/model/model_c_source_gen_jac.hpp>
 #include <cppad/cg/model/model_c_source_gen_hes.hpp>
+#include <cppad/cg/model/model_c_source_gen_newton.hpp>
 #include <cppad/cg/model/patterns/model_c_source_gen_loops.hpp>
 #include <cppad/cg/model/patterns/model_c_source_gen_loops_for0.hpp>
 #include <cppad/cg/model/patterns/model_c_source_gen_loops_for1.hpp>
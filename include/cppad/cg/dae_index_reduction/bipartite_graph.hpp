@@ -61,6 +61,11 @@ protected:
      * should be kept by also adding PrintFor operations in the reduced model.
      */
     bool preserveNames_;
+    /**
+     * The number of threads used to differentiate equations with respect
+     * to time (0 for one thread per core)
+     */
+    size_t timeDiffThreads_;
 private:
     int timeOrigVarIndex_; // time index in the original user model (may not exist)
     SimpleLogger& logger_;
@@ -82,6 +87,7 @@ public:
             origMaxTimeDivOrder_(0),
             origTimeDependentCount_(0),
             preserveNames_(false),
+            timeDiffThreads_(1),
             timeOrigVarIndex_(-1),
             logger_(logger) {
 
@@ -306,6 +312,30 @@ public:
         return preserveNames_;
     }
 
+    /**
+     * Defines the number of threads used to differentiate the new
+     * equations with respect to time when the reduced model is created.
+     * Each thread uses its own copy of the model and its own CodeHandler,
+     * and the derivatives are merged into the new model afterwards.
+     * Multiple threads are only used when CppAD is not already in parallel
+     * mode (defined by the user with thread_alloc::parallel_setup()).
+     *
+     * @param nThreads the number of threads (0 for one thread per core)
+     */
+    inline void setTimeDiffThreadCount(size_t nThreads) {
+        timeDiffThreads_ = nThreads;
+    }
+
+    /**
+     * Provides the number of threads used to differentiate the new
+     * equations with respect to time.
+     */
+    inline size_t getTimeDiffThreadCount() const {
+        if (timeDiffThreads_ == 0)
+            return std::max<size_t>(1, std::thread::hardware_concurrency());
+        return timeDiffThreads_;
+    }
+
     /**
      * Provides the structural index after this graph has been reduced.
      *
@@ -664,12 +694,32 @@ public:
             handler0.makeVariables(indep0);
 
             vector<CGBase> dep = forward0(*reducedFun, indep0);
+            const size_t forwardNodes0 = handler0.getManagedNodesCount();
 
             /**
              * register operations used to differentiate the equations
              */
-            //forwardTimeDiff(equations, dep, timeTapeIndex);
-            reverseTimeDiff(*reducedFun, equations, dep, timeTapeIndex);
+            size_t nThreads = std::min(getTimeDiffThreadCount(), equations.size());
+            if (nThreads > 1 && thread_alloc::num_threads() > 1) {
+                if (logger_.getVerbosity() >= Verbosity::High)
+                    logger_.log() << "CppAD already in parallel mode: equations differentiated by a single thread\n";
+                nThreads = 1;
+            }
+
+            if (nThreads > 1) {
+                vector<TimeDiffBatch> batches = parallelReverseTimeDiff(*reducedFun, equations, timeTapeIndex, nThreads);
+
+                // merge the equations differentiated by each thread
+                for (const TimeDiffBatch& batch : batches) {
+                    vector<CGBase> depBatch = mergeTimeDiffBatch(handler0, forwardNodes0, batch);
+                    for (size_t e = 0; e < batch.equations.size(); e++) {
+                        dep[batch.equations[e]] = depBatch[e];
+                    }
+                }
+            } else {
+                //forwardTimeDiff(equations, dep, timeTapeIndex);
+                reverseTimeDiff(*reducedFun, equations, dep, timeTapeIndex);
+            }
 
             /**
              * reconstruct the new system of equations
@@ -744,33 +794,254 @@ public:
                                        const std::vector<Enode<Base>*>& equations,
                                        std::vector<CG<Base> >& dep,
                                        size_t tapeTimeIndex) {
-        size_t m = reducedFun.Domain();
         size_t n = reducedFun.Range();
-        std::vector<CGBase> u(m);
         std::vector<CGBase> v(n);
 
         for (size_t e = 0; e < equations.size(); e++) {
-            size_t i = equations[e]->derivativeOf()->index();
-            if (reducedFun.Parameter(i)) { // return zero for this component of f
-                dep[equations[e]->index()] = 0;
-            } else {
-                // set v to the i-th coordinate direction
-                v[i] = 1;
-
-                // compute the derivative of this component of f
-                try {
-                    u = reducedFun.Reverse(1, v);
-                } catch (const std::exception& ex) {
-                    throw CGException("Failed to determine model Jacobian (reverse mode): ", ex.what());
+            dep[equations[e]->index()] = reverseTimeDiff(reducedFun, *equations[e], v, tapeTimeIndex);
+        }
+    }
+
+    /**
+     * Differentiates a single equation with respect to time using reverse
+     * mode (forward mode of order zero must have already been performed).
+     *
+     * @param reducedFun the model
+     * @param equation the new equation (derivative of an existing equation)
+     * @param v a vector of zeros with the size of the model range (restored
+     *          to zero on exit)
+     * @param tapeTimeIndex the index of time in the model
+     * @return the new equation
+     */
+    inline static CGBase reverseTimeDiff(ADFun<CGBase>& reducedFun,
+                                         const Enode<Base>& equation,
+                                         std::vector<CGBase>& v,
+                                         size_t tapeTimeIndex) {
+        size_t i = equation.derivativeOf()->index();
+        if (reducedFun.Parameter(i)) { // return zero for this component of f
+            return CGBase(0);
+        }
+
+        // set v to the i-th coordinate direction
+        v[i] = 1;
+
+        // compute the derivative of this component of f
+        std::vector<CGBase> u;
+        try {
+            u = reducedFun.Reverse(1, v);
+        } catch (const std::exception& ex) {
+            v[i] = 0;
+            throw CGException("Failed to determine model Jacobian (reverse mode): ", ex.what());
+        }
+
+        // reset v to vector of all zeros
+        v[i] = 0;
+
+        // return the result
+        return u[tapeTimeIndex];
+    }
+
+    /**
+     * The equations differentiated by one thread
+     * (there might not be any if the other threads processed all of them)
+     */
+    struct TimeDiffBatch {
+        /**
+         * The handler where the operations of this thread are registered
+         */
+        std::unique_ptr<CodeHandler<Base>> handler;
+        /**
+         * The number of nodes in the handler after the forward mode
+         * evaluation of the model
+         */
+        size_t forwardNodes = 0;
+        /**
+         * The indexes of the differentiated equations
+         */
+        std::vector<size_t> equations;
+        /**
+         * The new equations (same order as in equations)
+         */
+        std::vector<CGBase> dep;
+    };
+
+    /**
+     * Differentiates equations with respect to time using several threads.
+     * Each thread uses its own copy of the model and registers the
+     * operations in its own CodeHandler (see mergeTimeDiffBatch()).
+     * CppAD is placed in parallel mode while the threads are running.
+     *
+     * @param reducedFun the model (it is not modified)
+     * @param equations the new equations to generate
+     * @param tapeTimeIndex the index of time in the model
+     * @param nThreads the number of threads
+     * @return the equations differentiated by each thread
+     */
+    inline std::vector<TimeDiffBatch> parallelReverseTimeDiff(const ADFun<CGBase>& reducedFun,
+                                                              const std::vector<Enode<Base>*>& equations,
+                                                              size_t tapeTimeIndex,
+                                                              size_t nThreads) const {
+        CPPADCG_ASSERT_UNKNOWN(nThreads > 1)
+
+        std::vector<TimeDiffBatch> batches(nThreads);
+        for (TimeDiffBatch& batch : batches)
+            batch.handler.reset(new CodeHandler<Base>());
+
+        std::atomic<size_t> next(0);
+        std::vector<std::exception_ptr> errors(nThreads);
+
+        auto work = [&](size_t thread) {
+            threadNumber() = thread;
+            try {
+                TimeDiffBatch& batch = batches[thread];
+                size_t e = next++;
+                if (e >= equations.size())
+                    return;
+
+                // memory from thread_alloc must be released by the thread which allocated it
+                ADFun<CGBase> fun;
+                fun = reducedFun;
+
+                std::vector<CGBase> indep(fun.Domain());
+                batch.handler->makeVariables(indep);
+                forward0(fun, indep);
+                batch.forwardNodes = batch.handler->getManagedNodesCount();
+
+                std::vector<CGBase> v(fun.Range());
+                for (; e < equations.size(); e = next++) {
+                    batch.equations.push_back(equations[e]->index());
+                    batch.dep.push_back(reverseTimeDiff(fun, *equations[e], v, tapeTimeIndex));
+                }
+            } catch (...) {
+                errors[thread] = std::current_exception();
+                next = equations.size(); // stop the other threads
+            }
+        };
+
+        thread_alloc::parallel_setup(nThreads, inParallel, threadNum);
+        parallel_ad<CGBase>();
+        parallelMode() = true;
+
+        std::vector<std::thread> threads;
+        threads.reserve(nThreads - 1);
+        for (size_t t = 1; t < nThreads; ++t)
+            threads.emplace_back(work, t);
+        work(0);
+
+        for (std::thread& t : threads)
+            t.join();
+
+        parallelMode() = false;
+        for (size_t t = 1; t < nThreads; ++t)
+            thread_alloc::free_available(t);
+        thread_alloc::parallel_setup(1, nullptr, nullptr);
+
+        for (const std::exception_ptr& e : errors) {
+            if (e) std::rethrow_exception(e);
+        }
+
+        return batches;
+    }
+
+    /**
+     * Copies the operations used by a thread to differentiate its equations
+     * into the handler of the main thread.
+     * Both handlers registered the forward mode of the same model in the
+     * same order, therefore the copied operations use the existing forward
+     * mode nodes in handler0 instead of repeating them.
+     *
+     * @param handler0 the handler with the forward mode of the model
+     * @param forwardNodes0 the number of nodes in handler0 after the forward
+     *                      mode evaluation
+     * @param batch the equations differentiated by a thread
+     * @return the new equations in handler0 (same order as in
+     *         batch.equations)
+     */
+    static inline std::vector<CGBase> mergeTimeDiffBatch(CodeHandler<Base>& handler0,
+                                                         size_t forwardNodes0,
+                                                         const TimeDiffBatch& batch) {
+        using Node = OperationNode<Base>;
+
+        if (batch.equations.empty())
+            return std::vector<CGBase>(); // the thread did not get any equation
+
+        if (batch.forwardNodes != forwardNodes0) {
+            throw CGException("Failed to merge the equations differentiated in parallel: "
+                              "different number of forward mode operations");
+        }
+
+        const std::vector<Node*>& nodes = batch.handler->getManagedNodes();
+        const std::vector<Node*>& nodes0 = handler0.getManagedNodes();
+
+        // the new location of each node of the thread handler
+        std::vector<Node*> mapped(nodes.size(), nullptr);
+        for (size_t p = 0; p < batch.forwardNodes; ++p) {
+            CPPADCG_ASSERT_UNKNOWN(nodes[p]->getOperationType() == nodes0[p]->getOperationType())
+            mapped[p] = nodes0[p];
+        }
+
+        for (size_t p = batch.forwardNodes; p < nodes.size(); ++p) {
+            const Node& n = *nodes[p];
+
+            std::vector<Argument<Base> > args;
+            args.reserve(n.getArguments().size());
+            for (const Argument<Base>& a : n.getArguments()) {
+                if (a.getOperation() != nullptr) {
+                    Node* a0 = mapped[a.getOperation()->getHandlerPosition()];
+                    CPPADCG_ASSERT_UNKNOWN(a0 != nullptr)
+                    args.push_back(Argument<Base>(*a0));
+                } else {
+                    args.push_back(Argument<Base>(*a.getParameter()));
                 }
+            }
 
-                // reset v to vector of all zeros
-                v[i] = 0;
+            Node* n0;
+            if (n.getOperationType() == CGOpCode::Pri) {
+                const auto& pri = static_cast<const PrintOperationNode<Base>&>(n);
+                n0 = handler0.makePrintNode(pri.getBeforeString(), args[0], pri.getAfterString());
+            } else {
+                n0 = handler0.makeNode(n.getOperationType(), n.getInfo(), args);
+            }
+
+            if (n.getName() != nullptr)
+                n0->setName(*n.getName());
 
-                // return the result
-                dep[equations[e]->index()] = u[tapeTimeIndex];
+            mapped[p] = n0;
+        }
+
+        std::vector<CGBase> dep;
+        dep.reserve(batch.dep.size());
+        for (const CGBase& y : batch.dep) {
+            if (y.getOperationNode() != nullptr) {
+                dep.push_back(CGBase(*mapped[y.getOperationNode()->getHandlerPosition()]));
+            } else {
+                dep.push_back(y);
             }
         }
+
+        return dep;
+    }
+
+    /**
+     * The thread number provided to CppAD while the equations are
+     * differentiated in parallel
+     */
+    static inline size_t& threadNumber() {
+        static thread_local size_t thread = 0;
+        return thread;
+    }
+
+    static inline std::atomic<bool>& parallelMode() {
+        static std::atomic<bool> parallel(false);
+        return parallel;
+    }
+
+    static bool inParallel() {
+        return parallelMode();
+    }
+
+    static size_t threadNum() {
+        return threadNumber();
     }
 
     /**
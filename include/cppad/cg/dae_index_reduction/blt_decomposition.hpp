@@ -0,0 +1,455 @@
+#ifndef CPPAD_CG_BLT_DECOMPOSITION_INCLUDED
+#define CPPAD_CG_BLT_DECOMPOSITION_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+#include <cppad/cg/cppadcg.hpp>
+#include <cppad/cg/dae_index_reduction/dae_var_info.hpp>
+#include <cppad/cg/dae_index_reduction/dae_equation_info.hpp>
+#include <cppad/cg/dae_index_reduction/simple_logger.hpp>
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * A block of equations in the block lower triangular form of a DAE.
+ */
+class DaeBlock {
+private:
+    /**
+     * the equation indexes in the model
+     */
+    std::vector<size_t> equations_;
+    /**
+     * the tape indexes of the variables determined by the block (in the
+     * same order as the equations they are assigned to)
+     */
+    std::vector<size_t> variables_;
+    /**
+     * whether or not the variable can be determined directly from the
+     * equation
+     */
+    bool explicit_;
+public:
+
+    inline DaeBlock(std::vector<size_t> equations,
+                    std::vector<size_t> variables,
+                    bool explicitBlock) :
+            equations_(std::move(equations)),
+            variables_(std::move(variables)),
+            explicit_(explicitBlock) {
+    }
+
+    /**
+     * Provides the indexes of the equations in this block.
+     */
+    inline const std::vector<size_t>& getEquations() const {
+        return equations_;
+    }
+
+    /**
+     * Provides the tape indexes of the variables determined by this block.
+     * Explicit differential equations of semi-explicit DAEs do not
+     * determine any unknown variable (they provide the time derivative of
+     * their assigned variable).
+     */
+    inline const std::vector<size_t>& getVariables() const {
+        return variables_;
+    }
+
+    /**
+     * Whether or not the equations in this block can be evaluated directly,
+     * otherwise the block is an algebraic loop which must be solved
+     * (e.g. with a Newton method).
+     */
+    inline bool isExplicit() const {
+        return explicit_;
+    }
+
+    inline size_t size() const {
+        return equations_.size();
+    }
+};
+
+/**
+ * Block lower triangular (BLT) decomposition of an index 1 DAE system
+ * (e.g. the result of DummyDerivatives::reduceIndex()).
+ *
+ * The equation to variable assignments provided in DaeEquationInfo (the
+ * matching determined in the bipartite graph during the index reduction)
+ * are used to create a dependency graph between equations whose strongly
+ * connected components (Tarjan's algorithm) are the blocks.
+ * Blocks are sorted so that each block only depends on variables determined
+ * by previous blocks.
+ * Blocks with a single equation which can be solved symbolically for its
+ * variable become explicit assignments while the remaining blocks are
+ * algebraic loops.
+ *
+ * The unknown variables are the algebraic variables and the time
+ * derivatives, while the variables with time derivatives in the model, the
+ * integrated variable (time), and constants are considered known.
+ * Equations marked as explicit (the differential equations of
+ * semi-explicit DAEs) are placed in explicit blocks at the end.
+ */
+template<class Base>
+class BltDecomposition : public SimpleLogger {
+protected:
+    using CGBase = CppAD::cg::CG<Base>;
+    using ADCG = CppAD::AD<CGBase>;
+protected:
+    /**
+     * The index 1 model
+     */
+    ADFun<CGBase>* const fun_;
+    const std::vector<DaeVarInfo> varInfo_;
+    const std::vector<DaeEquationInfo> eqInfo_;
+    // typical values used to avoid NaNs in the tape validation by CppAD
+    std::vector<Base> x_;
+    /**
+     * Jacobian sparsity of the model
+     */
+    std::vector<std::set<size_t> > sparsity_;
+    std::vector<DaeBlock> blocks_;
+    bool decomposed_;
+    /**
+     * operation graph of the model
+     */
+    std::unique_ptr<CodeHandler<Base> > handler_;
+    std::vector<CGBase> indep0_;
+    std::vector<CGBase> res0_;
+public:
+
+    /**
+     * Creates a new BLT decomposition.
+     *
+     * @param fun The index 1 model
+     * @param varInfo The variable information (in the same order as in the
+     *                tape)
+     * @param eqInfo The equation information with the assigned variables
+     * @param x Typical variable values (used to avoid NaNs in CppAD checks)
+     */
+    BltDecomposition(ADFun<CGBase>& fun,
+                     const std::vector<DaeVarInfo>& varInfo,
+                     const std::vector<DaeEquationInfo>& eqInfo,
+                     const std::vector<Base>& x) :
+            fun_(&fun),
+            varInfo_(varInfo),
+            eqInfo_(eqInfo),
+            x_(x),
+            decomposed_(false) {
+        CPPADCG_ASSERT_KNOWN(varInfo_.size() == fun.Domain(), "Invalid variable information size");
+        CPPADCG_ASSERT_KNOWN(eqInfo_.size() == fun.Range(), "Invalid equation information size");
+        CPPADCG_ASSERT_KNOWN(x_.empty() || x_.size() == fun.Domain(), "Invalid typical variable values size");
+        x_.resize(fun.Domain());
+    }
+
+    BltDecomposition(const BltDecomposition& p) = delete;
+
+    BltDecomposition& operator=(const BltDecomposition& p) = delete;
+
+    inline virtual ~BltDecomposition() = default;
+
+    /**
+     * Determines the blocks of equations.
+     *
+     * @return the blocks in evaluation order
+     * @throws CGException if an equation is not assigned to an unknown
+     *                     variable
+     */
+    inline const std::vector<DaeBlock>& decompose() {
+        if (decomposed_)
+            return blocks_;
+
+        const size_t m = fun_->Range();
+        const size_t n = fun_->Domain();
+
+        sparsity_ = jacobianSparsitySet<std::vector<std::set<size_t> >, CGBase>(*fun_);
+
+        /**
+         * determine the unknown variables
+         */
+        std::vector<bool> known(n, false);
+        for (size_t j = 0; j < n; ++j) {
+            const DaeVarInfo& var = varInfo_[j];
+            if (!var.isFunctionOfIntegrated() || var.isIntegratedVariable())
+                known[j] = true;
+            if (var.getAntiDerivative() >= 0)
+                known[var.getAntiDerivative()] = true;
+        }
+
+        std::vector<size_t> outputs; // explicit differential equations
+        for (size_t i = 0; i < m; ++i) {
+            if (eqInfo_[i].isExplicit()) {
+                outputs.push_back(i);
+                if (eqInfo_[i].getAssignedVarIndex() >= 0)
+                    known[eqInfo_[i].getAssignedVarIndex()] = true;
+            }
+        }
+
+        std::vector<int> var2Eq(n, -1);
+        size_t unknowns = 0;
+        for (size_t j = 0; j < n; ++j) {
+            if (!known[j])
+                unknowns++;
+        }
+
+        for (size_t i = 0; i < m; ++i) {
+            if (eqInfo_[i].isExplicit())
+                continue;
+            int j = eqInfo_[i].getAssignedVarIndex();
+            if (j < 0 || size_t(j) >= n || known[j] || var2Eq[j] >= 0 || sparsity_[i].find(j) == sparsity_[i].end()) {
+                throw CGException("Equation ", i, " is not assigned to a unique unknown variable present in the equation");
+            }
+            var2Eq[j] = i;
+        }
+
+        if (unknowns != m - outputs.size()) {
+            throw CGException("The system is not well determined. "
+                              "The number of implicit equations (", m - outputs.size(), ")"
+                              " does not match the number of unknown variables (", unknowns, ").");
+        }
+
+        /**
+         * dependencies between equations (compressed sparse rows)
+         */
+        std::vector<size_t> depStart(m + 1, 0);
+        std::vector<size_t> deps;
+        std::vector<bool> implicitEq(m, false);
+        for (size_t i = 0; i < m; ++i) {
+            if (!eqInfo_[i].isExplicit()) {
+                implicitEq[i] = true;
+                for (size_t j : sparsity_[i]) {
+                    if (var2Eq[j] >= 0 && size_t(var2Eq[j]) != i)
+                        deps.push_back(var2Eq[j]);
+                }
+            }
+            depStart[i + 1] = deps.size();
+        }
+
+        /**
+         * operation graph used to determine which blocks are explicit
+         */
+        handler_.reset(new CodeHandler<Base>());
+        indep0_.resize(n);
+        handler_->makeVariables(indep0_);
+        res0_ = fun_->Forward(0, indep0_);
+
+        blocks_.clear();
+
+        std::vector<std::vector<size_t> > components = stronglyConnectedComponents(implicitEq, depStart, deps);
+        for (std::vector<size_t>& eqs : components) {
+            std::sort(eqs.begin(), eqs.end());
+            std::vector<size_t> vars(eqs.size());
+            for (size_t e = 0; e < eqs.size(); ++e) {
+                vars[e] = eqInfo_[eqs[e]].getAssignedVarIndex();
+            }
+
+            bool explicitBlock = false;
+            if (eqs.size() == 1 && res0_[eqs[0]].isVariable()) {
+                explicitBlock = handler_->isSolvable(*res0_[eqs[0]].getOperationNode(), *indep0_[vars[0]].getOperationNode());
+            }
+
+            blocks_.emplace_back(std::move(eqs), std::move(vars), explicitBlock);
+        }
+
+        for (size_t i : outputs) {
+            blocks_.emplace_back(std::vector<size_t>{i}, std::vector<size_t>(), true);
+        }
+
+        decomposed_ = true;
+
+        if (this->verbosity_ >= Verbosity::Low) {
+            log() << "BLT decomposition: " << blocks_.size() << " blocks\n";
+            for (size_t b = 0; b < blocks_.size(); ++b) {
+                const DaeBlock& block = blocks_[b];
+                log() << "   block " << b << (block.isExplicit() ? " (explicit)" : " (algebraic loop)") << ":";
+                for (size_t j : block.getVariables())
+                    log() << " " << varInfo_[j].getName();
+                log() << "\n";
+            }
+        }
+
+        return blocks_;
+    }
+
+    /**
+     * Provides the blocks determined by decompose().
+     */
+    inline const std::vector<DaeBlock>& getBlocks() const {
+        return blocks_;
+    }
+
+    /**
+     * Creates a model for each block which uses the same independent
+     * variables as the original model.
+     * The dependents of explicit blocks are the values of their variables
+     * (or the time derivatives of explicit differential equations) while
+     * the dependents of algebraic loops are the residuals of their
+     * equations.
+     *
+     * @return the models (in the same order as the blocks)
+     * @throws CGException on failure
+     */
+    inline std::vector<std::unique_ptr<ADFun<CGBase> > > generateBlockModels() {
+        decompose();
+
+        const size_t n = fun_->Domain();
+
+        std::vector<std::unique_ptr<ADFun<CGBase> > > models;
+        models.reserve(blocks_.size());
+
+        for (const DaeBlock& block : blocks_) {
+            const std::vector<size_t>& eqs = block.getEquations();
+            const std::vector<size_t>& vars = block.getVariables();
+
+            std::vector<CGBase> dep;
+            dep.reserve(eqs.size());
+            if (block.isExplicit() && !vars.empty()) {
+                dep.push_back(handler_->solveFor(*res0_[eqs[0]].getOperationNode(), *indep0_[vars[0]].getOperationNode()));
+            } else {
+                for (size_t i : eqs)
+                    dep.push_back(res0_[i]);
+            }
+
+            std::vector<ADCG> indep(n);
+            for (size_t j = 0; j < n; ++j) {
+                indep[j] = x_[j];
+            }
+            Independent(indep);
+
+            Evaluator<Base, CGBase> evaluator(*handler_);
+            std::vector<ADCG> y = evaluator.evaluate(indep, dep);
+
+            models.emplace_back(new ADFun<CGBase>(indep, y));
+        }
+
+        return models;
+    }
+
+    /**
+     * Configures the source code generation of a block model created by
+     * generateBlockModels().
+     * Algebraic loops also include the sparse Jacobian relative to the
+     * variables of the block (the only elements required by a Newton
+     * method).
+     *
+     * @param b the block index
+     * @param sourceGen the source code generator of the block model
+     */
+    inline void configureSourceGen(size_t b,
+                                   ModelCSourceGen<Base>& sourceGen) const {
+        CPPADCG_ASSERT_KNOWN(b < blocks_.size(), "Invalid block index");
+
+        const DaeBlock& block = blocks_[b];
+        sourceGen.setCreateForwardZero(true);
+
+        if (block.isExplicit())
+            return;
+
+        const std::vector<size_t>& eqs = block.getEquations();
+        std::vector<size_t> rows, cols;
+        for (size_t e = 0; e < eqs.size(); ++e) {
+            const std::set<size_t>& eqVars = sparsity_[eqs[e]];
+            for (size_t j : block.getVariables()) {
+                if (eqVars.find(j) != eqVars.end()) {
+                    rows.push_back(e);
+                    cols.push_back(j);
+                }
+            }
+        }
+
+        sourceGen.setCustomSparseJacobianElements(rows, cols);
+        sourceGen.setCreateSparseJacobian(true);
+    }
+
+protected:
+
+    /**
+     * Tarjan's algorithm (iterative version).
+     *
+     * @param active the equations to include in the components
+     * @param depStart the location of the first dependency of each equation
+     * @param deps the equations each equation depends on
+     * @return the strongly connected components where each component only
+     *         depends on previous components
+     */
+    static inline std::vector<std::vector<size_t> > stronglyConnectedComponents(const std::vector<bool>& active,
+                                                                                const std::vector<size_t>& depStart,
+                                                                                const std::vector<size_t>& deps) {
+        const size_t NONE = (std::numeric_limits<size_t>::max)();
+        const size_t m = depStart.size() - 1;
+
+        std::vector<size_t> index(m, NONE);
+        std::vector<size_t> low(m);
+        std::vector<bool> onStack(m, false);
+        std::vector<size_t> stack;
+        std::vector<std::pair<size_t, size_t> > calls; // equation and next dependency
+        std::vector<std::vector<size_t> > components;
+        size_t counter = 0;
+
+        for (size_t r = 0; r < m; ++r) {
+            if (!active[r] || index[r] != NONE)
+                continue;
+
+            index[r] = low[r] = counter++;
+            stack.push_back(r);
+            onStack[r] = true;
+            calls.emplace_back(r, depStart[r]);
+
+            while (!calls.empty()) {
+                size_t v = calls.back().first;
+
+                if (calls.back().second < depStart[v + 1]) {
+                    size_t w = deps[calls.back().second++];
+                    if (index[w] == NONE) {
+                        index[w] = low[w] = counter++;
+                        stack.push_back(w);
+                        onStack[w] = true;
+                        calls.emplace_back(w, depStart[w]);
+                    } else if (onStack[w]) {
+                        low[v] = std::min(low[v], index[w]);
+                    }
+                    continue;
+                }
+
+                if (low[v] == index[v]) {
+                    components.emplace_back();
+                    std::vector<size_t>& comp = components.back();
+                    size_t w;
+                    do {
+                        w = stack.back();
+                        stack.pop_back();
+                        onStack[w] = false;
+                        comp.push_back(w);
+                    } while (w != v);
+                }
+
+                calls.pop_back();
+                if (!calls.empty()) {
+                    size_t u = calls.back().first;
+                    low[u] = std::min(low[u], low[v]);
+                }
+            }
+        }
+
+        return components;
+    }
+
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
@@ -17,6 +17,7 @@
 
 #include <cppad/cg/dae_index_reduction/dae_index_reduction.hpp>
 #include <cppad/cg/dae_index_reduction/bipartite_graph.hpp>
+#include <cppad/cg/dae_index_reduction/hopcroft_karp.hpp>
 
 namespace CppAD {
 namespace cg {
@@ -33,6 +34,9 @@ protected:
 protected:
     //
     BipartiteGraph<Base> graph_;
+    // the algorithm used to assign equations to variables
+    BipartiteMatching matching_;
+    HopcroftKarp<Base> hopcroftKarp_;
 public:
 
     /**
@@ -47,7 +51,8 @@ public:
                                 const std::vector<DaeVarInfo>& varInfo,
                                 const std::vector<std::string>& eqName) :
             DaeIndexReduction<Base>(fun),
-            graph_(fun, varInfo, eqName, *this) {
+            graph_(fun, varInfo, eqName, *this),
+            matching_(BipartiteMatching::AugmentPath) {
     }
 
     inline virtual ~DaeStructuralIndexReduction() {
@@ -79,6 +84,43 @@ public:
         return graph_.isPreserveNames();
     }
 
+    /**
+     * Defines the number of threads used to differentiate the new
+     * equations with respect to time when the reduced model is created.
+     *
+     * @param nThreads the number of threads (0 for one thread per core)
+     */
+    inline void setTimeDiffThreadCount(size_t nThreads) {
+        graph_.setTimeDiffThreadCount(nThreads);
+    }
+
+    /**
+     * Provides the number of threads used to differentiate the new
+     * equations with respect to time.
+     */
+    inline size_t getTimeDiffThreadCount() const {
+        return graph_.getTimeDiffThreadCount();
+    }
+
+    /**
+     * Defines the algorithm used to assign equations to variables.
+     * BipartiteMatching::HopcroftKarp determines a maximum matching for
+     * all the equations at once which is much faster for large systems,
+     * while the equations which cannot be assigned are still processed
+     * by the augment path algorithm in order to determine which equations
+     * must be differentiated.
+     */
+    inline void setMatching(BipartiteMatching matching) {
+        matching_ = matching;
+    }
+
+    /**
+     * Provides the algorithm used to assign equations to variables.
+     */
+    inline BipartiteMatching getMatching() const {
+        return matching_;
+    }
+
     /**
      * Provides the structural index which is typically a good approximation of
      * the differentiation index.
@@ -90,6 +132,26 @@ public:
     inline size_t getStructuralIndex() const {
         return graph_.getStructuralIndex();
     }
+
+protected:
+
+    /**
+     * Assigns as many equations as possible to variables with the
+     * Hopcroft-Karp algorithm if it was selected with setMatching().
+     * Existing assignments are kept or extended.
+     *
+     * @param highestDerivativesOnly whether or not to only use the highest
+     *                               order time derivatives
+     */
+    inline void warmStartMatching(bool highestDerivativesOnly) {
+        if (matching_ != BipartiteMatching::HopcroftKarp)
+            return;
+
+        size_t matched = hopcroftKarp_.match(graph_.equations(), graph_.variables(), highestDerivativesOnly, *this);
+
+        if (this->verbosity_ >= Verbosity::High)
+            this->log() << "Hopcroft-Karp assigned " << matched << " of " << graph_.equations().size() << " equations\n";
+    }
 };
 
 } // END cg namespace
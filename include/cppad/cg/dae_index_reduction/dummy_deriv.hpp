@@ -98,6 +98,10 @@ protected:
      * Avoid using these variables as dummy derivatives
      */
     std::set<std::string> avoidAsDummy_;
+    /**
+     * Use a sparse QR factorization to select dummy derivatives
+     */
+    bool sparseSelection_;
 public:
 
     /**
@@ -125,7 +129,8 @@ public:
             reduceEquations_(true),
             generateSemiExplicitDae_(false),
             reorder_(true),
-            avoidConvertAlg2DifVars_(true) {
+            avoidConvertAlg2DifVars_(true),
+            sparseSelection_(false) {
 
         for (Vnode<Base>* jj : idxIdentify.getGraph().variables()) {
             if (jj->antiDerivative() != nullptr) {
@@ -236,6 +241,31 @@ public:
         return avoidAsDummy_;
     }
 
+    /**
+     * Whether or not a sparse QR factorization (Eigen::SparseQR) is used
+     * to select the dummy derivatives instead of a dense QR factorization
+     * with column pivoting.
+     */
+    inline bool isSparseSelection() const {
+        return sparseSelection_;
+    }
+
+    /**
+     * Defines whether or not to use a sparse QR factorization
+     * (Eigen::SparseQR with a COLAMD ordering) to select the dummy
+     * derivatives.
+     * The dense factorization chooses the columns with the best numerical
+     * conditioning but its cost grows cubically with the size of the
+     * equation blocks, which is prohibitive for large systems.
+     * The sparse factorization only guarantees that the selected columns
+     * are linearly independent.
+     *
+     * @param sparse whether or not to use the sparse factorization
+     */
+    inline void setSparseSelection(bool sparse) {
+        sparseSelection_ = sparse;
+    }
+
     inline std::unique_ptr<ADFun<CG<Base>>> reduceIndex(std::vector<DaeVarInfo>& newVarInfo,
                                                         std::vector<DaeEquationInfo>& newEqInfo) override {
 
@@ -1351,6 +1381,9 @@ protected:
         // resize and zero matrix
         jacobian_.resize(m - diffEqStart_, vnodes.size() - diffVarStart_);
 
+        std::vector<Eigen::Triplet<Base> > triplets;
+        triplets.reserve(jac.size());
+
         map<size_t, Vnode<Base>*> origIndex2var;
         for (size_t j = diffVarStart_; j< vnodes.size(); j++) {
             Vnode<Base>* jj = vnodes[j];
@@ -1369,10 +1402,10 @@ protected:
             size_t i = row[e]; // same order
             size_t j = origIndex2var[col[e]]->index(); // different order than in model/tape
 
-            jacobian_.coeffRef(i - diffEqStart_, j - diffVarStart_) = normVal;
+            triplets.emplace_back(i - diffEqStart_, j - diffVarStart_, normVal);
         }
 
-        jacobian_.makeCompressed();
+        jacobian_.setFromTriplets(triplets.begin(), triplets.end());
 
         if (this->verbosity_ >= Verbosity::High) {
             log() << "\npartial jacobian:\n" << jacobian_ << "\n\n";
@@ -1405,18 +1438,23 @@ protected:
          */
         std::set<size_t> excludeCols;
         std::set<size_t> avoidCols;
+
+        // the location of each column of the Jacobian in vars
+        std::vector<int> jac2Var(jacobian_.cols(), -1);
         for (size_t j = 0; j < vars.size(); j++) {
-            Vnode<Base>* jj = vars[j];
-            bool notZero = false;
-            for (size_t i = 0; i < eqs.size(); i++) {
-                Enode<Base>* ii = eqs[i];
-                Base val = jacobian_.coeff(ii->index() - diffEqStart_, jj->index() - diffVarStart_);
-                if (val != Base(0.0)) {
-                    notZero = true;
-                    break;
-                }
+            jac2Var[vars[j]->index() - diffVarStart_] = j;
+        }
+
+        std::vector<bool> notZero(vars.size(), false);
+        for (Enode<Base>* ii : eqs) {
+            for (typename Eigen::SparseMatrix<Base, Eigen::RowMajor>::InnerIterator it(jacobian_, ii->index() - diffEqStart_); it; ++it) {
+                if (jac2Var[it.col()] >= 0 && it.value() != Base(0.0))
+                    notZero[jac2Var[it.col()]] = true;
             }
-            if (!notZero) {
+        }
+
+        for (size_t j = 0; j < vars.size(); j++) {
+            if (!notZero[j]) {
                 // all zeros: must not choose this column/variable
                 excludeCols.insert(j);
             } else if (avoidAsDummy_.find(vars[j]->name()) != avoidAsDummy_.end()) {
@@ -1434,62 +1472,86 @@ protected:
         }
 
         std::vector<Vnode<Base>* > varsLocal;
-
-        Eigen::ColPivHouseholderQR<MatrixB> qr;
+        // the columns of varsLocal ordered by the QR factorization (linearly independent first)
+        std::vector<size_t> pivots;
+        size_t rank = 0;
 
         auto orderColumns = [&]() {
             varsLocal.reserve(vars.size() - excludeCols.size());
+            std::vector<int> var2Local(vars.size(), -1);
             for (size_t j = 0; j < vars.size(); j++) {
                 if (excludeCols.find(j) == excludeCols.end()) {
+                    var2Local[j] = varsLocal.size();
                     varsLocal.push_back(vars[j]);
                 }
             }
 
-
-            work.setZero(eqs.size(), varsLocal.size());
-
-            // determine the rows that only contain a single nonzero (a single column)
+            // the sub-matrix of the Jacobian
+            std::vector<Eigen::Triplet<Base> > triplets;
             for (size_t i = 0; i < eqs.size(); i++) {
-                Enode<Base>* ii = eqs[i];
-                for (size_t j = 0; j < varsLocal.size(); j++) {
-                    const Vnode<Base>* jj = varsLocal[j];
-                    Base val = jacobian_.coeff(ii->index() - diffEqStart_, jj->index() - diffVarStart_);
-                    if (val != Base(0.0)) {
-                        work(i, j) = val;
+                for (typename Eigen::SparseMatrix<Base, Eigen::RowMajor>::InnerIterator it(jacobian_, eqs[i]->index() - diffEqStart_); it; ++it) {
+                    int j = jac2Var[it.col()];
+                    if (j >= 0 && var2Local[j] >= 0 && it.value() != Base(0.0)) {
+                        triplets.emplace_back(i, var2Local[j], it.value());
                     }
                 }
             }
 
-            if (this->verbosity_ >= Verbosity::High)
-                log() << "subset Jac:\n" << work << "\n";
+            if (sparseSelection_) {
+                Eigen::SparseMatrix<Base> sparseWork(eqs.size(), varsLocal.size());
+                sparseWork.setFromTriplets(triplets.begin(), triplets.end());
+                sparseWork.makeCompressed();
 
-            qr.compute(work);
+                if (this->verbosity_ >= Verbosity::High)
+                    log() << "subset Jac:\n" << MatrixB(sparseWork) << "\n";
 
-            if (qr.info() != Eigen::Success) {
-                throw CGException("Failed to select dummy derivatives! "
-                                  "QR decomposition of a submatrix of the Jacobian failed!");
-            } else if (qr.rank() < work.rows()) {
-                throw CGException("Failed to select dummy derivatives! "
-                                  "The resulting system is probably singular for the provided data.");
-            }
+                Eigen::SparseQR<Eigen::SparseMatrix<Base>, Eigen::COLAMDOrdering<int> > qr(sparseWork);
 
-            using PermutationMatrix = typename Eigen::ColPivHouseholderQR<MatrixB>::PermutationType;
-            using Indices = typename PermutationMatrix::IndicesType;
+                if (qr.info() != Eigen::Success) {
+                    throw CGException("Failed to select dummy derivatives! "
+                                      "QR decomposition of a submatrix of the Jacobian failed!");
+                }
 
-            const PermutationMatrix& p = qr.colsPermutation();
-            const Indices& indices = p.indices();
+                rank = qr.rank();
+                const auto& indices = qr.colsPermutation().indices();
+                pivots.assign(indices.data(), indices.data() + indices.size());
 
-            if (this->verbosity_ >= Verbosity::High) {
-                log() << "## matrix Q:\n";
-                MatrixB q = qr.matrixQ();
-                log() << q << "\n";
-                log() << "## matrix R:\n";
-                MatrixB r = qr.matrixR().template triangularView<Eigen::Upper>();
-                log() << r << "\n";
-                log() << "## matrix P: " << indices.transpose() << "\n";
+            } else {
+                work.setZero(eqs.size(), varsLocal.size());
+                for (const auto& t : triplets) {
+                    work(t.row(), t.col()) = t.value();
+                }
+
+                if (this->verbosity_ >= Verbosity::High)
+                    log() << "subset Jac:\n" << work << "\n";
+
+                Eigen::ColPivHouseholderQR<MatrixB> qr(work);
+
+                if (qr.info() != Eigen::Success) {
+                    throw CGException("Failed to select dummy derivatives! "
+                                      "QR decomposition of a submatrix of the Jacobian failed!");
+                }
+
+                using PermutationMatrix = typename Eigen::ColPivHouseholderQR<MatrixB>::PermutationType;
+                using Indices = typename PermutationMatrix::IndicesType;
+
+                const Indices& indices = qr.colsPermutation().indices();
+
+                if (this->verbosity_ >= Verbosity::High) {
+                    log() << "## matrix Q:\n";
+                    MatrixB q = qr.matrixQ();
+                    log() << q << "\n";
+                    log() << "## matrix R:\n";
+                    MatrixB r = qr.matrixR().template triangularView<Eigen::Upper>();
+                    log() << r << "\n";
+                    log() << "## matrix P: " << indices.transpose() << "\n";
+                }
+
+                rank = qr.rank();
+                pivots.assign(indices.data(), indices.data() + indices.size());
             }
 
-            if (indices.size() < work.rows()) {
+            if (rank < eqs.size() || pivots.size() < eqs.size()) {
                 throw CGException("Failed to select dummy derivatives! "
                                   "The resulting system is probably singular for the provided data.");
             }
@@ -1514,17 +1576,14 @@ protected:
             orderColumns();
         }
 
-        const auto& p = qr.colsPermutation();
-        const auto& indices = p.indices();
-
         std::vector<Vnode<Base>* > newDummies;
         if (avoidConvertAlg2DifVars_) {
             auto& graph = idxIdentify_->getGraph();
             const auto& varInfo = graph.getOriginalVariableInfo();
 
             // add algebraic first
-            for (int i = 0; newDummies.size() < size_t(work.rows()) && i < qr.rank(); i++) {
-                Vnode<Base>* v = varsLocal[indices(i)];
+            for (int i = 0; newDummies.size() < eqs.size() && size_t(i) < rank; i++) {
+                Vnode<Base>* v = varsLocal[pivots[i]];
                 CPPADCG_ASSERT_UNKNOWN(v->originalVariable() != nullptr);
                 size_t tape = v->originalVariable()->tapeIndex();
                 CPPADCG_ASSERT_UNKNOWN(tape < varInfo.size());
@@ -1534,8 +1593,8 @@ protected:
                 }
             }
             // add remaining
-            for (int i = 0; newDummies.size() < size_t(work.rows()); i++) {
-                Vnode<Base>* v = varsLocal[indices(i)];
+            for (int i = 0; newDummies.size() < eqs.size(); i++) {
+                Vnode<Base>* v = varsLocal[pivots[i]];
                 CPPADCG_ASSERT_UNKNOWN(v->originalVariable() != nullptr);
                 size_t tape = v->originalVariable()->tapeIndex();
                 CPPADCG_ASSERT_UNKNOWN(tape < varInfo.size());
@@ -1547,8 +1606,8 @@ protected:
 
         } else {
             // use order provided by the householder column pivoting
-            for (int i = 0; i < work.rows(); i++) {
-                newDummies.push_back(varsLocal[indices(i)]);
+            for (size_t i = 0; i < eqs.size(); i++) {
+                newDummies.push_back(varsLocal[pivots[i]]);
             }
         }
 
@@ -0,0 +1,327 @@
+#ifndef CPPAD_CG_HOPCROFT_KARP_INCLUDED
+#define CPPAD_CG_HOPCROFT_KARP_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+#include <cppad/cg/dae_index_reduction/bipartite_nodes.hpp>
+#include <cppad/cg/dae_index_reduction/simple_logger.hpp>
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * The algorithm used to determine the assignments between equations and
+ * variables in structural index reduction methods.
+ */
+enum class BipartiteMatching {
+    /**
+     * Equations are assigned one at a time using the depth-first search
+     * in AugmentPath
+     */
+    AugmentPath,
+    /**
+     * A maximum matching is first determined with the Hopcroft-Karp
+     * algorithm and only the equations which remain unassigned are processed
+     * with AugmentPath
+     */
+    HopcroftKarp
+};
+
+/**
+ * Determines a maximum matching between equations and variables of a
+ * bipartite graph using the Hopcroft-Karp algorithm.
+ *
+ * The incidence of the equations is copied into a compressed sparse row
+ * structure and augmenting paths are searched for all the unassigned
+ * equations simultaneously (breadth-first layering followed by an iterative
+ * depth-first search), which requires O(sqrt(V) E) operations instead of the
+ * O(V E) operations of assigning one equation at a time.
+ *
+ * Existing valid assignments in the graph are used as the initial matching
+ * and the results are saved back into the graph nodes.
+ * Time derivatives are preferred over algebraic variables as in
+ * AugmentPathDepthLookahead.
+ */
+template<class Base>
+class HopcroftKarp {
+protected:
+    static const size_t NONE = (std::numeric_limits<size_t>::max)();
+    /**
+     * equations in the matching problem
+     */
+    std::vector<Enode<Base>*> eqs_;
+    /**
+     * the location in vars_ of the first variable of each equation
+     * (compressed sparse rows)
+     */
+    std::vector<size_t> eqStart_;
+    /**
+     * the indexes of the variables of each equation
+     */
+    std::vector<size_t> vars_;
+    /**
+     * the variable nodes (by index)
+     */
+    std::vector<Vnode<Base>*> vnodes_;
+    /**
+     * the variable assigned to each equation
+     */
+    std::vector<size_t> matchEq_;
+    /**
+     * the equation assigned to each variable
+     */
+    std::vector<size_t> matchVar_;
+    /**
+     * the layer of each equation in the breadth-first search
+     */
+    std::vector<size_t> dist_;
+    /**
+     * the layer of the equations with a free variable in the last
+     * breadth-first search (the length of the shortest augmenting paths)
+     */
+    size_t freeLayer_;
+    /**
+     * the next edge to be visited for each equation in the depth-first search
+     */
+    std::vector<size_t> next_;
+    std::vector<size_t> queue_;
+    std::vector<size_t> stack_;
+public:
+
+    inline virtual ~HopcroftKarp() = default;
+
+    /**
+     * Determines a maximum matching for the provided equations.
+     *
+     * @param enodes the equations to be assigned
+     * @param vnodes all the variables in the graph
+     * @param highestDerivativesOnly whether or not to only use the highest
+     *                               order time derivatives (and ignore
+     *                               algebraic variables)
+     * @param logger used to log the new assignments
+     * @return the number of equations with an assignment
+     */
+    inline size_t match(const std::vector<Enode<Base>*>& enodes,
+                        const std::vector<Vnode<Base>*>& vnodes,
+                        bool highestDerivativesOnly,
+                        const SimpleLogger& logger) {
+        size_t frozen = prepare(enodes, vnodes, highestDerivativesOnly);
+
+        const size_t neq = eqs_.size();
+
+        std::vector<size_t> initial(matchEq_);
+
+        // greedy initialization
+        for (size_t i = 0; i < neq; ++i) {
+            if (matchEq_[i] != NONE)
+                continue;
+            for (size_t e = eqStart_[i]; e < eqStart_[i + 1]; ++e) {
+                size_t j = vars_[e];
+                if (matchVar_[j] == NONE) {
+                    matchEq_[i] = j;
+                    matchVar_[j] = i;
+                    break;
+                }
+            }
+        }
+
+        while (layer()) {
+            for (size_t i = 0; i < neq; ++i) {
+                next_[i] = eqStart_[i];
+            }
+            for (size_t i = 0; i < neq; ++i) {
+                if (matchEq_[i] == NONE)
+                    augment(i);
+            }
+        }
+
+        // save the new assignments in the graph
+        size_t matched = frozen;
+        for (size_t i = 0; i < neq; ++i) {
+            size_t j = matchEq_[i];
+            if (j == NONE)
+                continue;
+            matched++;
+            if (j != initial[i]) {
+                vnodes_[j]->setAssignmentEquation(*eqs_[i], logger.log(), logger.getVerbosity());
+            }
+        }
+
+        return matched;
+    }
+
+protected:
+
+    /**
+     * Creates the compressed sparse row structure and the initial matching.
+     *
+     * @return the number of equations assigned to variables which cannot be
+     *         used (these equations are not included in the problem)
+     */
+    inline size_t prepare(const std::vector<Enode<Base>*>& enodes,
+                          const std::vector<Vnode<Base>*>& vnodes,
+                          bool highestDerivativesOnly) {
+        const size_t nvar = vnodes.size();
+
+        vnodes_ = vnodes;
+        eqs_.clear();
+        eqs_.reserve(enodes.size());
+        eqStart_.clear();
+        eqStart_.reserve(enodes.size() + 1);
+        eqStart_.push_back(0);
+        vars_.clear();
+        matchEq_.clear();
+        matchVar_.assign(nvar, NONE);
+
+        size_t frozen = 0;
+
+        for (Enode<Base>* i : enodes) {
+            Vnode<Base>* assigned = i->assignmentVariable();
+            if (assigned != nullptr && (assigned->isDeleted() || assigned->assignmentEquation() != i)) {
+                assigned = nullptr; // outdated assignment
+            }
+
+            if (assigned != nullptr && !accept(*assigned, highestDerivativesOnly)) {
+                // this assignment cannot be changed
+                frozen++;
+                continue;
+            }
+
+            size_t eq = eqs_.size();
+            eqs_.push_back(i);
+
+            // time derivatives first
+            for (int pass = 0; pass < 2; ++pass) {
+                for (Vnode<Base>* j : i->variables()) {
+                    if ((j->antiDerivative() != nullptr) == (pass == 0) && accept(*j, highestDerivativesOnly)) {
+                        CPPADCG_ASSERT_UNKNOWN(j->index() < nvar && vnodes[j->index()] == j);
+                        vars_.push_back(j->index());
+                    }
+                }
+            }
+            eqStart_.push_back(vars_.size());
+
+            if (assigned != nullptr) {
+                matchEq_.push_back(assigned->index());
+                matchVar_[assigned->index()] = eq;
+            } else {
+                matchEq_.push_back(NONE);
+            }
+        }
+
+        dist_.resize(eqs_.size());
+        next_.resize(eqs_.size());
+
+        return frozen;
+    }
+
+    static inline bool accept(const Vnode<Base>& j,
+                              bool highestDerivativesOnly) {
+        if (j.isDeleted())
+            return false;
+        return !highestDerivativesOnly || (j.derivative() == nullptr && j.antiDerivative() != nullptr);
+    }
+
+    /**
+     * Breadth-first search which determines the layers of the equations
+     * starting from the unassigned equations.
+     * The search stops at the first layer which reaches an unassigned
+     * variable so that only the shortest augmenting paths are used.
+     *
+     * @return true if an unassigned variable can be reached
+     */
+    inline bool layer() {
+        const size_t neq = eqs_.size();
+
+        queue_.clear();
+        for (size_t i = 0; i < neq; ++i) {
+            if (matchEq_[i] == NONE) {
+                dist_[i] = 0;
+                queue_.push_back(i);
+            } else {
+                dist_[i] = NONE;
+            }
+        }
+
+        freeLayer_ = NONE;
+        for (size_t q = 0; q < queue_.size(); ++q) {
+            size_t i = queue_[q];
+            if (dist_[i] >= freeLayer_)
+                break; // deeper layers cannot be part of a shortest path
+
+            for (size_t e = eqStart_[i]; e < eqStart_[i + 1]; ++e) {
+                size_t k = matchVar_[vars_[e]];
+                if (k == NONE) {
+                    freeLayer_ = dist_[i];
+                } else if (dist_[k] == NONE && freeLayer_ == NONE) {
+                    dist_[k] = dist_[i] + 1;
+                    queue_.push_back(k);
+                }
+            }
+        }
+
+        return freeLayer_ != NONE;
+    }
+
+    /**
+     * Iterative depth-first search for an augmenting path which follows
+     * the layers determined by layer().
+     *
+     * @param root an unassigned equation
+     * @return true if the matching was augmented
+     */
+    inline bool augment(size_t root) {
+        stack_.clear();
+        stack_.push_back(root);
+
+        while (!stack_.empty()) {
+            size_t i = stack_.back();
+
+            if (next_[i] == eqStart_[i + 1]) {
+                // dead end
+                dist_[i] = NONE;
+                stack_.pop_back();
+                if (!stack_.empty())
+                    next_[stack_.back()]++;
+                continue;
+            }
+
+            size_t j = vars_[next_[i]];
+            size_t k = matchVar_[j];
+            if (k == NONE && dist_[i] == freeLayer_) {
+                // flip the assignments along the path
+                for (size_t s : stack_) {
+                    size_t jj = vars_[next_[s]];
+                    matchEq_[s] = jj;
+                    matchVar_[jj] = s;
+                }
+                return true;
+            }
+
+            if (k != NONE && dist_[k] != NONE && dist_[k] == dist_[i] + 1 && dist_[k] <= freeLayer_) {
+                stack_.push_back(k);
+            } else {
+                next_[i]++;
+            }
+        }
+
+        return false;
+    }
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
@@ -116,14 +116,30 @@ protected:
         if (this->verbosity_ >= Verbosity::High)
             graph_.printDot(this->log());
 
+        if (this->matching_ == BipartiteMatching::HopcroftKarp) {
+            for (Vnode<Base>* jj : vnodes) {
+                if (!jj->isDeleted() && jj->derivative() != nullptr) {
+                    jj->deleteNode(log(), this->verbosity_);
+                }
+            }
+
+            this->warmStartMatching(false);
+        }
+
         size_t Ndash = enodes.size();
         for (size_t k = 0; k < Ndash; k++) {
             Enode<Base>* i = enodes[k];
 
+            // the equation might have already been differentiated
+            while (i->derivative() != nullptr)
+                i = i->derivative();
+
             if (this->verbosity_ >= Verbosity::High)
                 log() << "Outer loop: equation k = " << *i << "\n";
 
-            bool pathfound = false;
+            // the equation might have already been assigned (warm start)
+            Vnode<Base>* assigned = i->assignmentVariable();
+            bool pathfound = assigned != nullptr && !assigned->isDeleted() && assigned->assignmentEquation() == i;
             while (!pathfound) {
 
                 /**
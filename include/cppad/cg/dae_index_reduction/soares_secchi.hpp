@@ -175,6 +175,9 @@ protected:
             graph_.printDot(this->log());
 
         while (true) {
+            // assign as many equations as possible at once (if selected)
+            this->warmStartMatching(true);
+
             // augment the matching one by one
             for (size_t k = 0; k < enodes.size(); k++) {
                 Enode<Base>* i = enodes[k];
@@ -56,6 +56,12 @@ class CodeHandlerVectorSync;
 template<class Base, class T>
 class CodeHandlerVector;
 
+template<class Base>
+class OperationGraphWriter;
+
+template<class Base>
+class OperationGraphReader;
+
 template<class Base>
 class CG;
 
@@ -125,6 +131,12 @@ class LangStreamOperation;
 template<class Base>
 class LanguageC;
 
+template<class Base>
+class LanguageBytecode;
+
+template<class Base>
+class BytecodeProgram;
+
 template<class Base>
 class VariableNameGenerator;
 
@@ -146,6 +158,18 @@ class ModelLibraryProcessor;
 template<class Base>
 class FunctorGenericModel;
 
+template<class Base>
+class FunctorGenericModelContext;
+
+template<class Base>
+class AtomicExternalFunctionWrapper;
+
+template<class Base>
+class GenericModelExternalFunctionWrapper;
+
+template<class Base>
+class BytecodeGenericModel;
+
 /***************************************************************************
  * Dynamic model compilation
  **************************************************************************/
@@ -292,6 +316,26 @@ enum class JacobianADMode {
     Forward, Reverse, Automatic
 };
 
+/**
+ * Linear solvers used by the Newton solvers generated for blocks of
+ * algebraic equations
+ */
+enum class NewtonLinearSolver {
+    DenseLU, // LU factorization with partial pivoting of a dense matrix
+    SparseLU // LU factorization with a pivot order determined during code generation
+};
+
+/**
+ * The outcome of a generated Newton solver
+ */
+enum class NewtonSolverStatus {
+    Converged = 0,
+    MaxIterations = 1,
+    SingularJacobian = 2,
+    LineSearchFailed = 3,
+    OutOfMemory = 4
+};
+
 /**
  * Index pattern types
  */
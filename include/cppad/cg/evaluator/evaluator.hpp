@@ -38,7 +38,10 @@ class EvaluatorBase;
  *
  * This class should not be instantiated directly.
  *
- * @todo implement nonrecursive algorithm (so that there will never be any stack limit issues)
+ * By default the operation graph is evaluated recursively.
+ * The iterative mode (setIterative()) first determines the evaluation
+ * order of the nodes with an explicit stack, so that there will never be
+ * any stack limit issues for deep operation graphs.
  */
 template<class ScalarIn, class ScalarOut, class ActiveOut, class FinalEvaluatorType>
 class EvaluatorBase {
@@ -54,6 +57,19 @@ protected:
     bool underEval_;
     size_t depth_;
     SourceCodePath path_;
+    /**
+     * whether or not to use the non-recursive evaluation
+     */
+    bool iterative_;
+    /**
+     * the evaluation order of the nodes in the iterative mode
+     */
+    std::vector<OperationNode<ScalarIn>*> order_;
+    /**
+     * the stack used to determine the evaluation order (node and the
+     * index of the next argument to visit)
+     */
+    std::vector<std::pair<OperationNode<ScalarIn>*, size_t> > stack_;
 public:
 
     /**
@@ -64,7 +80,8 @@ public:
         indep_(nullptr),
         evals_(handler),
         underEval_(false),
-        depth_(0) { // not really required (but it avoids warnings)
+        depth_(0), // not really required (but it avoids warnings)
+        iterative_(false) {
     }
 
     inline virtual ~EvaluatorBase() {
@@ -78,6 +95,30 @@ public:
         return underEval_;
     }
 
+    /**
+     * Defines whether or not the operation graph should be evaluated
+     * without recursion.
+     * In the iterative mode the nodes are sorted topologically using an
+     * explicit stack and then evaluated in that order (which is the same
+     * order used by the recursive evaluation), therefore the results are
+     * the same in both modes.
+     * This mode should not be used by evaluators which depend on the
+     * complete operation path during the evaluation of each node (such as
+     * EvaluatorCloneSolve).
+     *
+     * @param iterative true for the non-recursive evaluation
+     */
+    inline void setIterative(bool iterative) {
+        iterative_ = iterative;
+    }
+
+    /**
+     * @return true if the operation graph is evaluated without recursion
+     */
+    inline bool isIterative() const {
+        return iterative_;
+    }
+
     /**
      * Performs all the operations required to calculate the dependent
      * variables with a (potentially) new data type
@@ -169,8 +210,15 @@ public:
             indep_ = indepNew;
             thisOps.analyzeOutIndeps(indep_, indepSize);
 
+            if (iterative_) {
+                handler_.startNewOperationTreeVisit();
+            }
+
             for (size_t i = 0; i < depSize; i++) {
                 CPPADCG_ASSERT_UNKNOWN(depth_ == 0);
+                if (iterative_ && depOld[i].getOperationNode() != nullptr) {
+                    evalNodesInOrder(*depOld[i].getOperationNode());
+                }
                 depNew[i] = evalCG(depOld[i]);
             }
 
@@ -212,6 +260,57 @@ protected:
         // empty
     }
 
+    /**
+     * Evaluates all the operations required by a node without recursion.
+     * The nodes are evaluated in the same order as in the recursive
+     * evaluation (depth-first with the arguments from left to right)
+     * so that each evaluation only requires nodes which have already
+     * been evaluated.
+     * Array creation and atomic operations are only visited; they are
+     * evaluated by the operations which use them.
+     *
+     * @param root the node to be evaluated
+     */
+    inline void evalNodesInOrder(OperationNode<ScalarIn>& root) {
+        if (evals_[root] != nullptr || handler_.isVisited(root))
+            return;
+
+        order_.clear();
+        stack_.clear();
+
+        handler_.markVisited(root);
+        stack_.emplace_back(&root, 0);
+
+        while (!stack_.empty()) {
+            OperationNode<ScalarIn>* node = stack_.back().first;
+            size_t a = stack_.back().second;
+            const std::vector<Argument<ScalarIn> >& args = node->getArguments();
+
+            if (a < args.size()) {
+                stack_.back().second++;
+
+                OperationNode<ScalarIn>* arg = args[a].getOperation();
+                if (arg != nullptr && evals_[*arg] == nullptr && !handler_.isVisited(*arg)) {
+                    handler_.markVisited(*arg);
+                    stack_.emplace_back(arg, 0);
+                }
+            } else {
+                stack_.pop_back();
+
+                CGOpCode op = node->getOperationType();
+                if (op != CGOpCode::ArrayCreation && op != CGOpCode::SparseArrayCreation &&
+                    op != CGOpCode::AtomicForward && op != CGOpCode::AtomicReverse) {
+                    order_.push_back(node);
+                }
+            }
+        }
+
+        for (OperationNode<ScalarIn>* node : order_) {
+            CPPADCG_ASSERT_UNKNOWN(depth_ == 0);
+            evalOperations(*node);
+        }
+    }
+
     inline ActiveOut evalCG(const CG<ScalarIn>& dep) {
         if (dep.isParameter()) {
             // parameter
@@ -0,0 +1,263 @@
+#ifndef CPPAD_CG_EVALUATOR_LANES_INCLUDED
+#define CPPAD_CG_EVALUATOR_LANES_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * Specialization of class Evaluator for an output active type of
+ * LaneArray<>, which evaluates an operation graph at W points with a
+ * single traversal of the graph.
+ * This class should not be instantiated directly.
+ */
+template<class ScalarIn, class ScalarOut, size_t W, class FinalEvaluatorType>
+class EvaluatorLanes : public EvaluatorOperations<ScalarIn, ScalarOut, LaneArray<ScalarOut, W>, FinalEvaluatorType> {
+    /**
+     * must be friends with one of its super classes since there is a cast to
+     * this type due to the curiously recurring template pattern (CRTP)
+     */
+    friend EvaluatorOperations<ScalarIn, ScalarOut, LaneArray<ScalarOut, W>, FinalEvaluatorType>;
+    friend EvaluatorBase<ScalarIn, ScalarOut, LaneArray<ScalarOut, W>, FinalEvaluatorType>;
+public:
+    using ActiveOut = LaneArray<ScalarOut, W>;
+    using NodeIn = OperationNode<ScalarIn>;
+    using ArgIn = Argument<ScalarIn>;
+    using Super = EvaluatorOperations<ScalarIn, ScalarOut, LaneArray<ScalarOut, W>, FinalEvaluatorType>;
+protected:
+    using Super::handler_;
+    using Super::evalArg;
+public:
+
+    inline EvaluatorLanes(CodeHandler<ScalarIn>& handler) :
+        Super(handler) {
+    }
+
+    /**
+     * Evaluates the dependent variables at several points.
+     * The points are processed in groups of W (one per lane), so that each
+     * traversal of the operation graph determines W points.
+     *
+     * @param nPoints The number of points.
+     * @param indepNew The independent variables of all points
+     *                 (the values of point p start at p * n).
+     * @param depNew The dependent variables of all points
+     *               (the values of point p start at p * m).
+     * @param depOld Dependent variable vector representing the operations
+     *               that are going to be executed
+     * @throws CGException on error (such as an unhandled operation type)
+     */
+    inline void evaluatePoints(size_t nPoints,
+                               ArrayView<const ScalarOut> indepNew,
+                               ArrayView<ScalarOut> depNew,
+                               ArrayView<const CG<ScalarIn> > depOld) {
+        const size_t n = handler_.getIndependentVariableSize();
+        const size_t m = depOld.size();
+
+        if (indepNew.size() != nPoints * n) {
+            throw CGException("Invalid independent variable size. Expected ", nPoints * n, " but got ", indepNew.size(), ".");
+        }
+        if (depNew.size() != nPoints * m) {
+            throw CGException("Invalid dependent variable size. Expected ", nPoints * m, " but got ", depNew.size(), ".");
+        }
+
+        std::vector<ActiveOut> x(n);
+        std::vector<ActiveOut> y(m);
+
+        for (size_t p0 = 0; p0 < nPoints; p0 += W) {
+            size_t nLanes = std::min(W, nPoints - p0);
+
+            for (size_t l = 0; l < W; ++l) {
+                // unused lanes repeat the last point
+                const ScalarOut* xp = &indepNew[(p0 + std::min(l, nLanes - 1)) * n];
+                for (size_t j = 0; j < n; ++j)
+                    x[j][l] = xp[j];
+            }
+
+            this->evaluate(x.data(), n, y.data(), depOld.data(), m);
+
+            for (size_t l = 0; l < nLanes; ++l) {
+                ScalarOut* yp = &depNew[(p0 + l) * m];
+                for (size_t i = 0; i < m; ++i)
+                    yp[i] = y[i][l];
+            }
+        }
+    }
+
+    /**
+     * Evaluates the dependent variables at several points.
+     *
+     * @param nPoints The number of points.
+     * @param indepNew The independent variables of all points
+     *                 (the values of point p start at p * n).
+     * @param depOld Dependent variable vector representing the operations
+     *               that are going to be executed
+     * @return The dependent variables of all points
+     *         (the values of point p start at p * m).
+     */
+    inline std::vector<ScalarOut> evaluatePoints(size_t nPoints,
+                                                 ArrayView<const ScalarOut> indepNew,
+                                                 ArrayView<const CG<ScalarIn> > depOld) {
+        std::vector<ScalarOut> depNew(nPoints * depOld.size());
+        evaluatePoints(nPoints, indepNew, depNew, depOld);
+        return depNew;
+    }
+
+protected:
+
+    /**
+     * Applies a scalar function to each lane of the single argument of a
+     * node.
+     */
+    template<class Function>
+    inline ActiveOut evalUnary(const NodeIn& node,
+                               Function f) {
+        const std::vector<ArgIn>& args = node.getArguments();
+        CPPADCG_ASSERT_KNOWN(args.size() == 1, "Invalid number of arguments for an unary operation");
+        return evalArg(args, 0).apply(f);
+    }
+
+    inline ActiveOut evalCompare(const NodeIn& node,
+                                 enum CompareOp cop) {
+        const std::vector<ArgIn>& args = node.getArguments();
+        CPPADCG_ASSERT_KNOWN(args.size() == 4, "Invalid number of arguments for CondExpOp()");
+        ActiveOut left = evalArg(args, 0);
+        ActiveOut right = evalArg(args, 1);
+        ActiveOut trueCase = evalArg(args, 2);
+        ActiveOut falseCase = evalArg(args, 3);
+
+        ActiveOut r;
+        for (size_t l = 0; l < W; ++l)
+            r[l] = CppAD::CondExpOp(cop, left[l], right[l], trueCase[l], falseCase[l]);
+        return r;
+    }
+
+    /**
+     * @note the following methods override the default ones even though
+     *       they are not virtual (hide methods in EvaluatorOperations)
+     */
+    inline ActiveOut evalAbs(const NodeIn& node) {
+        return evalUnary(node, [](const ScalarOut& v) { return CppAD::abs(v); });
+    }
+
+    inline ActiveOut evalAcos(const NodeIn& node) {
+        return evalUnary(node, [](const ScalarOut& v) { return CppAD::acos(v); });
+    }
+
+    inline ActiveOut evalAsin(const NodeIn& node) {
+        return evalUnary(node, [](const ScalarOut& v) { return CppAD::asin(v); });
+    }
+
+    inline ActiveOut evalAtan(const NodeIn& node) {
+        return evalUnary(node, [](const ScalarOut& v) { return CppAD::atan(v); });
+    }
+
+    inline ActiveOut evalCompareLt(const NodeIn& node) {
+        return evalCompare(node, CompareLt);
+    }
+
+    inline ActiveOut evalCompareLe(const NodeIn& node) {
+        return evalCompare(node, CompareLe);
+    }
+
+    inline ActiveOut evalCompareEq(const NodeIn& node) {
+        return evalCompare(node, CompareEq);
+    }
+
+    inline ActiveOut evalCompareGe(const NodeIn& node) {
+        return evalCompare(node, CompareGe);
+    }
+
+    inline ActiveOut evalCompareGt(const NodeIn& node) {
+        return evalCompare(node, CompareGt);
+    }
+
+    inline ActiveOut evalCompareNe(const NodeIn& node) {
+        return evalCompare(node, CompareNe);
+    }
+
+    inline ActiveOut evalCosh(const NodeIn& node) {
+        return evalUnary(node, [](const ScalarOut& v) { return CppAD::cosh(v); });
+    }
+
+    inline ActiveOut evalCos(const NodeIn& node) {
+        return evalUnary(node, [](const ScalarOut& v) { return CppAD::cos(v); });
+    }
+
+    inline ActiveOut evalExp(const NodeIn& node) {
+        return evalUnary(node, [](const ScalarOut& v) { return CppAD::exp(v); });
+    }
+
+    inline ActiveOut evalLog(const NodeIn& node) {
+        return evalUnary(node, [](const ScalarOut& v) { return CppAD::log(v); });
+    }
+
+    inline ActiveOut evalPow(const NodeIn& node) {
+        const std::vector<ArgIn>& args = node.getArguments();
+        CPPADCG_ASSERT_KNOWN(args.size() == 2, "Invalid number of arguments for pow()");
+        ActiveOut base = evalArg(args, 0);
+        ActiveOut exponent = evalArg(args, 1);
+
+        ActiveOut r;
+        for (size_t l = 0; l < W; ++l)
+            r[l] = CppAD::pow(base[l], exponent[l]);
+        return r;
+    }
+
+    inline ActiveOut evalSign(const NodeIn& node) {
+        return evalUnary(node, [](const ScalarOut& v) { return CppAD::sign(v); });
+    }
+
+    inline ActiveOut evalSinh(const NodeIn& node) {
+        return evalUnary(node, [](const ScalarOut& v) { return CppAD::sinh(v); });
+    }
+
+    inline ActiveOut evalSin(const NodeIn& node) {
+        return evalUnary(node, [](const ScalarOut& v) { return CppAD::sin(v); });
+    }
+
+    inline ActiveOut evalSqrt(const NodeIn& node) {
+        return evalUnary(node, [](const ScalarOut& v) { return CppAD::sqrt(v); });
+    }
+
+    inline ActiveOut evalTanh(const NodeIn& node) {
+        return evalUnary(node, [](const ScalarOut& v) { return CppAD::tanh(v); });
+    }
+
+    inline ActiveOut evalTan(const NodeIn& node) {
+        return evalUnary(node, [](const ScalarOut& v) { return CppAD::tan(v); });
+    }
+
+};
+
+/**
+ * Specialization of Evaluator for an output active type of LaneArray<>
+ */
+template<class ScalarIn, class ScalarOut, size_t W>
+class Evaluator<ScalarIn, ScalarOut, LaneArray<ScalarOut, W> > : public EvaluatorLanes<ScalarIn, ScalarOut, W, Evaluator<ScalarIn, ScalarOut, LaneArray<ScalarOut, W> > > {
+protected:
+    using Super = EvaluatorLanes<ScalarIn, ScalarOut, W, Evaluator<ScalarIn, ScalarOut, LaneArray<ScalarOut, W> > >;
+public:
+
+    inline Evaluator(CodeHandler<ScalarIn>& handler) :
+        Super(handler) {
+    }
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
@@ -0,0 +1,545 @@
+#ifndef CPPAD_CG_EVALUATOR_PARALLEL_INCLUDED
+#define CPPAD_CG_EVALUATOR_PARALLEL_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * Evaluates an operation graph for scalar output types (such as double)
+ * using several threads.
+ *
+ * The nodes are grouped into levels: a node only depends on nodes from
+ * previous levels, therefore all the nodes in a level can be evaluated
+ * concurrently.
+ * The schedule is created once (in the constructor) and the nodes are
+ * stored contiguously by level, so that each thread writes the results of
+ * its own contiguous block of nodes in each level of a single value array
+ * (results are not copied between thread-private arrays since the next
+ * levels read values written by any thread).
+ * The worker threads are created in the first parallel evaluation and
+ * reused by the following evaluations.
+ * Consecutive levels with few nodes are evaluated by a single thread in
+ * order to reduce the synchronization between threads.
+ *
+ * Only the operations supported by the bytecode interpreter
+ * (BytecodeProgram) can be evaluated and the same evaluation kernel is
+ * used (BytecodeProgram::evaluateOperation()).
+ * An object of this class cannot be used for simultaneous evaluations.
+ *
+ * @author Joao Leal
+ */
+template<class ScalarIn, class ScalarOut = ScalarIn>
+class EvaluatorParallel {
+public:
+    using NodeIn = OperationNode<ScalarIn>;
+    using ArgIn = Argument<ScalarIn>;
+protected:
+    /**
+     * A group of nodes evaluated before the threads synchronize
+     */
+    struct Stage {
+        size_t begin;
+        size_t end;
+        bool parallel;
+    };
+
+    /**
+     * Blocks threads until all of them reach the barrier
+     */
+    class Barrier {
+    private:
+        std::mutex mutex_;
+        std::condition_variable cond_;
+        const size_t count_;
+        size_t waiting_;
+        size_t generation_;
+    public:
+        inline explicit Barrier(size_t count) :
+            count_(count),
+            waiting_(0),
+            generation_(0) {
+        }
+
+        inline void wait() {
+            std::unique_lock<std::mutex> lock(mutex_);
+            size_t gen = generation_;
+            if (++waiting_ == count_) {
+                waiting_ = 0;
+                generation_++;
+                cond_.notify_all();
+            } else {
+                cond_.wait(lock, [&] { return gen != generation_; });
+            }
+        }
+    };
+
+protected:
+    /**
+     * the number of independent variables (the first values)
+     */
+    size_t indepSize_;
+    /**
+     * the operation type of each scheduled node (sorted by level)
+     */
+    std::vector<CGOpCode> ops_;
+    /**
+     * the location of the arguments of each node in args_
+     */
+    std::vector<size_t> argStart_;
+    /**
+     * the value positions of the arguments of all nodes
+     */
+    std::vector<size_t> args_;
+    /**
+     * the first node of each level (and the total number of nodes)
+     */
+    std::vector<size_t> levelStart_;
+    /**
+     * the groups of nodes evaluated between synchronizations
+     */
+    std::vector<Stage> stages_;
+    /**
+     * the constant values (placed after the node results)
+     */
+    std::vector<ScalarOut> constants_;
+    /**
+     * the value position of each dependent variable
+     */
+    std::vector<size_t> dependents_;
+    /**
+     * the values of the independents, nodes and constants
+     */
+    std::vector<ScalarOut> values_;
+    /**
+     * the number of threads (0 means one per core)
+     */
+    size_t nThreads_;
+    /**
+     * the minimum number of nodes in a level for it to be evaluated
+     * by several threads
+     */
+    size_t minParallelLevelSize_;
+    /**
+     * the worker threads reused by every parallel evaluation
+     */
+    std::vector<std::thread> workers_;
+    /**
+     * synchronizes the threads after each stage
+     */
+    std::unique_ptr<Barrier> barrier_;
+    std::mutex poolMutex_;
+    std::condition_variable poolCond_;
+    /**
+     * incremented to request a new evaluation from the workers
+     */
+    size_t round_;
+    /**
+     * whether or not the workers must terminate
+     */
+    bool stop_;
+public:
+
+    /**
+     * Creates the evaluation schedule.
+     *
+     * @param handler the code handler which owns the operation graph
+     * @param dependent the dependent variables to evaluate
+     * @throws CGException if the graph contains unsupported operations
+     */
+    inline EvaluatorParallel(CodeHandler<ScalarIn>& handler,
+                             ArrayView<const CG<ScalarIn> > dependent) :
+        indepSize_(handler.getIndependentVariableSize()),
+        nThreads_(0),
+        minParallelLevelSize_(64),
+        round_(0),
+        stop_(false) {
+        createSchedule(handler, dependent);
+    }
+
+    EvaluatorParallel(const EvaluatorParallel& orig) = delete;
+    EvaluatorParallel& operator=(const EvaluatorParallel& rhs) = delete;
+
+    inline virtual ~EvaluatorParallel() {
+        stopWorkers();
+    }
+
+    /**
+     * Defines the number of threads used in each evaluation.
+     * The results do not depend on the number of threads.
+     *
+     * @param nThreads the number of threads (0 for one thread per core)
+     */
+    inline void setThreadCount(size_t nThreads) {
+        nThreads_ = nThreads;
+    }
+
+    /**
+     * Provides the number of threads used in each evaluation.
+     */
+    inline size_t getThreadCount() const {
+        if (nThreads_ == 0)
+            return std::max<size_t>(1, std::thread::hardware_concurrency());
+        return nThreads_;
+    }
+
+    /**
+     * Defines the minimum number of nodes in a level for it to be split
+     * among several threads (smaller levels are evaluated by one thread).
+     */
+    inline void setMinimumParallelLevelSize(size_t size) {
+        minParallelLevelSize_ = std::max<size_t>(1, size);
+        createStages();
+    }
+
+    inline size_t getMinimumParallelLevelSize() const {
+        return minParallelLevelSize_;
+    }
+
+    /**
+     * Provides the number of levels in the schedule (the length of the
+     * longest path in the operation graph).
+     */
+    inline size_t getLevelCount() const {
+        return levelStart_.size() - 1;
+    }
+
+    /**
+     * Provides the number of scheduled operations.
+     */
+    inline size_t getOperationCount() const {
+        return ops_.size();
+    }
+
+    /**
+     * Provides the number of thread synchronizations required by each
+     * parallel evaluation.
+     */
+    inline size_t getStageCount() const {
+        return stages_.size();
+    }
+
+    /**
+     * Evaluates the dependent variables.
+     *
+     * @param x the independent variables
+     * @return the dependent variables
+     */
+    inline std::vector<ScalarOut> evaluate(ArrayView<const ScalarOut> x) {
+        std::vector<ScalarOut> y(dependents_.size());
+        evaluate(x, y);
+        return y;
+    }
+
+    /**
+     * Evaluates the dependent variables.
+     *
+     * @param x the independent variables
+     * @param y the dependent variables
+     */
+    inline void evaluate(ArrayView<const ScalarOut> x,
+                         ArrayView<ScalarOut> y) {
+        if (x.size() != indepSize_) {
+            throw CGException("Invalid independent variable size. Expected ", indepSize_, " but got ", x.size(), ".");
+        }
+        if (y.size() != dependents_.size()) {
+            throw CGException("Invalid dependent variable size. Expected ", dependents_.size(), " but got ", y.size(), ".");
+        }
+
+        std::copy(x.begin(), x.end(), values_.begin());
+
+        bool anyParallel = false;
+        for (const Stage& s : stages_) {
+            anyParallel |= s.parallel;
+        }
+
+        size_t nThreads = getThreadCount();
+
+        if (nThreads <= 1 || !anyParallel) {
+            evaluateRange(0, ops_.size());
+        } else {
+            startWorkers(nThreads - 1);
+
+            {
+                std::lock_guard<std::mutex> lock(poolMutex_);
+                round_++;
+            }
+            poolCond_.notify_all();
+
+            // the last barrier of the stages guarantees that all the workers are done
+            evaluateStages(0, nThreads);
+        }
+
+        for (size_t i = 0; i < dependents_.size(); ++i) {
+            y[i] = values_[dependents_[i]];
+        }
+    }
+
+protected:
+
+    /**
+     * Determines the level of each node and stores the nodes by level.
+     */
+    inline void createSchedule(CodeHandler<ScalarIn>& handler,
+                               ArrayView<const CG<ScalarIn> > dependent) {
+        const size_t unvisited = (std::numeric_limits<size_t>::max)();
+
+        /**
+         * topological order (without recursion)
+         */
+        CodeHandlerVector<ScalarIn, size_t> position(handler); // position in order
+        position.adjustSize();
+        position.fill(unvisited);
+
+        const std::vector<NodeIn*>& indep = handler.getIndependentVariables();
+        for (size_t j = 0; j < indep.size(); ++j) {
+            position[*indep[j]] = j;
+        }
+
+        std::vector<NodeIn*> order;
+        std::vector<size_t> level; // level of each node in order
+        std::vector<std::pair<NodeIn*, size_t> > stack;
+
+        for (size_t i = 0; i < dependent.size(); ++i) {
+            NodeIn* root = dependent[i].getOperationNode();
+            if (root == nullptr || position[*root] != unvisited)
+                continue;
+
+            position[*root] = unvisited - 1;
+            stack.emplace_back(root, 0);
+
+            while (!stack.empty()) {
+                NodeIn* node = stack.back().first;
+                size_t a = stack.back().second;
+                const std::vector<ArgIn>& args = node->getArguments();
+
+                if (a < args.size()) {
+                    stack.back().second++;
+                    NodeIn* arg = args[a].getOperation();
+                    if (arg != nullptr && position[*arg] == unvisited) {
+                        position[*arg] = unvisited - 1;
+                        stack.emplace_back(arg, 0);
+                    }
+                } else {
+                    stack.pop_back();
+
+                    CGOpCode op = node->getOperationType();
+                    if (op == CGOpCode::Inv) {
+                        throw CGException("Independent variable which does not belong to the code handler");
+                    }
+                    int nArgs = BytecodeProgram<ScalarIn>::getArgumentCount(op);
+                    if (nArgs < 0 || size_t(nArgs) != args.size()) {
+                        throw CGException("The parallel evaluator does not support the operation '", op, "'");
+                    }
+
+                    size_t l = 0;
+                    for (const ArgIn& arg : args) {
+                        if (arg.getOperation() != nullptr) {
+                            size_t p = position[*arg.getOperation()];
+                            if (p >= indepSize_)
+                                l = std::max(l, level[p - indepSize_] + 1);
+                        }
+                    }
+
+                    position[*node] = indepSize_ + order.size();
+                    order.push_back(node);
+                    level.push_back(l);
+                }
+            }
+        }
+
+        /**
+         * sort nodes by level (counting sort keeps the topological order
+         * inside each level)
+         */
+        size_t nLevels = 0;
+        for (size_t l : level)
+            nLevels = std::max(nLevels, l + 1);
+
+        levelStart_.assign(nLevels + 1, 0);
+        for (size_t l : level)
+            levelStart_[l + 1]++;
+        for (size_t l = 0; l < nLevels; ++l)
+            levelStart_[l + 1] += levelStart_[l];
+
+        std::vector<size_t> newPos(order.size());
+        std::vector<size_t> next(levelStart_.begin(), levelStart_.end() - 1);
+        for (size_t k = 0; k < order.size(); ++k) {
+            newPos[k] = next[level[k]]++;
+        }
+
+        auto valuePosition = [&](const ArgIn& arg) -> size_t {
+            if (arg.getOperation() == nullptr) {
+                constants_.push_back(ScalarOut(*arg.getParameter()));
+                return indepSize_ + order.size() + constants_.size() - 1;
+            }
+            size_t p = position[*arg.getOperation()];
+            if (p < indepSize_)
+                return p;
+            return indepSize_ + newPos[p - indepSize_];
+        };
+
+        /**
+         * store the nodes contiguously
+         */
+        std::vector<NodeIn*> sorted(order.size());
+        for (size_t k = 0; k < order.size(); ++k) {
+            sorted[newPos[k]] = order[k];
+        }
+
+        ops_.resize(sorted.size());
+        argStart_.resize(sorted.size() + 1);
+        args_.clear();
+        args_.reserve(2 * sorted.size());
+        constants_.clear();
+
+        for (size_t k = 0; k < sorted.size(); ++k) {
+            ops_[k] = sorted[k]->getOperationType();
+            argStart_[k] = args_.size();
+            for (const ArgIn& arg : sorted[k]->getArguments()) {
+                args_.push_back(valuePosition(arg));
+            }
+        }
+        argStart_[sorted.size()] = args_.size();
+
+        dependents_.resize(dependent.size());
+        for (size_t i = 0; i < dependent.size(); ++i) {
+            if (dependent[i].getOperationNode() == nullptr) {
+                constants_.push_back(ScalarOut(dependent[i].getValue()));
+                dependents_[i] = indepSize_ + order.size() + constants_.size() - 1;
+            } else {
+                dependents_[i] = valuePosition(*dependent[i].getOperationNode());
+            }
+        }
+
+        values_.resize(indepSize_ + order.size() + constants_.size());
+        std::copy(constants_.begin(), constants_.end(), values_.end() - constants_.size());
+
+        createStages();
+    }
+
+    /**
+     * Groups the levels into parallel and sequential stages.
+     */
+    inline void createStages() {
+        stages_.clear();
+
+        for (size_t l = 0; l + 1 < levelStart_.size(); ++l) {
+            size_t begin = levelStart_[l];
+            size_t end = levelStart_[l + 1];
+            bool parallel = end - begin >= minParallelLevelSize_;
+
+            if (!parallel && !stages_.empty() && !stages_.back().parallel) {
+                stages_.back().end = end; // merge small levels
+            } else {
+                stages_.push_back(Stage{begin, end, parallel});
+            }
+        }
+    }
+
+    /**
+     * Evaluates the scheduled nodes in [begin, end).
+     */
+    inline void evaluateRange(size_t begin,
+                              size_t end) {
+        ScalarOut* v = values_.data();
+        ScalarOut* res = v + indepSize_;
+
+        for (size_t k = begin; k < end; ++k) {
+            BytecodeProgram<ScalarIn>::evaluateOperation(ops_[k], v, &args_[argStart_[k]], res[k]); // checked in createSchedule()
+        }
+    }
+
+    /**
+     * Evaluates the part of each stage assigned to a thread.
+     *
+     * @param t the thread number (0 for the calling thread)
+     * @param nThreads the total number of threads
+     */
+    inline void evaluateStages(size_t t,
+                               size_t nThreads) {
+        for (const Stage& s : stages_) {
+            if (s.parallel) {
+                size_t length = s.end - s.begin;
+                evaluateRange(s.begin + (length * t) / nThreads,
+                              s.begin + (length * (t + 1)) / nThreads);
+            } else if (t == 0) {
+                evaluateRange(s.begin, s.end);
+            }
+            barrier_->wait();
+        }
+    }
+
+    /**
+     * Makes sure that the worker pool has the requested number of threads
+     * (the calling thread is not included).
+     */
+    inline void startWorkers(size_t nWorkers) {
+        if (workers_.size() == nWorkers && barrier_ != nullptr)
+            return;
+
+        stopWorkers();
+
+        barrier_.reset(new Barrier(nWorkers + 1));
+        stop_ = false;
+        workers_.reserve(nWorkers);
+        for (size_t t = 1; t <= nWorkers; ++t)
+            workers_.emplace_back(&EvaluatorParallel::workerLoop, this, t, nWorkers + 1, round_);
+    }
+
+    /**
+     * Terminates the threads in the worker pool.
+     */
+    inline void stopWorkers() {
+        if (workers_.empty())
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(poolMutex_);
+            stop_ = true;
+        }
+        poolCond_.notify_all();
+
+        for (std::thread& t : workers_)
+            t.join();
+        workers_.clear();
+    }
+
+    /**
+     * The function executed by each thread in the worker pool: waits for
+     * a new evaluation and evaluates its part of each stage.
+     */
+    inline void workerLoop(size_t t,
+                           size_t nThreads,
+                           size_t round) {
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(poolMutex_);
+                poolCond_.wait(lock, [&] { return stop_ || round_ != round; });
+                if (stop_)
+                    return;
+                round = round_;
+            }
+            evaluateStages(t, nThreads);
+        }
+    }
+
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
@@ -0,0 +1,154 @@
+#ifndef CPPAD_CG_LANE_ARRAY_INCLUDED
+#define CPPAD_CG_LANE_ARRAY_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * A fixed number of values (lanes) which are processed together by the
+ * arithmetic operations.
+ * It is used as an output type of the Evaluator in order to evaluate an
+ * operation graph at W points with a single traversal of the graph.
+ * The operations are simple loops with a constant length which can be
+ * vectorized by the compiler.
+ *
+ * @tparam Base the type of each value
+ * @tparam W the number of lanes
+ */
+template<class Base, size_t W>
+class LaneArray {
+    static_assert(W > 0, "The number of lanes must be positive");
+private:
+    std::array<Base, W> values_;
+public:
+
+    inline LaneArray() = default;
+
+    /**
+     * Creates lanes with the same value.
+     */
+    inline LaneArray(const Base& value) {
+        values_.fill(value);
+    }
+
+    inline static constexpr size_t size() {
+        return W;
+    }
+
+    inline Base& operator[](size_t i) {
+        return values_[i];
+    }
+
+    inline const Base& operator[](size_t i) const {
+        return values_[i];
+    }
+
+    inline Base* data() {
+        return values_.data();
+    }
+
+    inline const Base* data() const {
+        return values_.data();
+    }
+
+    /**
+     * Applies a function to each lane.
+     */
+    template<class Function>
+    inline LaneArray apply(Function f) const {
+        LaneArray r;
+        for (size_t l = 0; l < W; ++l)
+            r.values_[l] = f(values_[l]);
+        return r;
+    }
+
+    inline LaneArray& operator+=(const LaneArray& right) {
+        for (size_t l = 0; l < W; ++l)
+            values_[l] += right.values_[l];
+        return *this;
+    }
+
+    inline LaneArray& operator-=(const LaneArray& right) {
+        for (size_t l = 0; l < W; ++l)
+            values_[l] -= right.values_[l];
+        return *this;
+    }
+
+    inline LaneArray& operator*=(const LaneArray& right) {
+        for (size_t l = 0; l < W; ++l)
+            values_[l] *= right.values_[l];
+        return *this;
+    }
+
+    inline LaneArray& operator/=(const LaneArray& right) {
+        for (size_t l = 0; l < W; ++l)
+            values_[l] /= right.values_[l];
+        return *this;
+    }
+
+    inline LaneArray operator-() const {
+        LaneArray r;
+        for (size_t l = 0; l < W; ++l)
+            r.values_[l] = -values_[l];
+        return r;
+    }
+
+    friend inline LaneArray operator+(LaneArray left,
+                                      const LaneArray& right) {
+        return left += right;
+    }
+
+    friend inline LaneArray operator-(LaneArray left,
+                                      const LaneArray& right) {
+        return left -= right;
+    }
+
+    friend inline LaneArray operator*(LaneArray left,
+                                      const LaneArray& right) {
+        return left *= right;
+    }
+
+    friend inline LaneArray operator/(LaneArray left,
+                                      const LaneArray& right) {
+        return left /= right;
+    }
+
+    friend inline bool operator==(const LaneArray& left,
+                                  const LaneArray& right) {
+        return left.values_ == right.values_;
+    }
+
+    friend inline bool operator!=(const LaneArray& left,
+                                  const LaneArray& right) {
+        return left.values_ != right.values_;
+    }
+
+    friend inline std::ostream& operator<<(std::ostream& os,
+                                           const LaneArray& a) {
+        os << "{";
+        for (size_t l = 0; l < W; ++l) {
+            if (l > 0) os << ", ";
+            os << a.values_[l];
+        }
+        return os << "}";
+    }
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
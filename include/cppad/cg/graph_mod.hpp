@@ -55,6 +55,9 @@ inline void CodeHandler<Base>::substituteIndependent(OperationNode<Base>& indep,
 
     indep.makeAlias(arg);
 
+    // the expressions which use the independent variable have changed
+    invalidatePathGraphs(indep);
+
     if (removeFromIndependents) {
         // remove the substituted variable from the independent variable vector
         _independentVariables.erase(_independentVariables.begin() + indepIndex);
@@ -70,6 +73,8 @@ inline void CodeHandler<Base>::undoSubstituteIndependent(OperationNode<Base>& in
     }
 
     indep.setOperation(CGOpCode::Inv);
+
+    invalidatePathGraphs(indep);
 }
 
 template<class Base>
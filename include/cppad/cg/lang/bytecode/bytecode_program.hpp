@@ -0,0 +1,364 @@
+#ifndef CPPAD_CG_BYTECODE_PROGRAM_INCLUDED
+#define CPPAD_CG_BYTECODE_PROGRAM_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * A compact representation of an operation graph which can be evaluated
+ * by an interpreter without compiling any source code.
+ *
+ * The program operates on a register file where register 0 is unused,
+ * registers 1 to n hold the independent variables, the following registers
+ * hold the dependent and the temporary variables (using the variable IDs
+ * assigned by the CodeHandler, which are recycled) and the last registers
+ * hold the constants.
+ * Each instruction is stored in a flat array as the operation code
+ * (CGOpCode), the result register and the argument registers.
+ *
+ * Programs are created by LanguageBytecode.
+ *
+ * @author Joao Leal
+ */
+template<class Base>
+class BytecodeProgram {
+    friend class LanguageBytecode<Base>;
+private:
+    /**
+     * The instructions: operation code, result register and the argument
+     * registers
+     */
+    std::vector<uint32_t> _code;
+    /**
+     * The number of instructions in _code
+     */
+    size_t _instructions;
+    /**
+     * The number of independent variables
+     */
+    size_t _independentSize;
+    /**
+     * The register of each dependent variable
+     */
+    std::vector<uint32_t> _dependents;
+    /**
+     * The constant values (placed in the last registers)
+     */
+    std::vector<Base> _constants;
+    /**
+     * The total number of registers (including the constants)
+     */
+    size_t _registerSize;
+public:
+
+    inline BytecodeProgram() :
+        _instructions(0),
+        _independentSize(0),
+        _registerSize(1) {
+    }
+
+    /**
+     * Provides the number of independent variables
+     */
+    inline size_t getIndependentSize() const {
+        return _independentSize;
+    }
+
+    /**
+     * Provides the number of dependent variables
+     */
+    inline size_t getDependentSize() const {
+        return _dependents.size();
+    }
+
+    /**
+     * Provides the number of instructions
+     */
+    inline size_t getInstructionCount() const {
+        return _instructions;
+    }
+
+    /**
+     * Provides the number of registers required to evaluate this program
+     * (including the constants)
+     */
+    inline size_t getRegisterSize() const {
+        return _registerSize;
+    }
+
+    /**
+     * Provides the instructions: operation code, result register and the
+     * argument registers
+     */
+    inline const std::vector<uint32_t>& getCode() const {
+        return _code;
+    }
+
+    /**
+     * Prepares a register file to be used by this program.
+     * It only needs to be called once for each register file since the
+     * constants are never overwritten.
+     *
+     * @param registers the register file
+     */
+    inline void initRegisters(std::vector<Base>& registers) const {
+        registers.resize(_registerSize);
+        std::copy(_constants.begin(), _constants.end(), registers.end() - _constants.size());
+    }
+
+    /**
+     * Provides the location of an independent variable in a register file.
+     *
+     * @param registers a register file prepared with initRegisters()
+     * @param j the independent variable index
+     */
+    inline Base* getIndependent(std::vector<Base>& registers,
+                                size_t j) const {
+        CPPADCG_ASSERT_UNKNOWN(j < _independentSize)
+        return &registers[j + 1];
+    }
+
+    /**
+     * Evaluates the program.
+     *
+     * @param registers a register file prepared with initRegisters()
+     * @param x the independent variables (only the first getIndependentSize()
+     *          elements are used)
+     * @param y the dependent variables
+     */
+    inline void evaluate(std::vector<Base>& registers,
+                         ArrayView<const Base> x,
+                         ArrayView<Base> y) const {
+        CPPADCG_ASSERT_KNOWN(x.size() >= _independentSize, "Invalid independent array size")
+        if (_independentSize > 0)
+            std::copy(x.data(), x.data() + _independentSize, &registers[1]);
+
+        evaluate(registers, y);
+    }
+
+    /**
+     * Evaluates the program using the independent variables which have
+     * already been placed in the register file.
+     *
+     * @param registers a register file prepared with initRegisters()
+     *                  containing the independent variables
+     * @param y the dependent variables
+     */
+    inline void evaluate(std::vector<Base>& registers,
+                         ArrayView<Base> y) const {
+        CPPADCG_ASSERT_KNOWN(registers.size() == _registerSize, "Invalid register file size")
+        CPPADCG_ASSERT_KNOWN(y.size() == _dependents.size(), "Invalid dependent array size")
+
+        Base* r = registers.data();
+        const uint32_t* pc = _code.data();
+        const uint32_t* end = pc + _code.size();
+
+        while (pc != end) {
+            int nArgs = evaluateOperation(CGOpCode(pc[0]), r, pc + 2, r[pc[1]]);
+            if (nArgs < 0)
+                throw CGException("Invalid bytecode operation: ", CGOpCode(pc[0]));
+            pc += 2 + nArgs;
+        }
+
+        for (size_t i = 0; i < _dependents.size(); ++i) {
+            y[i] = r[_dependents[i]];
+        }
+    }
+
+    /**
+     * Evaluates a single operation.
+     * This is the evaluation kernel shared by the interpreter and by other
+     * evaluators of operation graphs (e.g. EvaluatorParallel).
+     *
+     * @param op the operation type
+     * @param v the values
+     * @param a the position of each argument in the values
+     * @param res the result of the operation
+     * @return the number of arguments used by the operation or -1 if the
+     *         operation is not supported (see getArgumentCount())
+     */
+    template<class Scalar, class Index>
+    static inline int evaluateOperation(CGOpCode op,
+                                        const Scalar* v,
+                                        const Index* a,
+                                        Scalar& res) {
+        switch (op) {
+            case CGOpCode::Assign:
+            case CGOpCode::Alias:
+            case CGOpCode::Pri:
+                res = v[a[0]];
+                return 1;
+            case CGOpCode::Abs:
+                res = CppAD::abs(v[a[0]]);
+                return 1;
+            case CGOpCode::Acos:
+                res = CppAD::acos(v[a[0]]);
+                return 1;
+            case CGOpCode::Acosh:
+                res = CppAD::acosh(v[a[0]]);
+                return 1;
+            case CGOpCode::Asin:
+                res = CppAD::asin(v[a[0]]);
+                return 1;
+            case CGOpCode::Asinh:
+                res = CppAD::asinh(v[a[0]]);
+                return 1;
+            case CGOpCode::Atan:
+                res = CppAD::atan(v[a[0]]);
+                return 1;
+            case CGOpCode::Atanh:
+                res = CppAD::atanh(v[a[0]]);
+                return 1;
+            case CGOpCode::Cosh:
+                res = CppAD::cosh(v[a[0]]);
+                return 1;
+            case CGOpCode::Cos:
+                res = CppAD::cos(v[a[0]]);
+                return 1;
+            case CGOpCode::Erf:
+                res = CppAD::erf(v[a[0]]);
+                return 1;
+            case CGOpCode::Exp:
+                res = CppAD::exp(v[a[0]]);
+                return 1;
+            case CGOpCode::Expm1:
+                res = CppAD::expm1(v[a[0]]);
+                return 1;
+            case CGOpCode::Log:
+                res = CppAD::log(v[a[0]]);
+                return 1;
+            case CGOpCode::Log1p:
+                res = CppAD::log1p(v[a[0]]);
+                return 1;
+            case CGOpCode::Sign:
+                res = CppAD::sign(v[a[0]]);
+                return 1;
+            case CGOpCode::Sinh:
+                res = CppAD::sinh(v[a[0]]);
+                return 1;
+            case CGOpCode::Sin:
+                res = CppAD::sin(v[a[0]]);
+                return 1;
+            case CGOpCode::Sqrt:
+                res = CppAD::sqrt(v[a[0]]);
+                return 1;
+            case CGOpCode::Tanh:
+                res = CppAD::tanh(v[a[0]]);
+                return 1;
+            case CGOpCode::Tan:
+                res = CppAD::tan(v[a[0]]);
+                return 1;
+            case CGOpCode::UnMinus:
+                res = -v[a[0]];
+                return 1;
+            case CGOpCode::Add:
+                res = v[a[0]] + v[a[1]];
+                return 2;
+            case CGOpCode::Sub:
+                res = v[a[0]] - v[a[1]];
+                return 2;
+            case CGOpCode::Mul:
+                res = v[a[0]] * v[a[1]];
+                return 2;
+            case CGOpCode::Div:
+                res = v[a[0]] / v[a[1]];
+                return 2;
+            case CGOpCode::Pow:
+                res = CppAD::pow(v[a[0]], v[a[1]]);
+                return 2;
+            case CGOpCode::ComLt:
+                res = v[a[0]] < v[a[1]] ? v[a[2]] : v[a[3]];
+                return 4;
+            case CGOpCode::ComLe:
+                res = v[a[0]] <= v[a[1]] ? v[a[2]] : v[a[3]];
+                return 4;
+            case CGOpCode::ComEq:
+                res = v[a[0]] == v[a[1]] ? v[a[2]] : v[a[3]];
+                return 4;
+            case CGOpCode::ComGe:
+                res = v[a[0]] >= v[a[1]] ? v[a[2]] : v[a[3]];
+                return 4;
+            case CGOpCode::ComGt:
+                res = v[a[0]] > v[a[1]] ? v[a[2]] : v[a[3]];
+                return 4;
+            case CGOpCode::ComNe:
+                res = v[a[0]] != v[a[1]] ? v[a[2]] : v[a[3]];
+                return 4;
+            default:
+                return -1;
+        }
+    }
+
+    /**
+     * Provides the number of argument registers used by an operation in
+     * the bytecode.
+     *
+     * @param op the operation type
+     * @return the number of arguments or -1 if the operation cannot be
+     *         used in a program
+     */
+    static inline int getArgumentCount(CGOpCode op) {
+        switch (op) {
+            case CGOpCode::Assign:
+            case CGOpCode::Alias:
+            case CGOpCode::Pri:
+            case CGOpCode::Abs:
+            case CGOpCode::Acos:
+            case CGOpCode::Acosh:
+            case CGOpCode::Asin:
+            case CGOpCode::Asinh:
+            case CGOpCode::Atan:
+            case CGOpCode::Atanh:
+            case CGOpCode::Cosh:
+            case CGOpCode::Cos:
+            case CGOpCode::Erf:
+            case CGOpCode::Exp:
+            case CGOpCode::Expm1:
+            case CGOpCode::Log:
+            case CGOpCode::Log1p:
+            case CGOpCode::Sign:
+            case CGOpCode::Sinh:
+            case CGOpCode::Sin:
+            case CGOpCode::Sqrt:
+            case CGOpCode::Tanh:
+            case CGOpCode::Tan:
+            case CGOpCode::UnMinus:
+                return 1;
+            case CGOpCode::Add:
+            case CGOpCode::Sub:
+            case CGOpCode::Mul:
+            case CGOpCode::Div:
+            case CGOpCode::Pow:
+                return 2;
+            case CGOpCode::ComLt:
+            case CGOpCode::ComLe:
+            case CGOpCode::ComEq:
+            case CGOpCode::ComGe:
+            case CGOpCode::ComGt:
+            case CGOpCode::ComNe:
+                return 4;
+            default:
+                return -1;
+        }
+    }
+
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
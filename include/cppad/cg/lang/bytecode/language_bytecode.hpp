@@ -0,0 +1,194 @@
+#ifndef CPPAD_CG_LANGUAGE_BYTECODE_INCLUDED
+#define CPPAD_CG_LANGUAGE_BYTECODE_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * Creates a bytecode program (BytecodeProgram) from an operation graph
+ * which can be evaluated without compiling any source code.
+ *
+ * Every operation is assigned to a register (the variable ID) and
+ * the registers of temporary variables are recycled by the CodeHandler.
+ * Loops, conditional blocks, arrays and atomic functions are not
+ * supported.
+ * No source code is written to the output stream.
+ *
+ * @author Joao Leal
+ */
+template<class Base>
+class LanguageBytecode : public Language<Base> {
+public:
+    using Node = OperationNode<Base>;
+    using Arg = Argument<Base>;
+protected:
+    // information from the code handler (not owned)
+    LanguageGenerationData<Base>* _info;
+    // the last program created
+    std::unique_ptr<BytecodeProgram<Base> > _program;
+public:
+
+    inline LanguageBytecode() :
+        _info(nullptr) {
+    }
+
+    /**
+     * Provides the program created by the last call to
+     * CodeHandler::generateCode() with this language.
+     * The program is no longer owned by this object.
+     */
+    inline std::unique_ptr<BytecodeProgram<Base> > releaseProgram() {
+        return std::move(_program);
+    }
+
+protected:
+
+    void generateSourceCode(std::ostream& out,
+                            std::unique_ptr<LanguageGenerationData<Base> > info) override {
+        _info = info.get();
+        _program.reset(new BytecodeProgram<Base>());
+        BytecodeProgram<Base>& p = *_program;
+
+        CPPADCG_ASSERT_KNOWN(_info->indexes.empty(), "The bytecode interpreter does not support loops")
+
+        const std::vector<Node*>& variableOrder = _info->variableOrder;
+
+        /**
+         * the registers for the independents, dependents and temporaries
+         */
+        size_t maxId = _info->minTemporaryVarID - 1;
+        for (const Node* node : variableOrder) {
+            size_t id = _info->varId[*node];
+            if (id != (std::numeric_limits<size_t>::max)())
+                maxId = std::max<size_t>(maxId, id);
+        }
+        p._registerSize = maxId + 1;
+        p._independentSize = _info->independent.size();
+
+        /**
+         * instructions
+         */
+        p._code.reserve(4 * variableOrder.size());
+
+        for (const Node* node : variableOrder) {
+            CGOpCode op = node->getOperationType();
+            int nArgs = BytecodeProgram<Base>::getArgumentCount(op);
+            if (nArgs < 0) {
+                throw CGException("The bytecode interpreter does not support the operation '", op, "'");
+            }
+
+            size_t id = _info->varId[*node];
+            if (op == CGOpCode::Pri && id == (std::numeric_limits<size_t>::max)()) {
+                continue; // users of this node read its argument directly
+            }
+
+            const std::vector<Arg>& args = node->getArguments();
+            CPPADCG_ASSERT_KNOWN(args.size() == size_t(nArgs), "Invalid number of arguments for operation")
+
+            p._code.push_back(uint32_t(op));
+            p._code.push_back(toRegister(id));
+            for (const Arg& a : args) {
+                p._code.push_back(getRegister(a));
+            }
+            p._instructions++;
+        }
+
+        /**
+         * dependents
+         */
+        const ArrayView<CG<Base> >& dependent = _info->dependent;
+        p._dependents.resize(dependent.size());
+        for (size_t i = 0; i < dependent.size(); ++i) {
+            const Node* node = dependent[i].getOperationNode();
+            if (node == nullptr) {
+                p._dependents[i] = addConstant(dependent[i].getValue());
+            } else {
+                p._dependents[i] = getRegister(*node);
+            }
+        }
+
+        p._registerSize += p._constants.size();
+
+        _info = nullptr;
+    }
+
+    bool createsNewVariable(const Node& var,
+                            size_t totalUseCount,
+                            size_t opCount) const override {
+        return true; // every operation is saved in a register
+    }
+
+    bool requiresVariableArgument(enum CGOpCode op,
+                                  size_t argIndex) const override {
+        return false;
+    }
+
+    bool requiresVariableDependencies() const override {
+        return false;
+    }
+
+    /**
+     * Provides the register with the value of an argument.
+     */
+    inline uint32_t getRegister(const Arg& arg) {
+        if (arg.getOperation() == nullptr) {
+            return addConstant(*arg.getParameter());
+        }
+
+        const Node& node = *arg.getOperation();
+        if (node.getOperationType() == CGOpCode::Alias) {
+            return getRegister(node.getArguments()[0]);
+        }
+        return getRegister(node);
+    }
+
+    /**
+     * Provides the register with the value of an operation.
+     */
+    inline uint32_t getRegister(const Node& node) {
+        size_t id = _info->varId[node];
+        if (id == 0 || id == (std::numeric_limits<size_t>::max)()) {
+            // aliases and print operations just forward their first argument
+            CGOpCode op = node.getOperationType();
+            if (op != CGOpCode::Alias && op != CGOpCode::Pri) {
+                throw CGException("The bytecode interpreter does not support the operation '", op, "'");
+            }
+            return getRegister(node.getArguments()[0]);
+        }
+        return toRegister(id);
+    }
+
+    /**
+     * Adds a new constant register.
+     */
+    inline uint32_t addConstant(const Base& value) {
+        BytecodeProgram<Base>& p = *_program;
+        p._constants.push_back(value);
+        return toRegister(p._registerSize + p._constants.size() - 1);
+    }
+
+    static inline uint32_t toRegister(size_t id) {
+        CPPADCG_ASSERT_KNOWN(id < (std::numeric_limits<uint32_t>::max)(), "Too many registers required by the bytecode")
+        return uint32_t(id);
+    }
+
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
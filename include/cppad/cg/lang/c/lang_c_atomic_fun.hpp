@@ -68,6 +68,29 @@ struct LangCAtomicFun {
                    const Array tx[],
                    Array* px,
                    const Array py[]);
+
+    /**
+     * Evaluates an atomic function for several sets of arguments at once
+     * (e.g. all the iterations of a loop).
+     * Each array holds nBatch consecutive blocks of values where the size
+     * and the number of non-zeros refer to a single block and all the
+     * blocks of a sparse array share the same indexes.
+     */
+    int (*forwardBatch)(void* libModel,
+                        int atomicIndex,
+                        int q,
+                        int p,
+                        unsigned long nBatch,
+                        const Array tx[],
+                        Array* ty);
+
+    int (*reverseBatch)(void* libModel,
+                        int atomicIndex,
+                        int p,
+                        unsigned long nBatch,
+                        const Array tx[],
+                        Array* px,
+                        const Array py[]);
 };
 
 }
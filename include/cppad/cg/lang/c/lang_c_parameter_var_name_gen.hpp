@@ -0,0 +1,114 @@
+#ifndef CPPAD_CG_LANG_C_PARAMETER_VAR_NAME_GEN_INCLUDED
+#define CPPAD_CG_LANG_C_PARAMETER_VAR_NAME_GEN_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * Creates variables names for the source code of models with runtime
+ * parameters.
+ * The independent variables are considered to have been registered first as
+ * variables in the code generation handler and then the parameters.
+ * The parameters are provided to the generated functions through a second
+ * input array so that their values can be changed without recompiling.
+ *
+ * @author Joao Leal
+ */
+template<class Base>
+class LangCParameterVariableNameGenerator : public LangCDefaultVariableNameGenerator<Base> {
+protected:
+    // array name of the parameters
+    std::string _paramName;
+    // the lowest variable ID used for the parameters
+    size_t _minParameterID;
+public:
+
+    /**
+     * @param n the number of independent variables
+     */
+    inline explicit LangCParameterVariableNameGenerator(size_t n,
+                                                        std::string depName = "y",
+                                                        std::string indepName = "x",
+                                                        std::string paramName = "p",
+                                                        std::string tmpName = "v",
+                                                        std::string tmpArrayName = "array",
+                                                        std::string tmpSparseArrayName = "sarray") :
+        LangCDefaultVariableNameGenerator<Base>(std::move(depName),
+                                                std::move(indepName),
+                                                std::move(tmpName),
+                                                std::move(tmpArrayName),
+                                                std::move(tmpSparseArrayName)),
+        _paramName(std::move(paramName)),
+        _minParameterID(n + 1) {
+
+        CPPADCG_ASSERT_KNOWN(!_paramName.empty(), "The name for the parameters must not be empty")
+
+        this->_independent.push_back(FuncArgument(_paramName));
+    }
+
+    inline virtual ~LangCParameterVariableNameGenerator() = default;
+
+    inline std::string generateIndependent(const OperationNode<Base>& independent,
+                                           size_t id) override {
+        if (id < _minParameterID) {
+            return LangCDefaultVariableNameGenerator<Base>::generateIndependent(independent, id);
+        }
+
+        this->_ss.clear();
+        this->_ss.str("");
+
+        this->_ss << _paramName << "[" << (id - _minParameterID) << "]";
+
+        return this->_ss.str();
+    }
+
+    const std::string& getIndependentArrayName(const OperationNode<Base>& indep,
+                                               size_t id) override {
+        if (id < _minParameterID)
+            return this->_indepName;
+        else
+            return _paramName;
+    }
+
+    size_t getIndependentArrayIndex(const OperationNode<Base>& indep,
+                                    size_t id) override {
+        if (id < _minParameterID)
+            return id - 1;
+        else
+            return id - _minParameterID;
+    }
+
+    bool isConsecutiveInIndepArray(const OperationNode<Base>& indepFirst,
+                                   size_t idFirst,
+                                   const OperationNode<Base>& indepSecond,
+                                   size_t idSecond) override {
+        return (idFirst < _minParameterID) == (idSecond < _minParameterID) &&
+                idFirst + 1 == idSecond;
+    }
+
+    bool isInSameIndependentArray(const OperationNode<Base>& indep1,
+                                  size_t id1,
+                                  const OperationNode<Base>& indep2,
+                                  size_t id2) override {
+        return (id1 < _minParameterID) == (id2 < _minParameterID);
+    }
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
@@ -53,6 +53,29 @@ protected:
     static const std::string _ATOMIC_PY;
 private:
     class AtomicFuncArray; //forward declaration
+    /**
+     * A loop whose iterations can be executed simultaneously (SIMD lanes)
+     */
+    struct SimdLoop {
+        // the temporary variables declared inside the loop body
+        std::vector<std::string> temporaries;
+        // the index variables assigned inside the loop body
+        std::vector<const Node*> indexes;
+    };
+
+    /**
+     * A loop whose atomic function call is evaluated once for all the
+     * iterations
+     */
+    struct BatchAtomicLoop {
+        // the position of the loop end in the variable order
+        size_t end;
+        // the position of the atomic function call in the variable order
+        size_t atomic;
+        // the positions of the assignments before the atomic function call
+        // which must be repeated in the loop after the call
+        std::vector<size_t> recompute;
+    };
 protected:
     // the type name of the Base class (e.g. "double")
     const std::string _baseTypeName;
@@ -110,11 +133,25 @@ protected:
     std::vector<const LoopStartOperationNode<Base>*> _currentLoops;
     // the maximum precision used to print values
     size_t _parameterPrecision;
+    // whether or not the pointers to variable arrays are restrict-qualified
+    bool _restrictPointers;
+    // whether or not to generate OpenMP simd pragmas for loops
+    bool _simdLoops;
+    // whether or not to call atomic functions once for all the iterations of loops
+    bool _batchAtomicLoops;
+    // the maximum number of values in the (stack) buffers of a batched atomic function call
+    size_t _maxBatchAtomicValues;
+    // maps the names of atomic functions to the C functions called directly
+    std::map<std::string, std::string> _directAtomicFunctions;
 private:
     std::vector<std::string> funcArgDcl_;
     std::vector<std::string> localFuncArgDcl_;
     std::string localFuncArgs_;
     std::string auxArrayName_;
+    // the loops which will use an OpenMP simd pragma
+    std::map<const Node*, SimdLoop> simdLoops_;
+    // the loops whose atomic function calls are batched
+    std::map<const Node*, BatchAtomicLoop> batchAtomicLoops_;
 
 public:
 
@@ -142,7 +179,11 @@ public:
         _maxAssignmentsPerFunction(0),
         _maxOperationsPerAssignment((std::numeric_limits<size_t>::max)()),
         _sources(nullptr),
-        _parameterPrecision(std::numeric_limits<Base>::digits10) {
+        _parameterPrecision(std::numeric_limits<Base>::digits10),
+        _restrictPointers(false),
+        _simdLoops(false),
+        _batchAtomicLoops(false),
+        _maxBatchAtomicValues(4096) {
     }
 
     inline virtual ~LanguageC() = default;
@@ -274,6 +315,136 @@ public:
         _maxOperationsPerAssignment = maxOperationsPerAssignment;
     }
 
+    /**
+     * Whether or not the pointers to the arrays of variables (independents,
+     * dependents, and temporaries) are declared with the restrict qualifier.
+     *
+     * @return true if the pointers are restrict-qualified
+     */
+    inline bool isRestrictPointers() const {
+        return _restrictPointers;
+    }
+
+    /**
+     * Defines whether or not the pointers to the arrays of variables
+     * (independents, dependents, and temporaries) are declared with the
+     * restrict qualifier (C99).
+     * This allows compilers to vectorize more loops but the generated
+     * functions must not be called with overlapping input and output arrays.
+     *
+     * @param restrictPointers true to use restrict-qualified pointers
+     */
+    inline void setRestrictPointers(bool restrictPointers) {
+        _restrictPointers = restrictPointers;
+    }
+
+    /**
+     * Whether or not OpenMP simd pragmas are generated for loops without
+     * dependencies between iterations.
+     *
+     * @return true if OpenMP simd pragmas are generated
+     */
+    inline bool isSimdLoops() const {
+        return _simdLoops;
+    }
+
+    /**
+     * Defines whether or not OpenMP simd pragmas (#pragma omp simd) are
+     * generated for loops without dependencies between iterations.
+     * A loop only uses a pragma if each element of the dependent array is
+     * assigned in at most one iteration (e.g. linear index patterns) and if
+     * it does not contain atomic functions, conditional expressions, or
+     * nested loops.
+     * The temporary variables of those loops are declared inside the loop
+     * body so that each iteration has its own copy.
+     * The pragmas are ignored when the source is compiled without OpenMP
+     * support (e.g. -fopenmp-simd in GCC and Clang).
+     *
+     * @param simdLoops true to generate OpenMP simd pragmas
+     */
+    inline void setSimdLoops(bool simdLoops) {
+        _simdLoops = simdLoops;
+    }
+
+    /**
+     * Whether or not the atomic function called inside loops is evaluated
+     * once for all the iterations.
+     *
+     * @return true if atomic function calls are batched
+     */
+    inline bool isBatchAtomicLoops() const {
+        return _batchAtomicLoops;
+    }
+
+    /**
+     * Defines whether or not the atomic function called inside a loop is
+     * evaluated once for all the iterations (through the forwardBatch and
+     * reverseBatch pointers of LangCAtomicFun) instead of once per
+     * iteration.
+     * The loop is split in two: the first one collects the arguments of
+     * every iteration and the second one uses the results.
+     * Only loops with a known number of iterations, a single atomic
+     * function call, and without conditional expressions or nested loops
+     * are batched.
+     * Temporary variables determined before the call which are also used
+     * after it are evaluated again in the second loop.
+     *
+     * @param batchAtomicLoops true to batch the atomic function calls of loops
+     */
+    inline void setBatchAtomicLoops(bool batchAtomicLoops) {
+        _batchAtomicLoops = batchAtomicLoops;
+    }
+
+    /**
+     * Provides the maximum number of values stored in the buffers of a
+     * batched atomic function call.
+     */
+    inline size_t getMaxBatchAtomicValues() const {
+        return _maxBatchAtomicValues;
+    }
+
+    /**
+     * Defines the maximum number of values stored in the buffers of a
+     * batched atomic function call.
+     * The buffers are local arrays (on the stack) and, therefore, the
+     * iterations of loops requiring larger buffers are split into chunks
+     * with one atomic function call per chunk.
+     * At least one iteration is always included in a chunk.
+     *
+     * @param maxValues the maximum number of values in the buffers
+     */
+    inline void setMaxBatchAtomicValues(size_t maxValues) {
+        _maxBatchAtomicValues = maxValues;
+    }
+
+    /**
+     * Provides the atomic functions which are called directly by the
+     * generated source code.
+     *
+     * @return maps the names of atomic functions to the prefix of the C
+     *         functions which are called directly
+     */
+    inline const std::map<std::string, std::string>& getDirectAtomicFunctions() const {
+        return _directAtomicFunctions;
+    }
+
+    /**
+     * Defines atomic functions which are called directly by the generated
+     * source code instead of through the function pointers in the
+     * LangCAtomicFun structure.
+     * The atomic function with the name NAME is evaluated by calling
+     * PREFIX_forward(q, p, tx, &ty, atomicFun) and
+     * PREFIX_reverse(p, tx, &px, py, atomicFun), where PREFIX is the
+     * associated value, which must be defined when the generated source
+     * code is linked.
+     *
+     * @param directAtomicFunctions maps the names of atomic functions to
+     *                              the prefix of the C functions to call
+     */
+    inline void setDirectAtomicFunctions(const std::map<std::string, std::string>& directAtomicFunctions) {
+        _directAtomicFunctions = directAtomicFunctions;
+    }
+
     inline std::string generateTemporaryVariableDeclaration(bool isWrapperFunction,
                                                             bool zeroArrayDependents,
                                                             const std::vector<int>& atomicMaxForward,
@@ -675,6 +846,8 @@ protected:
         localFuncArgs_ = "";
         auxArrayName_ = "";
         _currentLoops.clear();
+        simdLoops_.clear();
+        batchAtomicLoops_.clear();
         _atomicFuncArrays.clear();
         _streamStack.clear();
 
@@ -803,6 +976,16 @@ protected:
                 }
             }
 
+            if (_simdLoops) {
+                // loops which can be vectorized (their temporary variables are renamed)
+                findSimdLoops(variableOrder);
+            }
+
+            if (_batchAtomicLoops) {
+                // loops whose atomic function is called once for all the iterations
+                findBatchAtomicLoops(variableOrder);
+            }
+
             /**
              * Source code generation magic!
              */
@@ -842,6 +1025,13 @@ protected:
                     // try to detect a pattern and use a loop instead of individual assignments
                     i = printLoopIndexDeps(variableOrder, i);
                     continue;
+                } else if (node.getOperationType() == CGOpCode::LoopStart) {
+                    auto itBatch = batchAtomicLoops_.find(&node);
+                    if (itBatch != batchAtomicLoops_.end()) {
+                        assignCount += printBatchAtomicLoop(variableOrder, i, itBatch->second);
+                        i = itBatch->second.end;
+                        continue;
+                    }
                 }
 
                 assignCount += printAssignment(node);
@@ -928,6 +1118,7 @@ protected:
                 _ss << "#include <math.h>\n"
                         "#include <stdio.h>\n\n"
                     << ATOMICFUN_STRUCT_DEFINITION << "\n\n";
+                printDirectAtomicFunctionDeclarations(_ss);
                 printFunctionDeclaration(_ss, "void", _functionName, funcArgDcl_);
                 _ss << " {\n";
                 _nameGen->customFunctionVariableDeclarations(_ss);
@@ -1039,10 +1230,37 @@ protected:
         std::string dcl = _baseTypeName;
         if (funcArg.array) {
             dcl += "*";
+            if (_restrictPointers)
+                dcl += " restrict";
         }
         return dcl + " " + funcArg.name;
     }
 
+    /**
+     * Prints the declarations of the C functions of the atomic functions
+     * which are called directly by the current function.
+     */
+    inline void printDirectAtomicFunctionDeclarations(std::ostream& out) {
+        if (_directAtomicFunctions.empty())
+            return;
+
+        std::set<std::string> prefixes;
+        for (const auto& it : _info->atomicFunctionId2Name) {
+            auto itDirect = _directAtomicFunctions.find(it.second);
+            if (itDirect != _directAtomicFunctions.end())
+                prefixes.insert(itDirect->second);
+        }
+
+        for (const std::string& prefix : prefixes) {
+            out << "int " << prefix << "_forward(int q, int p, const Array tx[], Array* ty, "
+                << generateArgumentAtomicDcl() << ");\n"
+                << "int " << prefix << "_reverse(int p, const Array tx[], Array* px, const Array py[], "
+                << generateArgumentAtomicDcl() << ");\n";
+        }
+        if (!prefixes.empty())
+            out << "\n";
+    }
+
     virtual void saveLocalFunction(std::vector<std::string>& localFuncNames,
                                    bool zeroDependentArray) {
         _ss << _functionName << "__" << (localFuncNames.size() + 1);
@@ -1052,6 +1270,7 @@ protected:
         _ss << "#include <math.h>\n"
                 "#include <stdio.h>\n\n"
                 << ATOMICFUN_STRUCT_DEFINITION << "\n\n";
+        printDirectAtomicFunctionDeclarations(_ss);
         printFunctionDeclaration(_ss, "void", funcName, localFuncArgDcl_);
         _ss << " {\n";
         _nameGen->customFunctionVariableDeclarations(_ss);
@@ -1812,11 +2031,21 @@ protected:
         printArrayStructInit(_ATOMIC_TY, *ty[p]); // also does indentation
         _ss.str("");
 
-        _streamStack << _indentation << "atomicFun.forward(atomicFun.libModel, "
-                     << atomicIndex << ", " << q << ", " << p << ", "
-                     << _ATOMIC_TX << ", &" << _ATOMIC_TY << "); // "
-                     << _info->atomicFunctionId2Name.at(id)
-                     << "\n";
+        const std::string& atomicName = _info->atomicFunctionId2Name.at(id);
+        auto itDirect = _directAtomicFunctions.find(atomicName);
+        if (itDirect != _directAtomicFunctions.end()) {
+            _streamStack << _indentation << itDirect->second << "_forward("
+                         << q << ", " << p << ", "
+                         << _ATOMIC_TX << ", &" << _ATOMIC_TY << ", " << _atomicArgName << "); // "
+                         << atomicName
+                         << "\n";
+        } else {
+            _streamStack << _indentation << "atomicFun.forward(atomicFun.libModel, "
+                         << atomicIndex << ", " << q << ", " << p << ", "
+                         << _ATOMIC_TX << ", &" << _ATOMIC_TY << "); // "
+                         << atomicName
+                         << "\n";
+        }
 
         /**
          * the values of ty are now changed
@@ -1860,11 +2089,21 @@ protected:
         printArrayStructInit(_ATOMIC_PX, *px[0]); // also does indentation
         _ss.str("");
 
-        _streamStack << _indentation << "atomicFun.reverse(atomicFun.libModel, "
-                     << atomicIndex << ", " << p << ", "
-                     << _ATOMIC_TX << ", &" << _ATOMIC_PX << ", " << _ATOMIC_PY << "); // "
-                     << _info->atomicFunctionId2Name.at(id)
-                     << "\n";
+        const std::string& atomicName = _info->atomicFunctionId2Name.at(id);
+        auto itDirect = _directAtomicFunctions.find(atomicName);
+        if (itDirect != _directAtomicFunctions.end()) {
+            _streamStack << _indentation << itDirect->second << "_reverse("
+                         << p << ", "
+                         << _ATOMIC_TX << ", &" << _ATOMIC_PX << ", " << _ATOMIC_PY << ", " << _atomicArgName << "); // "
+                         << atomicName
+                         << "\n";
+        } else {
+            _streamStack << _indentation << "atomicFun.reverse(atomicFun.libModel, "
+                         << atomicIndex << ", " << p << ", "
+                         << _ATOMIC_TX << ", &" << _ATOMIC_PX << ", " << _ATOMIC_PY << "); // "
+                         << atomicName
+                         << "\n";
+        }
 
         /**
          * the values of px are now changed
@@ -1911,11 +2150,31 @@ protected:
             iterationCount = oss.str();
         }
 
+        auto itSimd = simdLoops_.find(&lnode);
+        if (itSimd != simdLoops_.end()) {
+            _streamStack << _spaces << "#pragma omp simd";
+            const std::vector<const Node*>& indexes = itSimd->second.indexes;
+            if (!indexes.empty()) {
+                _streamStack << " private(";
+                for (size_t i = 0; i < indexes.size(); ++i) {
+                    if (i > 0) _streamStack << ", ";
+                    _streamStack << *indexes[i]->getName();
+                }
+                _streamStack << ")";
+            }
+            _streamStack << "\n";
+        }
+
         _streamStack << _spaces << "for("
                      << jj << " = 0; "
                      << jj << " < " << iterationCount << "; "
                      << jj << "++) {\n";
         _indentation += _spaces;
+
+        if (itSimd != simdLoops_.end() && !itSimd->second.temporaries.empty()) {
+            // temporary variables private to each iteration
+            _streamStack << _indentation << _baseTypeName << " " << implode(itSimd->second.temporaries, ", ") << ";\n";
+        }
     }
 
     virtual void pushLoopEnd(Node& node) {
@@ -1932,6 +2191,25 @@ protected:
     virtual size_t printLoopIndexDeps(const std::vector<Node*>& variableOrder,
                                       size_t pos);
 
+    virtual void findSimdLoops(const std::vector<Node*>& variableOrder);
+
+    virtual void findBatchAtomicLoops(const std::vector<Node*>& variableOrder);
+
+    virtual unsigned printBatchAtomicLoop(const std::vector<Node*>& variableOrder,
+                                          size_t pos,
+                                          const BatchAtomicLoop& loop);
+
+    inline unsigned printLoopBody(const std::vector<Node*>& variableOrder,
+                                  size_t start,
+                                  size_t end);
+
+    virtual bool isSimdLoopDependents(const LoopStartOperationNode<Base>& loopStart,
+                                      const std::vector<const Node*>& dependents) const;
+
+    static inline bool evaluateIndexPattern(const IndexPattern& ip,
+                                            size_t x,
+                                            long& y);
+
     virtual size_t printLoopIndexedDepsUsingLoop(const std::vector<Node*>& variableOrder,
                                                  size_t starti);
 
@@ -2248,6 +2526,20 @@ const std::string LanguageC<Base>::ATOMICFUN_STRUCT_DEFINITION = // NOLINT(cert-
 "                   const Array tx[],\n"
 "                   Array* px,\n"
 "                   const Array py[]);\n"
+"    int (*forwardBatch)(void* libModel,\n"
+"                        int atomicIndex,\n"
+"                        int q,\n"
+"                        int p,\n"
+"                        " + U_INDEX_TYPE + " nBatch,\n"
+"                        const Array tx[],\n"
+"                        Array* ty);\n"
+"    int (*reverseBatch)(void* libModel,\n"
+"                        int atomicIndex,\n"
+"                        int p,\n"
+"                        " + U_INDEX_TYPE + " nBatch,\n"
+"                        const Array tx[],\n"
+"                        Array* px,\n"
+"                        const Array py[]);\n"
 "};";
 
 } // END cg namespace
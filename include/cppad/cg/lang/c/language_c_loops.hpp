@@ -173,6 +173,565 @@ inline size_t LanguageC<Base>::printLoopIndexedDepsUsingLoop(const std::vector<O
 }
 
 
+template<class Base>
+void LanguageC<Base>::findSimdLoops(const std::vector<OperationNode<Base>*>& variableOrder) {
+    const size_t vSize = variableOrder.size();
+
+    /**
+     * loop candidates
+     */
+    struct Candidate {
+        const Node* loopStart;
+        size_t start;
+        size_t end;
+        std::vector<Node*> temporaries;
+        std::vector<const Node*> indexes;
+        bool valid;
+    };
+    std::vector<Candidate> candidates;
+
+    for (size_t i = 0; i < vSize; ++i) {
+        if (variableOrder[i]->getOperationType() != CGOpCode::LoopStart)
+            continue;
+
+        const auto& loopStart = static_cast<const LoopStartOperationNode<Base>&> (*variableOrder[i]);
+
+        Candidate c{&loopStart, i, vSize, {}, {}, true};
+        std::vector<const Node*> dependents;
+
+        for (size_t p = i + 1; p < vSize && c.valid; ++p) {
+            Node& node = *variableOrder[p];
+            CGOpCode op = node.getOperationType();
+
+            if (op == CGOpCode::LoopEnd) {
+                c.end = p;
+                break;
+            }
+
+            switch (op) {
+                case CGOpCode::LoopStart: // nested loops
+                case CGOpCode::AtomicForward:
+                case CGOpCode::AtomicReverse:
+                case CGOpCode::ArrayCreation:
+                case CGOpCode::SparseArrayCreation:
+                case CGOpCode::ArrayElement:
+                case CGOpCode::StartIf:
+                case CGOpCode::ElseIf:
+                case CGOpCode::Else:
+                case CGOpCode::EndIf:
+                case CGOpCode::CondResult:
+                case CGOpCode::IndexCondExpr:
+                case CGOpCode::LoopIndexedTmp: // values carried between iterations
+                case CGOpCode::Tmp:
+                case CGOpCode::TmpDcl:
+                case CGOpCode::Pri:
+                case CGOpCode::DependentMultiAssign:
+                case CGOpCode::DependentRefRhs:
+                    c.valid = false;
+                    break;
+                case CGOpCode::LoopIndexedDep:
+                    dependents.push_back(&node);
+                    break;
+                case CGOpCode::IndexAssign:
+                    c.indexes.push_back(&static_cast<IndexAssignOperationNode<Base>&> (node).getIndex());
+                    break;
+                default:
+                    if (!isDependent(node) && requiresVariableName(node)) {
+                        c.temporaries.push_back(&node);
+                    }
+            }
+        }
+
+        if (!c.valid || c.end == vSize || !isSimdLoopDependents(loopStart, dependents))
+            continue; // nested loops are still checked
+
+        candidates.push_back(std::move(c));
+        i = candidates.back().end;
+    }
+
+    if (candidates.empty())
+        return;
+
+    /**
+     * temporary variables used outside their loop cannot be private to
+     * each iteration
+     */
+    std::vector<size_t> owner(vSize, candidates.size()); // the candidate containing each position
+    std::unordered_map<const Node*, size_t> tmp2Candidate;
+    for (size_t l = 0; l < candidates.size(); ++l) {
+        for (size_t p = candidates[l].start; p <= candidates[l].end; ++p)
+            owner[p] = l;
+        for (const Node* t : candidates[l].temporaries)
+            tmp2Candidate[t] = l;
+    }
+
+    std::unordered_set<const Node*> assigned(variableOrder.begin(), variableOrder.end());
+
+    std::vector<const Node*> stack;
+    for (size_t p = 0; p < vSize; ++p) {
+        const Node* node = variableOrder[p];
+        if (node->getOperationType() == CGOpCode::LoopEnd)
+            continue;
+
+        // visit the arguments of this assignment which are printed in the same expression
+        stack.clear();
+        stack.push_back(node);
+        while (!stack.empty()) {
+            const Node* n = stack.back();
+            stack.pop_back();
+            for (const Arg& a : n->getArguments()) {
+                const Node* arg = a.getOperation();
+                if (arg == nullptr)
+                    continue;
+
+                auto it = tmp2Candidate.find(arg);
+                if (it != tmp2Candidate.end()) {
+                    if (owner[p] != it->second)
+                        candidates[it->second].valid = false;
+                } else if (assigned.find(arg) == assigned.end()) {
+                    stack.push_back(arg);
+                }
+            }
+        }
+    }
+
+    /**
+     * rename the temporary variables of the vectorized loops
+     */
+    const std::string& tmpName = _nameGen->getTemporary()[0].name;
+
+    for (Candidate& c : candidates) {
+        if (!c.valid)
+            continue;
+
+        SimdLoop& loop = simdLoops_[c.loopStart];
+        loop.indexes = std::move(c.indexes);
+
+        std::set<size_t> ids;
+        for (Node* t : c.temporaries) {
+            size_t id = getVariableID(*t);
+            std::string name = tmpName + "_" + std::to_string(id);
+            if (ids.insert(id).second)
+                loop.temporaries.push_back(name);
+            t->setName(name);
+        }
+    }
+}
+
+template<class Base>
+bool LanguageC<Base>::isSimdLoopDependents(const LoopStartOperationNode<Base>& loopStart,
+                                           const std::vector<const OperationNode<Base>*>& dependents) const {
+    for (const OperationNode<Base>* dep : dependents) {
+        // the dependents must only be indexed by the loop index
+        const std::vector<Argument<Base> >& args = dep->getArguments();
+        if (args.size() != 2 || args[1].getOperation() == nullptr || args[1].getOperation()->getOperationType() != CGOpCode::Index)
+            return false;
+
+        const auto& index = static_cast<const IndexOperationNode<Base>&> (*args[1].getOperation());
+        if (&index.getIndex() != &loopStart.getIndex())
+            return false;
+    }
+
+    /**
+     * each dependent element can only be assigned by one iteration
+     */
+    if (loopStart.getIterationCountNode() == nullptr) {
+        size_t iterations = loopStart.getIterationCount();
+        std::map<long, size_t> element2Iteration;
+
+        for (const OperationNode<Base>* dep : dependents) {
+            const IndexPattern& ip = *_info->loopDependentIndexPatterns[dep->getInfo()[0]];
+            for (size_t j = 0; j < iterations; ++j) {
+                long e;
+                if (!evaluateIndexPattern(ip, j, e))
+                    return false;
+                auto added = element2Iteration.emplace(e, j);
+                if (!added.second && added.first->second != j)
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    // unknown number of iterations: only linear patterns with the same slope
+    long dy = 0;
+    std::set<long> constants;
+    for (const OperationNode<Base>* dep : dependents) {
+        const IndexPattern* ip = _info->loopDependentIndexPatterns[dep->getInfo()[0]];
+        if (ip->getType() != IndexPatternType::Linear)
+            return false;
+
+        const auto& lip = static_cast<const LinearIndexPattern&> (*ip);
+        if (lip.getLinearSlopeDx() != 1 || lip.getLinearSlopeDy() == 0)
+            return false;
+        if (dy == 0)
+            dy = lip.getLinearSlopeDy();
+        else if (dy != lip.getLinearSlopeDy())
+            return false;
+
+        constants.insert(lip.getLinearConstantTerm() - dy * lip.getXOffset());
+    }
+
+    const long step = std::abs(dy);
+    std::set<long> remainders;
+    for (long c : constants) {
+        long r = ((c % step) + step) % step;
+        if (!remainders.insert(r).second)
+            return false; // different dependents assign the same elements in different iterations
+    }
+
+    return true;
+}
+
+template<class Base>
+void LanguageC<Base>::findBatchAtomicLoops(const std::vector<OperationNode<Base>*>& variableOrder) {
+    const size_t vSize = variableOrder.size();
+
+    std::unordered_set<const Node*> assigned(variableOrder.begin(), variableOrder.end());
+
+    for (size_t i = 0; i < vSize; ++i) {
+        if (variableOrder[i]->getOperationType() != CGOpCode::LoopStart)
+            continue;
+
+        const auto& loopStart = static_cast<const LoopStartOperationNode<Base>&> (*variableOrder[i]);
+        if (loopStart.getIterationCountNode() != nullptr || simdLoops_.find(&loopStart) != simdLoops_.end())
+            continue; // the size of the buffers must be known
+
+        BatchAtomicLoop loop{vSize, vSize, {}};
+        bool valid = true;
+
+        for (size_t p = i + 1; p < vSize && valid; ++p) {
+            CGOpCode op = variableOrder[p]->getOperationType();
+
+            if (op == CGOpCode::LoopEnd) {
+                loop.end = p;
+                break;
+            }
+
+            switch (op) {
+                case CGOpCode::AtomicForward:
+                case CGOpCode::AtomicReverse:
+                    valid = loop.atomic == vSize; // a single call
+                    loop.atomic = p;
+                    break;
+                case CGOpCode::LoopStart: // nested loops
+                case CGOpCode::StartIf:
+                case CGOpCode::ElseIf:
+                case CGOpCode::Else:
+                case CGOpCode::EndIf:
+                case CGOpCode::CondResult:
+                case CGOpCode::IndexCondExpr:
+                case CGOpCode::LoopIndexedTmp: // values carried between iterations
+                case CGOpCode::Tmp:
+                case CGOpCode::TmpDcl:
+                case CGOpCode::Pri:
+                case CGOpCode::DependentMultiAssign:
+                case CGOpCode::DependentRefRhs:
+                    valid = false;
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        if (!valid || loop.end == vSize || loop.atomic == vSize)
+            continue; // nested loops are still checked
+
+        const Node& atomic = *variableOrder[loop.atomic];
+        const std::string& atomicName = _info->atomicFunctionId2Name.at(atomic.getInfo()[0]);
+        if (_directAtomicFunctions.find(atomicName) != _directAtomicFunctions.end())
+            continue; // no function pointer is used
+
+        // the array with the results of the atomic function
+        const Node* out;
+        if (atomic.getOperationType() == CGOpCode::AtomicForward) {
+            size_t p1 = atomic.getInfo()[2] + 1;
+            out = atomic.getArguments()[p1 + p1 - 1].getOperation();
+        } else {
+            size_t p1 = atomic.getInfo()[1] + 1;
+            out = atomic.getArguments()[2 * p1].getOperation();
+        }
+
+        /**
+         * the variables assigned before the call which are used after it
+         * must be determined again in the second loop
+         */
+        std::unordered_map<const Node*, size_t> before;
+        for (size_t p = i + 1; p < loop.atomic; ++p)
+            before[variableOrder[p]] = p;
+
+        std::set<size_t> recompute;
+        std::unordered_set<const Node*> visited;
+        std::vector<const Node*> stack(variableOrder.begin() + loop.atomic + 1, variableOrder.begin() + loop.end);
+
+        while (!stack.empty() && valid) {
+            const Node* n = stack.back();
+            stack.pop_back();
+            for (const Arg& a : n->getArguments()) {
+                const Node* arg = a.getOperation();
+                if (arg == nullptr || arg == out || arg == &atomic || !visited.insert(arg).second)
+                    continue;
+
+                auto it = before.find(arg);
+                if (it != before.end()) {
+                    CGOpCode op = arg->getOperationType();
+                    if (op == CGOpCode::ArrayCreation || op == CGOpCode::SparseArrayCreation ||
+                            op == CGOpCode::LoopIndexedDep || isDependent(*arg)) {
+                        valid = false; // cannot be repeated
+                        break;
+                    }
+                    recompute.insert(it->second);
+                    stack.push_back(arg);
+                } else if (assigned.find(arg) == assigned.end()) {
+                    stack.push_back(arg);
+                }
+            }
+        }
+
+        if (!valid)
+            continue;
+
+        // the indexes are always assigned again
+        for (size_t p = i + 1; p < loop.atomic; ++p) {
+            if (variableOrder[p]->getOperationType() == CGOpCode::IndexAssign)
+                recompute.insert(p);
+        }
+        loop.recompute.assign(recompute.begin(), recompute.end());
+
+        i = loop.end;
+        batchAtomicLoops_[&loopStart] = std::move(loop);
+    }
+}
+
+template<class Base>
+unsigned LanguageC<Base>::printBatchAtomicLoop(const std::vector<OperationNode<Base>*>& variableOrder,
+                                               size_t pos,
+                                               const BatchAtomicLoop& loop) {
+    auto& loopStart = static_cast<LoopStartOperationNode<Base>&> (*variableOrder[pos]);
+    Node& loopEnd = *variableOrder[loop.end];
+    Node& atomic = *variableOrder[loop.atomic];
+
+    const std::string& jj = *loopStart.getIndex().getName();
+    const size_t nBatch = loopStart.getIterationCount();
+
+    const bool forward = atomic.getOperationType() == CGOpCode::AtomicForward;
+    const size_t id = atomic.getInfo()[0];
+    const size_t atomicIndex = _info->atomicFunctionId2Index.at(id);
+    const std::string& atomicName = _info->atomicFunctionId2Name.at(id);
+    const int p = forward ? atomic.getInfo()[2] : atomic.getInfo()[1];
+    const size_t p1 = p + 1;
+    const std::vector<Arg>& opArgs = atomic.getArguments();
+
+    /**
+     * the arrays used by the atomic function (the last one is the output)
+     */
+    std::vector<Node*> arrays;
+    std::vector<std::string> structNames;
+    for (size_t k = 0; k < p1; k++) {
+        arrays.push_back(opArgs[k].getOperation());
+        structNames.push_back(_ATOMIC_TX + "[" + std::to_string(k) + "]");
+    }
+    if (forward) {
+        arrays.push_back(opArgs[p1 + p].getOperation());
+        structNames.push_back(_ATOMIC_TY);
+    } else {
+        for (size_t k = 0; k < p1; k++) {
+            arrays.push_back(opArgs[3 * p1 + k].getOperation());
+            structNames.push_back(_ATOMIC_PY + "[" + std::to_string(k) + "]");
+        }
+        arrays.push_back(opArgs[2 * p1].getOperation());
+        structNames.push_back(_ATOMIC_PX);
+    }
+    Node& out = *arrays.back();
+
+    /**
+     * the buffers are limited in size: the iterations are split into chunks
+     * with an atomic function call per chunk
+     */
+    size_t iterValues = 0;
+    for (const Node* array : arrays)
+        iterValues += array->getArguments().size();
+
+    size_t nChunk = nBatch;
+    if (iterValues * nBatch > _maxBatchAtomicValues) {
+        nChunk = std::max<size_t>(1, _maxBatchAtomicValues / iterValues);
+    }
+    const bool chunked = nChunk < nBatch;
+
+    // buffers with the values of the iterations in a chunk
+    std::vector<std::string> buffers(arrays.size());
+    std::string indentation2 = _indentation + _spaces;
+
+    _streamStack << _indentation << "{\n";
+    if (chunked) {
+        _streamStack << indentation2 << "// " << atomicName << " called once for every " << nChunk
+                     << " of " << nBatch << " iterations\n";
+    } else {
+        _streamStack << indentation2 << "// " << atomicName << " called once for " << nBatch << " iterations\n";
+    }
+    for (size_t a = 0; a < arrays.size(); a++) {
+        size_t values = arrays[a]->getArguments().size();
+        if (values > 0) {
+            buffers[a] = "batch" + std::to_string(a);
+            _streamStack << indentation2 << _baseTypeName << " " << buffers[a] << "[" << nChunk * values << "];\n";
+        }
+    }
+
+    std::string batchCount = std::to_string(nBatch);
+    std::string iteration = jj;
+    const std::string loopIndentation = _indentation;
+    if (chunked) {
+        batchCount = "batchCount";
+        iteration = "(" + jj + " - batchStart)";
+        _streamStack << indentation2 << U_INDEX_TYPE << " batchStart, batchCount;\n"
+                     << indentation2 << "for(batchStart = 0; batchStart < " << nBatch << "; batchStart += " << nChunk << ") {\n";
+        indentation2 += _spaces;
+        _indentation = indentation2;
+        _streamStack << indentation2 << "batchCount = " << nBatch << " - batchStart < " << nChunk
+                     << " ? " << nBatch << " - batchStart : " << nChunk << ";\n";
+    }
+
+    // the loop over the iterations (of a chunk)
+    auto printBatchLoopStart = [&]() -> unsigned {
+        if (!chunked)
+            return printAssignment(loopStart);
+
+        _currentLoops.push_back(&loopStart);
+        _streamStack << _indentation << "for(" << jj << " = batchStart; " << jj << " < batchStart + batchCount; "
+                     << jj << "++) {\n";
+        _indentation += _spaces;
+        return 1;
+    };
+
+    /**
+     * collect the arguments of all iterations
+     */
+    unsigned count = printBatchLoopStart();
+    count += printLoopBody(variableOrder, pos + 1, loop.atomic);
+    for (size_t a = 0; a < arrays.size(); a++) {
+        size_t values = arrays[a]->getArguments().size();
+        if (values > 0) {
+            _streamStack << _indentation << "for(i = 0; i < " << values << "; i++) "
+                         << buffers[a] << "[" << iteration << " * " << values << " + i] = ("
+                         << createVariableName(*arrays[a]) << ")[i];\n";
+        }
+    }
+    markArrayChanged(out);
+    count += printAssignment(loopEnd);
+
+    /**
+     * evaluate the atomic function
+     */
+    for (size_t a = 0; a < arrays.size(); a++) {
+        const Node& array = *arrays[a];
+        const std::string& name = structNames[a];
+        bool sparse = array.getOperationType() == CGOpCode::SparseArrayCreation;
+        size_t values = array.getArguments().size();
+
+        _streamStack << indentation2 << name << ".data = " << (values > 0 ? buffers[a] : "NULL") << "; "
+                     << name << ".size = " << (sparse ? array.getInfo()[0] : values) << "; "
+                     << name << ".sparse = " << sparse << ";";
+        if (sparse) {
+            _streamStack << " " << name << ".nnz = " << values << ";";
+            if (values > 0)
+                _streamStack << " " << name << ".idx = &(" << _C_SPARSE_INDEX_ARRAY << "[" << (getVariableID(array) - 1) << "]);";
+        }
+        _streamStack << "\n";
+
+        _atomicFuncArrays.erase(name); // no longer matches the values of the original arrays
+    }
+
+    if (forward) {
+        _streamStack << indentation2 << "atomicFun.forwardBatch(atomicFun.libModel, "
+                     << atomicIndex << ", " << atomic.getInfo()[1] << ", " << p << ", " << batchCount << ", "
+                     << _ATOMIC_TX << ", &" << _ATOMIC_TY << "); // "
+                     << atomicName
+                     << "\n";
+    } else {
+        _streamStack << indentation2 << "atomicFun.reverseBatch(atomicFun.libModel, "
+                     << atomicIndex << ", " << p << ", " << batchCount << ", "
+                     << _ATOMIC_TX << ", &" << _ATOMIC_PX << ", " << _ATOMIC_PY << "); // "
+                     << atomicName
+                     << "\n";
+    }
+
+    /**
+     * use the results in each iteration
+     */
+    count += printBatchLoopStart();
+    for (size_t r : loop.recompute) {
+        count += printAssignment(*variableOrder[r]);
+    }
+    size_t outSize = out.getArguments().size();
+    if (outSize > 0) {
+        _streamStack << _indentation << "for(i = 0; i < " << outSize << "; i++) ("
+                     << createVariableName(out) << ")[i] = "
+                     << buffers.back() << "[" << iteration << " * " << outSize << " + i];\n";
+    }
+    count += printLoopBody(variableOrder, loop.atomic + 1, loop.end);
+    count += printAssignment(loopEnd);
+
+    if (chunked) {
+        _indentation = loopIndentation;
+        _streamStack << _indentation << _spaces << "}\n";
+    }
+    _streamStack << _indentation << "}\n";
+
+    return count;
+}
+
+template<class Base>
+inline unsigned LanguageC<Base>::printLoopBody(const std::vector<OperationNode<Base>*>& variableOrder,
+                                               size_t start,
+                                               size_t end) {
+    unsigned count = 0;
+    for (size_t i = start; i < end; ++i) {
+        Node& node = *variableOrder[i];
+        if (node.getOperationType() == CGOpCode::LoopIndexedDep) {
+            i = printLoopIndexDeps(variableOrder, i);
+        } else {
+            count += printAssignment(node);
+        }
+    }
+    return count;
+}
+
+template<class Base>
+inline bool LanguageC<Base>::evaluateIndexPattern(const IndexPattern& ip,
+                                                  size_t x,
+                                                  long& y) {
+    switch (ip.getType()) {
+        case IndexPatternType::Linear:
+            y = static_cast<const LinearIndexPattern&> (ip).evaluate(long(x));
+            return true;
+
+        case IndexPatternType::Sectioned:
+        {
+            const auto& sections = static_cast<const SectionedIndexPattern&> (ip).getLinearSections();
+            auto it = sections.upper_bound(x);
+            if (it == sections.begin())
+                return false;
+            --it;
+            return evaluateIndexPattern(*it->second, x, y);
+        }
+
+        case IndexPatternType::Random1D:
+        {
+            const auto& values = static_cast<const Random1DIndexPattern&> (ip).getValues();
+            auto it = values.find(x);
+            if (it == values.end())
+                return false;
+            y = long(it->second);
+            return true;
+        }
+
+        default:
+            return false; // unsupported
+    }
+}
+
+
 } // END cg namespace
 } // END CppAD namespace
 
@@ -0,0 +1,287 @@
+#ifndef CPPAD_CG_ATOMIC_ARRAY_FUNCTION_INCLUDED
+#define CPPAD_CG_ATOMIC_ARRAY_FUNCTION_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * An interface which can be implemented by atomic functions (together with
+ * atomic_base) so that compiled models provide them the values of their
+ * arrays directly, instead of converting them into vectors of Taylor
+ * coefficients for atomic_base::forward() and atomic_base::reverse().
+ *
+ * These methods are only used for the evaluation of compiled models and
+ * they correspond to the orders used by the generated source code.
+ * The results must be assigned (not added) to the output arrays.
+ *
+ * @author Joao Leal
+ */
+template<class Base>
+class AtomicArrayFunction {
+public:
+
+    inline virtual ~AtomicArrayFunction() = default;
+
+    /**
+     * Evaluates the dependent variables (zero order forward mode).
+     *
+     * @param x independent variable vector
+     * @param y dependent variable vector
+     * @return true if the evaluation succeeded
+     */
+    virtual bool forwardZero(ArrayView<const Base> x,
+                             ArrayView<Base> y) = 0;
+
+    /**
+     * Determines the first-order Taylor coefficients of the dependent
+     * variables (first order forward mode).
+     *
+     * @param x independent variable vector
+     * @param tx1 first-order Taylor coefficients of the independents
+     * @param ty1 first-order Taylor coefficients of the dependents
+     * @return true if the evaluation succeeded
+     */
+    virtual bool forwardOne(ArrayView<const Base> x,
+                            ArrayView<const Base> tx1,
+                            ArrayView<Base> ty1) = 0;
+
+    /**
+     * Determines the partial derivatives of the independent variables
+     * (first order reverse mode).
+     *
+     * @param x independent variable vector
+     * @param px partial derivatives of the independents
+     * @param py partial derivatives of the dependents
+     * @return true if the evaluation succeeded
+     */
+    virtual bool reverseOne(ArrayView<const Base> x,
+                            ArrayView<Base> px,
+                            ArrayView<const Base> py) = 0;
+
+    /**
+     * Determines the second-order partial derivatives of the independent
+     * variables (second order reverse mode) when the first-order partials
+     * of the dependents are zero.
+     *
+     * @param x independent variable vector
+     * @param tx1 first-order Taylor coefficients of the independents
+     * @param px2 second-order partials of the independents
+     * @param py2 second-order partials of the dependents
+     * @return true if the evaluation succeeded
+     */
+    virtual bool reverseTwo(ArrayView<const Base> x,
+                            ArrayView<const Base> tx1,
+                            ArrayView<Base> px2,
+                            ArrayView<const Base> py2) = 0;
+};
+
+/**
+ * An AtomicArrayFunction which also accepts the sparse arrays used by the
+ * generated source code, which avoids their expansion into dense arrays.
+ *
+ * @author Joao Leal
+ */
+template<class Base>
+class AtomicSparseArrayFunction : public AtomicArrayFunction<Base> {
+public:
+    using AtomicArrayFunction<Base>::forwardOne;
+    using AtomicArrayFunction<Base>::reverseOne;
+    using AtomicArrayFunction<Base>::reverseTwo;
+
+    inline virtual ~AtomicSparseArrayFunction() = default;
+
+    /**
+     * Determines the first-order Taylor coefficients of the dependent
+     * variables (first order forward mode).
+     *
+     * @param x independent variable vector
+     * @param tx1Nnz the number of non-zeros of the first-order Taylor
+     *               coefficients of the independents
+     * @param idx the locations of the non-zero first-order Taylor
+     *            coefficients of the independents
+     * @param tx1 the non-zero first-order Taylor coefficients of the
+     *            independents
+     * @param ty1 first-order Taylor coefficients of the dependents
+     * @return true if the evaluation succeeded
+     */
+    virtual bool forwardOne(ArrayView<const Base> x,
+                            size_t tx1Nnz, const size_t idx[], const Base tx1[],
+                            ArrayView<Base> ty1) = 0;
+
+    /**
+     * Determines the partial derivatives of the independent variables
+     * (first order reverse mode).
+     *
+     * @param x independent variable vector
+     * @param px partial derivatives of the independents
+     * @param pyNnz the number of non-zeros of the partial derivatives of
+     *              the dependents
+     * @param idx the locations of the non-zero partial derivatives of the
+     *            dependents
+     * @param py the non-zero partial derivatives of the dependents
+     * @return true if the evaluation succeeded
+     */
+    virtual bool reverseOne(ArrayView<const Base> x,
+                            ArrayView<Base> px,
+                            size_t pyNnz, const size_t idx[], const Base py[]) = 0;
+
+    /**
+     * Determines the second-order partial derivatives of the independent
+     * variables (second order reverse mode) when the first-order partials
+     * of the dependents are zero.
+     *
+     * @param x independent variable vector
+     * @param tx1Nnz the number of non-zeros of the first-order Taylor
+     *               coefficients of the independents
+     * @param idx the locations of the non-zero first-order Taylor
+     *            coefficients of the independents
+     * @param tx1 the non-zero first-order Taylor coefficients of the
+     *            independents
+     * @param px2 second-order partials of the independents
+     * @param py2 second-order partials of the dependents
+     * @return true if the evaluation succeeded
+     */
+    virtual bool reverseTwo(ArrayView<const Base> x,
+                            size_t tx1Nnz, const size_t idx[], const Base tx1[],
+                            ArrayView<Base> px2,
+                            ArrayView<const Base> py2) = 0;
+};
+
+/**
+ * An AtomicArrayFunction which can also be evaluated for several sets of
+ * arguments at once, which is used by the generated source code for loops
+ * calling atomic functions (see LanguageC::setBatchAtomicLoops()).
+ * Each array holds nBatch consecutive blocks of values (e.g. x holds nBatch
+ * independent variable vectors).
+ * The default implementations evaluate each block individually and should
+ * be overridden by atomic functions which can take advantage of processing
+ * several blocks simultaneously (SIMD, BLAS, ...).
+ *
+ * @author Joao Leal
+ */
+template<class Base>
+class AtomicBatchArrayFunction : public AtomicArrayFunction<Base> {
+public:
+
+    inline virtual ~AtomicBatchArrayFunction() = default;
+
+    /**
+     * Evaluates the dependent variables (zero order forward mode) of
+     * several independent variable vectors.
+     *
+     * @param nBatch the number of blocks
+     * @param x nBatch independent variable vectors
+     * @param y nBatch dependent variable vectors
+     * @return true if the evaluation succeeded
+     */
+    virtual bool forwardZeroBatch(size_t nBatch,
+                                  ArrayView<const Base> x,
+                                  ArrayView<Base> y) {
+        size_t n = x.size() / nBatch;
+        size_t m = y.size() / nBatch;
+        for (size_t b = 0; b < nBatch; b++) {
+            if (!this->forwardZero(x.segment(b * n, n),
+                                   y.segment(b * m, m)))
+                return false;
+        }
+        return true;
+    }
+
+    /**
+     * Determines the first-order Taylor coefficients of the dependent
+     * variables (first order forward mode) of several blocks.
+     *
+     * @param nBatch the number of blocks
+     * @param x nBatch independent variable vectors
+     * @param tx1 nBatch first-order Taylor coefficients of the independents
+     * @param ty1 nBatch first-order Taylor coefficients of the dependents
+     * @return true if the evaluation succeeded
+     */
+    virtual bool forwardOneBatch(size_t nBatch,
+                                 ArrayView<const Base> x,
+                                 ArrayView<const Base> tx1,
+                                 ArrayView<Base> ty1) {
+        size_t n = x.size() / nBatch;
+        size_t m = ty1.size() / nBatch;
+        for (size_t b = 0; b < nBatch; b++) {
+            if (!this->forwardOne(x.segment(b * n, n),
+                                  tx1.segment(b * n, n),
+                                  ty1.segment(b * m, m)))
+                return false;
+        }
+        return true;
+    }
+
+    /**
+     * Determines the partial derivatives of the independent variables
+     * (first order reverse mode) of several blocks.
+     *
+     * @param nBatch the number of blocks
+     * @param x nBatch independent variable vectors
+     * @param px nBatch partial derivatives of the independents
+     * @param py nBatch partial derivatives of the dependents
+     * @return true if the evaluation succeeded
+     */
+    virtual bool reverseOneBatch(size_t nBatch,
+                                 ArrayView<const Base> x,
+                                 ArrayView<Base> px,
+                                 ArrayView<const Base> py) {
+        size_t n = x.size() / nBatch;
+        size_t m = py.size() / nBatch;
+        for (size_t b = 0; b < nBatch; b++) {
+            if (!this->reverseOne(x.segment(b * n, n),
+                                  px.segment(b * n, n),
+                                  py.segment(b * m, m)))
+                return false;
+        }
+        return true;
+    }
+
+    /**
+     * Determines the second-order partial derivatives of the independent
+     * variables (second order reverse mode) of several blocks when the
+     * first-order partials of the dependents are zero.
+     *
+     * @param nBatch the number of blocks
+     * @param x nBatch independent variable vectors
+     * @param tx1 nBatch first-order Taylor coefficients of the independents
+     * @param px2 nBatch second-order partials of the independents
+     * @param py2 nBatch second-order partials of the dependents
+     * @return true if the evaluation succeeded
+     */
+    virtual bool reverseTwoBatch(size_t nBatch,
+                                 ArrayView<const Base> x,
+                                 ArrayView<const Base> tx1,
+                                 ArrayView<Base> px2,
+                                 ArrayView<const Base> py2) {
+        size_t n = x.size() / nBatch;
+        size_t m = py2.size() / nBatch;
+        for (size_t b = 0; b < nBatch; b++) {
+            if (!this->reverseTwo(x.segment(b * n, n),
+                                  tx1.segment(b * n, n),
+                                  px2.segment(b * n, n),
+                                  py2.segment(b * m, m)))
+                return false;
+        }
+        return true;
+    }
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
@@ -19,80 +19,230 @@
 namespace CppAD {
 namespace cg {
 
+/**
+ * Calls an atomic function from a compiled model.
+ * Atomic functions which also implement AtomicArrayFunction (or
+ * AtomicSparseArrayFunction) receive the arrays of the compiled model
+ * directly, otherwise the arrays are converted into the Taylor coefficient
+ * vectors of atomic_base.
+ * Atomic functions implementing AtomicBatchArrayFunction also receive the
+ * batched calls of loops directly.
+ */
 template<class Base>
 class AtomicExternalFunctionWrapper : public ExternalFunctionWrapper<Base> {
 private:
     atomic_base<Base>* atomic_;
+    /// the same atomic function if it accepts arrays (null otherwise)
+    AtomicArrayFunction<Base>* arrayAtomic_;
+    /// the same atomic function if it accepts sparse arrays (null otherwise)
+    AtomicSparseArrayFunction<Base>* sparseAtomic_;
+    /// the same atomic function if it accepts batches of arrays (null otherwise)
+    AtomicBatchArrayFunction<Base>* batchAtomic_;
 public:
 
     inline AtomicExternalFunctionWrapper(atomic_base<Base>& atomic) :
-        atomic_(&atomic) {
+        atomic_(&atomic),
+        arrayAtomic_(dynamic_cast<AtomicArrayFunction<Base>*> (&atomic)),
+        sparseAtomic_(dynamic_cast<AtomicSparseArrayFunction<Base>*> (&atomic)),
+        batchAtomic_(dynamic_cast<AtomicBatchArrayFunction<Base>*> (&atomic)) {
     }
 
     inline virtual ~AtomicExternalFunctionWrapper() = default;
 
-    bool forward(FunctorGenericModel<Base>& libModel,
+    bool forward(FunctorGenericModelContext<Base>& ctx,
                  int q,
                  int p,
                  const Array tx[],
                  Array& ty) override {
+        if (arrayAtomic_ != nullptr && !tx[0].sparse && !ty.sparse && p <= 1) {
+            ArrayView<const Base> x(static_cast<const Base*> (tx[0].data), tx[0].size);
+            ArrayView<Base> y(static_cast<Base*> (ty.data), ty.size);
+
+            if (p == 0) {
+                return arrayAtomic_->forwardZero(x, y);
+            } else if (tx[1].sparse && sparseAtomic_ != nullptr) {
+                return sparseAtomic_->forwardOne(x,
+                                                 tx[1].nnz, tx[1].idx, static_cast<const Base*> (tx[1].data),
+                                                 y);
+            } else {
+                return arrayAtomic_->forwardOne(x, toDense(tx[1], ctx._tx), y);
+            }
+        }
+
         size_t m = ty.size;
         size_t n = tx[0].size;
 
         CppAD::vector<bool> vx, vy;
 
-        convert(tx, libModel._tx, n, p, p + 1);
+        convert(tx, ctx._tx, n, p, p + 1);
 
         size_t ty_size = m * (p + 1);
-        libModel._ty.resize(ty_size);
+        ctx._ty.resize(ty_size);
 
-        std::fill(&libModel._ty[0], &libModel._ty[0] + ty_size, Base(0));
+        std::fill(&ctx._ty[0], &ctx._ty[0] + ty_size, Base(0));
 
-        bool ret = atomic_->forward(q, p, vx, vy, libModel._tx, libModel._ty);
+        bool ret = atomic_->forward(q, p, vx, vy, ctx._tx, ctx._ty);
 
-        convertAdd(libModel._ty, ty, m, p, p);
+        convertAdd(ctx._ty, ty, m, p, p);
 
         return ret;
     }
 
-    bool reverse(FunctorGenericModel<Base>& libModel,
+    bool reverse(FunctorGenericModelContext<Base>& ctx,
                  int p,
                  const Array tx[],
                  Array& px,
                  const Array py[]) override {
+        if (arrayAtomic_ != nullptr && !tx[0].sparse && !px.sparse) {
+            ArrayView<const Base> x(static_cast<const Base*> (tx[0].data), tx[0].size);
+            ArrayView<Base> pxb(static_cast<Base*> (px.data), px.size);
+
+            if (p == 0) {
+                if (py[0].sparse && sparseAtomic_ != nullptr) {
+                    return sparseAtomic_->reverseOne(x,
+                                                     pxb,
+                                                     py[0].nnz, py[0].idx, static_cast<const Base*> (py[0].data));
+                } else {
+                    return arrayAtomic_->reverseOne(x, pxb, toDense(py[0], ctx._py));
+                }
+            } else if (p == 1 && py[0].sparse && py[0].nnz == 0 && !py[1].sparse) {
+                // only the second order partials of the dependents are used (Hessians)
+                ArrayView<const Base> py2(static_cast<const Base*> (py[1].data), py[1].size);
+
+                if (tx[1].sparse && sparseAtomic_ != nullptr) {
+                    return sparseAtomic_->reverseTwo(x,
+                                                     tx[1].nnz, tx[1].idx, static_cast<const Base*> (tx[1].data),
+                                                     pxb,
+                                                     py2);
+                } else {
+                    return arrayAtomic_->reverseTwo(x, toDense(tx[1], ctx._tx), pxb, py2);
+                }
+            }
+        }
+
         size_t m = py[0].size;
         size_t n = tx[0].size;
 
-        convert(tx, libModel._tx, n, p, p + 1);
+        convert(tx, ctx._tx, n, p, p + 1);
 
-        libModel._ty.resize(m * (p + 1));
-        std::fill(&libModel._ty[0], &libModel._ty[0] + libModel._ty.size(), Base(0));
+        ctx._ty.resize(m * (p + 1));
+        std::fill(&ctx._ty[0], &ctx._ty[0] + ctx._ty.size(), Base(0));
 
-        convert(py, libModel._py, m, p, p + 1);
+        convert(py, ctx._py, m, p, p + 1);
 
         size_t px_size = n * (p + 1);
-        libModel._px.resize(px_size);
+        ctx._px.resize(px_size);
 
-        std::fill(&libModel._px[0], &libModel._px[0] + px_size, Base(0));
+        std::fill(&ctx._px[0], &ctx._px[0] + px_size, Base(0));
 
 #ifndef NDEBUG
-        if (libModel._evalAtomicForwardOne4CppAD) {
+        if (ctx._model->isAtomicEvalForwardOne4CppAD()) {
             // only required in order to avoid an issue with a validation inside CppAD
             CppAD::vector<bool> vx, vy;
-            if (!atomic_->forward(p, p, vx, vy, libModel._tx, libModel._ty))
+            if (!atomic_->forward(p, p, vx, vy, ctx._tx, ctx._ty))
                 return false;
         }
 #endif
 
-        bool ret = atomic_->reverse(p, libModel._tx, libModel._ty, libModel._px, libModel._py);
+        bool ret = atomic_->reverse(p, ctx._tx, ctx._ty, ctx._px, ctx._py);
 
-        convertAdd(libModel._px, px, n, p, 0); // k=0 for both p=0 and p=1
+        convertAdd(ctx._px, px, n, p, 0); // k=0 for both p=0 and p=1
 
         return ret;
     }
 
+    bool forwardBatch(FunctorGenericModelContext<Base>& ctx,
+                      int q,
+                      int p,
+                      size_t nBatch,
+                      const Array tx[],
+                      Array& ty) override {
+        if (batchAtomic_ != nullptr && !tx[0].sparse && !ty.sparse && p <= 1) {
+            ArrayView<const Base> x(static_cast<const Base*> (tx[0].data), tx[0].size * nBatch);
+            ArrayView<Base> y(static_cast<Base*> (ty.data), ty.size * nBatch);
+
+            if (p == 0) {
+                return batchAtomic_->forwardZeroBatch(nBatch, x, y);
+            } else {
+                return batchAtomic_->forwardOneBatch(nBatch, x, toDense(tx[1], nBatch, ctx._tx), y);
+            }
+        }
+
+        return ExternalFunctionWrapper<Base>::forwardBatch(ctx, q, p, nBatch, tx, ty);
+    }
+
+    bool reverseBatch(FunctorGenericModelContext<Base>& ctx,
+                      int p,
+                      size_t nBatch,
+                      const Array tx[],
+                      Array& px,
+                      const Array py[]) override {
+        if (batchAtomic_ != nullptr && !tx[0].sparse && !px.sparse) {
+            ArrayView<const Base> x(static_cast<const Base*> (tx[0].data), tx[0].size * nBatch);
+            ArrayView<Base> pxb(static_cast<Base*> (px.data), px.size * nBatch);
+
+            if (p == 0) {
+                return batchAtomic_->reverseOneBatch(nBatch, x, pxb, toDense(py[0], nBatch, ctx._py));
+            } else if (p == 1 && py[0].sparse && py[0].nnz == 0 && !py[1].sparse) {
+                // only the second order partials of the dependents are used (Hessians)
+                ArrayView<const Base> py2(static_cast<const Base*> (py[1].data), py[1].size * nBatch);
+
+                return batchAtomic_->reverseTwoBatch(nBatch, x, toDense(tx[1], nBatch, ctx._tx), pxb, py2);
+            }
+        }
+
+        return ExternalFunctionWrapper<Base>::reverseBatch(ctx, p, nBatch, tx, px, py);
+    }
+
 private:
 
+    /**
+     * Provides the values of nBatch consecutive blocks of an array in a
+     * dense format.
+     * Sparse arrays are expanded into the provided work vector.
+     */
+    static inline ArrayView<const Base> toDense(const Array& from,
+                                                size_t nBatch,
+                                                CppAD::vector<Base>& work) {
+        if (!from.sparse) {
+            return ArrayView<const Base>(static_cast<const Base*> (from.data), from.size * nBatch);
+        }
+
+        size_t size = from.size * nBatch;
+        work.resize(size);
+        std::fill(work.data(), work.data() + size, Base(0));
+
+        const Base* values = static_cast<const Base*> (from.data);
+        for (size_t b = 0; b < nBatch; b++) {
+            for (size_t e = 0; e < from.nnz; e++) {
+                work[b * from.size + from.idx[e]] = values[b * from.nnz + e];
+            }
+        }
+
+        return ArrayView<const Base>(work.data(), size);
+    }
+
+    /**
+     * Provides the values of an array in a dense format.
+     * Sparse arrays are expanded into the provided work vector.
+     */
+    static inline ArrayView<const Base> toDense(const Array& from,
+                                                CppAD::vector<Base>& work) {
+        if (!from.sparse) {
+            return ArrayView<const Base>(static_cast<const Base*> (from.data), from.size);
+        }
+
+        work.resize(from.size);
+        std::fill(work.data(), work.data() + from.size, Base(0));
+
+        const Base* values = static_cast<const Base*> (from.data);
+        for (size_t e = 0; e < from.nnz; e++) {
+            work[from.idx[e]] = values[e];
+        }
+
+        return ArrayView<const Base>(work.data(), from.size);
+    }
+
     inline void convert(const Array from[],
                         CppAD::vector<Base>& to,
                         size_t n,
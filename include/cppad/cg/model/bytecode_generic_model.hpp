@@ -0,0 +1,634 @@
+#ifndef CPPAD_CG_BYTECODE_GENERIC_MODEL_INCLUDED
+#define CPPAD_CG_BYTECODE_GENERIC_MODEL_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * A model evaluated by a bytecode interpreter (see BytecodeProgram) which
+ * does not require any compiler.
+ * The operation graphs are created from a CppAD tape in the same way as
+ * in ModelCSourceGen, but they are translated into bytecode instead of
+ * source code.
+ *
+ * Only the zero order forward mode, the dense/sparse Jacobian and the
+ * dense/sparse Hessian are supported and models cannot use atomic
+ * functions.
+ * Objects of this class are not thread-safe.
+ *
+ * @author Joao Leal
+ */
+template<class Base>
+class BytecodeGenericModel : public GenericModel<Base> {
+public:
+    using CGBase = CG<Base>;
+    using ADCG = AD<CGBase>;
+protected:
+    /**
+     * A bytecode program and its register file
+     */
+    struct Function {
+        std::unique_ptr<BytecodeProgram<Base> > program;
+        std::vector<Base> registers;
+    };
+protected:
+    /// the model name
+    const std::string _name;
+    /// the original model (only used while creating the programs)
+    ADFun<CGBase>* _fun;
+    size_t _m;
+    size_t _n;
+    /// no atomic functions are used
+    const std::vector<std::string> _atomicNames;
+    Function _zero;
+    Function _jacobian;
+    Function _hessian;
+    Function _sparseJacobian;
+    Function _sparseHessian;
+    /// the Jacobian sparsity pattern
+    std::vector<size_t> _jacRows;
+    std::vector<size_t> _jacCols;
+    bool _jacSparsity;
+    /// the sparsity pattern for the sum of the Hessians
+    std::vector<size_t> _hessRows;
+    std::vector<size_t> _hessCols;
+    bool _hessSparsity;
+    /// auxiliary array for the compressed sparse Jacobian/Hessian
+    std::vector<Base> _compressed;
+public:
+    using GenericModel<Base>::ForwardZero;
+    using GenericModel<Base>::Jacobian;
+    using GenericModel<Base>::Hessian;
+    using GenericModel<Base>::ForwardOne;
+    using GenericModel<Base>::ReverseOne;
+    using GenericModel<Base>::ReverseTwo;
+    using GenericModel<Base>::SparseJacobian;
+    using GenericModel<Base>::SparseHessian;
+
+    /**
+     * Creates a new model without any function.
+     * The functions must be created with createForwardZero(),
+     * createJacobian(), createHessian(), createSparseJacobian() and
+     * createSparseHessian().
+     *
+     * @param fun the original model which must exist while the functions
+     *            are being created
+     * @param name the model name
+     */
+    BytecodeGenericModel(ADFun<CGBase>& fun,
+                         std::string name) :
+        _name(std::move(name)),
+        _fun(&fun),
+        _m(fun.Range()),
+        _n(fun.Domain()),
+        _jacSparsity(false),
+        _hessSparsity(false) {
+    }
+
+    BytecodeGenericModel(const BytecodeGenericModel&) = delete;
+    BytecodeGenericModel& operator=(const BytecodeGenericModel&) = delete;
+
+    virtual ~BytecodeGenericModel() = default;
+
+    /**
+     * Creates the zero order forward mode function.
+     */
+    virtual void createForwardZero() {
+        CodeHandler<Base> handler;
+
+        std::vector<CGBase> indVars(_n);
+        handler.makeVariables(indVars);
+
+        std::vector<CGBase> dep = _fun->Forward(0, indVars);
+
+        createFunction(_zero, handler, dep, "model");
+
+        determineJacobianSparsity(); // required to determine the dependency of y on x
+    }
+
+    /**
+     * Creates the dense Jacobian function.
+     */
+    virtual void createJacobian() {
+        CodeHandler<Base> handler;
+
+        std::vector<CGBase> indVars(_n);
+        handler.makeVariables(indVars);
+
+        std::vector<CGBase> jac = _fun->Jacobian(indVars);
+
+        createFunction(_jacobian, handler, jac, "Jacobian");
+    }
+
+    /**
+     * Creates the dense Hessian function (of the weighted sum of the
+     * dependents).
+     */
+    virtual void createHessian() {
+        CodeHandler<Base> handler;
+
+        std::vector<CGBase> indVars(_n);
+        handler.makeVariables(indVars);
+
+        std::vector<CGBase> w(_m);
+        handler.makeVariables(w);
+
+        std::vector<CGBase> hess = _fun->Hessian(indVars, w);
+
+        // make use of the symmetry of the Hessian in order to reduce operations
+        for (size_t i = 0; i < _n; i++) {
+            for (size_t j = 0; j < i; j++) {
+                hess[i * _n + j] = hess[j * _n + i];
+            }
+        }
+
+        createFunction(_hessian, handler, hess, "Hessian");
+    }
+
+    /**
+     * Creates the sparse Jacobian function.
+     */
+    virtual void createSparseJacobian() {
+        std::vector<std::set<size_t> > sparsity = determineJacobianSparsity();
+
+        CodeHandler<Base> handler;
+
+        std::vector<CGBase> indVars(_n);
+        handler.makeVariables(indVars);
+
+        std::vector<CGBase> jac(_jacRows.size());
+        CppAD::sparse_jacobian_work work;
+        if (_n <= _m) {
+            _fun->SparseJacobianForward(indVars, sparsity, _jacRows, _jacCols, jac, work);
+        } else {
+            _fun->SparseJacobianReverse(indVars, sparsity, _jacRows, _jacCols, jac, work);
+        }
+
+        createFunction(_sparseJacobian, handler, jac, "sparse Jacobian");
+    }
+
+    /**
+     * Creates the sparse Hessian function (of the weighted sum of the
+     * dependents).
+     */
+    virtual void createSparseHessian() {
+        std::vector<std::set<size_t> > sparsity = determineHessianSparsity();
+
+        // make use of the symmetry of the Hessian in order to reduce operations
+        std::map<std::pair<size_t, size_t>, size_t> lowerPos;
+        std::vector<size_t> lowerRows, lowerCols;
+        for (size_t e = 0; e < _hessRows.size(); e++) {
+            if (_hessRows[e] >= _hessCols[e]) {
+                lowerPos[std::make_pair(_hessRows[e], _hessCols[e])] = lowerRows.size();
+                lowerRows.push_back(_hessRows[e]);
+                lowerCols.push_back(_hessCols[e]);
+            }
+        }
+
+        CodeHandler<Base> handler;
+
+        std::vector<CGBase> indVars(_n);
+        handler.makeVariables(indVars);
+
+        std::vector<CGBase> w(_m);
+        handler.makeVariables(w);
+
+        std::vector<CGBase> lowerHess(lowerRows.size());
+        CppAD::sparse_hessian_work work;
+        work.color_method = "cppad.general";
+        _fun->SparseHessian(indVars, w, sparsity, lowerRows, lowerCols, lowerHess, work);
+
+        std::vector<CGBase> hess(_hessRows.size());
+        for (size_t e = 0; e < _hessRows.size(); e++) {
+            size_t i = std::max(_hessRows[e], _hessCols[e]);
+            size_t j = std::min(_hessRows[e], _hessCols[e]);
+            hess[e] = lowerHess[lowerPos.at(std::make_pair(i, j))];
+        }
+
+        createFunction(_sparseHessian, handler, hess, "sparse Hessian");
+    }
+
+    /**
+     * Provides the bytecode program for the zero order forward mode
+     * (nullptr if it was not created).
+     */
+    inline const BytecodeProgram<Base>* getForwardZeroProgram() const {
+        return _zero.program.get();
+    }
+
+    const std::string& getName() const override {
+        return _name;
+    }
+
+    size_t Domain() const override {
+        return _n;
+    }
+
+    size_t Range() const override {
+        return _m;
+    }
+
+    const std::vector<std::string>& getAtomicFunctionNames() override {
+        return _atomicNames;
+    }
+
+    bool addAtomicFunction(atomic_base<Base>& atomic) override {
+        return false; // never used
+    }
+
+    bool addExternalModel(GenericModel<Base>& atomic) override {
+        return false; // never used
+    }
+
+    // Jacobian sparsity
+    bool isJacobianSparsityAvailable() override {
+        return _jacSparsity;
+    }
+
+    std::vector<std::set<size_t> > JacobianSparsitySet() override {
+        CPPADCG_ASSERT_KNOWN(_jacSparsity, "No Jacobian sparsity available")
+        std::vector<std::set<size_t> > s(_m);
+        generateSparsitySet(_jacRows, _jacCols, s);
+        return s;
+    }
+
+    std::vector<bool> JacobianSparsityBool() override {
+        CPPADCG_ASSERT_KNOWN(_jacSparsity, "No Jacobian sparsity available")
+        return toSparsityBool(_jacRows, _jacCols, _n, _m);
+    }
+
+    void JacobianSparsity(std::vector<size_t>& equations,
+                          std::vector<size_t>& variables) override {
+        CPPADCG_ASSERT_KNOWN(_jacSparsity, "No Jacobian sparsity available")
+        equations = _jacRows;
+        variables = _jacCols;
+    }
+
+    // Hessian sparsity
+    bool isHessianSparsityAvailable() override {
+        return _hessSparsity;
+    }
+
+    std::vector<std::set<size_t> > HessianSparsitySet() override {
+        CPPADCG_ASSERT_KNOWN(_hessSparsity, "No Hessian sparsity available")
+        std::vector<std::set<size_t> > s(_n);
+        generateSparsitySet(_hessRows, _hessCols, s);
+        return s;
+    }
+
+    std::vector<bool> HessianSparsityBool() override {
+        CPPADCG_ASSERT_KNOWN(_hessSparsity, "No Hessian sparsity available")
+        return toSparsityBool(_hessRows, _hessCols, _n, _n);
+    }
+
+    void HessianSparsity(std::vector<size_t>& rows,
+                         std::vector<size_t>& cols) override {
+        CPPADCG_ASSERT_KNOWN(_hessSparsity, "No Hessian sparsity available")
+        rows = _hessRows;
+        cols = _hessCols;
+    }
+
+    bool isEquationHessianSparsityAvailable() override {
+        return false;
+    }
+
+    std::vector<std::set<size_t> > HessianSparsitySet(size_t i) override {
+        throw CGException("Hessian sparsity for each equation is not available in bytecode models");
+    }
+
+    std::vector<bool> HessianSparsityBool(size_t i) override {
+        throw CGException("Hessian sparsity for each equation is not available in bytecode models");
+    }
+
+    void HessianSparsity(size_t i,
+                         std::vector<size_t>& rows,
+                         std::vector<size_t>& cols) override {
+        throw CGException("Hessian sparsity for each equation is not available in bytecode models");
+    }
+
+    // Forward zero
+    bool isForwardZeroAvailable() override {
+        return _zero.program != nullptr;
+    }
+
+    void ForwardZero(ArrayView<const Base> x,
+                     ArrayView<Base> dep) override {
+        CPPADCG_ASSERT_KNOWN(_zero.program != nullptr, "No zero order forward function created")
+        CPPADCG_ASSERT_KNOWN(x.size() == _n, "Invalid independent array size")
+        CPPADCG_ASSERT_KNOWN(dep.size() == _m, "Invalid dependent array size")
+
+        _zero.program->evaluate(_zero.registers, x, dep);
+    }
+
+    void ForwardZero(const std::vector<const Base*> &x,
+                     ArrayView<Base> dep) override {
+        CPPADCG_ASSERT_KNOWN(x.size() == 1, "The number of independent variable arrays is invalid")
+        ForwardZero(ArrayView<const Base>(x[0], _n), dep);
+    }
+
+    void ForwardZero(const CppAD::vector<bool>& vx,
+                     CppAD::vector<bool>& vy,
+                     ArrayView<const Base> tx,
+                     ArrayView<Base> ty) override {
+        ForwardZero(tx, ty);
+
+        if (vx.size() > 0) {
+            CPPADCG_ASSERT_KNOWN(vx.size() >= _n, "Invalid vx size")
+            CPPADCG_ASSERT_KNOWN(vy.size() >= _m, "Invalid vy size")
+            for (size_t e = 0; e < _jacRows.size(); e++) {
+                if (vx[_jacCols[e]]) {
+                    vy[_jacRows[e]] = true;
+                }
+            }
+        }
+    }
+
+    // Dense Jacobian
+    bool isJacobianAvailable() override {
+        return _jacobian.program != nullptr;
+    }
+
+    void Jacobian(ArrayView<const Base> x,
+                  ArrayView<Base> jac) override {
+        CPPADCG_ASSERT_KNOWN(_jacobian.program != nullptr, "No Jacobian function created")
+        CPPADCG_ASSERT_KNOWN(x.size() == _n, "Invalid independent array size")
+        CPPADCG_ASSERT_KNOWN(jac.size() == _m * _n, "Invalid Jacobian array size")
+
+        _jacobian.program->evaluate(_jacobian.registers, x, jac);
+    }
+
+    // Dense Hessian
+    bool isHessianAvailable() override {
+        return _hessian.program != nullptr;
+    }
+
+    void Hessian(ArrayView<const Base> x,
+                 ArrayView<const Base> w,
+                 ArrayView<Base> hess) override {
+        CPPADCG_ASSERT_KNOWN(_hessian.program != nullptr, "No Hessian function created")
+        CPPADCG_ASSERT_KNOWN(hess.size() == _n * _n, "Invalid Hessian array size")
+
+        evaluate(_hessian, x, w, hess);
+    }
+
+    // Forward one
+    bool isForwardOneAvailable() override {
+        return false;
+    }
+
+    void ForwardOne(ArrayView<const Base> tx,
+                    ArrayView<Base> ty) override {
+        throw CGException("First order forward mode is not available in bytecode models");
+    }
+
+    bool isSparseForwardOneAvailable() override {
+        return false;
+    }
+
+    void ForwardOne(ArrayView<const Base> x,
+                    size_t tx1Nnz, const size_t idx[], const Base tx1[],
+                    ArrayView<Base> ty1) override {
+        throw CGException("First order forward mode is not available in bytecode models");
+    }
+
+    // Reverse one
+    bool isReverseOneAvailable() override {
+        return false;
+    }
+
+    bool isSparseReverseOneAvailable() override {
+        return false;
+    }
+
+    void ReverseOne(ArrayView<const Base> tx,
+                    ArrayView<const Base> ty,
+                    ArrayView<Base> px,
+                    ArrayView<const Base> py) override {
+        throw CGException("First order reverse mode is not available in bytecode models");
+    }
+
+    void ReverseOne(ArrayView<const Base> x,
+                    ArrayView<Base> px,
+                    size_t pyNnz, const size_t idx[], const Base py[]) override {
+        throw CGException("First order reverse mode is not available in bytecode models");
+    }
+
+    // Reverse two
+    bool isReverseTwoAvailable() override {
+        return false;
+    }
+
+    bool isSparseReverseTwoAvailable() override {
+        return false;
+    }
+
+    void ReverseTwo(ArrayView<const Base> tx,
+                    ArrayView<const Base> ty,
+                    ArrayView<Base> px,
+                    ArrayView<const Base> py) override {
+        throw CGException("Second order reverse mode is not available in bytecode models");
+    }
+
+    void ReverseTwo(ArrayView<const Base> x,
+                    size_t tx1Nnz, const size_t idx[], const Base tx1[],
+                    ArrayView<Base> px2,
+                    ArrayView<const Base> py2) override {
+        throw CGException("Second order reverse mode is not available in bytecode models");
+    }
+
+    // sparse Jacobian
+    bool isSparseJacobianAvailable() override {
+        return _sparseJacobian.program != nullptr;
+    }
+
+    void SparseJacobian(ArrayView<const Base> x,
+                        ArrayView<Base> jac) override {
+        CPPADCG_ASSERT_KNOWN(_sparseJacobian.program != nullptr, "No sparse Jacobian function created")
+        CPPADCG_ASSERT_KNOWN(x.size() == _n, "Invalid independent array size")
+        CPPADCG_ASSERT_KNOWN(jac.size() == _m * _n, "Invalid Jacobian array size")
+
+        _compressed.resize(_jacRows.size());
+        _sparseJacobian.program->evaluate(_sparseJacobian.registers, x, _compressed);
+
+        std::fill(jac.begin(), jac.end(), Base(0));
+        for (size_t e = 0; e < _jacRows.size(); e++) {
+            jac[_jacRows[e] * _n + _jacCols[e]] = _compressed[e];
+        }
+    }
+
+    void SparseJacobian(const std::vector<Base>& x,
+                        std::vector<Base>& jac,
+                        std::vector<size_t>& row,
+                        std::vector<size_t>& col) override {
+        jac.resize(_jacRows.size());
+        const size_t* r;
+        const size_t* c;
+        SparseJacobian(x, jac, &r, &c);
+        row = _jacRows;
+        col = _jacCols;
+    }
+
+    void SparseJacobian(ArrayView<const Base> x,
+                        ArrayView<Base> jac,
+                        size_t const** row,
+                        size_t const** col) override {
+        CPPADCG_ASSERT_KNOWN(_sparseJacobian.program != nullptr, "No sparse Jacobian function created")
+        CPPADCG_ASSERT_KNOWN(x.size() == _n, "Invalid independent array size")
+        CPPADCG_ASSERT_KNOWN(jac.size() == _jacRows.size(), "Invalid Jacobian array size")
+
+        _sparseJacobian.program->evaluate(_sparseJacobian.registers, x, jac);
+        *row = _jacRows.data();
+        *col = _jacCols.data();
+    }
+
+    void SparseJacobian(const std::vector<const Base*>& x,
+                        ArrayView<Base> jac,
+                        size_t const** row,
+                        size_t const** col) override {
+        CPPADCG_ASSERT_KNOWN(x.size() == 1, "The number of independent variable arrays is invalid")
+        SparseJacobian(ArrayView<const Base>(x[0], _n), jac, row, col);
+    }
+
+    // sparse Hessian
+    bool isSparseHessianAvailable() override {
+        return _sparseHessian.program != nullptr;
+    }
+
+    void SparseHessian(ArrayView<const Base> x,
+                       ArrayView<const Base> w,
+                       ArrayView<Base> hess) override {
+        CPPADCG_ASSERT_KNOWN(_sparseHessian.program != nullptr, "No sparse Hessian function created")
+        CPPADCG_ASSERT_KNOWN(hess.size() == _n * _n, "Invalid Hessian array size")
+
+        _compressed.resize(_hessRows.size());
+        evaluate(_sparseHessian, x, w, _compressed);
+
+        std::fill(hess.begin(), hess.end(), Base(0));
+        for (size_t e = 0; e < _hessRows.size(); e++) {
+            hess[_hessRows[e] * _n + _hessCols[e]] = _compressed[e];
+        }
+    }
+
+    void SparseHessian(const std::vector<Base>& x,
+                       const std::vector<Base>& w,
+                       std::vector<Base>& hess,
+                       std::vector<size_t>& row,
+                       std::vector<size_t>& col) override {
+        hess.resize(_hessRows.size());
+        const size_t* r;
+        const size_t* c;
+        SparseHessian(x, w, hess, &r, &c);
+        row = _hessRows;
+        col = _hessCols;
+    }
+
+    void SparseHessian(ArrayView<const Base> x,
+                       ArrayView<const Base> w,
+                       ArrayView<Base> hess,
+                       size_t const** row,
+                       size_t const** col) override {
+        CPPADCG_ASSERT_KNOWN(_sparseHessian.program != nullptr, "No sparse Hessian function created")
+        CPPADCG_ASSERT_KNOWN(hess.size() == _hessRows.size(), "Invalid Hessian array size")
+
+        evaluate(_sparseHessian, x, w, hess);
+        *row = _hessRows.data();
+        *col = _hessCols.data();
+    }
+
+    void SparseHessian(const std::vector<const Base*>& x,
+                       ArrayView<const Base> w,
+                       ArrayView<Base> hess,
+                       size_t const** row,
+                       size_t const** col) override {
+        CPPADCG_ASSERT_KNOWN(x.size() == 1, "The number of independent variable arrays is invalid")
+        SparseHessian(ArrayView<const Base>(x[0], _n), w, hess, row, col);
+    }
+
+protected:
+
+    /**
+     * Creates the bytecode program for an operation graph.
+     */
+    inline void createFunction(Function& f,
+                               CodeHandler<Base>& handler,
+                               std::vector<CGBase>& dep,
+                               const std::string& jobName) {
+        LanguageBytecode<Base> lang;
+        LangCDefaultVariableNameGenerator<Base> nameGen;
+        std::ostringstream code;
+
+        handler.generateCode(code, lang, dep, nameGen, jobName);
+
+        f.program = lang.releaseProgram();
+        f.program->initRegisters(f.registers);
+    }
+
+    /**
+     * Evaluates a program whose independent variables are the model
+     * independents followed by the weights of each dependent.
+     */
+    inline void evaluate(Function& f,
+                         ArrayView<const Base> x,
+                         ArrayView<const Base> w,
+                         ArrayView<Base> out) {
+        CPPADCG_ASSERT_KNOWN(x.size() == _n, "Invalid independent array size")
+        CPPADCG_ASSERT_KNOWN(w.size() == _m, "Invalid multiplier array size")
+
+        std::vector<Base>& reg = f.registers;
+        if (_n > 0)
+            std::copy(x.begin(), x.end(), f.program->getIndependent(reg, 0));
+        if (_m > 0)
+            std::copy(w.begin(), w.end(), f.program->getIndependent(reg, _n));
+
+        f.program->evaluate(reg, out);
+    }
+
+    inline std::vector<std::set<size_t> > determineJacobianSparsity() {
+        std::vector<std::set<size_t> > sparsity = jacobianSparsitySet<std::vector<std::set<size_t> >, CGBase>(*_fun);
+        if (!_jacSparsity) {
+            generateSparsityIndexes(sparsity, _jacRows, _jacCols);
+            _jacSparsity = true;
+        }
+        return sparsity;
+    }
+
+    inline std::vector<std::set<size_t> > determineHessianSparsity() {
+        std::vector<std::set<size_t> > sparsity = hessianSparsitySet<std::vector<std::set<size_t> >, CGBase>(*_fun);
+        if (!_hessSparsity) {
+            generateSparsityIndexes(sparsity, _hessRows, _hessCols);
+            _hessSparsity = true;
+        }
+        return sparsity;
+    }
+
+    static inline std::vector<bool> toSparsityBool(const std::vector<size_t>& rows,
+                                                   const std::vector<size_t>& cols,
+                                                   size_t nCols,
+                                                   size_t nRows) {
+        std::vector<bool> s(nRows * nCols, false);
+        for (size_t e = 0; e < rows.size(); e++) {
+            s[rows[e] * nCols + cols[e]] = true;
+        }
+        return s;
+    }
+
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
@@ -27,6 +27,16 @@ namespace cg {
  */
 template<class Base>
 class AbstractCCompiler : public CCompiler<Base> {
+protected:
+    /**
+     * The inputs used to compile a source file
+     */
+    struct CompiledSourceInfo {
+        std::string source;
+        std::vector<std::string> flags;
+        std::vector<std::string> libFlags;
+        bool posIndepCode;
+    };
 protected:
     std::string _path; // the path to the gcc executable
     std::string _tmpFolder;
@@ -38,6 +48,25 @@ protected:
     std::vector<std::string> _linkFlags;
     bool _verbose;
     bool _saveToDiskFirst;
+    /**
+     * whether or not to keep the object files between library builds and
+     * only recompile the sources which have changed
+     */
+    bool _compileCache;
+    /**
+     * the compilation inputs used to create each object file in the
+     * compile cache
+     */
+    std::map<std::string, CompiledSourceInfo> _compiledSources;
+    /**
+     * the number of compiled source files (since the creation of the compiler)
+     */
+    size_t _compiledCount;
+    /**
+     * the number of source files whose compilation was skipped because an
+     * up-to-date object file existed in the compile cache
+     */
+    size_t _reusedCount;
 public:
 
     AbstractCCompiler(const std::string& compilerPath) :
@@ -45,7 +74,10 @@ public:
         _tmpFolder("cppadcg_tmp"),
         _sourcesFolder("cppadcg_sources"),
         _verbose(false),
-        _saveToDiskFirst(false) {
+        _saveToDiskFirst(false),
+        _compileCache(false),
+        _compiledCount(0),
+        _reusedCount(0) {
     }
 
     AbstractCCompiler(const AbstractCCompiler& orig) = delete;
@@ -135,6 +167,61 @@ public:
         _verbose = verbose;
     }
 
+    /**
+     * Whether or not the object files are kept between library builds so
+     * that only the source files which have changed are recompiled.
+     */
+    bool isCompileCache() const {
+        return _compileCache;
+    }
+
+    /**
+     * Defines whether or not the object files are kept between library
+     * builds (compile cache) so that the compilation of unchanged source
+     * files is skipped.
+     * This is only a cache of object files: the model is still taped and
+     * all of its source files are still generated, and only the source
+     * files whose content or compilation flags differ from the ones used to
+     * create the cached object file are recompiled before the library is
+     * linked again.
+     * The same compiler object must be used for all the builds.
+     *
+     * @param compileCache true to keep the object files between builds
+     */
+    void setCompileCache(bool compileCache) {
+        _compileCache = compileCache;
+        if (!compileCache) {
+            clearCompileCache();
+        }
+    }
+
+    /**
+     * Provides the number of source files compiled by this compiler.
+     */
+    size_t getCompiledSourceCount() const {
+        return _compiledCount;
+    }
+
+    /**
+     * Provides the number of source files which did not have to be
+     * compiled because of the compile cache.
+     */
+    size_t getReusedSourceCount() const {
+        return _reusedCount;
+    }
+
+    /**
+     * Deletes the object files in the compile cache.
+     */
+    void clearCompileCache() {
+        for (const auto& it : _compiledSources) {
+            // files still required by the current build are deleted by cleanup()
+            if (_ofiles.find(it.first) == _ofiles.end())
+                remove(it.first.c_str());
+        }
+        _compiledSources.clear();
+    }
+
     /**
      * Compiles the provided C source code.
      *
@@ -194,6 +281,16 @@ public:
             std::string file = system::createPath(this->_tmpFolder, it->first + outputExtension);
             outputFiles.insert(file);
 
+            if (_compileCache && isUpToDate(file, it->second, posIndepCode)) {
+                _reusedCount++;
+                if (timer == nullptr && _verbose) {
+                    std::cout << "[" << std::setw(countWidth) << std::setfill(' ') << std::right << count
+                            << "/" << sources.size() << "] up to date '" << file << "'" << std::endl;
+                }
+                continue;
+            }
+            _compiledSources.erase(file);
+
             steady_clock::time_point beginTime;
 
             if (timer != nullptr || _verbose) {
@@ -230,6 +327,14 @@ public:
                 compileSource(it->second, file, posIndepCode);
             }
 
+            _compiledCount++;
+            if (_compileCache) {
+                _compiledSources[file] = CompiledSourceInfo{it->second,
+                                                            _compileFlags,
+                                                            _compileLibFlags,
+                                                            posIndepCode};
+            }
+
             if (timer != nullptr) {
                 timer->finishedJob();
             } else if (_verbose) {
@@ -253,22 +358,54 @@ public:
 
     void cleanup() override {
         // clean up;
-        for (const std::string& it : _ofiles) {
-            if (remove(it.c_str()) != 0)
-                std::cerr << "Failed to delete temporary file '" << it << "'" << std::endl;
+        if (!_compileCache) {
+            for (const std::string& it : _ofiles) {
+                if (remove(it.c_str()) != 0)
+                    std::cerr << "Failed to delete temporary file '" << it << "'" << std::endl;
+            }
         }
         _ofiles.clear();
         _sfiles.clear();
 
-        remove(this->_tmpFolder.c_str());
+        if (!_compileCache) {
+            remove(this->_tmpFolder.c_str());
+        }
     }
 
     virtual ~AbstractCCompiler() {
+        _compileCache = false;
         cleanup();
+        clearCompileCache();
+        remove(this->_tmpFolder.c_str());
     }
 
 protected:
 
+    /**
+     * Determines whether or not an object file in the compile cache was
+     * created from the same source code and with the same compilation
+     * flags.
+     *
+     * @param file the object file path
+     * @param source the content of the source file
+     * @param posIndepCode whether or not to create position-independent
+     *                     code for dynamic linking
+     */
+    bool isUpToDate(const std::string& file,
+                    const std::string& source,
+                    bool posIndepCode) const {
+        auto it = _compiledSources.find(file);
+        if (it == _compiledSources.end())
+            return false;
+
+        const CompiledSourceInfo& info = it->second;
+        return info.posIndepCode == posIndepCode &&
+               info.flags == _compileFlags &&
+               info.libFlags == _compileLibFlags &&
+               info.source == source &&
+               system::isFile(file);
+    }
+
     /**
      * Compiles a single source file into an object file.
      *
@@ -122,10 +122,12 @@ public:
     }
 
     void cleanup() override {
-        // clean up
-        for (const std::string& it : _bcfiles) {
-            if (remove(it.c_str()) != 0)
-                std::cerr << "Failed to delete temporary file '" << it << "'" << std::endl;
+        // clean up (bit code files are kept in the compile cache)
+        if (!this->_compileCache) {
+            for (const std::string& it : _bcfiles) {
+                if (remove(it.c_str()) != 0)
+                    std::cerr << "Failed to delete temporary file '" << it << "'" << std::endl;
+            }
         }
         _bcfiles.clear();
 
@@ -25,14 +25,14 @@ public:
      * Computes results during a forward mode sweep, the Taylor coefficients 
      * for dependent variables relative to independent variables.
      * 
-     * @param libModel The model calling where this is being called from.
+     * @param ctx The context of the model where this is being called from.
      * @param q Lowest order for this forward mode calculation.
      * @param p Highest order for this forward mode calculation.
      * @param tx Independent variable Taylor coefficients.
      * @param ty Dependent variable Taylor coefficients.
      * @return <code>true</code> if evaluation succeeded, <code>false</code> otherwise. 
      */
-    virtual bool forward(FunctorGenericModel<Base>& libModel,
+    virtual bool forward(FunctorGenericModelContext<Base>& ctx,
                          int q,
                          int p,
                          const Array tx[],
@@ -42,21 +42,103 @@ public:
      * Computes results during a reverse mode sweep, the adjoints or partial
      * derivatives of independent variables.
      * 
-     * @param libModel The model calling where this is being called from.
+     * @param ctx The context of the model where this is being called from.
      * @param p Order for this reverse mode calculation.
      * @param tx Independent variable Taylor coefficients.
      * @param px Independent variable partial derivatives.
      * @param py Dependent variable partial derivatives.
      * @return <code>true</code> if evaluation succeeded, <code>false</code> otherwise.
      */
-    virtual bool reverse(FunctorGenericModel<Base>& libModel,
+    virtual bool reverse(FunctorGenericModelContext<Base>& ctx,
                          int p,
                          const Array tx[],
                          Array& px,
                          const Array py[]) = 0;
 
+    /**
+     * Computes the results of a forward mode sweep for several sets of
+     * arguments at once (e.g. all the iterations of a loop).
+     * Each array holds nBatch consecutive blocks of values where the size
+     * and the number of non-zeros refer to a single block.
+     * The default implementation evaluates each block individually.
+     *
+     * @param ctx The context of the model where this is being called from.
+     * @param q Lowest order for this forward mode calculation.
+     * @param p Highest order for this forward mode calculation.
+     * @param nBatch The number of blocks.
+     * @param tx Independent variable Taylor coefficients.
+     * @param ty Dependent variable Taylor coefficients.
+     * @return <code>true</code> if evaluation succeeded, <code>false</code> otherwise.
+     */
+    virtual bool forwardBatch(FunctorGenericModelContext<Base>& ctx,
+                              int q,
+                              int p,
+                              size_t nBatch,
+                              const Array tx[],
+                              Array& ty) {
+        std::vector<Array> txb(tx, tx + p + 1);
+        Array tyb = ty;
+        for (size_t b = 0; b < nBatch; b++) {
+            for (int k = 0; k <= p; k++)
+                txb[k].data = block(tx[k], b);
+            tyb.data = block(ty, b);
+            if (!forward(ctx, q, p, txb.data(), tyb))
+                return false;
+        }
+        return true;
+    }
+
+    /**
+     * Computes the results of a reverse mode sweep for several sets of
+     * arguments at once (e.g. all the iterations of a loop).
+     * Each array holds nBatch consecutive blocks of values where the size
+     * and the number of non-zeros refer to a single block.
+     * The default implementation evaluates each block individually.
+     *
+     * @param ctx The context of the model where this is being called from.
+     * @param p Order for this reverse mode calculation.
+     * @param nBatch The number of blocks.
+     * @param tx Independent variable Taylor coefficients.
+     * @param px Independent variable partial derivatives.
+     * @param py Dependent variable partial derivatives.
+     * @return <code>true</code> if evaluation succeeded, <code>false</code> otherwise.
+     */
+    virtual bool reverseBatch(FunctorGenericModelContext<Base>& ctx,
+                              int p,
+                              size_t nBatch,
+                              const Array tx[],
+                              Array& px,
+                              const Array py[]) {
+        std::vector<Array> txb(tx, tx + p + 1);
+        std::vector<Array> pyb(py, py + p + 1);
+        Array pxb = px;
+        for (size_t b = 0; b < nBatch; b++) {
+            for (int k = 0; k <= p; k++) {
+                txb[k].data = block(tx[k], b);
+                pyb[k].data = block(py[k], b);
+            }
+            pxb.data = block(px, b);
+            if (!reverse(ctx, p, txb.data(), pxb, pyb.data()))
+                return false;
+        }
+        return true;
+    }
+
     inline virtual ~ExternalFunctionWrapper() {
     }
+
+protected:
+
+    /**
+     * Provides the location of the values of a block in a batched array.
+     */
+    static inline void* block(const Array& array,
+                              size_t b) {
+        if (array.data == nullptr)
+            return nullptr;
+        size_t size = array.sparse ? array.nnz : array.size;
+        return static_cast<Base*> (array.data) + b * size;
+    }
 };
 
 } // END cg namespace
@@ -23,10 +23,13 @@ namespace cg {
 
 /**
  * A model which can be accessed through function pointers.
- * This class is not thread-safe and it should not be used simultaneously in
- * different threads.
+ * The methods which do not receive a FunctorGenericModelContext use an
+ * internal context and should not be used simultaneously in different
+ * threads.
+ * The same model can be evaluated simultaneously in several threads by
+ * providing a different context (see createContext()) to each thread.
  * Multiple instances of this class for the same model from the same model
- * library object can be used simulataneously in different threads.
+ * library object can also be used simulataneously in different threads.
  *
  * @author Joao Leal
  */
@@ -38,14 +41,18 @@ protected:
     const std::string _name;
     size_t _m;
     size_t _n;
-    std::vector<const Base*> _in;
-    std::vector<const Base*> _inHess;
-    std::vector<Base*> _out;
-    LangCAtomicFun _atomicFuncArg;
+    /// number of runtime parameters
+    size_t _np;
+    /// number of independent variable arrays
+    size_t _inSize;
+    /// number of dependent variable arrays
+    size_t _outSize;
+    /// the context used by the methods which do not receive a context
+    std::unique_ptr<FunctorGenericModelContext<Base>> _ctx;
     std::vector<std::string> _atomicNames; // names of the atomic/external functions required by this model
     std::vector<ExternalFunctionWrapper<Base>* > _atomic;
+    std::vector<bool> _directAtomic; // whether or not each atomic function is called directly by the compiled code
     size_t _missingAtomicFunctions;
-    CppAD::vector<Base> _tx, _ty, _px, _py;
     // original model function
     void (*_zero)(Base const*const*, Base * const*, LangCAtomicFun);
     // first order forward mode
@@ -86,8 +93,37 @@ protected:
             unsigned long const** row,
             unsigned long const** col,
             unsigned long * nnz);
+    // compressed sparse (CSR/CSC) Jacobian structure in the dynamic library
+    void (*_jacobianSparsityCompressed)(int* rowMajor,
+            unsigned long const** outer,
+            unsigned long const** inner,
+            unsigned long* nOuter,
+            unsigned long* nnz);
+    // compressed sparse (CSR/CSC) Hessian structure in the dynamic library
+    void (*_hessianSparsityCompressed)(int* rowMajor,
+            unsigned long const** outer,
+            unsigned long const** inner,
+            unsigned long* nOuter,
+            unsigned long* nnz);
     void (*_atomicFunctions)(const char*** names,
             unsigned long * n);
+    // Newton solvers for blocks of algebraic equations in the dynamic library
+    int (*_newtonSolve)(unsigned long block,
+            Base* x,
+            Base const* p,
+            unsigned long maxIter,
+            Base tol,
+            unsigned long* iterations,
+            LangCAtomicFun);
+    void (*_newtonBlocks)(unsigned long* n);
+    void (*_newtonBlock)(unsigned long block,
+            unsigned long const** equations,
+            unsigned long const** variables,
+            unsigned long* size);
+    /// places the sparse Jacobian elements in a dense matrix
+    SparseScatterPlan _jacDensePlan;
+    /// places the sparse Hessian elements in a dense matrix
+    SparseScatterPlan _hessDensePlan;
 
 public:
 
@@ -171,6 +207,52 @@ public:
         std::copy(col, col + nnz, variables.begin());
     }
 
+    /**
+     * Provides the Jacobian sparsity pattern stored in the model library
+     * without creating any copy (unlike JacobianSparsitySet() and
+     * JacobianSparsityBool()).
+     * The views remain valid while the model library is loaded.
+     *
+     * @return views of the row and column of each Jacobian element in the
+     *         same order as the sparse Jacobian values
+     */
+    CoordinateSparsityView JacobianSparsityView() const {
+        CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
+        CPPADCG_ASSERT_KNOWN(_jacobianSparsity != nullptr, "No Jacobian sparsity function defined in the dynamic library");
+
+        unsigned long const* row, *col;
+        unsigned long nnz;
+        (*_jacobianSparsity)(&row, &col, &nnz);
+
+        return CoordinateSparsityView(ArrayView<const size_t>(row, nnz),
+                                      ArrayView<const size_t>(col, nnz));
+    }
+
+    /**
+     * Whether or not the sparse Jacobian elements are provided in the same
+     * order as in a compressed sparse matrix (CSR or CSC).
+     *
+     * @see ModelCSourceGen::setCompressedSparseJacobian()
+     */
+    bool isJacobianSparsityCompressedAvailable() const {
+        return _jacobianSparsityCompressed != nullptr;
+    }
+
+    /**
+     * Provides the structure of the sparse Jacobian as a compressed sparse
+     * matrix (CSR or CSC) without any copy.
+     * The output of the sparse Jacobian can be used directly as the values
+     * array of this matrix.
+     *
+     * @return views of the outer and inner index arrays in the library
+     */
+    CompressedSparsityView JacobianSparsityCompressed() const {
+        CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
+        CPPADCG_ASSERT_KNOWN(_jacobianSparsityCompressed != nullptr, "No compressed Jacobian sparsity function defined in the dynamic library");
+
+        return loadSparsityCompressed(*_jacobianSparsityCompressed);
+    }
+
     // Hessian sparsity
     bool isHessianSparsityAvailable() override {
         return _hessianSparsity != nullptr;
@@ -224,6 +306,72 @@ public:
         std::copy(col, col + nnz, cols.begin());
     }
 
+    /**
+     * Provides the Hessian sparsity pattern stored in the model library
+     * without creating any copy (unlike HessianSparsitySet() and
+     * HessianSparsityBool()).
+     * The views remain valid while the model library is loaded.
+     *
+     * @return views of the row and column of each Hessian element in the
+     *         same order as the sparse Hessian values
+     */
+    CoordinateSparsityView HessianSparsityView() const {
+        CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
+        CPPADCG_ASSERT_KNOWN(_hessianSparsity != nullptr, "No Hessian sparsity function defined in the dynamic library");
+
+        unsigned long const* row, *col;
+        unsigned long nnz;
+        (*_hessianSparsity)(&row, &col, &nnz);
+
+        return CoordinateSparsityView(ArrayView<const size_t>(row, nnz),
+                                      ArrayView<const size_t>(col, nnz));
+    }
+
+    /**
+     * Provides the Hessian sparsity pattern of a single equation stored in
+     * the model library without creating any copy.
+     * The views remain valid while the model library is loaded.
+     *
+     * @param i the equation/dependent variable index
+     * @return views of the row and column of each Hessian element
+     */
+    CoordinateSparsityView HessianSparsityView(size_t i) const {
+        CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
+        CPPADCG_ASSERT_KNOWN(_hessianSparsity2 != nullptr, "No Hessian sparsity function defined in the dynamic library");
+
+        unsigned long const* row, *col;
+        unsigned long nnz;
+        (*_hessianSparsity2)(i, &row, &col, &nnz);
+
+        return CoordinateSparsityView(ArrayView<const size_t>(row, nnz),
+                                      ArrayView<const size_t>(col, nnz));
+    }
+
+    /**
+     * Whether or not the sparse Hessian elements are provided in the same
+     * order as in a compressed sparse matrix (CSR or CSC).
+     *
+     * @see ModelCSourceGen::setCompressedSparseHessian()
+     */
+    bool isHessianSparsityCompressedAvailable() const {
+        return _hessianSparsityCompressed != nullptr;
+    }
+
+    /**
+     * Provides the structure of the sparse Hessian as a compressed sparse
+     * matrix (CSR or CSC) without any copy.
+     * The output of the sparse Hessian can be used directly as the values
+     * array of this matrix.
+     *
+     * @return views of the outer and inner index arrays in the library
+     */
+    CompressedSparsityView HessianSparsityCompressed() const {
+        CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
+        CPPADCG_ASSERT_KNOWN(_hessianSparsityCompressed != nullptr, "No compressed Hessian sparsity function defined in the dynamic library");
+
+        return loadSparsityCompressed(*_hessianSparsityCompressed);
+    }
+
     bool isEquationHessianSparsityAvailable() override {
         return _hessianSparsity2 != nullptr;
     }
@@ -288,6 +436,30 @@ public:
         return _m;
     }
 
+    /// number of runtime parameters
+
+    size_t getParameterCount() const override {
+        return _np;
+    }
+
+    /**
+     * Creates a new context which can be used to evaluate this model
+     * simultaneously in several threads (one context per thread).
+     * The evaluation methods which receive a context do not modify this
+     * model and can be called concurrently as long as:
+     *  - each thread uses a different context,
+     *  - the atomic functions are also thread-safe, and
+     *  - the thread pool of the model library is disabled (if the library
+     *    was compiled with multithreading support).
+     * The context must not be used after this model is deleted.
+     *
+     * @return a new evaluation context for this model
+     */
+    std::unique_ptr<FunctorGenericModelContext<Base>> createContext() const {
+        CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
+        return std::unique_ptr<FunctorGenericModelContext<Base>>(new FunctorGenericModelContext<Base>(*this));
+    }
+
     bool isForwardZeroAvailable() override {
         return _zero != nullptr;
     }
@@ -295,31 +467,53 @@ public:
     /// calculate the dependent values (zero order)
     void ForwardZero(ArrayView<const Base> x,
                      ArrayView<Base> dep) override {
+        ForwardZero(*_ctx, x, dep);
+    }
+
+    /**
+     * Evaluates the dependent model variables (zero-order) using the
+     * temporary data in the provided context.
+     *
+     * @param ctx an evaluation context created for this model
+     * @param x The independent variable vector
+     * @param dep The dependent variable vector
+     */
+    void ForwardZero(FunctorGenericModelContext<Base>& ctx,
+                     ArrayView<const Base> x,
+                     ArrayView<Base> dep) const {
         CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
         CPPADCG_ASSERT_KNOWN(_zero != nullptr, "No zero order forward function defined in the dynamic library");
-        CPPADCG_ASSERT_KNOWN(_in.size() == 1, "The number of independent variable arrays is higher than 1,"
+        CPPADCG_ASSERT_KNOWN(ctx._model == this, "The evaluation context was created for a different model");
+        CPPADCG_ASSERT_KNOWN(_inSize == 1, "The number of independent variable arrays is higher than 1,"
                              " please use the variable size methods");
         CPPADCG_ASSERT_KNOWN(dep.size() == _m, "Invalid dependent array size");
         CPPADCG_ASSERT_KNOWN(x.size() == _n, "Invalid independent array size");
         CPPADCG_ASSERT_KNOWN(_missingAtomicFunctions == 0, "Some atomic functions used by the compiled model have not been specified yet");
 
-        _in[0] = x.data();
-        _out[0] = dep.data();
+        ctx._in[0] = x.data();
+        ctx._out[0] = dep.data();
 
-        (*_zero)(&_in[0], &_out[0], _atomicFuncArg);
+        (*_zero)(&ctx._in[0], &ctx._out[0], ctx._atomicFuncArg);
     }
 
     void ForwardZero(const std::vector<const Base*> &x,
                      ArrayView<Base> dep) override {
+        ForwardZero(*_ctx, x, dep);
+    }
+
+    void ForwardZero(FunctorGenericModelContext<Base>& ctx,
+                     const std::vector<const Base*> &x,
+                     ArrayView<Base> dep) const {
         CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
         CPPADCG_ASSERT_KNOWN(_zero != nullptr, "No zero order forward function defined in the dynamic library");
-        CPPADCG_ASSERT_KNOWN(_in.size() == x.size(), "The number of independent variable arrays is invalid");
+        CPPADCG_ASSERT_KNOWN(ctx._model == this, "The evaluation context was created for a different model");
+        CPPADCG_ASSERT_KNOWN(_inSize == x.size(), "The number of independent variable arrays is invalid");
         CPPADCG_ASSERT_KNOWN(dep.size() == _m, "Invalid dependent array size");
         CPPADCG_ASSERT_KNOWN(_missingAtomicFunctions == 0, "Some atomic functions used by the compiled model have not been specified yet");
 
-        _out[0] = dep.data();
+        ctx._out[0] = dep.data();
 
-        (*_zero)(&x[0], &_out[0], _atomicFuncArg);
+        (*_zero)(&x[0], &ctx._out[0], ctx._atomicFuncArg);
     }
 
     void ForwardZero(const CppAD::vector<bool>& vx,
@@ -328,27 +522,22 @@ public:
                      ArrayView<Base> ty) override {
         CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
         CPPADCG_ASSERT_KNOWN(_zero != nullptr, "No zero order forward function defined in the dynamic library");
-        CPPADCG_ASSERT_KNOWN(_in.size() == 1, "The number of independent variable arrays is higher than 1,"
+        CPPADCG_ASSERT_KNOWN(_inSize == 1, "The number of independent variable arrays is higher than 1,"
                              " please use the variable size methods");
         CPPADCG_ASSERT_KNOWN(tx.size() == _n, "Invalid independent array size");
         CPPADCG_ASSERT_KNOWN(ty.size() == _m, "Invalid dependent array size");
         CPPADCG_ASSERT_KNOWN(_missingAtomicFunctions == 0, "Some atomic functions used by the compiled model have not been specified yet");
 
-        _in[0] = tx.data();
-        _out[0] = ty.data();
-
-        (*_zero)(&_in[0], &_out[0], _atomicFuncArg);
+        ForwardZero(*_ctx, tx, ty);
 
         if (vx.size() > 0) {
             CPPADCG_ASSERT_KNOWN(vx.size() >= _n, "Invalid vx size");
             CPPADCG_ASSERT_KNOWN(vy.size() >= _m, "Invalid vy size");
-            const std::vector<std::set<size_t> > jacSparsity = JacobianSparsitySet();
-            for (size_t i = 0; i < _m; i++) {
-                for (size_t j : jacSparsity[i]) {
-                    if (vx[j]) {
-                        vy[i] = true;
-                        break;
-                    }
+            // use the sparsity in the library directly (no sets)
+            CoordinateSparsityView jacSparsity = JacobianSparsityView();
+            for (size_t e = 0; e < jacSparsity.nnz(); e++) {
+                if (vx[jacSparsity.cols[e]]) {
+                    vy[jacSparsity.rows[e]] = true;
                 }
             }
         }
@@ -361,19 +550,26 @@ public:
     /// calculate entire Jacobian
     void Jacobian(ArrayView<const Base> x,
                   ArrayView<Base> jac) override {
+        Jacobian(*_ctx, x, jac);
+    }
+
+    void Jacobian(FunctorGenericModelContext<Base>& ctx,
+                  ArrayView<const Base> x,
+                  ArrayView<Base> jac) const {
         CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
         CPPADCG_ASSERT_KNOWN(_jacobian != nullptr, "No Jacobian function defined in the dynamic library");
-        CPPADCG_ASSERT_KNOWN(_in.size() == 1, "The number of independent variable arrays is higher than 1,"
+        CPPADCG_ASSERT_KNOWN(ctx._model == this, "The evaluation context was created for a different model");
+        CPPADCG_ASSERT_KNOWN(_inSize == 1, "The number of independent variable arrays is higher than 1,"
                              " please use the variable size methods");
         CPPADCG_ASSERT_KNOWN(x.size() == _n, "Invalid independent array size");
         CPPADCG_ASSERT_KNOWN(jac.size() == _m * _n, "Invalid Jacobian array size");
         CPPADCG_ASSERT_KNOWN(_missingAtomicFunctions == 0, "Some atomic functions used by the compiled model have not been specified yet");
 
 
-        _in[0] = x.data();
-        _out[0] = jac.data();
+        ctx._in[0] = x.data();
+        ctx._out[0] = jac.data();
 
-        (*_jacobian)(&_in[0], &_out[0], _atomicFuncArg);
+        (*_jacobian)(&ctx._in[0], &ctx._out[0], ctx._atomicFuncArg);
     }
 
     bool isHessianAvailable() override {
@@ -384,20 +580,28 @@ public:
     void Hessian(ArrayView<const Base> x,
                  ArrayView<const Base> w,
                  ArrayView<Base> hess) override {
+        Hessian(*_ctx, x, w, hess);
+    }
+
+    void Hessian(FunctorGenericModelContext<Base>& ctx,
+                 ArrayView<const Base> x,
+                 ArrayView<const Base> w,
+                 ArrayView<Base> hess) const {
         CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
         CPPADCG_ASSERT_KNOWN(_hessian != nullptr, "No Hessian function defined in the dynamic library");
-        CPPADCG_ASSERT_KNOWN(_in.size() == 1, "The number of independent variable arrays is higher than 1,"
+        CPPADCG_ASSERT_KNOWN(ctx._model == this, "The evaluation context was created for a different model");
+        CPPADCG_ASSERT_KNOWN(_inSize == 1, "The number of independent variable arrays is higher than 1,"
                              " please use the variable size methods");
         CPPADCG_ASSERT_KNOWN(x.size() == _n, "Invalid independent array size");
         CPPADCG_ASSERT_KNOWN(w.size() == _m, "Invalid multiplier array size");
         CPPADCG_ASSERT_KNOWN(hess.size() == _n * _n, "Invalid Hessian size");
         CPPADCG_ASSERT_KNOWN(_missingAtomicFunctions == 0, "Some atomic functions used by the compiled model have not been specified yet");
 
-        _inHess[0] = x.data();
-        _inHess[1] = w.data();
-        _out[0] = hess.data();
+        ctx._inHess[0] = x.data();
+        ctx._inHess[1] = w.data();
+        ctx._out[0] = hess.data();
 
-        (*_hessian)(&_inHess[0], &_out[0], _atomicFuncArg);
+        (*_hessian)(&ctx._inHess[0], &ctx._out[0], ctx._atomicFuncArg);
     }
 
     bool isForwardOneAvailable() override {
@@ -406,15 +610,22 @@ public:
 
     void ForwardOne(ArrayView<const Base> tx,
                     ArrayView<Base> ty) override {
+        ForwardOne(*_ctx, tx, ty);
+    }
+
+    void ForwardOne(FunctorGenericModelContext<Base>& ctx,
+                    ArrayView<const Base> tx,
+                    ArrayView<Base> ty) const {
         const size_t k = 1;
 
         CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
         CPPADCG_ASSERT_KNOWN(_forwardOne != nullptr, "No forward one function defined in the dynamic library");
+        CPPADCG_ASSERT_KNOWN(ctx._model == this, "The evaluation context was created for a different model");
         CPPADCG_ASSERT_KNOWN(tx.size() >= (k + 1) * _n, "Invalid tx size");
         CPPADCG_ASSERT_KNOWN(ty.size() >= (k + 1) * _m, "Invalid ty size");
         CPPADCG_ASSERT_KNOWN(_missingAtomicFunctions == 0, "Some atomic functions used by the compiled model have not been specified yet");
 
-        int ret = (*_forwardOne)(tx.data(), ty.data(), _atomicFuncArg);
+        int ret = (*_forwardOne)(tx.data(), ty.data(), ctx._atomicFuncArg);
 
         CPPADCG_ASSERT_KNOWN(ret == 0, "First-order forward mode failed."); // generic failure
     }
@@ -426,9 +637,17 @@ public:
     void ForwardOne(ArrayView<const Base> x,
                     size_t tx1Nnz, const size_t idx[], const Base tx1[],
                     ArrayView<Base> ty1) override {
+        ForwardOne(*_ctx, x, tx1Nnz, idx, tx1, ty1);
+    }
+
+    void ForwardOne(FunctorGenericModelContext<Base>& ctx,
+                    ArrayView<const Base> x,
+                    size_t tx1Nnz, const size_t idx[], const Base tx1[],
+                    ArrayView<Base> ty1) const {
         CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
         CPPADCG_ASSERT_KNOWN(_sparseForwardOne != nullptr, "No sparse forward one function defined in the dynamic library");
         CPPADCG_ASSERT_KNOWN(_forwardOneSparsity != nullptr, "No forward one sparsity function defined in the dynamic library");
+        CPPADCG_ASSERT_KNOWN(ctx._model == this, "The evaluation context was created for a different model");
         CPPADCG_ASSERT_KNOWN(x.size() >= _n, "Invalid x size");
         CPPADCG_ASSERT_KNOWN(ty1.size() >= _m, "Invalid ty1 size");
         CPPADCG_ASSERT_KNOWN(_missingAtomicFunctions == 0, "Some atomic functions used by the compiled model have not been specified yet");
@@ -440,18 +659,18 @@ public:
         unsigned long const* pos;
         size_t nnz = 0;
 
-        _ty.resize(_m);
-        Base* compressed = &_ty[0];
+        ctx._compressed.resize(_m);
+        Base* compressed = &ctx._compressed[0];
 
-        _inHess[0] = x.data();
-        _out[0] = compressed;
+        ctx._inHess[0] = x.data();
+        ctx._out[0] = compressed;
 
         for (size_t ej = 0; ej < tx1Nnz; ej++) {
             size_t j = idx[ej];
             (*_forwardOneSparsity)(j, &pos, &nnz);
 
-            _inHess[1] = &tx1[ej];
-            int ret = (*_sparseForwardOne)(j, &_inHess[0], &_out[0], _atomicFuncArg);
+            ctx._inHess[1] = &tx1[ej];
+            int ret = (*_sparseForwardOne)(j, &ctx._inHess[0], &ctx._out[0], ctx._atomicFuncArg);
 
             CPPADCG_ASSERT_KNOWN(ret == 0, "First-order forward mode failed."); // generic failure
 
@@ -469,18 +688,27 @@ public:
                     ArrayView<const Base> ty,
                     ArrayView<Base> px,
                     ArrayView<const Base> py) override {
+        ReverseOne(*_ctx, tx, ty, px, py);
+    }
+
+    void ReverseOne(FunctorGenericModelContext<Base>& ctx,
+                    ArrayView<const Base> tx,
+                    ArrayView<const Base> ty,
+                    ArrayView<Base> px,
+                    ArrayView<const Base> py) const {
         const size_t k = 0;
         const size_t k1 = k + 1;
 
         CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
         CPPADCG_ASSERT_KNOWN(_reverseOne != nullptr, "No reverse one function defined in the dynamic library");
+        CPPADCG_ASSERT_KNOWN(ctx._model == this, "The evaluation context was created for a different model");
         CPPADCG_ASSERT_KNOWN(tx.size() >= k1 * _n, "Invalid tx size");
         CPPADCG_ASSERT_KNOWN(ty.size() >= k1 * _m, "Invalid ty size");
         CPPADCG_ASSERT_KNOWN(px.size() >= k1 * _n, "Invalid px size");
         CPPADCG_ASSERT_KNOWN(py.size() >= k1 * _m, "Invalid py size");
         CPPADCG_ASSERT_KNOWN(_missingAtomicFunctions == 0, "Some atomic functions used by the compiled model have not been specified yet");
 
-        int ret = (*_reverseOne)(tx.data(), ty.data(), px.data(), py.data(), _atomicFuncArg);
+        int ret = (*_reverseOne)(tx.data(), ty.data(), px.data(), py.data(), ctx._atomicFuncArg);
 
         CPPADCG_ASSERT_KNOWN(ret == 0, "First-order reverse mode failed.");
     }
@@ -492,9 +720,17 @@ public:
     void ReverseOne(ArrayView<const Base> x,
                     ArrayView<Base> px,
                     size_t pyNnz, const size_t idx[], const Base py[]) override {
+        ReverseOne(*_ctx, x, px, pyNnz, idx, py);
+    }
+
+    void ReverseOne(FunctorGenericModelContext<Base>& ctx,
+                    ArrayView<const Base> x,
+                    ArrayView<Base> px,
+                    size_t pyNnz, const size_t idx[], const Base py[]) const {
         CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
         CPPADCG_ASSERT_KNOWN(_sparseReverseOne != nullptr, "No sparse reverse one function defined in the dynamic library");
         CPPADCG_ASSERT_KNOWN(_reverseOneSparsity != nullptr, "No reverse one sparsity function defined in the dynamic library");
+        CPPADCG_ASSERT_KNOWN(ctx._model == this, "The evaluation context was created for a different model");
         CPPADCG_ASSERT_KNOWN(x.size() >= _n, "Invalid x size");
         CPPADCG_ASSERT_KNOWN(px.size() >= _n, "Invalid px size");
         CPPADCG_ASSERT_KNOWN(_missingAtomicFunctions == 0, "Some atomic functions used by the compiled model have not been specified yet");
@@ -506,18 +742,18 @@ public:
         unsigned long const* pos;
         size_t nnz = 0;
 
-        _px.resize(_n);
-        Base* compressed = &_px[0];
+        ctx._compressed.resize(_n);
+        Base* compressed = &ctx._compressed[0];
 
-        _inHess[0] = x.data();
-        _out[0] = compressed;
+        ctx._inHess[0] = x.data();
+        ctx._out[0] = compressed;
 
         for (size_t ei = 0; ei < pyNnz; ei++) {
             size_t i = idx[ei];
             (*_reverseOneSparsity)(i, &pos, &nnz);
 
-            _inHess[1] = &py[ei];
-            int ret = (*_sparseReverseOne)(i, &_inHess[0], &_out[0], _atomicFuncArg);
+            ctx._inHess[1] = &py[ei];
+            int ret = (*_sparseReverseOne)(i, &ctx._inHess[0], &ctx._out[0], ctx._atomicFuncArg);
 
             CPPADCG_ASSERT_KNOWN(ret == 0, "First-order reverse mode failed.");
 
@@ -535,19 +771,28 @@ public:
                     ArrayView<const Base> ty,
                     ArrayView<Base> px,
                     ArrayView<const Base> py) override {
+        ReverseTwo(*_ctx, tx, ty, px, py);
+    }
+
+    void ReverseTwo(FunctorGenericModelContext<Base>& ctx,
+                    ArrayView<const Base> tx,
+                    ArrayView<const Base> ty,
+                    ArrayView<Base> px,
+                    ArrayView<const Base> py) const {
         const size_t k = 1;
         const size_t k1 = k + 1;
 
         CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
         CPPADCG_ASSERT_KNOWN(_reverseTwo != nullptr, "No sparse reverse two function defined in the dynamic library");
-        CPPADCG_ASSERT_KNOWN(_in.size() == 1, "The number of independent variable arrays is higher than 1");
+        CPPADCG_ASSERT_KNOWN(ctx._model == this, "The evaluation context was created for a different model");
+        CPPADCG_ASSERT_KNOWN(_inSize == 1, "The number of independent variable arrays is higher than 1");
         CPPADCG_ASSERT_KNOWN(tx.size() >= k1 * _n, "Invalid tx size");
         CPPADCG_ASSERT_KNOWN(ty.size() >= k1 * _m, "Invalid ty size");
         CPPADCG_ASSERT_KNOWN(px.size() >= k1 * _n, "Invalid px size");
         CPPADCG_ASSERT_KNOWN(py.size() >= k1 * _m, "Invalid py size");
         CPPADCG_ASSERT_KNOWN(_missingAtomicFunctions == 0, "Some atomic functions used by the compiled model have not been specified yet");
 
-        int ret = (*_reverseTwo)(tx.data(), ty.data(), px.data(), py.data(), _atomicFuncArg);
+        int ret = (*_reverseTwo)(tx.data(), ty.data(), px.data(), py.data(), ctx._atomicFuncArg);
 
         CPPADCG_ASSERT_KNOWN(ret != 1, "Second-order reverse mode failed: py[2*i] (i=0...m) must be zero.");
         CPPADCG_ASSERT_KNOWN(ret == 0, "Second-order reverse mode failed.");
@@ -561,9 +806,18 @@ public:
                     size_t tx1Nnz, const size_t idx[], const Base tx1[],
                     ArrayView<Base> px2,
                     ArrayView<const Base> py2) override {
+        ReverseTwo(*_ctx, x, tx1Nnz, idx, tx1, px2, py2);
+    }
+
+    void ReverseTwo(FunctorGenericModelContext<Base>& ctx,
+                    ArrayView<const Base> x,
+                    size_t tx1Nnz, const size_t idx[], const Base tx1[],
+                    ArrayView<Base> px2,
+                    ArrayView<const Base> py2) const {
         CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
         CPPADCG_ASSERT_KNOWN(_sparseReverseTwo != nullptr, "No sparse reverse two function defined in the dynamic library");
         CPPADCG_ASSERT_KNOWN(_reverseTwoSparsity != nullptr, "No reverse two sparsity function defined in the dynamic library");
+        CPPADCG_ASSERT_KNOWN(ctx._model == this, "The evaluation context was created for a different model");
         CPPADCG_ASSERT_KNOWN(x.size() >= _n, "Invalid x size");
         CPPADCG_ASSERT_KNOWN(px2.size() >= _n, "Invalid px2 size");
         CPPADCG_ASSERT_KNOWN(py2.size() >= _m, "Invalid py2 size");
@@ -576,20 +830,20 @@ public:
         unsigned long const* pos;
         size_t nnz = 0;
 
-        _px.resize(_n);
-        Base* compressed = &_px[0];
+        ctx._compressed.resize(_n);
+        Base* compressed = &ctx._compressed[0];
 
         const Base * in[3];
         in[0] = x.data();
         in[2] = py2.data();
-        _out[0] = compressed;
+        ctx._out[0] = compressed;
 
         for (size_t ej = 0; ej < tx1Nnz; ej++) {
             size_t j = idx[ej];
             (*_reverseTwoSparsity)(j, &pos, &nnz);
 
             in[1] = &tx1[ej];
-            int ret = (*_sparseReverseTwo)(j, &in[0], &_out[0], _atomicFuncArg);
+            int ret = (*_sparseReverseTwo)(j, &in[0], &ctx._out[0], ctx._atomicFuncArg);
 
             CPPADCG_ASSERT_KNOWN(ret == 0, "Second-order reverse mode failed."); // generic failure
 
@@ -607,9 +861,16 @@ public:
 
     void SparseJacobian(ArrayView<const Base> x,
                         ArrayView<Base> jac) override {
+        SparseJacobian(*_ctx, x, jac);
+    }
+
+    void SparseJacobian(FunctorGenericModelContext<Base>& ctx,
+                        ArrayView<const Base> x,
+                        ArrayView<Base> jac) const {
         CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
         CPPADCG_ASSERT_KNOWN(_sparseJacobian != nullptr, "No sparse jacobian function defined in the dynamic library");
-        CPPADCG_ASSERT_KNOWN(_in.size() == 1, "The number of independent variable arrays is higher than 1,"
+        CPPADCG_ASSERT_KNOWN(ctx._model == this, "The evaluation context was created for a different model");
+        CPPADCG_ASSERT_KNOWN(_inSize == 1, "The number of independent variable arrays is higher than 1,"
                              " please use the variable size methods");
         CPPADCG_ASSERT_KNOWN(x.size() == _n, "Invalid independent array size");
         CPPADCG_ASSERT_KNOWN(jac.size() == _m * _n, "Invalid Jacobian size");
@@ -620,29 +881,135 @@ public:
         unsigned long nnz;
         (*_jacobianSparsity)(&row, &col, &nnz);
 
-        CppAD::vector<Base> compressed(nnz);
+        ctx._compressed.resize(nnz);
 
         if (nnz > 0) {
-            _in[0] = x.data();
-            _out[0] = &compressed[0];
+            ctx._in[0] = x.data();
+            ctx._out[0] = &ctx._compressed[0];
 
-            (*_sparseJacobian)(&_in[0], &_out[0], _atomicFuncArg);
+            (*_sparseJacobian)(&ctx._in[0], &ctx._out[0], ctx._atomicFuncArg);
         }
 
-        createDenseFromSparse(compressed,
-                              _m, _n,
-                              row, col,
-                              nnz,
-                              jac);
+        _jacDensePlan.scatter(ctx._compressed.data(), jac);
+    }
+
+    /**
+     * Creates a plan to place the sparse Jacobian elements in a compressed
+     * sparse matrix (CSR or CSC) with the same elements as the Jacobian.
+     *
+     * @param order the storage order of the compressed sparse matrix
+     * @param outer the outer index array which will be created
+     *              (row pointers for CSR, column pointers for CSC)
+     * @param inner the inner index array which will be created
+     *              (column indexes for CSR, row indexes for CSC)
+     * @return the plan to be used with SparseJacobian()
+     */
+    template<class Index>
+    SparseScatterPlan createJacobianScatterPlan(SparseStorageOrder order,
+                                                std::vector<Index>& outer,
+                                                std::vector<Index>& inner) const {
+        CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
+        CPPADCG_ASSERT_KNOWN(_jacobianSparsity != nullptr, "No Jacobian sparsity function defined in the dynamic library");
+
+        unsigned long const* row, *col;
+        unsigned long nnz;
+        (*_jacobianSparsity)(&row, &col, &nnz);
+
+        return SparseScatterPlan::createCompressed(order, _m, _n, row, col, nnz, outer, inner);
+    }
+
+    /**
+     * Creates a plan to place the sparse Jacobian elements in a compressed
+     * sparse matrix (CSR or CSC) with a fixed structure provided by the user
+     * (which must contain all Jacobian elements).
+     *
+     * @param order the storage order of the compressed sparse matrix
+     * @param outer the outer index array (row pointers for CSR, column
+     *              pointers for CSC)
+     * @param inner the inner index array (column indexes for CSR, row
+     *              indexes for CSC)
+     * @return the plan to be used with SparseJacobian()
+     */
+    template<class Index>
+    SparseScatterPlan createJacobianScatterPlan(SparseStorageOrder order,
+                                                ArrayView<const Index> outer,
+                                                ArrayView<const Index> inner) const {
+        CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
+        CPPADCG_ASSERT_KNOWN(_jacobianSparsity != nullptr, "No Jacobian sparsity function defined in the dynamic library");
+        CPPADCG_ASSERT_KNOWN(outer.size() == (order == SparseStorageOrder::ROW_MAJOR ? _m : _n) + 1, "Invalid outer index array size");
+
+        unsigned long const* row, *col;
+        unsigned long nnz;
+        (*_jacobianSparsity)(&row, &col, &nnz);
+
+        return SparseScatterPlan::createCompressed(order, row, col, nnz, outer, inner);
+    }
+
+    /**
+     * Determines the sparse Jacobian and places its elements in another
+     * array (e.g. the values of a compressed sparse matrix) using a plan
+     * previously created for this model.
+     *
+     * @param x The independent variable vector
+     * @param plan the plan created with createJacobianScatterPlan()
+     * @param values the destination array
+     */
+    void SparseJacobian(ArrayView<const Base> x,
+                        const SparseScatterPlan& plan,
+                        ArrayView<Base> values) {
+        SparseJacobian(*_ctx, x, plan, values);
+    }
+
+    void SparseJacobian(FunctorGenericModelContext<Base>& ctx,
+                        ArrayView<const Base> x,
+                        const SparseScatterPlan& plan,
+                        ArrayView<Base> values) const {
+        CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
+        CPPADCG_ASSERT_KNOWN(_sparseJacobian != nullptr, "No sparse Jacobian function defined in the dynamic library");
+        CPPADCG_ASSERT_KNOWN(ctx._model == this, "The evaluation context was created for a different model");
+        CPPADCG_ASSERT_KNOWN(_inSize == 1, "The number of independent variable arrays is higher than 1,"
+                             " please use the variable size methods");
+        CPPADCG_ASSERT_KNOWN(x.size() == _n, "Invalid independent array size");
+        CPPADCG_ASSERT_KNOWN(plan.getSourceSize() == _jacDensePlan.getSourceSize(), "Invalid scatter plan");
+        CPPADCG_ASSERT_KNOWN(_missingAtomicFunctions == 0, "Some atomic functions used by the compiled model have not been specified yet");
+
+        ctx._in[0] = x.data();
+
+        if (plan.isIdentity()) {
+            // the elements can be placed directly in the destination
+            CPPADCG_ASSERT_KNOWN(values.size() == plan.getDestinationSize(), "Invalid destination array size");
+            if (values.size() > 0) {
+                ctx._out[0] = values.data();
+                (*_sparseJacobian)(&ctx._in[0], &ctx._out[0], ctx._atomicFuncArg);
+            }
+            return;
+        }
+
+        ctx._compressed.resize(plan.getSourceSize());
+        if (ctx._compressed.size() > 0) {
+            ctx._out[0] = &ctx._compressed[0];
+            (*_sparseJacobian)(&ctx._in[0], &ctx._out[0], ctx._atomicFuncArg);
+        }
+
+        plan.scatter(ctx._compressed.data(), values);
     }
 
     void SparseJacobian(const std::vector<Base> &x,
                         std::vector<Base>& jac,
                         std::vector<size_t>& row,
                         std::vector<size_t>& col) override {
+        SparseJacobian(*_ctx, x, jac, row, col);
+    }
+
+    void SparseJacobian(FunctorGenericModelContext<Base>& ctx,
+                        const std::vector<Base> &x,
+                        std::vector<Base>& jac,
+                        std::vector<size_t>& row,
+                        std::vector<size_t>& col) const {
         CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
         CPPADCG_ASSERT_KNOWN(_sparseJacobian != nullptr, "No sparse Jacobian function defined in the dynamic library");
-        CPPADCG_ASSERT_KNOWN(_in.size() == 1, "The number of independent variable arrays is higher than 1,"
+        CPPADCG_ASSERT_KNOWN(ctx._model == this, "The evaluation context was created for a different model");
+        CPPADCG_ASSERT_KNOWN(_inSize == 1, "The number of independent variable arrays is higher than 1,"
                              " please use the variable size methods");
         CPPADCG_ASSERT_KNOWN(_missingAtomicFunctions == 0, "Some atomic functions used by the compiled model have not been specified yet");
 
@@ -656,10 +1023,10 @@ public:
         col.resize(nnz);
 
         if (nnz > 0) {
-            _in[0] = &x[0];
-            _out[0] = &jac[0];
+            ctx._in[0] = &x[0];
+            ctx._out[0] = &jac[0];
 
-            (*_sparseJacobian)(&_in[0], &_out[0], _atomicFuncArg);
+            (*_sparseJacobian)(&ctx._in[0], &ctx._out[0], ctx._atomicFuncArg);
             std::copy(drow, drow + nnz, row.begin());
             std::copy(dcol, dcol + nnz, col.begin());
         }
@@ -669,9 +1036,18 @@ public:
                         ArrayView<Base> jac,
                         size_t const** row,
                         size_t const** col) override {
+        SparseJacobian(*_ctx, x, jac, row, col);
+    }
+
+    void SparseJacobian(FunctorGenericModelContext<Base>& ctx,
+                        ArrayView<const Base> x,
+                        ArrayView<Base> jac,
+                        size_t const** row,
+                        size_t const** col) const {
         CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
         CPPADCG_ASSERT_KNOWN(_sparseJacobian != nullptr, "No sparse Jacobian function defined in the dynamic library");
-        CPPADCG_ASSERT_KNOWN(_in.size() == 1, "The number of independent variable arrays is higher than 1,"
+        CPPADCG_ASSERT_KNOWN(ctx._model == this, "The evaluation context was created for a different model");
+        CPPADCG_ASSERT_KNOWN(_inSize == 1, "The number of independent variable arrays is higher than 1,"
                              " please use the variable size methods");
         CPPADCG_ASSERT_KNOWN(x.size() == _n, "Invalid independent array size");
         CPPADCG_ASSERT_KNOWN(_missingAtomicFunctions == 0, "Some atomic functions used by the compiled model have not been specified yet");
@@ -685,10 +1061,10 @@ public:
         *col = dcol;
 
         if (nnz > 0) {
-            _in[0] = x.data();
-            _out[0] = jac.data();
+            ctx._in[0] = x.data();
+            ctx._out[0] = jac.data();
 
-            (*_sparseJacobian)(&_in[0], &_out[0], _atomicFuncArg);
+            (*_sparseJacobian)(&ctx._in[0], &ctx._out[0], ctx._atomicFuncArg);
         }
     }
 
@@ -696,9 +1072,18 @@ public:
                         ArrayView<Base> jac,
                         size_t const** row,
                         size_t const** col) override {
+        SparseJacobian(*_ctx, x, jac, row, col);
+    }
+
+    void SparseJacobian(FunctorGenericModelContext<Base>& ctx,
+                        const std::vector<const Base*>& x,
+                        ArrayView<Base> jac,
+                        size_t const** row,
+                        size_t const** col) const {
         CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
         CPPADCG_ASSERT_KNOWN(_sparseJacobian != nullptr, "No sparse Jacobian function defined in the dynamic library");
-        CPPADCG_ASSERT_KNOWN(_in.size() == x.size(), "The number of independent variable arrays is invalid");
+        CPPADCG_ASSERT_KNOWN(ctx._model == this, "The evaluation context was created for a different model");
+        CPPADCG_ASSERT_KNOWN(_inSize == x.size(), "The number of independent variable arrays is invalid");
         CPPADCG_ASSERT_KNOWN(_missingAtomicFunctions == 0, "Some atomic functions used by the compiled model have not been specified yet");
 
         unsigned long const* drow;
@@ -710,9 +1095,9 @@ public:
         *col = dcol;
 
         if (nnz > 0) {
-            _out[0] = jac.data();
+            ctx._out[0] = jac.data();
 
-            (*_sparseJacobian)(&x[0], &_out[0], _atomicFuncArg);
+            (*_sparseJacobian)(&x[0], &ctx._out[0], ctx._atomicFuncArg);
         }
     }
 
@@ -725,12 +1110,20 @@ public:
     void SparseHessian(ArrayView<const Base> x,
                        ArrayView<const Base> w,
                        ArrayView<Base> hess) override {
+        SparseHessian(*_ctx, x, w, hess);
+    }
+
+    void SparseHessian(FunctorGenericModelContext<Base>& ctx,
+                       ArrayView<const Base> x,
+                       ArrayView<const Base> w,
+                       ArrayView<Base> hess) const {
         CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
         CPPADCG_ASSERT_KNOWN(_sparseHessian != nullptr, "No sparse Hessian function defined in the dynamic library");
+        CPPADCG_ASSERT_KNOWN(ctx._model == this, "The evaluation context was created for a different model");
         CPPADCG_ASSERT_KNOWN(x.size() == _n, "Invalid independent array size");
         CPPADCG_ASSERT_KNOWN(w.size() == _m, "Invalid multiplier array size");
         // CPPADCG_ASSERT_KNOWN(hess.size() == _n * _n, "Invalid Hessian size");
-        CPPADCG_ASSERT_KNOWN(_in.size() == 1, "The number of independent variable arrays is higher than 1,"
+        CPPADCG_ASSERT_KNOWN(_inSize == 1, "The number of independent variable arrays is higher than 1,"
                              " please use the variable size methods");
         CPPADCG_ASSERT_KNOWN(_missingAtomicFunctions == 0, "Some atomic functions used by the compiled model have not been specified yet");
 
@@ -738,20 +1131,122 @@ public:
         unsigned long nnz;
         (*_hessianSparsity)(&row, &col, &nnz);
 
-        CppAD::vector<Base> compressed(nnz);
+        ctx._compressed.resize(nnz);
         if (nnz > 0) {
-            _inHess[0] = x.data();
-            _inHess[1] = w.data();
-            _out[0] = &compressed[0];
+            ctx._inHess[0] = x.data();
+            ctx._inHess[1] = w.data();
+            ctx._out[0] = &ctx._compressed[0];
 
-            (*_sparseHessian)(&_inHess[0], &_out[0], _atomicFuncArg);
+            (*_sparseHessian)(&ctx._inHess[0], &ctx._out[0], ctx._atomicFuncArg);
         }
 
-        createDenseFromSparse(compressed,
-                              _n, _n,
-                              row, col,
-                              nnz,
-                              hess);
+        _hessDensePlan.scatter(ctx._compressed.data(), hess);
+    }
+
+    /**
+     * Creates a plan to place the sparse Hessian elements in a compressed
+     * sparse matrix (CSR or CSC) with the same elements as the Hessian.
+     *
+     * @param order the storage order of the compressed sparse matrix
+     * @param outer the outer index array which will be created
+     *              (row pointers for CSR, column pointers for CSC)
+     * @param inner the inner index array which will be created
+     *              (column indexes for CSR, row indexes for CSC)
+     * @return the plan to be used with SparseHessian()
+     */
+    template<class Index>
+    SparseScatterPlan createHessianScatterPlan(SparseStorageOrder order,
+                                               std::vector<Index>& outer,
+                                               std::vector<Index>& inner) const {
+        CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
+        CPPADCG_ASSERT_KNOWN(_hessianSparsity != nullptr, "No Hessian sparsity function defined in the dynamic library");
+
+        unsigned long const* row, *col;
+        unsigned long nnz;
+        (*_hessianSparsity)(&row, &col, &nnz);
+
+        return SparseScatterPlan::createCompressed(order, _n, _n, row, col, nnz, outer, inner);
+    }
+
+    /**
+     * Creates a plan to place the sparse Hessian elements in a compressed
+     * sparse matrix (CSR or CSC) with a fixed structure provided by the user
+     * (which must contain all Hessian elements).
+     *
+     * @param order the storage order of the compressed sparse matrix
+     * @param outer the outer index array (row pointers for CSR, column
+     *              pointers for CSC)
+     * @param inner the inner index array (column indexes for CSR, row
+     *              indexes for CSC)
+     * @return the plan to be used with SparseHessian()
+     */
+    template<class Index>
+    SparseScatterPlan createHessianScatterPlan(SparseStorageOrder order,
+                                               ArrayView<const Index> outer,
+                                               ArrayView<const Index> inner) const {
+        CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
+        CPPADCG_ASSERT_KNOWN(_hessianSparsity != nullptr, "No Hessian sparsity function defined in the dynamic library");
+        CPPADCG_ASSERT_KNOWN(outer.size() == _n + 1, "Invalid outer index array size");
+
+        unsigned long const* row, *col;
+        unsigned long nnz;
+        (*_hessianSparsity)(&row, &col, &nnz);
+
+        return SparseScatterPlan::createCompressed(order, row, col, nnz, outer, inner);
+    }
+
+    /**
+     * Determines the sparse Hessian and places its elements in another
+     * array (e.g. the values of a compressed sparse matrix) using a plan
+     * previously created for this model.
+     *
+     * @param x The independent variable vector
+     * @param w The equation multipliers
+     * @param plan the plan created with createHessianScatterPlan()
+     * @param values the destination array
+     */
+    void SparseHessian(ArrayView<const Base> x,
+                       ArrayView<const Base> w,
+                       const SparseScatterPlan& plan,
+                       ArrayView<Base> values) {
+        SparseHessian(*_ctx, x, w, plan, values);
+    }
+
+    void SparseHessian(FunctorGenericModelContext<Base>& ctx,
+                       ArrayView<const Base> x,
+                       ArrayView<const Base> w,
+                       const SparseScatterPlan& plan,
+                       ArrayView<Base> values) const {
+        CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
+        CPPADCG_ASSERT_KNOWN(_sparseHessian != nullptr, "No sparse Hessian function defined in the dynamic library");
+        CPPADCG_ASSERT_KNOWN(ctx._model == this, "The evaluation context was created for a different model");
+        CPPADCG_ASSERT_KNOWN(_inSize == 1, "The number of independent variable arrays is higher than 1,"
+                             " please use the variable size methods");
+        CPPADCG_ASSERT_KNOWN(x.size() == _n, "Invalid independent array size");
+        CPPADCG_ASSERT_KNOWN(w.size() == _m, "Invalid multiplier array size");
+        CPPADCG_ASSERT_KNOWN(plan.getSourceSize() == _hessDensePlan.getSourceSize(), "Invalid scatter plan");
+        CPPADCG_ASSERT_KNOWN(_missingAtomicFunctions == 0, "Some atomic functions used by the compiled model have not been specified yet");
+
+        ctx._inHess[0] = x.data();
+        ctx._inHess[1] = w.data();
+
+        if (plan.isIdentity()) {
+            // the elements can be placed directly in the destination
+            CPPADCG_ASSERT_KNOWN(values.size() == plan.getDestinationSize(), "Invalid destination array size");
+            if (values.size() > 0) {
+                ctx._out[0] = values.data();
+                (*_sparseHessian)(&ctx._inHess[0], &ctx._out[0], ctx._atomicFuncArg);
+            }
+            return;
+        }
+
+        ctx._compressed.resize(plan.getSourceSize());
+        if (ctx._compressed.size() > 0) {
+            ctx._out[0] = &ctx._compressed[0];
+            (*_sparseHessian)(&ctx._inHess[0], &ctx._out[0], ctx._atomicFuncArg);
+        }
+
+        plan.scatter(ctx._compressed.data(), values);
     }
 
     void SparseHessian(const std::vector<Base> &x,
@@ -759,11 +1254,21 @@ public:
                        std::vector<Base>& hess,
                        std::vector<size_t>& row,
                        std::vector<size_t>& col) override {
+        SparseHessian(*_ctx, x, w, hess, row, col);
+    }
+
+    void SparseHessian(FunctorGenericModelContext<Base>& ctx,
+                       const std::vector<Base> &x,
+                       const std::vector<Base> &w,
+                       std::vector<Base>& hess,
+                       std::vector<size_t>& row,
+                       std::vector<size_t>& col) const {
         CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
         CPPADCG_ASSERT_KNOWN(_sparseHessian != nullptr, "No sparse Hessian function defined in the dynamic library");
+        CPPADCG_ASSERT_KNOWN(ctx._model == this, "The evaluation context was created for a different model");
         CPPADCG_ASSERT_KNOWN(x.size() == _n, "Invalid independent array size");
         CPPADCG_ASSERT_KNOWN(w.size() == _m, "Invalid multiplier array size");
-        CPPADCG_ASSERT_KNOWN(_in.size() == 1, "The number of independent variable arrays is higher than 1,"
+        CPPADCG_ASSERT_KNOWN(_inSize == 1, "The number of independent variable arrays is higher than 1,"
                              " please use the variable size methods");
         CPPADCG_ASSERT_KNOWN(_missingAtomicFunctions == 0, "Some atomic functions used by the compiled model have not been specified yet");
 
@@ -779,11 +1284,11 @@ public:
             std::copy(drow, drow + nnz, row.begin());
             std::copy(dcol, dcol + nnz, col.begin());
 
-            _inHess[0] = &x[0];
-            _inHess[1] = &w[0];
-            _out[0] = &hess[0];
+            ctx._inHess[0] = &x[0];
+            ctx._inHess[1] = &w[0];
+            ctx._out[0] = &hess[0];
 
-            (*_sparseHessian)(&_inHess[0], &_out[0], _atomicFuncArg);
+            (*_sparseHessian)(&ctx._inHess[0], &ctx._out[0], ctx._atomicFuncArg);
         }
     }
 
@@ -792,9 +1297,19 @@ public:
                        ArrayView<Base> hess,
                        size_t const** row,
                        size_t const** col) override {
+        SparseHessian(*_ctx, x, w, hess, row, col);
+    }
+
+    void SparseHessian(FunctorGenericModelContext<Base>& ctx,
+                       ArrayView<const Base> x,
+                       ArrayView<const Base> w,
+                       ArrayView<Base> hess,
+                       size_t const** row,
+                       size_t const** col) const {
         CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
         CPPADCG_ASSERT_KNOWN(_sparseHessian != nullptr, "No sparse Hessian function defined in the dynamic library");
-        CPPADCG_ASSERT_KNOWN(_in.size() == 1, "The number of independent variable arrays is higher than 1,"
+        CPPADCG_ASSERT_KNOWN(ctx._model == this, "The evaluation context was created for a different model");
+        CPPADCG_ASSERT_KNOWN(_inSize == 1, "The number of independent variable arrays is higher than 1,"
                              " please use the variable size methods");
         CPPADCG_ASSERT_KNOWN(x.size() == _n, "Invalid independent array size");
         CPPADCG_ASSERT_KNOWN(w.size() == _m, "Invalid multiplier array size");
@@ -808,11 +1323,11 @@ public:
         *col = dcol;
 
         if (nnz > 0) {
-            _inHess[0] = x.data();
-            _inHess[1] = w.data();
-            _out[0] = hess.data();
+            ctx._inHess[0] = x.data();
+            ctx._inHess[1] = w.data();
+            ctx._out[0] = hess.data();
 
-            (*_sparseHessian)(&_inHess[0], &_out[0], _atomicFuncArg);
+            (*_sparseHessian)(&ctx._inHess[0], &ctx._out[0], ctx._atomicFuncArg);
         }
     }
 
@@ -821,9 +1336,19 @@ public:
                        ArrayView<Base> hess,
                        size_t const** row,
                        size_t const** col) override {
+        SparseHessian(*_ctx, x, w, hess, row, col);
+    }
+
+    void SparseHessian(FunctorGenericModelContext<Base>& ctx,
+                       const std::vector<const Base*>& x,
+                       ArrayView<const Base> w,
+                       ArrayView<Base> hess,
+                       size_t const** row,
+                       size_t const** col) const {
         CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
         CPPADCG_ASSERT_KNOWN(_sparseHessian != nullptr, "No sparse Hessian function defined in the dynamic library");
-        CPPADCG_ASSERT_KNOWN(_in.size() == x.size(), "The number of independent variable arrays is invalid");
+        CPPADCG_ASSERT_KNOWN(ctx._model == this, "The evaluation context was created for a different model");
+        CPPADCG_ASSERT_KNOWN(_inSize == x.size(), "The number of independent variable arrays is invalid");
         CPPADCG_ASSERT_KNOWN(w.size() == _m, "Invalid multiplier array size");
         CPPADCG_ASSERT_KNOWN(_missingAtomicFunctions == 0, "Some atomic functions used by the compiled model have not been specified yet");
 
@@ -835,14 +1360,89 @@ public:
         *col = dcol;
 
         if (nnz > 0) {
-            std::copy(x.begin(), x.end(), _inHess.begin());
-            _inHess.back() = w.data(); // the index might not be 1
-            _out[0] = hess.data();
+            std::copy(x.begin(), x.end(), ctx._inHess.begin());
+            ctx._inHess.back() = w.data(); // the index might not be 1
+            ctx._out[0] = hess.data();
 
-            (*_sparseHessian)(&_inHess[0], &_out[0], _atomicFuncArg);
+            (*_sparseHessian)(&ctx._inHess[0], &ctx._out[0], ctx._atomicFuncArg);
         }
     }
 
+    size_t getNewtonSolverBlockCount() const override {
+        CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
+        if (_newtonBlocks == nullptr)
+            return 0;
+
+        unsigned long n;
+        (*_newtonBlocks)(&n);
+        return n;
+    }
+
+    void getNewtonSolverBlock(size_t block,
+                              std::vector<size_t>& equations,
+                              std::vector<size_t>& variables) const override {
+        CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
+        CPPADCG_ASSERT_KNOWN(_newtonBlock != nullptr, "No Newton solver defined in the dynamic library");
+
+        unsigned long const* eqs;
+        unsigned long const* vars;
+        unsigned long size;
+        (*_newtonBlock)(block, &eqs, &vars, &size);
+        CPPADCG_ASSERT_KNOWN(eqs != nullptr, "Invalid Newton solver block index");
+
+        equations.assign(eqs, eqs + size);
+        variables.assign(vars, vars + size);
+    }
+
+    NewtonSolverStatus NewtonSolve(size_t block,
+                                   ArrayView<Base> x,
+                                   ArrayView<const Base> p,
+                                   size_t maxIterations,
+                                   Base tolerance,
+                                   size_t* iterations = nullptr) override {
+        return NewtonSolve(*_ctx, block, x, p, maxIterations, tolerance, iterations);
+    }
+
+    /**
+     * Determines the variables of a block of algebraic equations with the
+     * Newton solver generated in the dynamic library.
+     * The remaining variables are kept constant.
+     *
+     * @param ctx the evaluation context
+     * @param block the block index
+     * @param x the independent variables (the block variables are used as
+     *          the initial guess and replaced by the solution)
+     * @param p the runtime parameters (it can be empty if the model does
+     *          not have parameters)
+     * @param maxIterations the maximum number of Newton iterations
+     * @param tolerance the maximum absolute residual of the block equations
+     * @param iterations if not null it will hold the number of iterations
+     * @return whether or not the solver converged
+     */
+    NewtonSolverStatus NewtonSolve(FunctorGenericModelContext<Base>& ctx,
+                                   size_t block,
+                                   ArrayView<Base> x,
+                                   ArrayView<const Base> p,
+                                   size_t maxIterations,
+                                   Base tolerance,
+                                   size_t* iterations = nullptr) const {
+        CPPADCG_ASSERT_KNOWN(_isLibraryReady, "Model library is not ready (possibly closed)");
+        CPPADCG_ASSERT_KNOWN(_newtonSolve != nullptr, "No Newton solver defined in the dynamic library");
+        CPPADCG_ASSERT_KNOWN(ctx._model == this, "The evaluation context was created for a different model");
+        CPPADCG_ASSERT_KNOWN(x.size() == _n, "Invalid independent array size");
+        CPPADCG_ASSERT_KNOWN(p.size() == _np, "Invalid parameter array size");
+        CPPADCG_ASSERT_KNOWN(_missingAtomicFunctions == 0, "Some atomic functions used by the compiled model have not been specified yet");
+
+        unsigned long it = 0;
+        int ret = (*_newtonSolve)(block, x.data(), p.data(), maxIterations, tolerance, &it, ctx._atomicFuncArg);
+        CPPADCG_ASSERT_KNOWN(ret >= 0, "Invalid Newton solver block index");
+
+        if (iterations != nullptr)
+            *iterations = it;
+
+        return NewtonSolverStatus(ret);
+    }
+
 protected:
 
     /**
@@ -855,7 +1455,9 @@ protected:
         _name(name),
         _m(0),
         _n(0),
-        _atomicFuncArg{nullptr}, // not really required
+        _np(0),
+        _inSize(0),
+        _outSize(0),
         _missingAtomicFunctions(0),
         _zero(nullptr),
         _forwardOne(nullptr),
@@ -873,7 +1475,12 @@ protected:
         _reverseTwoSparsity(nullptr),
         _jacobianSparsity(nullptr),
         _hessianSparsity(nullptr),
-        _hessianSparsity2(nullptr) {
+        _hessianSparsity2(nullptr),
+        _jacobianSparsityCompressed(nullptr),
+        _hessianSparsityCompressed(nullptr),
+        _newtonSolve(nullptr),
+        _newtonBlocks(nullptr),
+        _newtonBlock(nullptr) {
 
     }
 
@@ -883,6 +1490,8 @@ protected:
 
         // load functions from the dynamic library
         loadFunctions();
+
+        _ctx = createContext();
     }
 
     virtual void* loadFunction(const std::string& functionName,
@@ -905,9 +1514,8 @@ protected:
         unsigned int outSize = 0;
         (*infoFunc)(&dynamicLibBaseName, &_m, &_n, &inSize, &outSize);
 
-        _in.resize(inSize);
-        _inHess.resize(inSize + 1);
-        _out.resize(outSize);
+        _inSize = inSize;
+        _outSize = outSize;
 
         CPPADCG_ASSERT_KNOWN(local == std::string(dynamicLibBaseName),
                              (std::string("Invalid data type in dynamic library. Expected '") + local
@@ -917,6 +1525,18 @@ protected:
         CPPADCG_ASSERT_KNOWN(outSize > 0,
                              "Invalid dimension received from the dynamic library.");
 
+        /**
+         * Runtime parameters (not available in libraries created by older versions)
+         */
+        void (*paramCountFunc)(unsigned long*);
+        paramCountFunc = reinterpret_cast<decltype(paramCountFunc)>(loadFunction(_name + "_" + ModelCSourceGen<Base>::FUNCTION_PARAMETER_COUNT, false));
+
+        unsigned long np = 0;
+        if (paramCountFunc != nullptr) {
+            (*paramCountFunc)(&np);
+        }
+        _np = np;
+
         _isLibraryReady = true;
     }
 
@@ -938,7 +1558,12 @@ protected:
         _jacobianSparsity = reinterpret_cast<decltype(_jacobianSparsity)>(loadFunction(_name + "_" + ModelCSourceGen<Base>::FUNCTION_JACOBIAN_SPARSITY, false));
         _hessianSparsity = reinterpret_cast<decltype(_hessianSparsity)>(loadFunction(_name + "_" + ModelCSourceGen<Base>::FUNCTION_HESSIAN_SPARSITY, false));
         _hessianSparsity2 = reinterpret_cast<decltype(_hessianSparsity2)>(loadFunction(_name + "_" + ModelCSourceGen<Base>::FUNCTION_HESSIAN_SPARSITY2, false));
+        _jacobianSparsityCompressed = reinterpret_cast<decltype(_jacobianSparsityCompressed)>(loadFunction(_name + "_" + ModelCSourceGen<Base>::FUNCTION_JACOBIAN_SPARSITY_COMPRESSED, false));
+        _hessianSparsityCompressed = reinterpret_cast<decltype(_hessianSparsityCompressed)>(loadFunction(_name + "_" + ModelCSourceGen<Base>::FUNCTION_HESSIAN_SPARSITY_COMPRESSED, false));
         _atomicFunctions = reinterpret_cast<decltype(_atomicFunctions)>(loadFunction(_name + "_" + ModelCSourceGen<Base>::FUNCTION_ATOMIC_FUNC_NAMES, true));
+        _newtonSolve = reinterpret_cast<decltype(_newtonSolve)>(loadFunction(_name + "_" + ModelCSourceGen<Base>::FUNCTION_NEWTON_SOLVE, false));
+        _newtonBlocks = reinterpret_cast<decltype(_newtonBlocks)>(loadFunction(_name + "_" + ModelCSourceGen<Base>::FUNCTION_NEWTON_BLOCKS, false));
+        _newtonBlock = reinterpret_cast<decltype(_newtonBlock)>(loadFunction(_name + "_" + ModelCSourceGen<Base>::FUNCTION_NEWTON_BLOCK, false));
 
         CPPADCG_ASSERT_KNOWN((_sparseForwardOne == nullptr) == (_forwardOneSparsity == nullptr), "Missing functions in the dynamic library");
         CPPADCG_ASSERT_KNOWN((_sparseForwardOne == nullptr) == (_forwardOne == nullptr), "Missing functions in the dynamic library");
@@ -948,6 +1573,8 @@ protected:
         CPPADCG_ASSERT_KNOWN((_sparseReverseTwo == nullptr) == (_reverseTwo == nullptr), "Missing functions in the dynamic library");
         CPPADCG_ASSERT_KNOWN((_sparseJacobian == nullptr) || (_jacobianSparsity != nullptr), "Missing functions in the dynamic library");
         CPPADCG_ASSERT_KNOWN((_sparseHessian == nullptr) || (_hessianSparsity != nullptr), "Missing functions in the dynamic library");
+        CPPADCG_ASSERT_KNOWN((_newtonSolve == nullptr) == (_newtonBlocks == nullptr), "Missing functions in the dynamic library");
+        CPPADCG_ASSERT_KNOWN((_newtonSolve == nullptr) == (_newtonBlock == nullptr), "Missing functions in the dynamic library");
 
         /**
          * Prepare the atomic functions argument
@@ -961,11 +1588,47 @@ protected:
             _atomicNames[i] = std::string(names[i]);
         }
 
-        _atomicFuncArg.libModel = this;
-        _atomicFuncArg.forward = &atomicForward;
-        _atomicFuncArg.reverse = &atomicReverse;
-
         _missingAtomicFunctions = n;
+
+        /**
+         * Atomic functions called directly by the compiled code
+         * (other models in the same library)
+         */
+        _directAtomic.assign(n, false);
+
+        void (*directAtomicFunctions)(const char*** names,
+                                      unsigned long* n);
+        directAtomicFunctions = reinterpret_cast<decltype(directAtomicFunctions)>(loadFunction(_name + "_" + ModelCSourceGen<Base>::FUNCTION_DIRECT_ATOMIC_FUNC_NAMES, false));
+        if (directAtomicFunctions != nullptr) {
+            const char** directNames;
+            unsigned long nDirect;
+            (*directAtomicFunctions)(&directNames, &nDirect);
+            for (unsigned long k = 0; k < nDirect; ++k) {
+                for (unsigned long i = 0; i < n; ++i) {
+                    if (!_directAtomic[i] && _atomicNames[i] == directNames[k]) {
+                        _directAtomic[i] = true;
+                        _missingAtomicFunctions--;
+                    }
+                }
+            }
+        }
+
+        /**
+         * Prepare the placement of sparse results in dense matrices
+         */
+        if (_jacobianSparsity != nullptr) {
+            unsigned long const* row, *col;
+            unsigned long nnz;
+            (*_jacobianSparsity)(&row, &col, &nnz);
+            _jacDensePlan = SparseScatterPlan::createDense(_m, _n, row, col, nnz);
+        }
+
+        if (_hessianSparsity != nullptr) {
+            unsigned long const* row, *col;
+            unsigned long nnz;
+            (*_hessianSparsity)(&row, &col, &nnz);
+            _hessDensePlan = SparseScatterPlan::createDense(_n, _n, row, col, nnz);
+        }
     }
 
     template <class VectorSet>
@@ -996,17 +1659,15 @@ protected:
         }
     }
 
-    inline void createDenseFromSparse(const CppAD::vector<Base>& compressed,
-                                      unsigned long nrows, unsigned long ncols,
-                                      unsigned long const* rows, unsigned long const* cols,
-                                      unsigned long nnz,
-                                      ArrayView<Base> mat) const {
-        CPPADCG_ASSERT_KNOWN(mat.size() == nrows * ncols, "Invalid matrix size");
-        mat.fill(Base(0));
+    static inline CompressedSparsityView loadSparsityCompressed(void (&func)(int*, unsigned long const**, unsigned long const**, unsigned long*, unsigned long*)) {
+        int rowMajor;
+        unsigned long const* outer, *inner;
+        unsigned long nOuter, nnz;
+        (*func)(&rowMajor, &outer, &inner, &nOuter, &nnz);
 
-        for (size_t i = 0; i < nnz; i++) {
-            mat[rows[i] * ncols + cols[i]] = compressed[i];
-        }
+        return CompressedSparsityView(rowMajor ? SparseStorageOrder::ROW_MAJOR : SparseStorageOrder::COLUMN_MAJOR,
+                                      ArrayView<const size_t>(outer, nOuter + 1),
+                                      ArrayView<const size_t>(inner, nnz));
     }
 
     virtual void modelLibraryClosed() {
@@ -1028,6 +1689,11 @@ protected:
         _jacobianSparsity = nullptr;
         _hessianSparsity = nullptr;
         _hessianSparsity2 = nullptr;
+        _jacobianSparsityCompressed = nullptr;
+        _hessianSparsityCompressed = nullptr;
+        _newtonSolve = nullptr;
+        _newtonBlocks = nullptr;
+        _newtonBlock = nullptr;
     }
 
 private:
@@ -1038,6 +1704,9 @@ private:
         size_t n = _atomicNames.size();
         for (size_t i = 0; i < n; i++) {
             if (name == _atomicNames[i]) {
+                if (_directAtomic[i]) {
+                    return false; // called directly by the compiled code
+                }
                 if (_atomic[i] == nullptr) {
                     _missingAtomicFunctions--;
                 } else {
@@ -1050,33 +1719,60 @@ private:
         return false;
     }
 
-    static int atomicForward(void* libModelIn,
+    static int atomicForward(void* ctxIn,
                              int atomicIndex,
                              int q,
                              int p,
                              const Array tx[],
                              Array* ty) {
-        FunctorGenericModel<Base>* libModel = static_cast<FunctorGenericModel<Base>*> (libModelIn);
-        ExternalFunctionWrapper<Base>* externalFunc = libModel->_atomic[atomicIndex];
+        auto* ctx = static_cast<FunctorGenericModelContext<Base>*> (ctxIn);
+        ExternalFunctionWrapper<Base>* externalFunc = ctx->_model->_atomic[atomicIndex];
 
-        return externalFunc->forward(*libModel, q, p, tx, *ty);
+        return externalFunc->forward(*ctx, q, p, tx, *ty);
     }
 
-    static int atomicReverse(void* libModelIn,
+    static int atomicReverse(void* ctxIn,
                              int atomicIndex,
                              int p,
                              const Array tx[],
                              Array* px,
                              const Array py[]) {
-        FunctorGenericModel<Base>* libModel = static_cast<FunctorGenericModel<Base>*> (libModelIn);
-        ExternalFunctionWrapper<Base>* externalFunc = libModel->_atomic[atomicIndex];
+        auto* ctx = static_cast<FunctorGenericModelContext<Base>*> (ctxIn);
+        ExternalFunctionWrapper<Base>* externalFunc = ctx->_model->_atomic[atomicIndex];
+
+        return externalFunc->reverse(*ctx, p, tx, *px, py);
+    }
+
+    static int atomicForwardBatch(void* ctxIn,
+                                  int atomicIndex,
+                                  int q,
+                                  int p,
+                                  unsigned long nBatch,
+                                  const Array tx[],
+                                  Array* ty) {
+        auto* ctx = static_cast<FunctorGenericModelContext<Base>*> (ctxIn);
+        ExternalFunctionWrapper<Base>* externalFunc = ctx->_model->_atomic[atomicIndex];
+
+        return externalFunc->forwardBatch(*ctx, q, p, nBatch, tx, *ty);
+    }
 
-        return externalFunc->reverse(*libModel, p, tx, *px, py);
+    static int atomicReverseBatch(void* ctxIn,
+                                  int atomicIndex,
+                                  int p,
+                                  unsigned long nBatch,
+                                  const Array tx[],
+                                  Array* px,
+                                  const Array py[]) {
+        auto* ctx = static_cast<FunctorGenericModelContext<Base>*> (ctxIn);
+        ExternalFunctionWrapper<Base>* externalFunc = ctx->_model->_atomic[atomicIndex];
+
+        return externalFunc->reverseBatch(*ctx, p, nBatch, tx, *px, py);
     }
 #ifdef CPPAD_CG_SYSTEM_LINUX
     friend class LinuxDynamicLib<Base>;
 #endif
     friend class AtomicExternalFunctionWrapper<Base>;
+    friend class FunctorGenericModelContext<Base>;
 };
 
 } // END cg namespace
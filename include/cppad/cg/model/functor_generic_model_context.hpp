@@ -0,0 +1,110 @@
+#ifndef CPPAD_CG_FUNCTOR_GENERIC_MODEL_CONTEXT_INCLUDED
+#define CPPAD_CG_FUNCTOR_GENERIC_MODEL_CONTEXT_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * Holds the temporary data required to evaluate a FunctorGenericModel.
+ * A model can be evaluated simultaneously in several threads as long as
+ * each thread uses its own context.
+ * The context must not be used after the model is deleted.
+ *
+ * @author Joao Leal
+ */
+template<class Base>
+class FunctorGenericModelContext {
+protected:
+    /// the model evaluated with this context
+    const FunctorGenericModel<Base>* _model;
+    std::vector<const Base*> _in;
+    std::vector<const Base*> _inHess;
+    std::vector<Base*> _out;
+    /// passed to the compiled code so that atomic functions use this context
+    LangCAtomicFun _atomicFuncArg;
+    /// used by the atomic functions
+    CppAD::vector<Base> _tx, _ty, _px, _py;
+    /// used to hold compressed results (sparse Jacobians/Hessians, ...)
+    CppAD::vector<Base> _compressed;
+    /// the contexts used to evaluate nested models (created on demand)
+    std::map<const FunctorGenericModel<Base>*, std::unique_ptr<FunctorGenericModelContext<Base>>> _nested;
+public:
+
+    /**
+     * Creates a new context which can be used to evaluate a model.
+     *
+     * @param model the model which will be evaluated using this context
+     */
+    explicit FunctorGenericModelContext(const FunctorGenericModel<Base>& model) :
+        _model(&model),
+        _in(model._inSize),
+        _inHess(model._inSize + 1),
+        _out(model._outSize),
+        _atomicFuncArg{this,
+                       &FunctorGenericModel<Base>::atomicForward,
+                       &FunctorGenericModel<Base>::atomicReverse,
+                       &FunctorGenericModel<Base>::atomicForwardBatch,
+                       &FunctorGenericModel<Base>::atomicReverseBatch} {
+    }
+
+    FunctorGenericModelContext(const FunctorGenericModelContext& orig) :
+        _model(orig._model),
+        _in(orig._in.size()),
+        _inHess(orig._inHess.size()),
+        _out(orig._out.size()),
+        _atomicFuncArg{this,
+                       orig._atomicFuncArg.forward,
+                       orig._atomicFuncArg.reverse,
+                       orig._atomicFuncArg.forwardBatch,
+                       orig._atomicFuncArg.reverseBatch} {
+    }
+
+    FunctorGenericModelContext& operator=(const FunctorGenericModelContext&) = delete;
+
+    virtual ~FunctorGenericModelContext() = default;
+
+    /**
+     * Provides the model evaluated with this context.
+     */
+    inline const FunctorGenericModel<Base>& getModel() const {
+        return *_model;
+    }
+
+protected:
+
+    /**
+     * Provides the context used to evaluate a model called as an atomic
+     * function from the model of this context.
+     *
+     * @param model the nested model
+     */
+    inline FunctorGenericModelContext<Base>& getNestedContext(const FunctorGenericModel<Base>& model) {
+        std::unique_ptr<FunctorGenericModelContext<Base>>& ctx = _nested[&model];
+        if (ctx == nullptr)
+            ctx = model.createContext();
+        return *ctx;
+    }
+
+    friend class FunctorGenericModel<Base>;
+    friend class AtomicExternalFunctionWrapper<Base>;
+    friend class GenericModelExternalFunctionWrapper<Base>;
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
@@ -116,6 +116,18 @@ public:
      */
     virtual size_t Range() const = 0;
 
+    /**
+     * Provides the number of runtime parameters.
+     * Models with runtime parameters receive their values through an
+     * additional input array, which allows to change them without
+     * recompiling the model (see ModelCSourceGen::getParameterCount()).
+     *
+     * @return The number of runtime parameters
+     */
+    virtual size_t getParameterCount() const {
+        return 0;
+    }
+
     /**
      * The names of the atomic functions required by this model.
      * All external/atomic functions must be provided before using
@@ -235,6 +247,23 @@ public:
     virtual void ForwardZero(const std::vector<const Base*> &x,
                              ArrayView<Base> dep) = 0;
 
+    /**
+     * Determines the dependent variable values of a model with runtime
+     * parameters.
+     *
+     * @param x The independent variable vector
+     * @param p The runtime parameter vector
+     * @param dep The values of the dependent variables
+     */
+    inline void ForwardZero(ArrayView<const Base> x,
+                            ArrayView<const Base> p,
+                            ArrayView<Base> dep) {
+        CPPADCG_ASSERT_KNOWN(x.size() == Domain(), "Invalid independent array size")
+        CPPADCG_ASSERT_KNOWN(p.size() == getParameterCount(), "Invalid parameter array size")
+
+        ForwardZero(std::vector<const Base*>{x.data(), p.data()}, dep);
+    }
+
     /***********************************************************************
      *                        Dense Jacobian
      **********************************************************************/
@@ -675,6 +704,28 @@ public:
                                 size_t const** row,
                                 size_t const** col) = 0;
 
+    /**
+     * Determines the sparse Jacobian of a model with runtime parameters.
+     * The sparsity pattern does not depend on the parameter values.
+     *
+     * @param x The independent variable vector
+     * @param p The runtime parameter vector
+     * @param jac The values of the sparse Jacobian in the order provided by
+     *            row and col
+     * @param row The row indices of the Jacobian values
+     * @param col The column indices of the Jacobian values
+     */
+    inline void SparseJacobian(ArrayView<const Base> x,
+                               ArrayView<const Base> p,
+                               ArrayView<Base> jac,
+                               size_t const** row,
+                               size_t const** col) {
+        CPPADCG_ASSERT_KNOWN(x.size() == Domain(), "Invalid independent array size")
+        CPPADCG_ASSERT_KNOWN(p.size() == getParameterCount(), "Invalid parameter array size")
+
+        SparseJacobian(std::vector<const Base*>{x.data(), p.data()}, jac, row, col);
+    }
+
     /***********************************************************************
      *                        Sparse Hessians
      **********************************************************************/
@@ -744,6 +795,78 @@ public:
                                size_t const** row,
                                size_t const** col) = 0;
 
+    /**
+     * Determines the sparse Hessian of a model with runtime parameters.
+     * The sparsity pattern does not depend on the parameter values.
+     *
+     * @param x The independent variable vector
+     * @param p The runtime parameter vector
+     * @param w The equation multipliers
+     * @param hess The values of the sparse hessian in the order provided by
+     *             row and col
+     * @param row The row indices of the hessian values
+     * @param col The column indices of the hessian values
+     */
+    inline void SparseHessian(ArrayView<const Base> x,
+                              ArrayView<const Base> p,
+                              ArrayView<const Base> w,
+                              ArrayView<Base> hess,
+                              size_t const** row,
+                              size_t const** col) {
+        CPPADCG_ASSERT_KNOWN(x.size() == Domain(), "Invalid independent array size")
+        CPPADCG_ASSERT_KNOWN(p.size() == getParameterCount(), "Invalid parameter array size")
+
+        SparseHessian(std::vector<const Base*>{x.data(), p.data()}, w, hess, row, col);
+    }
+
+    /**
+     * Provides the number of blocks of algebraic equations with a Newton
+     * solver in the compiled model.
+     *
+     * @return the number of blocks (zero if no Newton solver was generated)
+     */
+    virtual size_t getNewtonSolverBlockCount() const {
+        return 0;
+    }
+
+    /**
+     * Provides the equations and the variables of a block of algebraic
+     * equations with a Newton solver.
+     *
+     * @param block the block index
+     * @param equations the equation (dependent) indexes
+     * @param variables the variable (independent) indexes
+     */
+    virtual void getNewtonSolverBlock(size_t block,
+                                      std::vector<size_t>& equations,
+                                      std::vector<size_t>& variables) const {
+        throw CGException("No Newton solver defined for model '", getName(), "'");
+    }
+
+    /**
+     * Determines the variables of a block of algebraic equations with the
+     * Newton solver generated for this model.
+     * The remaining variables are kept constant.
+     *
+     * @param block the block index
+     * @param x the independent variables (the block variables are used as
+     *          the initial guess and replaced by the solution)
+     * @param p the runtime parameters (it can be empty if the model does
+     *          not have parameters)
+     * @param maxIterations the maximum number of Newton iterations
+     * @param tolerance the maximum absolute residual of the block equations
+     * @param iterations if not null it will hold the number of iterations
+     * @return whether or not the solver converged
+     */
+    virtual NewtonSolverStatus NewtonSolve(size_t block,
+                                           ArrayView<Base> x,
+                                           ArrayView<const Base> p,
+                                           size_t maxIterations,
+                                           Base tolerance,
+                                           size_t* iterations = nullptr) {
+        throw CGException("No Newton solver defined for model '", getName(), "'");
+    }
+
     /**
      * Provides a wrapper for this compiled model allowing it to be used as
      * an atomic function. The model must not be deleted while the atomic
@@ -18,20 +18,31 @@
 namespace CppAD {
 namespace cg {
 
+/**
+ * Calls a model as an atomic function of another model.
+ * Models of type FunctorGenericModel are evaluated with a nested context
+ * owned by the context of the calling model and therefore they can be
+ * evaluated simultaneously in several threads (one context per thread).
+ * Other types of models use their own internal data and must not be
+ * evaluated concurrently.
+ */
 template<class Base>
 class GenericModelExternalFunctionWrapper : public ExternalFunctionWrapper<Base> {
 private:
     GenericModel<Base>* model_;
+    /// the same model if it can be evaluated with a context (or null)
+    FunctorGenericModel<Base>* functor_;
 public:
 
     inline GenericModelExternalFunctionWrapper(GenericModel<Base>& model) :
-        model_(&model) {
+        model_(&model),
+        functor_(dynamic_cast<FunctorGenericModel<Base>*> (&model)) {
     }
 
     inline virtual ~GenericModelExternalFunctionWrapper() {
     }
 
-    virtual bool forward(FunctorGenericModel<Base>& libModel,
+    virtual bool forward(FunctorGenericModelContext<Base>& ctx,
                          int q,
                          int p,
                          const Array tx[],
@@ -44,23 +55,31 @@ public:
 
 
         if (p == 0) {
-            model_->ForwardZero(x, y);
+            if (functor_ != nullptr)
+                functor_->ForwardZero(ctx.getNestedContext(*functor_), x, y);
+            else
+                model_->ForwardZero(x, y);
             return true;
 
         } else if (p == 1) {
             CPPADCG_ASSERT_KNOWN(tx[1].sparse, "independent Taylor array must be sparse");
             Base* tx1 = static_cast<Base*> (tx[1].data);
 
-            model_->ForwardOne(x,
-                               tx[1].nnz, tx[1].idx, tx1,
-                               y);
+            if (functor_ != nullptr)
+                functor_->ForwardOne(ctx.getNestedContext(*functor_), x,
+                                     tx[1].nnz, tx[1].idx, tx1,
+                                     y);
+            else
+                model_->ForwardOne(x,
+                                   tx[1].nnz, tx[1].idx, tx1,
+                                   y);
             return true;
         }
 
         return false;
     }
 
-    virtual bool reverse(FunctorGenericModel<Base>& libModel,
+    virtual bool reverse(FunctorGenericModelContext<Base>& ctx,
                          int p,
                          const Array tx[],
                          Array& px,
@@ -75,9 +94,14 @@ public:
             CPPADCG_ASSERT_KNOWN(py[0].sparse, "dependent partials array must be sparse");
             Base* pyb = static_cast<Base*> (py[0].data);
 
-            model_->ReverseOne(x,
-                               pxb,
-                               py[0].nnz, py[0].idx, pyb);
+            if (functor_ != nullptr)
+                functor_->ReverseOne(ctx.getNestedContext(*functor_), x,
+                                     pxb,
+                                     py[0].nnz, py[0].idx, pyb);
+            else
+                model_->ReverseOne(x,
+                                   pxb,
+                                   py[0].nnz, py[0].idx, pyb);
             return true;
 
         } else if (p == 1) {
@@ -88,10 +112,16 @@ public:
             CPPADCG_ASSERT_KNOWN(!py[1].sparse, "independent partials array must be dense");
             ArrayView<const Base> py2(static_cast<Base*> (py[1].data), py[1].size);
 
-            model_->ReverseTwo(x,
-                               tx[1].nnz, tx[1].idx, tx1,
-                               pxb,
-                               py2);
+            if (functor_ != nullptr)
+                functor_->ReverseTwo(ctx.getNestedContext(*functor_), x,
+                                     tx[1].nnz, tx[1].idx, tx1,
+                                     pxb,
+                                     py2);
+            else
+                model_->ReverseTwo(x,
+                                   tx[1].nnz, tx[1].idx, tx1,
+                                   pxb,
+                                   py2);
             return true;
         }
 
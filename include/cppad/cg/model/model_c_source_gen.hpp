@@ -52,6 +52,8 @@ public:
     static const std::string FUNCTION_JACOBIAN_SPARSITY;
     static const std::string FUNCTION_HESSIAN_SPARSITY;
     static const std::string FUNCTION_HESSIAN_SPARSITY2;
+    static const std::string FUNCTION_JACOBIAN_SPARSITY_COMPRESSED;
+    static const std::string FUNCTION_HESSIAN_SPARSITY_COMPRESSED;
     static const std::string FUNCTION_SPARSE_FORWARD_ONE;
     static const std::string FUNCTION_SPARSE_REVERSE_ONE;
     static const std::string FUNCTION_SPARSE_REVERSE_TWO;
@@ -60,6 +62,12 @@ public:
     static const std::string FUNCTION_REVERSE_TWO_SPARSITY;
     static const std::string FUNCTION_INFO;
     static const std::string FUNCTION_ATOMIC_FUNC_NAMES;
+    static const std::string FUNCTION_PARAMETER_COUNT;
+    static const std::string FUNCTION_ATOMIC;
+    static const std::string FUNCTION_DIRECT_ATOMIC_FUNC_NAMES;
+    static const std::string FUNCTION_NEWTON_SOLVE;
+    static const std::string FUNCTION_NEWTON_BLOCKS;
+    static const std::string FUNCTION_NEWTON_BLOCK;
 protected:
     static const std::string CONST;
 
@@ -120,6 +128,48 @@ protected:
         std::vector<size_t> cols;
     };
 
+    /**
+     * A block of algebraic equations solved by a generated Newton solver
+     */
+    class NewtonBlock {
+    public:
+        /// the equations (dependents) of the block
+        std::vector<size_t> equations;
+        /// the variables (independents) determined by the block
+        std::vector<size_t> variables;
+        /// the linear solver used in each Newton iteration
+        NewtonLinearSolver linearSolver;
+    };
+
+    /**
+     * The static pivot order and fill-in of the LU factorization of a
+     * block Jacobian (see NewtonLinearSolver::SparseLU).
+     * The factorized matrix is saved in a compressed sparse row format.
+     */
+    class StaticSparseLU {
+    public:
+        /// the block row (equation) used in each position
+        std::vector<size_t> rowPerm;
+        /// the block column (variable) used in each position
+        std::vector<size_t> colPerm;
+        /// the outer index array of the factorized matrix
+        std::vector<size_t> rowStart;
+        /// the column index of each element of the factorized matrix
+        std::vector<size_t> col;
+        /// the location of each diagonal element
+        std::vector<size_t> diag;
+        /// the location of each element of L which is determined by a division
+        std::vector<size_t> divPos;
+        /// the location of the pivot used in each division
+        std::vector<size_t> divPivot;
+        /// the range of updates performed after each division
+        std::vector<size_t> updStart;
+        /// the location of each updated element
+        std::vector<size_t> updTarget;
+        /// the location of the element of U used to update each element
+        std::vector<size_t> updSource;
+    };
+
     /**
      * Used for coloring
      */
@@ -209,11 +259,23 @@ protected:
      */
     Position _custom_jac;
     LocalSparsityInfo _jacSparsity;
+    /**
+     * Whether or not the sparse Jacobian elements are ordered as in a
+     * compressed sparse matrix (CSR/CSC)
+     */
+    bool _jacCompressed;
+    SparseStorageOrder _jacCompressedOrder;
     /**
      * Custom Hessian element indexes
      */
     Position _custom_hess;
     LocalSparsityInfo _hessSparsity;
+    /**
+     * Whether or not the sparse Hessian elements are ordered as in a
+     * compressed sparse matrix (CSR/CSC)
+     */
+    bool _hessCompressed;
+    SparseStorageOrder _hessCompressedOrder;
     /**
      * Hessian sparsity from the model for each equation
      */
@@ -242,6 +304,46 @@ protected:
      *
      */
     std::vector<std::set<size_t> > _relatedDepCandidates;
+    /**
+     * Whether or not to automatically determine the related dependent
+     * candidates when none are provided
+     */
+    bool _autoRelatedDependents;
+    /**
+     * The number of threads used to detect loops (0 means one per core)
+     */
+    size_t _loopDetectionThreads;
+    /**
+     * Whether or not the generated code uses restrict-qualified pointers
+     * for the arrays of variables
+     */
+    bool _restrictPointers;
+    /**
+     * Whether or not OpenMP simd pragmas are generated for loops without
+     * dependencies between iterations
+     */
+    bool _simdLoops;
+    /**
+     * Whether or not the atomic function called inside loops is evaluated
+     * once for all the iterations
+     */
+    bool _batchAtomicLoops;
+    /**
+     * The maximum number of values in the buffers of a batched atomic
+     * function call
+     */
+    size_t _maxBatchAtomicValues;
+    /**
+     * Maps the names of atomic functions to the prefix of the C functions
+     * which are called directly by the generated source code
+     * (models in the same library)
+     */
+    std::map<std::string, std::string> _directAtomicFunctions;
+    /**
+     * Whether or not to generate the C functions which allow other models
+     * in the same library to call this model directly as an atomic function
+     */
+    bool _directlyCallable;
     /**
      * Maps the column groups of each loop model to the set of columns
      * (loop->group->{columns->{compressed forward 1 position} })
@@ -272,6 +374,11 @@ protected:
      *  [var]{compressed reverse 2 position}
      */
     std::map<size_t, std::set<size_t> > _nonLoopRev2Elements;
+    /**
+     * The blocks of algebraic equations for which a Newton solver is
+     * generated
+     */
+    std::vector<NewtonBlock> _newtonBlocks;
     /**
      *
      */
@@ -310,9 +417,20 @@ public:
         _sparseJacobianReusesOne(true),
         _sparseHessianReusesRev2(true),
         _jacMode(JacobianADMode::Automatic),
+        _jacCompressed(false),
+        _jacCompressedOrder(SparseStorageOrder::ROW_MAJOR),
+        _hessCompressed(false),
+        _hessCompressedOrder(SparseStorageOrder::ROW_MAJOR),
         _atomicsInfo(nullptr),
         _maxAssignPerFunc(20000),
         _maxOperationsPerAssignment(1000),
+        _autoRelatedDependents(false),
+        _loopDetectionThreads(1),
+        _restrictPointers(false),
+        _simdLoops(false),
+        _batchAtomicLoops(false),
+        _maxBatchAtomicValues(4096),
+        _directlyCallable(false),
         _jobTimer(nullptr) {
 
         CPPADCG_ASSERT_KNOWN(!_name.empty(), "Model name cannot be empty");
@@ -359,6 +477,21 @@ public:
         }
     }
 
+    /**
+     * Provides the number of runtime parameters of the model.
+     * These are the dynamic parameters of the taped ADFun (see
+     * CppAD::Independent(x, abort_op_index, record_compare, dynamic)) which
+     * are provided to the generated functions through an additional input
+     * array (after the independent variables and before the Hessian
+     * multipliers).
+     * Their values can therefore be changed without recompiling the model.
+     *
+     * @return the number of runtime parameters
+     */
+    inline size_t getParameterCount() const {
+        return _fun.size_dyn_ind();
+    }
+
     inline void setRelatedDependents(const std::vector<std::set<size_t> >& relatedDepCandidates) {
         _relatedDepCandidates = relatedDepCandidates;
     }
@@ -367,6 +500,105 @@ public:
         return _relatedDepCandidates;
     }
 
+    /**
+     * Defines whether or not the groups of related dependents (used to
+     * detect loops) should be determined automatically when none are
+     * provided with setRelatedDependents().
+     * Dependents are grouped by the shape of their expression trees where
+     * the independent variables are abstracted away.
+     *
+     * @param autoRelated true to determine the related dependents
+     *                    automatically
+     */
+    inline void setAutomaticRelatedDependents(bool autoRelated) {
+        _autoRelatedDependents = autoRelated;
+    }
+
+    inline bool isAutomaticRelatedDependents() const {
+        return _autoRelatedDependents;
+    }
+
+    /**
+     * Defines the number of threads used to determine the equation
+     * patterns when detecting loops.
+     * The generated source code does not depend on the number of threads.
+     *
+     * @param nThreads the number of threads (0 for one thread per core)
+     */
+    inline void setLoopDetectionThreads(size_t nThreads) {
+        _loopDetectionThreads = nThreads;
+    }
+
+    inline size_t getLoopDetectionThreads() const {
+        return _loopDetectionThreads;
+    }
+
+    /**
+     * Defines whether or not the pointers to the arrays of variables in the
+     * generated source code are restrict-qualified (C99), which allows the
+     * compiler to vectorize more loops.
+     * The model must then never be evaluated with overlapping input and
+     * output arrays.
+     *
+     * @param restrictPointers true to use restrict-qualified pointers
+     */
+    inline void setRestrictPointers(bool restrictPointers) {
+        _restrictPointers = restrictPointers;
+    }
+
+    inline bool isRestrictPointers() const {
+        return _restrictPointers;
+    }
+
+    /**
+     * Defines whether or not OpenMP simd pragmas are generated for the
+     * loops (see setRelatedDependents()) whose iterations are independent,
+     * such as loops where the dependents follow linear index patterns.
+     * The pragmas only have an effect when the source code is compiled with
+     * OpenMP support (e.g. -fopenmp-simd).
+     *
+     * @param simdLoops true to generate OpenMP simd pragmas
+     */
+    inline void setSimdLoops(bool simdLoops) {
+        _simdLoops = simdLoops;
+    }
+
+    inline bool isSimdLoops() const {
+        return _simdLoops;
+    }
+
+    /**
+     * Defines whether or not an atomic function called inside the loops
+     * (see setRelatedDependents()) is evaluated once for all the iterations
+     * instead of once per iteration.
+     * Atomic functions implementing AtomicBatchArrayFunction can then use
+     * their own vectorized implementations.
+     *
+     * @param batchAtomicLoops true to batch the atomic function calls of loops
+     */
+    inline void setBatchAtomicLoops(bool batchAtomicLoops) {
+        _batchAtomicLoops = batchAtomicLoops;
+    }
+
+    inline bool isBatchAtomicLoops() const {
+        return _batchAtomicLoops;
+    }
+
+    /**
+     * Defines the maximum number of values in the buffers of a batched
+     * atomic function call (see LanguageC::setMaxBatchAtomicValues()).
+     * Loops requiring larger buffers are evaluated in chunks of iterations.
+     *
+     * @param maxValues the maximum number of values in the buffers
+     */
+    inline void setMaxBatchAtomicValues(size_t maxValues) {
+        _maxBatchAtomicValues = maxValues;
+    }
+
+    inline size_t getMaxBatchAtomicValues() const {
+        return _maxBatchAtomicValues;
+    }
+
     /**
      * Provides the maximum precision used to print constant values in the
      * generated source code
@@ -851,6 +1083,86 @@ public:
         _custom_hess = Position(elements);
     }
 
+    /**
+     * Whether or not the elements of the sparse Jacobian are provided in the
+     * same order as in a compressed sparse matrix (CSR or CSC).
+     *
+     * @return true if the sparse Jacobian elements are provided in a
+     *         compressed sparse order
+     */
+    inline bool isCompressedSparseJacobian() const {
+        return _jacCompressed;
+    }
+
+    /**
+     * The order of the elements of the sparse Jacobian when it is provided
+     * as a compressed sparse matrix.
+     */
+    inline SparseStorageOrder getCompressedSparseJacobianOrder() const {
+        return _jacCompressedOrder;
+    }
+
+    /**
+     * Defines whether or not the elements of the sparse Jacobian should be
+     * provided in the same order as in a compressed sparse matrix (CSR or
+     * CSC) so that the output array can be used directly as the values array
+     * of that matrix.
+     * The elements are sorted by a stable sort, which means that the
+     * elements defined with setCustomSparseJacobianElements() are also
+     * reordered.
+     * The outer and inner index arrays are also generated and can be
+     * accessed from the compiled model.
+     *
+     * @param compressed true to generate the elements in a compressed sparse
+     *                   order
+     * @param order the compressed sparse matrix storage order
+     */
+    inline void setCompressedSparseJacobian(bool compressed,
+                                            SparseStorageOrder order = SparseStorageOrder::ROW_MAJOR) {
+        _jacCompressed = compressed;
+        _jacCompressedOrder = order;
+    }
+
+    /**
+     * Whether or not the elements of the sparse Hessian are provided in the
+     * same order as in a compressed sparse matrix (CSR or CSC).
+     *
+     * @return true if the sparse Hessian elements are provided in a
+     *         compressed sparse order
+     */
+    inline bool isCompressedSparseHessian() const {
+        return _hessCompressed;
+    }
+
+    /**
+     * The order of the elements of the sparse Hessian when it is provided
+     * as a compressed sparse matrix.
+     */
+    inline SparseStorageOrder getCompressedSparseHessianOrder() const {
+        return _hessCompressedOrder;
+    }
+
+    /**
+     * Defines whether or not the elements of the sparse Hessian should be
+     * provided in the same order as in a compressed sparse matrix (CSR or
+     * CSC) so that the output array can be used directly as the values array
+     * of that matrix.
+     * The elements are sorted by a stable sort, which means that the
+     * elements defined with setCustomSparseHessianElements() are also
+     * reordered.
+     * The outer and inner index arrays are also generated and can be
+     * accessed from the compiled model.
+     *
+     * @param compressed true to generate the elements in a compressed sparse
+     *                   order
+     * @param order the compressed sparse matrix storage order
+     */
+    inline void setCompressedSparseHessian(bool compressed,
+                                           SparseStorageOrder order = SparseStorageOrder::ROW_MAJOR) {
+        _hessCompressed = compressed;
+        _hessCompressedOrder = order;
+    }
+
     /**
      * The maximum number of assignment per generated function.
      * Zero means it is disabled (no limit).
@@ -896,6 +1208,57 @@ public:
         _maxOperationsPerAssignment = maxOperationsPerAssignment;
     }
 
+    /**
+     * Requests the generation of a Newton solver (in C) for a block of
+     * algebraic equations.
+     * The solver determines the values of the block variables which zero
+     * the block equations while the other independent variables are kept
+     * constant.
+     * Each iteration evaluates generated functions restricted to the block
+     * (the residuals of the block equations and the Jacobian elements of
+     * the block variables) without leaving the compiled library, followed
+     * by a backtracking line search.
+     * The sparse LU factorization uses a pivot order determined during the
+     * code generation (no pivoting at runtime) and, therefore, it should
+     * only be selected for blocks whose Jacobian remains well conditioned
+     * for that order.
+     *
+     * @param equations the equations (dependent indexes) of the block
+     * @param variables the variables (independent indexes) determined by
+     *                  the block (same size as equations)
+     * @param linearSolver the linear solver used in each iteration
+     * @return the index of the block in the generated solver
+     */
+    inline size_t addNewtonSolverBlock(const std::vector<size_t>& equations,
+                                       const std::vector<size_t>& variables,
+                                       NewtonLinearSolver linearSolver = NewtonLinearSolver::DenseLU) {
+        CPPADCG_ASSERT_KNOWN(!equations.empty(), "A Newton solver block cannot be empty")
+        CPPADCG_ASSERT_KNOWN(equations.size() == variables.size(), "The number of equations and variables of a Newton solver block must be the same")
+        for (size_t i : equations) {
+            CPPADCG_ASSERT_KNOWN(i < _fun.Range(), "Invalid equation index in a Newton solver block")
+        }
+        for (size_t j : variables) {
+            CPPADCG_ASSERT_KNOWN(j < _fun.Domain(), "Invalid variable index in a Newton solver block")
+        }
+
+        _newtonBlocks.push_back(NewtonBlock{equations, variables, linearSolver});
+        return _newtonBlocks.size() - 1;
+    }
+
+    /**
+     * Provides the number of blocks for which a Newton solver is generated.
+     */
+    inline size_t getNewtonSolverBlockCount() const {
+        return _newtonBlocks.size();
+    }
+
+    /**
+     * Removes all the Newton solver blocks.
+     */
+    inline void clearNewtonSolverBlocks() {
+        _newtonBlocks.clear();
+    }
+
     inline virtual ~ModelCSourceGen() {
         delete _funNoLoops;
         delete _atomicsInfo;
@@ -934,10 +1297,65 @@ protected:
 
     virtual void generateAtomicFuncNames();
 
+    /**
+     * Generates the list of atomic functions which are called directly by
+     * the generated source code and, therefore, do not need to be provided
+     * when the model is used.
+     */
+    virtual void generateDirectAtomicFuncNames();
+
+    /**
+     * Makes sure that only the sources which support runtime parameters
+     * are requested when the model has runtime parameters.
+     *
+     * @throws CGException if an unsupported source was requested
+     */
+    virtual void checkParameterSupport();
+
+    /**
+     * Creates the variables for the runtime parameters in the handler and
+     * provides them as the new dynamic parameter values of a copy of the
+     * ADFun (the model provided by the user is not modified since these
+     * variables are only valid while the handler exists).
+     * It must be called right after the creation of the independent
+     * variables so that the parameters are registered before any other
+     * variable (e.g. the Hessian multipliers).
+     *
+     * @param handler The operation graph handler
+     * @param funCopy Holds the copy of the ADFun (if one is required)
+     * @return the ADFun to be used with this handler: the model itself if
+     *         there are no runtime parameters, otherwise the copy
+     */
+    virtual ADFun<CGBase>& prepareParameters(CodeHandler<Base>& handler,
+                                             std::unique_ptr<ADFun<CGBase> >& funCopy);
+
     virtual bool isAtomicsUsed();
 
     virtual const std::map<size_t, AtomicUseInfo<Base> >& getAtomicsInfo();
 
+    /***********************************************************************
+     * direct calls from other models in the same library
+     **********************************************************************/
+
+    /**
+     * Determines whether or not the generated source code of another model
+     * can call this model directly when it is used as an atomic function.
+     * It requires this model not to use atomic functions or runtime
+     * parameters, and to provide all the derivative orders which may be
+     * required by the other model.
+     *
+     * @param caller The model which uses this model as an atomic function
+     * @return true if direct calls are possible
+     */
+    virtual bool isDirectlyCallableBy(ModelCSourceGen<Base>& caller);
+
+    /**
+     * Generates the C functions with the same arguments as the function
+     * pointers in the LangCAtomicFun structure which evaluate this model,
+     * so that other models can call this model directly.
+     */
+    virtual void generateDirectAtomicSources();
+
     /***********************************************************************
      * zero order (the original model)
      **********************************************************************/
@@ -1147,9 +1565,76 @@ protected:
     virtual void generateSparsity2DSource2(const std::string& function,
                                            const std::vector<LocalSparsityInfo>& sparsities);
 
+    /**
+     * Generates a function which provides the outer and inner index arrays
+     * of a compressed sparse matrix (CSR/CSC) with the elements of a
+     * sparsity pattern already sorted in that order.
+     */
+    virtual void generateSparsityCompressedSource(const std::string& function,
+                                                  const LocalSparsityInfo& sparsity,
+                                                  SparseStorageOrder order,
+                                                  size_t nOuter);
+
+    /**
+     * Sorts the elements of a sparsity pattern (stable) in the order used by
+     * a compressed sparse matrix.
+     */
+    static inline void sortCompressed(LocalSparsityInfo& sparsity,
+                                      SparseStorageOrder order);
+
     virtual void generateSparsity1DSource2(const std::string& function,
                                            const std::map<size_t, std::vector<size_t> >& rows);
 
+    /***********************************************************************
+     * Newton solvers
+     **********************************************************************/
+
+    /**
+     * Generates the Newton solvers for the blocks of algebraic equations
+     * (see addNewtonSolverBlock()).
+     */
+    virtual void generateNewtonSolverSource();
+
+    /**
+     * Generates the functions with the residuals of the equations and the
+     * Jacobian elements of a block of algebraic equations used by its
+     * Newton solver.
+     *
+     * @param k the index of the block of algebraic equations
+     * @param blockElements the local row and column of each block element
+     *                      (the order of the generated Jacobian elements)
+     */
+    virtual void generateNewtonBlockSources(size_t k,
+                                            const std::vector<std::pair<size_t, size_t> >& blockElements);
+
+    /**
+     * Generates the C code of the linear solver used by a Newton solver.
+     *
+     * @param k the index of the block of algebraic equations
+     * @param blockElements the local row and column of each block element
+     *                      (in the same order as in the block Jacobian)
+     * @param luPos the location in the matrix to factorize of each block
+     *              element
+     * @return the number of elements of the matrix to factorize
+     */
+    virtual size_t generateNewtonLinearSolverSource(size_t k,
+                                                    const std::vector<std::pair<size_t, size_t> >& blockElements,
+                                                    std::vector<size_t>& luPos);
+
+    /**
+     * Determines a pivot order and the fill-in for the LU factorization of
+     * a matrix with a given sparsity pattern.
+     * The rows are first matched to the columns so that the diagonal only
+     * has structural non-zeros and then a minimum degree ordering is used
+     * to reduce the fill-in.
+     *
+     * @param size the number of rows and columns
+     * @param elements the column indexes of each row
+     * @throws CGException if the matrix is structurally singular
+     */
+    static inline StaticSparseLU determineStaticSparseLU(size_t size,
+                                                         const std::vector<std::set<size_t> >& elements);
+
     /***********************************************************************
      * Forward 1 mode
      **********************************************************************/
@@ -0,0 +1,250 @@
+#ifndef CPPAD_CG_MODEL_C_SOURCE_GEN_ATOMIC_INCLUDED
+#define CPPAD_CG_MODEL_C_SOURCE_GEN_ATOMIC_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+namespace CppAD {
+namespace cg {
+
+template<class Base>
+bool ModelCSourceGen<Base>::isDirectlyCallableBy(ModelCSourceGen<Base>& caller) {
+    if (&caller == this || !_zero || getParameterCount() > 0 || isAtomicsUsed()) {
+        return false;
+    }
+
+    bool firstOrder = caller._jacobian || caller._sparseJacobian ||
+            caller._forwardOne || caller._reverseOne;
+    bool secondOrder = caller._hessian || caller._sparseHessian || caller._reverseTwo;
+
+    if ((firstOrder || secondOrder) && (!_forwardOne || !_reverseOne)) {
+        return false;
+    }
+
+    return !secondOrder || _reverseTwo;
+}
+
+template<class Base>
+void ModelCSourceGen<Base>::generateDirectAtomicSources() {
+    size_t m = _fun.Range();
+    size_t n = _fun.Domain();
+
+    const std::string prefix = _name + "_" + FUNCTION_ATOMIC;
+
+    LanguageC<Base> langC(_baseTypeName);
+    std::string argsDcl = langC.generateDefaultFunctionArgumentsDcl();
+    std::string args = langC.generateDefaultFunctionArguments();
+    std::string atomicDcl = langC.generateArgumentAtomicDcl();
+
+    /**
+     * forward mode
+     */
+    _cache.str("");
+    _cache << LanguageC<Base>::ATOMICFUN_STRUCT_DEFINITION << "\n"
+            "\n"
+            "void " << _name << "_" << FUNCTION_FORWAD_ZERO << "(" << argsDcl << ");\n";
+    if (_forwardOne) {
+        _cache << "int " << _name << "_" << FUNCTION_SPARSE_FORWARD_ONE << "(unsigned long pos, " << argsDcl << ");\n"
+                "void " << _name << "_" << FUNCTION_FORWARD_ONE_SPARSITY << "(unsigned long pos, unsigned long const** elements, unsigned long* nnz);\n";
+    }
+    _cache << "\n";
+    LanguageC<Base>::printFunctionDeclaration(_cache, "int", prefix + "_forward", {"int q",
+                                                                                   "int p",
+                                                                                   "const Array tx[]",
+                                                                                   "Array* ty",
+                                                                                   atomicDcl});
+    _cache << " {\n"
+            "   " << _baseTypeName << " const * in[2];\n"
+            "   " << _baseTypeName << "* out[1];\n"
+            "   " << _baseTypeName << "* y;\n";
+    if (_forwardOne) {
+        _cache << "   " << _baseTypeName << " compressed[" << m << "];\n"
+                "   " << _baseTypeName << " const * tx1;\n"
+                "   unsigned long e, ePos, i, j, nnz;\n"
+                "   unsigned long const* pos;\n"
+                "   int ret;\n";
+    }
+    _cache << "\n"
+            "   if (tx[0].sparse || ty->sparse)\n"
+            "      return 1; // only dense arrays are supported\n"
+            "\n"
+            "   in[0] = (" << _baseTypeName << " const *) tx[0].data;\n"
+            "   y = (" << _baseTypeName << "*) ty->data;\n"
+            "\n"
+            "   if (p == 0) {\n"
+            "      out[0] = y;\n"
+            "      " << _name << "_" << FUNCTION_FORWAD_ZERO << "(" << args << ");\n"
+            "      return 0;\n"
+            "   }\n";
+    if (_forwardOne) {
+        _cache << "\n"
+                "   if (p == 1) {\n"
+                "      if (!tx[1].sparse)\n"
+                "         return 1; // the first-order Taylor coefficients must be sparse\n"
+                "\n"
+                "      for (i = 0; i < " << m << "; i++)\n"
+                "         y[i] = 0;\n"
+                "\n"
+                "      tx1 = (" << _baseTypeName << " const *) tx[1].data;\n"
+                "      out[0] = compressed;\n"
+                "      for (e = 0; e < tx[1].nnz; e++) {\n"
+                "         if (tx1[e] == 0)\n"
+                "            continue;\n"
+                "         j = tx[1].idx[e];\n"
+                "         " << _name << "_" << FUNCTION_FORWARD_ONE_SPARSITY << "(j, &pos, &nnz);\n"
+                "\n"
+                "         in[1] = &tx1[e];\n";
+        if (!_loopTapes.empty()) {
+            _cache << "         for (ePos = 0; ePos < nnz; ePos++)\n"
+                    "            compressed[ePos] = 0;\n";
+        }
+        _cache << "         ret = " << _name << "_" << FUNCTION_SPARSE_FORWARD_ONE << "(j, " << args << ");\n"
+                "         if (ret != 0)\n"
+                "            return ret;\n"
+                "\n"
+                "         for (ePos = 0; ePos < nnz; ePos++)\n"
+                "            y[pos[ePos]] += compressed[ePos];\n"
+                "      }\n"
+                "      return 0;\n"
+                "   }\n";
+    }
+    _cache << "\n"
+            "   return 1; // unsupported order\n"
+            "}\n";
+
+    _sources[prefix + "_forward.c"] = _cache.str();
+
+    /**
+     * reverse mode
+     */
+    _cache.str("");
+    _cache << LanguageC<Base>::ATOMICFUN_STRUCT_DEFINITION << "\n"
+            "\n";
+    if (_reverseOne) {
+        _cache << "int " << _name << "_" << FUNCTION_SPARSE_REVERSE_ONE << "(unsigned long pos, " << argsDcl << ");\n"
+                "void " << _name << "_" << FUNCTION_REVERSE_ONE_SPARSITY << "(unsigned long pos, unsigned long const** elements, unsigned long* nnz);\n";
+    }
+    if (_reverseTwo) {
+        _cache << "int " << _name << "_" << FUNCTION_SPARSE_REVERSE_TWO << "(unsigned long pos, " << argsDcl << ");\n"
+                "void " << _name << "_" << FUNCTION_REVERSE_TWO_SPARSITY << "(unsigned long pos, unsigned long const** elements, unsigned long* nnz);\n";
+    }
+    _cache << "\n";
+    LanguageC<Base>::printFunctionDeclaration(_cache, "int", prefix + "_reverse", {"int p",
+                                                                                   "const Array tx[]",
+                                                                                   "Array* px",
+                                                                                   "const Array py[]",
+                                                                                   atomicDcl});
+    _cache << " {\n";
+    if (_reverseOne || _reverseTwo) {
+        _cache << "   " << _baseTypeName << " const * in[3];\n"
+                "   " << _baseTypeName << "* out[1];\n"
+                "   " << _baseTypeName << " compressed[" << n << "];\n"
+                "   " << _baseTypeName << " const * v;\n"
+                "   " << _baseTypeName << "* pxb;\n"
+                "   unsigned long e, ePos, " << (_reverseOne ? "i, " : "") << "j, nnz;\n"
+                "   unsigned long const* pos;\n"
+                "   int ret;\n"
+                "\n"
+                "   if (tx[0].sparse || px->sparse)\n"
+                "      return 1; // only dense arrays are supported\n"
+                "\n"
+                "   in[0] = (" << _baseTypeName << " const *) tx[0].data;\n"
+                "   out[0] = compressed;\n"
+                "   pxb = (" << _baseTypeName << "*) px->data;\n"
+                "   for (j = 0; j < " << n << "; j++)\n"
+                "      pxb[j] = 0;\n";
+    } else {
+        _cache << "   return 1; // unsupported order\n"
+                "}\n";
+    }
+
+    if (_reverseOne) {
+        _cache << "\n"
+                "   if (p == 0) {\n"
+                "      if (!py[0].sparse)\n"
+                "         return 1; // the partial derivatives must be sparse\n"
+                "\n"
+                "      v = (" << _baseTypeName << " const *) py[0].data;\n"
+                "      for (e = 0; e < py[0].nnz; e++) {\n"
+                "         if (v[e] == 0)\n"
+                "            continue;\n"
+                "         i = py[0].idx[e];\n"
+                "         " << _name << "_" << FUNCTION_REVERSE_ONE_SPARSITY << "(i, &pos, &nnz);\n"
+                "\n"
+                "         in[1] = &v[e];\n";
+        if (!_loopTapes.empty()) {
+            _cache << "         for (ePos = 0; ePos < nnz; ePos++)\n"
+                    "            compressed[ePos] = 0;\n";
+        }
+        _cache << "         ret = " << _name << "_" << FUNCTION_SPARSE_REVERSE_ONE << "(i, " << args << ");\n"
+                "         if (ret != 0)\n"
+                "            return ret;\n"
+                "\n"
+                "         for (ePos = 0; ePos < nnz; ePos++)\n"
+                "            pxb[pos[ePos]] += compressed[ePos];\n"
+                "      }\n"
+                "      return 0;\n"
+                "   }\n";
+    }
+
+    if (_reverseTwo) {
+        _cache << "\n"
+                "   if (p == 1) {\n"
+                "      if (!tx[1].sparse || !py[0].sparse || py[1].sparse)\n"
+                "         return 1; // unexpected array types\n"
+                "\n"
+                "      v = (" << _baseTypeName << " const *) py[0].data;\n"
+                "      for (e = 0; e < py[0].nnz; e++) {\n"
+                "         if (v[e] != 0)\n"
+                "            return 1; // the first-order partials of the dependents must be zero\n"
+                "      }\n"
+                "\n"
+                "      in[2] = (" << _baseTypeName << " const *) py[1].data;\n"
+                "      v = (" << _baseTypeName << " const *) tx[1].data;\n"
+                "      for (e = 0; e < tx[1].nnz; e++) {\n"
+                "         if (v[e] == 0)\n"
+                "            continue;\n"
+                "         j = tx[1].idx[e];\n"
+                "         " << _name << "_" << FUNCTION_REVERSE_TWO_SPARSITY << "(j, &pos, &nnz);\n"
+                "\n"
+                "         in[1] = &v[e];\n";
+        if (!_loopTapes.empty()) {
+            _cache << "         for (ePos = 0; ePos < nnz; ePos++)\n"
+                    "            compressed[ePos] = 0;\n";
+        }
+        _cache << "         ret = " << _name << "_" << FUNCTION_SPARSE_REVERSE_TWO << "(j, " << args << ");\n"
+                "         if (ret != 0)\n"
+                "            return ret;\n"
+                "\n"
+                "         for (ePos = 0; ePos < nnz; ePos++)\n"
+                "            pxb[pos[ePos]] += compressed[ePos];\n"
+                "      }\n"
+                "      return 0;\n"
+                "   }\n";
+    }
+
+    if (_reverseOne || _reverseTwo) {
+        _cache << "\n"
+                "   return 1; // unsupported order\n"
+                "}\n";
+    }
+
+    _sources[prefix + "_reverse.c"] = _cache.str();
+    _cache.str("");
+}
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
@@ -35,10 +35,13 @@ void ModelCSourceGen<Base>::generateZeroSource() {
         }
     }
 
+    std::unique_ptr<ADFun<CGBase> > funCopy;
+    ADFun<CGBase>& fun = prepareParameters(handler, funCopy);
+
     std::vector<CGBase> dep;
 
     if (_loopTapes.empty()) {
-        dep = _fun.Forward(0, indVars);
+        dep = fun.Forward(0, indVars);
     } else {
         /**
          * Contains loops
@@ -52,6 +55,11 @@ void ModelCSourceGen<Base>::generateZeroSource() {
     langC.setMaxAssignmentsPerFunction(_maxAssignPerFunc, &_sources);
     langC.setMaxOperationsPerAssignment(_maxOperationsPerAssignment);
     langC.setParameterPrecision(_parameterPrecision);
+    langC.setRestrictPointers(_restrictPointers);
+    langC.setSimdLoops(_simdLoops);
+    langC.setDirectAtomicFunctions(_directAtomicFunctions);
+    langC.setBatchAtomicLoops(_batchAtomicLoops);
+    langC.setMaxBatchAtomicValues(_maxBatchAtomicValues);
     langC.setGenerateFunction(_name + "_" + FUNCTION_FORWAD_ZERO);
 
     std::ostringstream code;
@@ -117,6 +117,11 @@ void ModelCSourceGen<Base>::generateSparseForwardOneSourcesWithAtomics(const std
         langC.setMaxAssignmentsPerFunction(_maxAssignPerFunc, &_sources);
         langC.setMaxOperationsPerAssignment(_maxOperationsPerAssignment);
         langC.setParameterPrecision(_parameterPrecision);
+        langC.setRestrictPointers(_restrictPointers);
+        langC.setSimdLoops(_simdLoops);
+        langC.setDirectAtomicFunctions(_directAtomicFunctions);
+        langC.setBatchAtomicLoops(_batchAtomicLoops);
+        langC.setMaxBatchAtomicValues(_maxBatchAtomicValues);
         _cache.str("");
         _cache << _name << "_" << FUNCTION_SPARSE_FORWARD_ONE << "_indep" << j;
         langC.setGenerateFunction(_cache.str());
@@ -204,6 +209,11 @@ void ModelCSourceGen<Base>::generateSparseForwardOneSourcesNoAtomics(const std::
         langC.setMaxAssignmentsPerFunction(_maxAssignPerFunc, &_sources);
         langC.setMaxOperationsPerAssignment(_maxOperationsPerAssignment);
         langC.setParameterPrecision(_parameterPrecision);
+        langC.setRestrictPointers(_restrictPointers);
+        langC.setSimdLoops(_simdLoops);
+        langC.setDirectAtomicFunctions(_directAtomicFunctions);
+        langC.setBatchAtomicLoops(_batchAtomicLoops);
+        langC.setMaxBatchAtomicValues(_maxBatchAtomicValues);
         _cache.str("");
         _cache << _name << "_" << FUNCTION_SPARSE_FORWARD_ONE << "_indep" << j;
         langC.setGenerateFunction(_cache.str());
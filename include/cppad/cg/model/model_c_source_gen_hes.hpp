@@ -66,6 +66,11 @@ void ModelCSourceGen<Base>::generateHessianSource() {
     langC.setMaxAssignmentsPerFunction(_maxAssignPerFunc, &_sources);
     langC.setMaxOperationsPerAssignment(_maxOperationsPerAssignment);
     langC.setParameterPrecision(_parameterPrecision);
+    langC.setRestrictPointers(_restrictPointers);
+    langC.setSimdLoops(_simdLoops);
+    langC.setDirectAtomicFunctions(_directAtomicFunctions);
+    langC.setBatchAtomicLoops(_batchAtomicLoops);
+    langC.setMaxBatchAtomicValues(_maxBatchAtomicValues);
     langC.setGenerateFunction(_name + "_" + FUNCTION_HESSIAN);
 
     std::ostringstream code;
@@ -172,6 +177,9 @@ void ModelCSourceGen<Base>::generateSparseHessianSourceDirectly() {
         }
     }
 
+    std::unique_ptr<ADFun<CGBase> > funCopy;
+    ADFun<CGBase>& fun = prepareParameters(handler, funCopy);
+
     // multipliers
     vector<CGBase> w(m);
     handler.makeVariables(w);
@@ -189,7 +197,7 @@ void ModelCSourceGen<Base>::generateSparseHessianSourceDirectly() {
         // (some values could be zeroed)
         work.color_method = "cppad.general";
         vector<CGBase> lowerHess(lowerHessRows.size());
-        _fun.SparseHessian(indVars, w, _hessSparsity.sparsity, lowerHessRows, lowerHessCols, lowerHess, work);
+        fun.SparseHessian(indVars, w, _hessSparsity.sparsity, lowerHessRows, lowerHessCols, lowerHess, work);
 
         for (size_t i = 0; i < lowerHessOrder.size(); i++) {
             hess[lowerHessOrder[i]] = lowerHess[i];
@@ -214,11 +222,16 @@ void ModelCSourceGen<Base>::generateSparseHessianSourceDirectly() {
     langC.setMaxAssignmentsPerFunction(_maxAssignPerFunc, &_sources);
     langC.setMaxOperationsPerAssignment(_maxOperationsPerAssignment);
     langC.setParameterPrecision(_parameterPrecision);
+    langC.setRestrictPointers(_restrictPointers);
+    langC.setSimdLoops(_simdLoops);
+    langC.setDirectAtomicFunctions(_directAtomicFunctions);
+    langC.setBatchAtomicLoops(_batchAtomicLoops);
+    langC.setMaxBatchAtomicValues(_maxBatchAtomicValues);
     langC.setGenerateFunction(_name + "_" + FUNCTION_SPARSE_HESSIAN);
 
     std::ostringstream code;
     std::unique_ptr<VariableNameGenerator<Base> > nameGen(createVariableNameGenerator("hess"));
-    LangCDefaultHessianVarNameGenerator<Base> nameGenHess(nameGen.get(), n);
+    LangCDefaultHessianVarNameGenerator<Base> nameGenHess(nameGen.get(), n + getParameterCount());
 
     handler.generateCode(code, langC, hess, nameGenHess, _atomicFunctions, jobName);
 }
@@ -657,6 +670,10 @@ void ModelCSourceGen<Base>::determineHessianSparsity() {
         _hessSparsity.rows = _custom_hess.row;
         _hessSparsity.cols = _custom_hess.col;
     }
+
+    if (_hessCompressed) {
+        sortCompressed(_hessSparsity, _hessCompressedOrder);
+    }
 }
 
 template<class Base>
@@ -667,6 +684,13 @@ void ModelCSourceGen<Base>::generateHessianSparsitySource() {
     _sources[_name + "_" + FUNCTION_HESSIAN_SPARSITY + ".c"] = _cache.str();
     _cache.str("");
 
+    if (_hessCompressed) {
+        generateSparsityCompressedSource(_name + "_" + FUNCTION_HESSIAN_SPARSITY_COMPRESSED, _hessSparsity,
+                                         _hessCompressedOrder, _fun.Domain());
+        _sources[_name + "_" + FUNCTION_HESSIAN_SPARSITY_COMPRESSED + ".c"] = _cache.str();
+        _cache.str("");
+    }
+
     if (_hessianByEquation || _reverseTwo) {
         generateSparsity2DSource2(_name + "_" + FUNCTION_HESSIAN_SPARSITY2, _hessSparsities);
         _sources[_name + "_" + FUNCTION_HESSIAN_SPARSITY2 + ".c"] = _cache.str();
@@ -53,6 +53,12 @@ const std::string ModelCSourceGen<Base>::FUNCTION_HESSIAN_SPARSITY = "hessian_sp
 template<class Base>
 const std::string ModelCSourceGen<Base>::FUNCTION_HESSIAN_SPARSITY2 = "hessian_sparsity2";
 
+template<class Base>
+const std::string ModelCSourceGen<Base>::FUNCTION_JACOBIAN_SPARSITY_COMPRESSED = "jacobian_sparsity_compressed";
+
+template<class Base>
+const std::string ModelCSourceGen<Base>::FUNCTION_HESSIAN_SPARSITY_COMPRESSED = "hessian_sparsity_compressed";
+
 template<class Base>
 const std::string ModelCSourceGen<Base>::FUNCTION_SPARSE_FORWARD_ONE = "sparse_forward_one";
 
@@ -77,6 +83,24 @@ const std::string ModelCSourceGen<Base>::FUNCTION_INFO = "info";
 template<class Base>
 const std::string ModelCSourceGen<Base>::FUNCTION_ATOMIC_FUNC_NAMES = "atomic_functions";
 
+template<class Base>
+const std::string ModelCSourceGen<Base>::FUNCTION_PARAMETER_COUNT = "parameter_count";
+
+template<class Base>
+const std::string ModelCSourceGen<Base>::FUNCTION_ATOMIC = "atomic";
+
+template<class Base>
+const std::string ModelCSourceGen<Base>::FUNCTION_DIRECT_ATOMIC_FUNC_NAMES = "direct_atomic_functions";
+
+template<class Base>
+const std::string ModelCSourceGen<Base>::FUNCTION_NEWTON_SOLVE = "newton_solve";
+
+template<class Base>
+const std::string ModelCSourceGen<Base>::FUNCTION_NEWTON_BLOCKS = "newton_blocks";
+
+template<class Base>
+const std::string ModelCSourceGen<Base>::FUNCTION_NEWTON_BLOCK = "newton_block";
+
 template<class Base>
 const std::string ModelCSourceGen<Base>::CONST = "const";
 
@@ -85,6 +109,9 @@ VariableNameGenerator<Base>* ModelCSourceGen<Base>::createVariableNameGenerator(
                                                                                 const std::string& indepName,
                                                                                 const std::string& tmpName,
                                                                                 const std::string& tmpArrayName) {
+    if (getParameterCount() > 0) {
+        return new LangCParameterVariableNameGenerator<Base> (_fun.Domain(), depName, indepName, "p", tmpName, tmpArrayName);
+    }
     return new LangCDefaultVariableNameGenerator<Base> (depName, indepName, tmpName, tmpArrayName);
 }
 
@@ -102,8 +129,15 @@ void ModelCSourceGen<Base>::generateSources(MultiThreadingType multiThreadingTyp
                                             JobTimer* timer) {
     _jobTimer = timer;
 
+    checkParameterSupport();
+
     generateLoops();
 
+    if (!_loopTapes.empty()) {
+        // the sources for the loops only use the LangCAtomicFun structure
+        _directAtomicFunctions.clear();
+    }
+
     startingJob("'" + _name + "'", JobTimer::SOURCE_FOR_MODEL);
 
     if (_zero) {
@@ -150,16 +184,60 @@ void ModelCSourceGen<Base>::generateSources(MultiThreadingType multiThreadingTyp
         generateHessianSparsitySource();
     }
 
+    if (!_newtonBlocks.empty()) {
+        generateNewtonSolverSource();
+    }
+
+    if (_directlyCallable) {
+        generateDirectAtomicSources();
+    }
+
     generateInfoSource();
 
     generateAtomicFuncNames();
 
+    generateDirectAtomicFuncNames();
+
     finishedJob();
 }
 
+template<class Base>
+void ModelCSourceGen<Base>::checkParameterSupport() {
+    if (getParameterCount() == 0) {
+        return; //nothing to do
+    }
+
+    if (_jacobian || _hessian || _forwardOne || _reverseOne || _reverseTwo) {
+        throw CGException("Model '", _name, "' has runtime parameters which are only supported by the zero order forward mode,"
+                          " the sparse Jacobian, and the sparse Hessian");
+    }
+
+    if (!_relatedDepCandidates.empty() || _autoRelatedDependents) {
+        throw CGException("Model '", _name, "' has runtime parameters which are not supported with loops");
+    }
+}
+
+template<class Base>
+ADFun<CG<Base> >& ModelCSourceGen<Base>::prepareParameters(CodeHandler<Base>& handler,
+                                                           std::unique_ptr<ADFun<CGBase> >& funCopy) {
+    size_t np = getParameterCount();
+    if (np == 0) {
+        return _fun; //nothing to do
+    }
+
+    std::vector<CGBase> params(np);
+    handler.makeVariables(params);
+
+    funCopy.reset(new ADFun<CGBase>());
+    *funCopy = _fun;
+    funCopy->new_dynamic(params);
+
+    return *funCopy;
+}
+
 template<class Base>
 void ModelCSourceGen<Base>::generateLoops() {
-    if (_relatedDepCandidates.empty()) {
+    if (_relatedDepCandidates.empty() && !_autoRelatedDependents) {
         return; //nothing to do
     }
 
@@ -178,7 +256,20 @@ void ModelCSourceGen<Base>::generateLoops() {
 
     std::vector<CGBase> yy = _fun.Forward(0, xx);
 
-    DependentPatternMatcher<Base> matcher(_relatedDepCandidates, yy, xx);
+    std::vector<std::set<size_t> > foundCandidates;
+    if (_relatedDepCandidates.empty()) {
+        RelatedDependentsFinder<Base> finder;
+        foundCandidates = finder.find(yy);
+
+        if (foundCandidates.empty()) {
+            finishedJob();
+            return; //nothing to do
+        }
+    }
+    const std::vector<std::set<size_t> >& candidates = _relatedDepCandidates.empty() ? foundCandidates : _relatedDepCandidates;
+
+    DependentPatternMatcher<Base> matcher(candidates, yy, xx);
+    matcher.setThreadCount(_loopDetectionThreads);
     matcher.generateTapes(_funNoLoops, _loopTapes);
 
     finishedJob();
@@ -211,6 +302,16 @@ void ModelCSourceGen<Base>::generateInfoSource() {
             "}\n\n";
 
     _sources[funcName + ".c"] = _cache.str();
+
+    funcName = _name + "_" + FUNCTION_PARAMETER_COUNT;
+
+    _cache.str("");
+    LanguageC<Base>::printFunctionDeclaration(_cache, "void", funcName, {"unsigned long* np"});
+    _cache << " {\n"
+            "   *np = " << getParameterCount() << ";\n"
+            "}\n\n";
+
+    _sources[funcName + ".c"] = _cache.str();
 }
 
 template<class Base>
@@ -234,6 +335,36 @@ void ModelCSourceGen<Base>::generateAtomicFuncNames() {
     _sources[funcName + ".c"] = _cache.str();
 }
 
+template<class Base>
+void ModelCSourceGen<Base>::generateDirectAtomicFuncNames() {
+    std::vector<std::string> direct;
+    for (const std::string& name : _atomicFunctions) {
+        if (_directAtomicFunctions.find(name) != _directAtomicFunctions.end())
+            direct.push_back(name);
+    }
+
+    if (direct.empty())
+        return; // the library does not need to provide this function
+
+    std::string funcName = _name + "_" + FUNCTION_DIRECT_ATOMIC_FUNC_NAMES;
+    size_t n = direct.size();
+    _cache.str("");
+    LanguageC<Base>::printFunctionDeclaration(_cache, "void", funcName, {"const char*** names",
+                                                                         "unsigned long* n"});
+    _cache << " {\n"
+            "   static const char* atomic[" << n << "] = {";
+    for (size_t i = 0; i < n; i++) {
+        if (i > 0) _cache << ", ";
+        _cache << "\"" << direct[i] << "\"";
+    }
+    _cache << "};\n"
+            "   *names = atomic;\n"
+            "   *n = " << n << ";\n"
+            "}\n\n";
+
+    _sources[funcName + ".c"] = _cache.str();
+}
+
 template<class Base>
 bool ModelCSourceGen<Base>::isAtomicsUsed() {
     if (_zeroEvaluated) {
@@ -411,6 +542,72 @@ void ModelCSourceGen<Base>::generateSparsity2DSource(const std::string& function
             "}\n";
 }
 
+template<class Base>
+void ModelCSourceGen<Base>::generateSparsityCompressedSource(const std::string& function,
+                                                             const LocalSparsityInfo& sparsity,
+                                                             SparseStorageOrder order,
+                                                             size_t nOuter) {
+    bool rowMajor = order == SparseStorageOrder::ROW_MAJOR;
+    const std::vector<size_t>& outerEl = rowMajor ? sparsity.rows : sparsity.cols;
+    const std::vector<size_t>& innerEl = rowMajor ? sparsity.cols : sparsity.rows;
+
+    std::vector<size_t> outer(nOuter + 1, 0);
+    for (size_t e = 0; e < outerEl.size(); e++) {
+        CPPADCG_ASSERT_UNKNOWN(e == 0 || outerEl[e - 1] <= outerEl[e]);
+        outer[outerEl[e] + 1]++;
+    }
+    for (size_t o = 0; o < nOuter; o++) {
+        outer[o + 1] += outer[o];
+    }
+
+    LanguageC<Base>::printFunctionDeclaration(_cache, "void", function, {"int* rowMajor",
+                                                                         "unsigned long const** outer",
+                                                                         "unsigned long const** inner",
+                                                                         "unsigned long* nOuter",
+                                                                         "unsigned long* nnz"});
+    _cache << " {\n";
+
+    _cache << "   ";
+    LanguageC<Base>::printStaticIndexArray(_cache, "outers", outer);
+
+    _cache << "   ";
+    LanguageC<Base>::printStaticIndexArray(_cache, "inners", innerEl);
+
+    _cache << "   *rowMajor = " << (rowMajor ? 1 : 0) << ";\n"
+            "   *outer = outers;\n"
+            "   *inner = inners;\n"
+            "   *nOuter = " << nOuter << ";\n"
+            "   *nnz = " << innerEl.size() << ";\n"
+            "}\n";
+}
+
+template<class Base>
+inline void ModelCSourceGen<Base>::sortCompressed(LocalSparsityInfo& sparsity,
+                                                  SparseStorageOrder order) {
+    bool rowMajor = order == SparseStorageOrder::ROW_MAJOR;
+    const std::vector<size_t>& outerEl = rowMajor ? sparsity.rows : sparsity.cols;
+    const std::vector<size_t>& innerEl = rowMajor ? sparsity.cols : sparsity.rows;
+
+    size_t nnz = sparsity.rows.size();
+    std::vector<size_t> pos(nnz);
+    for (size_t e = 0; e < nnz; e++)
+        pos[e] = e;
+
+    std::stable_sort(pos.begin(), pos.end(), [&](size_t a, size_t b) {
+        if (outerEl[a] != outerEl[b])
+            return outerEl[a] < outerEl[b];
+        return innerEl[a] < innerEl[b];
+    });
+
+    std::vector<size_t> rows(nnz), cols(nnz);
+    for (size_t e = 0; e < nnz; e++) {
+        rows[e] = sparsity.rows[pos[e]];
+        cols[e] = sparsity.cols[pos[e]];
+    }
+    sparsity.rows.swap(rows);
+    sparsity.cols.swap(cols);
+}
+
 template<class Base>
 void ModelCSourceGen<Base>::generateSparsity2DSource2(const std::string& function,
                                                       const std::vector<LocalSparsityInfo>& sparsities) {
@@ -55,6 +55,11 @@ void ModelCSourceGen<Base>::generateJacobianSource() {
     langC.setMaxAssignmentsPerFunction(_maxAssignPerFunc, &_sources);
     langC.setMaxOperationsPerAssignment(_maxOperationsPerAssignment);
     langC.setParameterPrecision(_parameterPrecision);
+    langC.setRestrictPointers(_restrictPointers);
+    langC.setSimdLoops(_simdLoops);
+    langC.setDirectAtomicFunctions(_directAtomicFunctions);
+    langC.setBatchAtomicLoops(_batchAtomicLoops);
+    langC.setMaxBatchAtomicValues(_maxBatchAtomicValues);
     langC.setGenerateFunction(_name + "_" + FUNCTION_JACOBIAN);
 
     std::ostringstream code;
@@ -119,14 +124,17 @@ void ModelCSourceGen<Base>::generateSparseJacobianSource(bool forward) {
         }
     }
 
+    std::unique_ptr<ADFun<CGBase> > funCopy;
+    ADFun<CGBase>& fun = prepareParameters(handler, funCopy);
+
     vector<CGBase> jac(_jacSparsity.rows.size());
     if (_loopTapes.empty()) {
         //printSparsityPattern(_jacSparsity.sparsity, "jac sparsity");
         CppAD::sparse_jacobian_work work;
         if (forward) {
-            _fun.SparseJacobianForward(indVars, _jacSparsity.sparsity, _jacSparsity.rows, _jacSparsity.cols, jac, work);
+            fun.SparseJacobianForward(indVars, _jacSparsity.sparsity, _jacSparsity.rows, _jacSparsity.cols, jac, work);
         } else {
-            _fun.SparseJacobianReverse(indVars, _jacSparsity.sparsity, _jacSparsity.rows, _jacSparsity.cols, jac, work);
+            fun.SparseJacobianReverse(indVars, _jacSparsity.sparsity, _jacSparsity.rows, _jacSparsity.cols, jac, work);
         }
 
     } else {
@@ -139,6 +147,11 @@ void ModelCSourceGen<Base>::generateSparseJacobianSource(bool forward) {
     langC.setMaxAssignmentsPerFunction(_maxAssignPerFunc, &_sources);
     langC.setMaxOperationsPerAssignment(_maxOperationsPerAssignment);
     langC.setParameterPrecision(_parameterPrecision);
+    langC.setRestrictPointers(_restrictPointers);
+    langC.setSimdLoops(_simdLoops);
+    langC.setDirectAtomicFunctions(_directAtomicFunctions);
+    langC.setBatchAtomicLoops(_batchAtomicLoops);
+    langC.setMaxBatchAtomicValues(_maxBatchAtomicValues);
     langC.setGenerateFunction(_name + "_" + FUNCTION_SPARSE_JACOBIAN);
 
     std::ostringstream code;
@@ -475,6 +488,10 @@ void ModelCSourceGen<Base>::determineJacobianSparsity() {
         _jacSparsity.rows = _custom_jac.row;
         _jacSparsity.cols = _custom_jac.col;
     }
+
+    if (_jacCompressed) {
+        sortCompressed(_jacSparsity, _jacCompressedOrder);
+    }
 }
 
 template<class Base>
@@ -484,6 +501,14 @@ void ModelCSourceGen<Base>::generateJacobianSparsitySource() {
     generateSparsity2DSource(_name + "_" + FUNCTION_JACOBIAN_SPARSITY, _jacSparsity);
     _sources[_name + "_" + FUNCTION_JACOBIAN_SPARSITY + ".c"] = _cache.str();
     _cache.str("");
+
+    if (_jacCompressed) {
+        size_t nOuter = _jacCompressedOrder == SparseStorageOrder::ROW_MAJOR ? _fun.Range() : _fun.Domain();
+        generateSparsityCompressedSource(_name + "_" + FUNCTION_JACOBIAN_SPARSITY_COMPRESSED, _jacSparsity,
+                                         _jacCompressedOrder, nOuter);
+        _sources[_name + "_" + FUNCTION_JACOBIAN_SPARSITY_COMPRESSED + ".c"] = _cache.str();
+        _cache.str("");
+    }
 }
 
 } // END cg namespace
@@ -0,0 +1,644 @@
+#ifndef CPPAD_CG_MODEL_C_SOURCE_GEN_NEWTON_INCLUDED
+#define CPPAD_CG_MODEL_C_SOURCE_GEN_NEWTON_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+namespace CppAD {
+namespace cg {
+
+template<class Base>
+void ModelCSourceGen<Base>::generateNewtonSolverSource() {
+    determineJacobianSparsity();
+
+    const std::string& T = _baseTypeName;
+    const std::string functionSolve = _name + "_" + FUNCTION_NEWTON_SOLVE;
+
+    LanguageC<Base> langC(_baseTypeName);
+    std::string argsDcl = langC.generateDefaultFunctionArgumentsDcl();
+
+    auto printArray = [this](const std::string& name, const std::vector<size_t>& values) {
+        _cache << "   ";
+        LanguageC<Base>::printStaticIndexArray(_cache, name, values);
+    };
+
+    _cache.str("");
+    _cache << "#include <stdlib.h>\n"
+            << LanguageC<Base>::ATOMICFUN_STRUCT_DEFINITION << "\n"
+            "\n"
+            "#define CPPADCG_NEWTON_ABS(v) ((v) < 0 ? -(v) : (v))\n"
+            "\n";
+    for (size_t k = 0; k < _newtonBlocks.size(); ++k) {
+        _cache << "void " << functionSolve << "_residual" << k << "(" << argsDcl << ");\n"
+                "void " << functionSolve << "_jacobian" << k << "(" << argsDcl << ");\n";
+    }
+    _cache << "\n";
+
+    for (size_t k = 0; k < _newtonBlocks.size(); ++k) {
+        const NewtonBlock& block = _newtonBlocks[k];
+        const size_t b = block.equations.size();
+
+        std::map<size_t, size_t> eq2Local;
+        for (size_t i = 0; i < b; ++i)
+            eq2Local[block.equations[i]] = i;
+        std::map<size_t, size_t> var2Local;
+        for (size_t j = 0; j < b; ++j)
+            var2Local[block.variables[j]] = j;
+
+        if (eq2Local.size() != b || var2Local.size() != b) {
+            throw CGException("Model '", _name, "': repeated equations or variables in Newton solver block ", k);
+        }
+
+        /**
+         * the Jacobian elements of the block (by row)
+         */
+        std::vector<std::pair<size_t, size_t> > elements; // local row and column
+        for (size_t i = 0; i < b; ++i) {
+            for (size_t j : _jacSparsity.sparsity[block.equations[i]]) {
+                auto itJ = var2Local.find(j);
+                if (itJ != var2Local.end())
+                    elements.emplace_back(i, itJ->second);
+            }
+        }
+        const size_t nnzBlock = elements.size();
+
+        /**
+         * the block residuals and Jacobian (the other equations are not
+         * evaluated in the Newton iterations)
+         */
+        generateNewtonBlockSources(k, elements);
+
+        /**
+         * the linear solver
+         */
+        std::string linearFunction = functionSolve + "_linear" + std::to_string(k);
+        std::string residualFunction = functionSolve + "_residual" + std::to_string(k);
+        std::string jacobianFunction = functionSolve + "_jacobian" + std::to_string(k);
+        std::vector<size_t> luPos;
+        size_t nLU = generateNewtonLinearSolverSource(k, elements, luPos);
+        _cache << "\n";
+
+        /**
+         * the Newton solver
+         */
+        LanguageC<Base>::printFunctionDeclaration(_cache, "static int", functionSolve + std::to_string(k), {T + "* x",
+                                                                                                              T + " const* p",
+                                                                                                              "unsigned long maxIter",
+                                                                                                              T + " tol",
+                                                                                                              "unsigned long* iterations",
+                                                                                                              langC.generateArgumentAtomicDcl()});
+        _cache << " {\n";
+        printArray("vars", block.variables);
+        printArray("luPos", luPos);
+        _cache << "   " << T << " const * in[2];\n"
+                "   " << T << " * out[1];\n"
+                "   " << T << "* work;\n"
+                "   " << T << "* res;\n"
+                "   " << T << "* jac;\n"
+                "   " << T << "* lu;\n"
+                "   " << T << "* dx;\n"
+                "   " << T << "* x0;\n"
+                "   " << T << "* tmp;\n"
+                "   " << T << " f, fNew, alpha, v, resMax;\n"
+                "   unsigned long i, e, it;\n"
+                "   int ret, accepted;\n"
+                "\n"
+                "   work = (" << T << "*) malloc(" << (b + nnzBlock + nLU + 3 * b) << " * sizeof(" << T << "));\n"
+                "   if (work == 0)\n"
+                "      return " << int(NewtonSolverStatus::OutOfMemory) << ";\n"
+                "   res = work;\n"
+                "   jac = res + " << b << ";\n"
+                "   lu = jac + " << nnzBlock << ";\n"
+                "   dx = lu + " << nLU << ";\n"
+                "   x0 = dx + " << b << ";\n"
+                "   tmp = x0 + " << b << ";\n"
+                "\n"
+                "   in[0] = x;\n"
+                "   in[1] = p;\n"
+                "\n"
+                "   out[0] = res;\n"
+                "   " << residualFunction << "(in, out, atomicFun);\n"
+                "   f = 0;\n"
+                "   for (i = 0; i < " << b << "; i++)\n"
+                "      f += res[i] * res[i];\n"
+                "   f *= 0.5;\n"
+                "\n"
+                "   ret = " << int(NewtonSolverStatus::MaxIterations) << ";\n"
+                "   for (it = 0; ; it++) {\n"
+                "      resMax = 0;\n"
+                "      for (i = 0; i < " << b << "; i++) {\n"
+                "         v = CPPADCG_NEWTON_ABS(res[i]);\n"
+                "         if (!(v <= resMax))\n"
+                "            resMax = v; // also propagates NaN\n"
+                "      }\n"
+                "      if (resMax <= tol) {\n"
+                "         ret = " << int(NewtonSolverStatus::Converged) << ";\n"
+                "         break;\n"
+                "      }\n"
+                "      if (it >= maxIter)\n"
+                "         break;\n"
+                "\n"
+                "      out[0] = jac;\n"
+                "      " << jacobianFunction << "(in, out, atomicFun);\n"
+                "\n"
+                "      for (e = 0; e < " << nLU << "; e++)\n"
+                "         lu[e] = 0;\n"
+                "      for (e = 0; e < " << nnzBlock << "; e++)\n"
+                "         lu[luPos[e]] = jac[e];\n"
+                "\n"
+                "      for (i = 0; i < " << b << "; i++)\n"
+                "         dx[i] = -res[i];\n"
+                "\n"
+                "      if (" << linearFunction << "(lu, dx, tmp) != 0) {\n"
+                "         ret = " << int(NewtonSolverStatus::SingularJacobian) << ";\n"
+                "         break;\n"
+                "      }\n"
+                "\n"
+                "      /**\n"
+                "       * backtracking line search (Armijo condition)\n"
+                "       */\n"
+                "      for (i = 0; i < " << b << "; i++)\n"
+                "         x0[i] = x[vars[i]];\n"
+                "\n"
+                "      accepted = 0;\n"
+                "      for (alpha = 1; alpha >= 1e-10; alpha *= 0.5) {\n"
+                "         for (i = 0; i < " << b << "; i++)\n"
+                "            x[vars[i]] = x0[i] + alpha * dx[i];\n"
+                "\n"
+                "         out[0] = res;\n"
+                "         " << residualFunction << "(in, out, atomicFun);\n"
+                "         fNew = 0;\n"
+                "         for (i = 0; i < " << b << "; i++)\n"
+                "            fNew += res[i] * res[i];\n"
+                "         fNew *= 0.5;\n"
+                "\n"
+                "         if (fNew <= (1 - 2e-4 * alpha) * f) {\n"
+                "            accepted = 1;\n"
+                "            break;\n"
+                "         }\n"
+                "      }\n"
+                "\n"
+                "      if (!accepted) {\n"
+                "         for (i = 0; i < " << b << "; i++)\n"
+                "            x[vars[i]] = x0[i];\n"
+                "         ret = " << int(NewtonSolverStatus::LineSearchFailed) << ";\n"
+                "         break;\n"
+                "      }\n"
+                "      f = fNew;\n"
+                "   }\n"
+                "\n"
+                "   if (iterations != 0)\n"
+                "      *iterations = it;\n"
+                "\n"
+                "   free(work);\n"
+                "   return ret;\n"
+                "}\n\n";
+    }
+
+    /**
+     * the function which selects the block
+     */
+    LanguageC<Base>::printFunctionDeclaration(_cache, "int", functionSolve, {"unsigned long block",
+                                                                             T + "* x",
+                                                                             T + " const* p",
+                                                                             "unsigned long maxIter",
+                                                                             T + " tol",
+                                                                             "unsigned long* iterations",
+                                                                             langC.generateArgumentAtomicDcl()});
+    _cache << " {\n"
+            "   switch(block) {\n";
+    for (size_t k = 0; k < _newtonBlocks.size(); ++k) {
+        _cache << "      case " << k << ":\n"
+                "         return " << functionSolve << k << "(x, p, maxIter, tol, iterations, atomicFun);\n";
+    }
+    _cache << "      default:\n"
+            "         return -1; // error\n"
+            "   };\n"
+            "}\n\n";
+
+    _sources[functionSolve + ".c"] = _cache.str();
+
+    /**
+     * the blocks
+     */
+    std::string functionBlocks = _name + "_" + FUNCTION_NEWTON_BLOCKS;
+    _cache.str("");
+    LanguageC<Base>::printFunctionDeclaration(_cache, "void", functionBlocks, {"unsigned long* n"});
+    _cache << " {\n"
+            "   *n = " << _newtonBlocks.size() << ";\n"
+            "}\n\n";
+    _sources[functionBlocks + ".c"] = _cache.str();
+
+    std::string functionBlock = _name + "_" + FUNCTION_NEWTON_BLOCK;
+    _cache.str("");
+    LanguageC<Base>::printFunctionDeclaration(_cache, "void", functionBlock, {"unsigned long block",
+                                                                              "unsigned long const** equations",
+                                                                              "unsigned long const** variables",
+                                                                              "unsigned long* size"});
+    _cache << " {\n";
+    for (size_t k = 0; k < _newtonBlocks.size(); ++k) {
+        printArray("eqs" + std::to_string(k), _newtonBlocks[k].equations);
+        printArray("vars" + std::to_string(k), _newtonBlocks[k].variables);
+    }
+    _cache << "\n"
+            "   switch(block) {\n";
+    for (size_t k = 0; k < _newtonBlocks.size(); ++k) {
+        _cache << "      case " << k << ":\n"
+                "         *equations = eqs" << k << ";\n"
+                "         *variables = vars" << k << ";\n"
+                "         *size = " << _newtonBlocks[k].equations.size() << ";\n"
+                "         return;\n";
+    }
+    _cache << "      default:\n"
+            "         *equations = 0;\n"
+            "         *variables = 0;\n"
+            "         *size = 0;\n"
+            "   };\n"
+            "}\n\n";
+    _sources[functionBlock + ".c"] = _cache.str();
+    _cache.str("");
+}
+
+template<class Base>
+void ModelCSourceGen<Base>::generateNewtonBlockSources(size_t k,
+                                                       const std::vector<std::pair<size_t, size_t> >& blockElements) {
+    const NewtonBlock& block = _newtonBlocks[k];
+    const size_t n = _fun.Domain();
+    const size_t b = block.equations.size();
+    const std::string function = _name + "_" + FUNCTION_NEWTON_SOLVE;
+
+    std::vector<size_t> rows(blockElements.size()), cols(blockElements.size());
+    for (size_t e = 0; e < blockElements.size(); e++) {
+        rows[e] = block.equations[blockElements[e].first];
+        cols[e] = block.variables[blockElements[e].second];
+    }
+
+    /**
+     * only the operations used by the block equations are included in the
+     * generated functions
+     */
+    for (bool jacobian : {false, true}) {
+        const std::string funcName = function + (jacobian ? "_jacobian" : "_residual") + std::to_string(k);
+        const std::string jobName = std::string("Newton solver block ") + (jacobian ? "Jacobian " : "residuals ") + std::to_string(k);
+
+        startingJob("'" + jobName + "'", JobTimer::GRAPH);
+
+        CodeHandler<Base> handler;
+        handler.setJobTimer(_jobTimer);
+
+        std::vector<CGBase> indVars(n);
+        handler.makeVariables(indVars);
+        if (_x.size() > 0) {
+            for (size_t j = 0; j < n; j++) {
+                indVars[j].setValue(_x[j]);
+            }
+        }
+
+        std::unique_ptr<ADFun<CGBase> > funCopy;
+        ADFun<CGBase>& fun = prepareParameters(handler, funCopy);
+
+        std::vector<CGBase> values;
+        if (jacobian) {
+            values.resize(blockElements.size());
+            CppAD::sparse_jacobian_work work;
+            if (_jacMode == JacobianADMode::Reverse) {
+                fun.SparseJacobianReverse(indVars, _jacSparsity.sparsity, rows, cols, values, work);
+            } else {
+                fun.SparseJacobianForward(indVars, _jacSparsity.sparsity, rows, cols, values, work);
+            }
+        } else {
+            std::vector<CGBase> dep = fun.Forward(0, indVars);
+            values.resize(b);
+            for (size_t i = 0; i < b; i++)
+                values[i] = dep[block.equations[i]];
+        }
+
+        finishedJob();
+
+        LanguageC<Base> langC(_baseTypeName);
+        langC.setMaxAssignmentsPerFunction(_maxAssignPerFunc, &_sources);
+        langC.setMaxOperationsPerAssignment(_maxOperationsPerAssignment);
+        langC.setParameterPrecision(_parameterPrecision);
+        langC.setRestrictPointers(_restrictPointers);
+        langC.setDirectAtomicFunctions(_directAtomicFunctions);
+        langC.setGenerateFunction(funcName);
+
+        std::ostringstream code;
+        std::unique_ptr<VariableNameGenerator<Base> > nameGen(createVariableNameGenerator(jacobian ? "jac" : "y"));
+
+        handler.generateCode(code, langC, values, *nameGen, _atomicFunctions, jobName);
+    }
+}
+
+template<class Base>
+size_t ModelCSourceGen<Base>::generateNewtonLinearSolverSource(size_t k,
+                                                               const std::vector<std::pair<size_t, size_t> >& blockElements,
+                                                               std::vector<size_t>& luPos) {
+    const NewtonBlock& block = _newtonBlocks[k];
+    const std::string& T = _baseTypeName;
+    const size_t b = block.equations.size();
+    const std::string function = _name + "_" + FUNCTION_NEWTON_SOLVE + "_linear" + std::to_string(k);
+
+    auto printArray = [this](const std::string& name, const std::vector<size_t>& values) {
+        _cache << "   ";
+        LanguageC<Base>::printStaticIndexArray(_cache, name, values);
+    };
+
+    luPos.resize(blockElements.size());
+
+    LanguageC<Base>::printFunctionDeclaration(_cache, "static int", function, {T + "* lu",
+                                                                               T + "* dx",
+                                                                               T + "* tmp"});
+    _cache << " {\n";
+
+    if (block.linearSolver == NewtonLinearSolver::DenseLU) {
+        for (size_t e = 0; e < blockElements.size(); ++e)
+            luPos[e] = blockElements[e].first * b + blockElements[e].second;
+
+        /**
+         * LU factorization with partial pivoting
+         */
+        _cache << "   unsigned long i, j, k, piv;\n"
+                "   " << T << " vmax, v, l;\n"
+                "\n"
+                "   (void) tmp;\n"
+                "\n"
+                "   for (k = 0; k < " << b << "; k++) {\n"
+                "      piv = k;\n"
+                "      vmax = CPPADCG_NEWTON_ABS(lu[k * " << b << " + k]);\n"
+                "      for (i = k + 1; i < " << b << "; i++) {\n"
+                "         v = CPPADCG_NEWTON_ABS(lu[i * " << b << " + k]);\n"
+                "         if (v > vmax) {\n"
+                "            vmax = v;\n"
+                "            piv = i;\n"
+                "         }\n"
+                "      }\n"
+                "      if (!(vmax > 0))\n"
+                "         return 1; // singular\n"
+                "\n"
+                "      if (piv != k) {\n"
+                "         for (j = k; j < " << b << "; j++) {\n"
+                "            v = lu[k * " << b << " + j];\n"
+                "            lu[k * " << b << " + j] = lu[piv * " << b << " + j];\n"
+                "            lu[piv * " << b << " + j] = v;\n"
+                "         }\n"
+                "         v = dx[k];\n"
+                "         dx[k] = dx[piv];\n"
+                "         dx[piv] = v;\n"
+                "      }\n"
+                "\n"
+                "      for (i = k + 1; i < " << b << "; i++) {\n"
+                "         l = lu[i * " << b << " + k] / lu[k * " << b << " + k];\n"
+                "         if (l != 0) {\n"
+                "            for (j = k + 1; j < " << b << "; j++)\n"
+                "               lu[i * " << b << " + j] -= l * lu[k * " << b << " + j];\n"
+                "            dx[i] -= l * dx[k];\n"
+                "         }\n"
+                "      }\n"
+                "   }\n"
+                "\n"
+                "   for (i = " << b << "; i-- > 0;) {\n"
+                "      for (j = i + 1; j < " << b << "; j++)\n"
+                "         dx[i] -= lu[i * " << b << " + j] * dx[j];\n"
+                "      dx[i] /= lu[i * " << b << " + i];\n"
+                "   }\n"
+                "\n"
+                "   return 0;\n"
+                "}\n";
+        return b * b;
+    }
+
+    /**
+     * LU factorization with a static pivot order
+     */
+    std::vector<std::set<size_t> > elements(b);
+    for (const auto& el : blockElements)
+        elements[el.first].insert(el.second);
+
+    StaticSparseLU slu = determineStaticSparseLU(b, elements);
+
+    std::vector<size_t> rowPos(b); // block row -> position
+    std::vector<size_t> colPos(b); // block column -> position
+    for (size_t p = 0; p < b; ++p) {
+        rowPos[slu.rowPerm[p]] = p;
+        colPos[slu.colPerm[p]] = p;
+    }
+
+    for (size_t e = 0; e < blockElements.size(); ++e) {
+        size_t r = rowPos[blockElements[e].first];
+        size_t c = colPos[blockElements[e].second];
+        auto begin = slu.col.begin() + slu.rowStart[r];
+        auto end = slu.col.begin() + slu.rowStart[r + 1];
+        auto it = std::lower_bound(begin, end, c);
+        CPPADCG_ASSERT_UNKNOWN(it != end && *it == c)
+        luPos[e] = it - slu.col.begin();
+    }
+
+    printArray("rowPerm", slu.rowPerm);
+    printArray("colPerm", slu.colPerm);
+    printArray("rowStart", slu.rowStart);
+    printArray("col", slu.col);
+    printArray("diag", slu.diag);
+    printArray("divPos", slu.divPos);
+    printArray("divPivot", slu.divPivot);
+    printArray("updStart", slu.updStart);
+    printArray("updTarget", slu.updTarget);
+    printArray("updSource", slu.updSource);
+    _cache << "   unsigned long d, u, i, e;\n"
+            "   " << T << " l;\n"
+            "\n"
+            "   for (d = 0; d < " << slu.divPos.size() << "; d++) {\n"
+            "      if (lu[divPivot[d]] == 0)\n"
+            "         return 1; // singular\n"
+            "      l = lu[divPos[d]] / lu[divPivot[d]];\n"
+            "      lu[divPos[d]] = l;\n"
+            "      for (u = updStart[d]; u < updStart[d + 1]; u++)\n"
+            "         lu[updTarget[u]] -= l * lu[updSource[u]];\n"
+            "   }\n"
+            "\n"
+            "   for (i = 0; i < " << b << "; i++) {\n"
+            "      if (!(CPPADCG_NEWTON_ABS(lu[diag[i]]) > 0))\n"
+            "         return 1; // singular\n"
+            "      tmp[i] = dx[rowPerm[i]];\n"
+            "   }\n"
+            "\n"
+            "   for (i = 0; i < " << b << "; i++) {\n"
+            "      for (e = rowStart[i]; e < diag[i]; e++)\n"
+            "         tmp[i] -= lu[e] * tmp[col[e]];\n"
+            "   }\n"
+            "\n"
+            "   for (i = " << b << "; i-- > 0;) {\n"
+            "      for (e = diag[i] + 1; e < rowStart[i + 1]; e++)\n"
+            "         tmp[i] -= lu[e] * tmp[col[e]];\n"
+            "      tmp[i] /= lu[diag[i]];\n"
+            "   }\n"
+            "\n"
+            "   for (i = 0; i < " << b << "; i++)\n"
+            "      dx[colPerm[i]] = tmp[i];\n"
+            "\n"
+            "   return 0;\n"
+            "}\n";
+
+    return slu.col.size();
+}
+
+template<class Base>
+typename ModelCSourceGen<Base>::StaticSparseLU ModelCSourceGen<Base>::determineStaticSparseLU(size_t size,
+                                                                                                const std::vector<std::set<size_t> >& elements) {
+    CPPADCG_ASSERT_UNKNOWN(elements.size() == size)
+
+    const size_t none = (std::numeric_limits<size_t>::max)();
+
+    /**
+     * match each column to a row (augmenting paths)
+     */
+    std::vector<size_t> colMatch(size, none);
+    std::vector<bool> visited(size);
+
+    std::function<bool(size_t)> augment = [&](size_t r) {
+        for (size_t c : elements[r]) {
+            if (visited[c])
+                continue;
+            visited[c] = true;
+            if (colMatch[c] == none || augment(colMatch[c])) {
+                colMatch[c] = r;
+                return true;
+            }
+        }
+        return false;
+    };
+
+    for (size_t r = 0; r < size; ++r) {
+        std::fill(visited.begin(), visited.end(), false);
+        if (!augment(r)) {
+            throw CGException("Newton solver block is structurally singular");
+        }
+    }
+
+    /**
+     * minimum degree ordering of the columns (using the symmetric pattern
+     * of the matrix with the matched rows in the diagonal)
+     */
+    std::vector<std::set<size_t> > adj(size);
+    for (size_t c = 0; c < size; ++c) {
+        for (size_t c2 : elements[colMatch[c]]) {
+            if (c2 != c) {
+                adj[c].insert(c2);
+                adj[c2].insert(c);
+            }
+        }
+    }
+
+    std::vector<size_t> order;
+    order.reserve(size);
+    std::vector<bool> eliminated(size, false);
+    for (size_t k = 0; k < size; ++k) {
+        size_t best = none;
+        for (size_t c = 0; c < size; ++c) {
+            if (!eliminated[c] && (best == none || adj[c].size() < adj[best].size()))
+                best = c;
+        }
+
+        eliminated[best] = true;
+        order.push_back(best);
+
+        std::vector<size_t> neighbours(adj[best].begin(), adj[best].end());
+        for (size_t u : neighbours) {
+            adj[u].erase(best);
+            for (size_t v : neighbours) {
+                if (u != v)
+                    adj[u].insert(v);
+            }
+        }
+        adj[best].clear();
+    }
+
+    StaticSparseLU lu;
+    lu.colPerm = order;
+    lu.rowPerm.resize(size);
+
+    std::vector<size_t> colPos(size);
+    for (size_t k = 0; k < size; ++k) {
+        lu.rowPerm[k] = colMatch[order[k]];
+        colPos[order[k]] = k;
+    }
+
+    /**
+     * symbolic factorization
+     */
+    std::vector<std::set<size_t> > rows(size);
+    std::vector<std::set<size_t> > lowerRows(size); // the rows with a non-zero below the diagonal of each column
+    for (size_t k = 0; k < size; ++k) {
+        for (size_t c : elements[lu.rowPerm[k]]) {
+            size_t l = colPos[c];
+            rows[k].insert(l);
+            if (l < k)
+                lowerRows[l].insert(k);
+        }
+    }
+
+    for (size_t k = 0; k < size; ++k) {
+        for (size_t i : lowerRows[k]) {
+            for (auto it = rows[k].upper_bound(k); it != rows[k].end(); ++it) {
+                size_t l = *it;
+                if (rows[i].insert(l).second && l < i) {
+                    lowerRows[l].insert(i); // fill-in (l > k)
+                }
+            }
+        }
+    }
+
+    lu.rowStart.resize(size + 1);
+    lu.diag.resize(size);
+    lu.rowStart[0] = 0;
+    for (size_t k = 0; k < size; ++k) {
+        for (size_t l : rows[k]) {
+            if (l == k)
+                lu.diag[k] = lu.col.size();
+            lu.col.push_back(l);
+        }
+        lu.rowStart[k + 1] = lu.col.size();
+    }
+
+    auto position = [&](size_t r, size_t c) {
+        auto begin = lu.col.begin() + lu.rowStart[r];
+        auto end = lu.col.begin() + lu.rowStart[r + 1];
+        auto it = std::lower_bound(begin, end, c);
+        CPPADCG_ASSERT_UNKNOWN(it != end && *it == c)
+        return size_t(it - lu.col.begin());
+    };
+
+    /**
+     * numeric operations
+     */
+    lu.updStart.push_back(0);
+    for (size_t k = 0; k < size; ++k) {
+        for (size_t i : lowerRows[k]) {
+            lu.divPos.push_back(position(i, k));
+            lu.divPivot.push_back(lu.diag[k]);
+            for (auto it = rows[k].upper_bound(k); it != rows[k].end(); ++it) {
+                lu.updTarget.push_back(position(i, *it));
+                lu.updSource.push_back(position(k, *it));
+            }
+            lu.updStart.push_back(lu.updTarget.size());
+        }
+    }
+
+    return lu;
+}
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
@@ -122,6 +122,11 @@ void ModelCSourceGen<Base>::generateSparseReverseOneSourcesWithAtomics(const std
         langC.setMaxAssignmentsPerFunction(_maxAssignPerFunc, &_sources);
         langC.setMaxOperationsPerAssignment(_maxOperationsPerAssignment);
         langC.setParameterPrecision(_parameterPrecision);
+        langC.setRestrictPointers(_restrictPointers);
+        langC.setSimdLoops(_simdLoops);
+        langC.setDirectAtomicFunctions(_directAtomicFunctions);
+        langC.setBatchAtomicLoops(_batchAtomicLoops);
+        langC.setMaxBatchAtomicValues(_maxBatchAtomicValues);
         _cache.str("");
         _cache << _name << "_" << FUNCTION_SPARSE_REVERSE_ONE << "_dep" << i;
         langC.setGenerateFunction(_cache.str());
@@ -210,6 +215,11 @@ void ModelCSourceGen<Base>::generateSparseReverseOneSourcesNoAtomics(const std::
         langC.setMaxAssignmentsPerFunction(_maxAssignPerFunc, &_sources);
         langC.setMaxOperationsPerAssignment(_maxOperationsPerAssignment);
         langC.setParameterPrecision(_parameterPrecision);
+        langC.setRestrictPointers(_restrictPointers);
+        langC.setSimdLoops(_simdLoops);
+        langC.setDirectAtomicFunctions(_directAtomicFunctions);
+        langC.setBatchAtomicLoops(_batchAtomicLoops);
+        langC.setMaxBatchAtomicValues(_maxBatchAtomicValues);
         _cache.str("");
         _cache << _name << "_" << FUNCTION_SPARSE_REVERSE_ONE << "_dep" << i;
         langC.setGenerateFunction(_cache.str());
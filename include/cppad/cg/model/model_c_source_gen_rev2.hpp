@@ -130,6 +130,11 @@ void ModelCSourceGen<Base>::generateSparseReverseTwoSourcesWithAtomics(const std
         langC.setMaxAssignmentsPerFunction(_maxAssignPerFunc, &_sources);
         langC.setMaxOperationsPerAssignment(_maxOperationsPerAssignment);
         langC.setParameterPrecision(_parameterPrecision);
+        langC.setRestrictPointers(_restrictPointers);
+        langC.setSimdLoops(_simdLoops);
+        langC.setDirectAtomicFunctions(_directAtomicFunctions);
+        langC.setBatchAtomicLoops(_batchAtomicLoops);
+        langC.setMaxBatchAtomicValues(_maxBatchAtomicValues);
         _cache.str("");
         _cache << _name << "_" << FUNCTION_SPARSE_REVERSE_TWO << "_indep" << j;
         langC.setGenerateFunction(_cache.str());
@@ -233,6 +238,11 @@ void ModelCSourceGen<Base>::generateSparseReverseTwoSourcesNoAtomics(const std::
         langC.setMaxAssignmentsPerFunction(_maxAssignPerFunc, &_sources);
         langC.setMaxOperationsPerAssignment(_maxOperationsPerAssignment);
         langC.setParameterPrecision(_parameterPrecision);
+        langC.setRestrictPointers(_restrictPointers);
+        langC.setSimdLoops(_simdLoops);
+        langC.setDirectAtomicFunctions(_directAtomicFunctions);
+        langC.setBatchAtomicLoops(_batchAtomicLoops);
+        langC.setMaxBatchAtomicValues(_maxBatchAtomicValues);
         _cache.str("");
         _cache << _name << "_" << FUNCTION_SPARSE_REVERSE_TWO << "_indep" << j;
         langC.setGenerateFunction(_cache.str());
@@ -63,6 +63,11 @@ protected:
      * Parallelization can be disabled locally for each model.
      */
     MultiThreadingType _multiThreading;
+    /**
+     * Whether or not models which use other models of this library as
+     * atomic functions call them directly in the generated source code
+     */
+    bool _directModelCalls;
     /**
      * temporary stream to generate source code
      */
@@ -77,7 +82,8 @@ public:
      *              this object)
      */
     inline ModelLibraryCSourceGen(ModelCSourceGen<Base>& model):
-        _multiThreading(MultiThreadingType::NONE) {
+        _multiThreading(MultiThreadingType::NONE),
+        _directModelCalls(false) {
         CPPADCG_ASSERT_KNOWN(_models.find(model.getName()) == _models.end(),
                              "Another model with the same name was already registered");
 
@@ -158,6 +164,39 @@ public:
         _multiThreading = multiThreading;
     }
 
+    /**
+     * Whether or not models which use other models of this library as
+     * atomic functions call them directly in the generated source code.
+     *
+     * @return true if direct calls between models are generated
+     */
+    inline bool isDirectModelCalls() const {
+        return _directModelCalls;
+    }
+
+    /**
+     * Defines whether or not models which use other models of this library
+     * as atomic functions (with the same name as the model) call them
+     * directly in the generated source code, instead of calling the atomic
+     * function provided to GenericModel at runtime
+     * (e.g. with addExternalModel()).
+     * This avoids the conversion of the arrays of the generated source code
+     * into Taylor coefficients and, since the calls are resolved when the
+     * library is linked, it allows compilers to inline the called model
+     * with link time optimizations.
+     * A model is only called directly if it does not use atomic functions
+     * or runtime parameters, and if it provides all the derivatives which
+     * may be required by the calling model (forward zero, forward one,
+     * reverse one, and reverse two for second order information);
+     * otherwise the atomic function must still be provided at runtime.
+     * It must be defined before the source code is generated.
+     *
+     * @param directModelCalls true to generate direct calls between models
+     */
+    inline void setDirectModelCalls(bool directModelCalls) {
+        _directModelCalls = directModelCalls;
+    }
+
     /**
      * Saves the generated C source code into several files.
      * 
@@ -186,6 +225,12 @@ protected:
 
     virtual void generateThreadPoolSources(std::map<std::string, std::string>& sources);
 
+    /**
+     * Defines which models call other models of this library directly
+     * (only if direct model calls are enabled).
+     */
+    virtual void prepareDirectModelCalls();
+
     static void saveSources(const std::string& sourcesFolder,
                             const std::map<std::string, std::string>& sources);
 
@@ -21,7 +21,7 @@ namespace CppAD {
 namespace cg {
 
 template<class Base>
-const unsigned long ModelLibraryCSourceGen<Base>::API_VERSION = 7;
+const unsigned long ModelLibraryCSourceGen<Base>::API_VERSION = 8;
 
 template<class Base>
 const std::string ModelLibraryCSourceGen<Base>::FUNCTION_VERSION = "cppad_cg_version";
@@ -78,6 +78,7 @@ void ModelLibraryCSourceGen<Base>::saveSources(const std::string& sourcesFolder)
     system::createFolder(sourcesFolder);
 
     // save/generate model sources
+    prepareDirectModelCalls();
     for (const auto& it : _models) {
         saveSources(sourcesFolder, it.second->getSources());
     }
@@ -89,6 +90,27 @@ void ModelLibraryCSourceGen<Base>::saveSources(const std::string& sourcesFolder)
     saveSources(sourcesFolder, getCustomSources());
 }
 
+template<class Base>
+void ModelLibraryCSourceGen<Base>::prepareDirectModelCalls() {
+    if (!_directModelCalls)
+        return;
+
+    for (const auto& itCaller : _models) {
+        ModelCSourceGen<Base>& caller = *itCaller.second;
+        if (!caller._sources.empty())
+            continue; // source code already generated
+
+        caller._directAtomicFunctions.clear();
+        for (const auto& itCallee : _models) {
+            ModelCSourceGen<Base>& callee = *itCallee.second;
+            if ((callee._sources.empty() || callee._directlyCallable) && callee.isDirectlyCallableBy(caller)) {
+                caller._directAtomicFunctions[callee.getName()] = callee.getName() + "_" + ModelCSourceGen<Base>::FUNCTION_ATOMIC;
+                callee._directlyCallable = true;
+            }
+        }
+    }
+}
+
 template<class Base>
 void ModelLibraryCSourceGen<Base>::saveSources(const std::string& sourcesFolder,
                                                const std::map<std::string, std::string>& sources) {
@@ -43,6 +43,7 @@ protected:
     }
 
     inline const std::map<std::string, std::string>& getSources(ModelCSourceGen<Base>& model) {
+        modelLibraryHelper_->prepareDirectModelCalls();
         return model.getSources(modelLibraryHelper_->getMultiThreading(), modelLibraryHelper_);
     }
 
@@ -347,6 +347,11 @@ void ModelCSourceGen<Base>::prepareSparseForwardOneWithLoops(const std::map<size
             LanguageC<Base> langC(_baseTypeName);
             langC.setFunctionIndexArgument(indexJcolDcl);
             langC.setParameterPrecision(_parameterPrecision);
+            langC.setRestrictPointers(_restrictPointers);
+            langC.setSimdLoops(_simdLoops);
+            langC.setDirectAtomicFunctions(_directAtomicFunctions);
+            langC.setBatchAtomicLoops(_batchAtomicLoops);
+            langC.setMaxBatchAtomicValues(_maxBatchAtomicValues);
 
             _cache.str("");
             std::ostringstream code;
@@ -431,6 +436,11 @@ void ModelCSourceGen<Base>::createForwardOneWithLoopsNL(CodeHandler<Base>& handl
     LanguageC<Base> langC(_baseTypeName);
     langC.setMaxAssignmentsPerFunction(_maxAssignPerFunc, &_sources);
     langC.setParameterPrecision(_parameterPrecision);
+    langC.setRestrictPointers(_restrictPointers);
+    langC.setSimdLoops(_simdLoops);
+    langC.setDirectAtomicFunctions(_directAtomicFunctions);
+    langC.setBatchAtomicLoops(_batchAtomicLoops);
+    langC.setMaxBatchAtomicValues(_maxBatchAtomicValues);
     _cache.str("");
     _cache << _name << "_" << FUNCTION_SPARSE_FORWARD_ONE << "_noloop_indep" << j;
     langC.setGenerateFunction(_cache.str());
@@ -282,6 +282,11 @@ void ModelCSourceGen<Base>::prepareSparseReverseOneWithLoops(const std::map<size
             LanguageC<Base> langC(_baseTypeName);
             langC.setFunctionIndexArgument(indexJrowDcl);
             langC.setParameterPrecision(_parameterPrecision);
+            langC.setRestrictPointers(_restrictPointers);
+            langC.setSimdLoops(_simdLoops);
+            langC.setDirectAtomicFunctions(_directAtomicFunctions);
+            langC.setBatchAtomicLoops(_batchAtomicLoops);
+            langC.setMaxBatchAtomicValues(_maxBatchAtomicValues);
 
             _cache.str("");
             std::ostringstream code;
@@ -366,6 +371,11 @@ void ModelCSourceGen<Base>::createReverseOneWithLoopsNL(CodeHandler<Base>& handl
     LanguageC<Base> langC(_baseTypeName);
     langC.setMaxAssignmentsPerFunction(_maxAssignPerFunc, &_sources);
     langC.setParameterPrecision(_parameterPrecision);
+    langC.setRestrictPointers(_restrictPointers);
+    langC.setSimdLoops(_simdLoops);
+    langC.setDirectAtomicFunctions(_directAtomicFunctions);
+    langC.setBatchAtomicLoops(_batchAtomicLoops);
+    langC.setMaxBatchAtomicValues(_maxBatchAtomicValues);
     _cache.str("");
     _cache << _name << "_" << FUNCTION_SPARSE_REVERSE_ONE << "_noloop_dep" << i;
     langC.setGenerateFunction(_cache.str());
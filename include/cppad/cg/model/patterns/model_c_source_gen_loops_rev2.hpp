@@ -383,6 +383,11 @@ void ModelCSourceGen<Base>::prepareSparseReverseTwoWithLoops(const std::map<size
             LanguageC<Base> langC(_baseTypeName);
             langC.setFunctionIndexArgument(indexJrowDcl);
             langC.setParameterPrecision(_parameterPrecision);
+            langC.setRestrictPointers(_restrictPointers);
+            langC.setSimdLoops(_simdLoops);
+            langC.setDirectAtomicFunctions(_directAtomicFunctions);
+            langC.setBatchAtomicLoops(_batchAtomicLoops);
+            langC.setMaxBatchAtomicValues(_maxBatchAtomicValues);
 
             std::ostringstream code;
             std::unique_ptr<VariableNameGenerator<Base> > nameGen(createVariableNameGenerator("px"));
@@ -526,6 +531,11 @@ void ModelCSourceGen<Base>::prepareSparseReverseTwoWithLoops(const std::map<size
                 langC.setMaxAssignmentsPerFunction(_maxAssignPerFunc, &_sources);
                 langC.setMaxOperationsPerAssignment(_maxOperationsPerAssignment);
                 langC.setParameterPrecision(_parameterPrecision);
+                langC.setRestrictPointers(_restrictPointers);
+                langC.setSimdLoops(_simdLoops);
+                langC.setDirectAtomicFunctions(_directAtomicFunctions);
+                langC.setBatchAtomicLoops(_batchAtomicLoops);
+                langC.setMaxBatchAtomicValues(_maxBatchAtomicValues);
                 _cache.str("");
                 _cache << _name << "_" << FUNCTION_SPARSE_REVERSE_TWO << "_noloop_indep" << j;
                 string functionName = _cache.str();
@@ -0,0 +1,491 @@
+#ifndef CPPAD_CG_RELOADABLE_GENERIC_MODEL_INCLUDED
+#define CPPAD_CG_RELOADABLE_GENERIC_MODEL_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * A model whose implementation can be replaced by a new version from a
+ * different model library while it is being used.
+ *
+ * A new library is loaded next to the current one and, once it has been
+ * validated, it becomes the implementation used by all new calls.
+ * Calls which were already executing continue to use the previous version.
+ * Previous versions are only unloaded by reload() or unloadRetired()
+ * after all the calls using them have finished, so that the (potentially
+ * slow) library unloading never happens in the thread evaluating the
+ * model.
+ *
+ * Evaluations of this model are not thread-safe (the same as the wrapped
+ * models), however reload() and unloadRetired() can be called from a
+ * different thread while the model is being evaluated.
+ *
+ * Since dynamic libraries are only loaded once per path by the operating
+ * system, each new version must be created in a different file (e.g.
+ * by using a version number in the library name).
+ *
+ * @author Joao Leal
+ */
+template<class Base>
+class ReloadableGenericModel : public GenericModel<Base> {
+protected:
+    /**
+     * A loaded version of the model.
+     * The model must be deleted before its library.
+     */
+    struct Version {
+        std::unique_ptr<ModelLibrary<Base>> library;
+        std::unique_ptr<GenericModel<Base>> model;
+        unsigned long number;
+    };
+protected:
+    /// the model name
+    const std::string _name;
+    /// the version used by new calls (only accessed through atomic operations)
+    std::shared_ptr<Version> _current;
+    /// previous versions which might still be in use
+    std::vector<std::shared_ptr<Version>> _retired;
+    /// atomic functions which must be provided to every new version
+    std::vector<atomic_base<Base>*> _atomicFuncs;
+    /// external models which must be provided to every new version
+    std::vector<GenericModel<Base>*> _externalModels;
+    /// serializes reloads
+    std::mutex _reloadMutex;
+    size_t _m;
+    size_t _n;
+public:
+    using GenericModel<Base>::ForwardZero;
+    using GenericModel<Base>::Jacobian;
+    using GenericModel<Base>::Hessian;
+    using GenericModel<Base>::ForwardOne;
+    using GenericModel<Base>::ReverseOne;
+    using GenericModel<Base>::ReverseTwo;
+    using GenericModel<Base>::SparseJacobian;
+    using GenericModel<Base>::SparseHessian;
+
+    /**
+     * Creates a new reloadable model.
+     *
+     * @param library the model library containing the first version of the
+     *                model (the library will be owned by this object)
+     * @param name the model name
+     * @throws CGException if the model does not exist in the library
+     */
+    ReloadableGenericModel(std::unique_ptr<ModelLibrary<Base>> library,
+                           const std::string& name) :
+        _name(name),
+        _m(0),
+        _n(0) {
+        std::shared_ptr<Version> v = createVersion(std::move(library), 0);
+        _m = v->model->Range();
+        _n = v->model->Domain();
+        std::atomic_store(&_current, v);
+    }
+
+    ReloadableGenericModel(const ReloadableGenericModel&) = delete;
+    ReloadableGenericModel& operator=(const ReloadableGenericModel&) = delete;
+
+    virtual ~ReloadableGenericModel() = default;
+
+    /**
+     * Replaces the model implementation by the one in a new library.
+     * New calls will use the new version while calls already in progress
+     * will continue using the previous one.
+     * This method also unloads older versions which are no longer in use.
+     *
+     * @param library the model library with the new model version (it will
+     *                be owned by this object)
+     * @return the number of the new version
+     * @throws CGException if the model does not exist in the new library or
+     *                     if it has a different number of dependent or
+     *                     independent variables
+     */
+    unsigned long reload(std::unique_ptr<ModelLibrary<Base>> library) {
+        std::lock_guard<std::mutex> lock(_reloadMutex);
+
+        std::shared_ptr<Version> old = std::atomic_load(&_current);
+
+        std::shared_ptr<Version> v = createVersion(std::move(library), old->number + 1);
+
+        if (v->model->Range() != _m || v->model->Domain() != _n) {
+            throw CGException("Unable to reload model '", _name, "': the new version has ",
+                              v->model->Range(), " dependents and ", v->model->Domain(), " independents "
+                              "(expected ", _m, " and ", _n, ")");
+        }
+
+        for (atomic_base<Base>* a : _atomicFuncs) {
+            v->model->addAtomicFunction(*a);
+        }
+        for (GenericModel<Base>* e : _externalModels) {
+            v->model->addExternalModel(*e);
+        }
+
+        std::atomic_store(&_current, v);
+
+        _retired.push_back(std::move(old));
+        unloadRetiredNoLock();
+
+        return v->number;
+    }
+
+    /**
+     * Unloads the previous versions of the model which are no longer used
+     * by any call in progress.
+     *
+     * @return the number of previous versions still loaded
+     */
+    size_t unloadRetired() {
+        std::lock_guard<std::mutex> lock(_reloadMutex);
+        return unloadRetiredNoLock();
+    }
+
+    /**
+     * Provides the number of the version used by new calls.
+     * The first version is 0.
+     */
+    unsigned long getVersion() const {
+        return current()->number;
+    }
+
+    /**
+     * Provides the model version used by new calls.
+     * The returned model will remain valid while the returned pointer is
+     * held even if a new version is loaded.
+     */
+    std::shared_ptr<GenericModel<Base>> getCurrentModel() const {
+        std::shared_ptr<Version> v = current();
+        return std::shared_ptr<GenericModel<Base>>(v, v->model.get());
+    }
+
+    const std::string& getName() const override {
+        return _name;
+    }
+
+    size_t Domain() const override {
+        return _n;
+    }
+
+    size_t Range() const override {
+        return _m;
+    }
+
+    size_t getParameterCount() const override {
+        return current()->model->getParameterCount();
+    }
+
+    /**
+     * Provides the names of the atomic functions used by the current
+     * version.
+     * The returned reference is only valid until the version is unloaded.
+     */
+    const std::vector<std::string>& getAtomicFunctionNames() override {
+        return current()->model->getAtomicFunctionNames();
+    }
+
+    bool addAtomicFunction(atomic_base<Base>& atomic) override {
+        std::lock_guard<std::mutex> lock(_reloadMutex);
+        _atomicFuncs.push_back(&atomic);
+        return std::atomic_load(&_current)->model->addAtomicFunction(atomic);
+    }
+
+    bool addExternalModel(GenericModel<Base>& atomic) override {
+        std::lock_guard<std::mutex> lock(_reloadMutex);
+        _externalModels.push_back(&atomic);
+        return std::atomic_load(&_current)->model->addExternalModel(atomic);
+    }
+
+    // Jacobian sparsity
+    bool isJacobianSparsityAvailable() override {
+        return current()->model->isJacobianSparsityAvailable();
+    }
+
+    std::vector<std::set<size_t> > JacobianSparsitySet() override {
+        return current()->model->JacobianSparsitySet();
+    }
+
+    std::vector<bool> JacobianSparsityBool() override {
+        return current()->model->JacobianSparsityBool();
+    }
+
+    void JacobianSparsity(std::vector<size_t>& equations,
+                          std::vector<size_t>& variables) override {
+        current()->model->JacobianSparsity(equations, variables);
+    }
+
+    // Hessian sparsity
+    bool isHessianSparsityAvailable() override {
+        return current()->model->isHessianSparsityAvailable();
+    }
+
+    std::vector<std::set<size_t> > HessianSparsitySet() override {
+        return current()->model->HessianSparsitySet();
+    }
+
+    std::vector<bool> HessianSparsityBool() override {
+        return current()->model->HessianSparsityBool();
+    }
+
+    void HessianSparsity(std::vector<size_t>& rows,
+                         std::vector<size_t>& cols) override {
+        current()->model->HessianSparsity(rows, cols);
+    }
+
+    bool isEquationHessianSparsityAvailable() override {
+        return current()->model->isEquationHessianSparsityAvailable();
+    }
+
+    std::vector<std::set<size_t> > HessianSparsitySet(size_t i) override {
+        return current()->model->HessianSparsitySet(i);
+    }
+
+    std::vector<bool> HessianSparsityBool(size_t i) override {
+        return current()->model->HessianSparsityBool(i);
+    }
+
+    void HessianSparsity(size_t i,
+                         std::vector<size_t>& rows,
+                         std::vector<size_t>& cols) override {
+        current()->model->HessianSparsity(i, rows, cols);
+    }
+
+    // Forward zero
+    bool isForwardZeroAvailable() override {
+        return current()->model->isForwardZeroAvailable();
+    }
+
+    void ForwardZero(const CppAD::vector<bool>& vx,
+                     CppAD::vector<bool>& vy,
+                     ArrayView<const Base> tx,
+                     ArrayView<Base> ty) override {
+        current()->model->ForwardZero(vx, vy, tx, ty);
+    }
+
+    void ForwardZero(ArrayView<const Base> x,
+                     ArrayView<Base> dep) override {
+        current()->model->ForwardZero(x, dep);
+    }
+
+    void ForwardZero(const std::vector<const Base*> &x,
+                     ArrayView<Base> dep) override {
+        current()->model->ForwardZero(x, dep);
+    }
+
+    // Dense Jacobian
+    bool isJacobianAvailable() override {
+        return current()->model->isJacobianAvailable();
+    }
+
+    void Jacobian(ArrayView<const Base> x,
+                  ArrayView<Base> jac) override {
+        current()->model->Jacobian(x, jac);
+    }
+
+    // Dense Hessian
+    bool isHessianAvailable() override {
+        return current()->model->isHessianAvailable();
+    }
+
+    void Hessian(ArrayView<const Base> x,
+                 ArrayView<const Base> w,
+                 ArrayView<Base> hess) override {
+        current()->model->Hessian(x, w, hess);
+    }
+
+    // Forward one
+    bool isForwardOneAvailable() override {
+        return current()->model->isForwardOneAvailable();
+    }
+
+    void ForwardOne(ArrayView<const Base> tx,
+                    ArrayView<Base> ty) override {
+        current()->model->ForwardOne(tx, ty);
+    }
+
+    bool isSparseForwardOneAvailable() override {
+        return current()->model->isSparseForwardOneAvailable();
+    }
+
+    void ForwardOne(ArrayView<const Base> x,
+                    size_t tx1Nnz, const size_t idx[], const Base tx1[],
+                    ArrayView<Base> ty1) override {
+        current()->model->ForwardOne(x, tx1Nnz, idx, tx1, ty1);
+    }
+
+    // Reverse one
+    bool isReverseOneAvailable() override {
+        return current()->model->isReverseOneAvailable();
+    }
+
+    bool isSparseReverseOneAvailable() override {
+        return current()->model->isSparseReverseOneAvailable();
+    }
+
+    void ReverseOne(ArrayView<const Base> tx,
+                    ArrayView<const Base> ty,
+                    ArrayView<Base> px,
+                    ArrayView<const Base> py) override {
+        current()->model->ReverseOne(tx, ty, px, py);
+    }
+
+    void ReverseOne(ArrayView<const Base> x,
+                    ArrayView<Base> px,
+                    size_t pyNnz, const size_t idx[], const Base py[]) override {
+        current()->model->ReverseOne(x, px, pyNnz, idx, py);
+    }
+
+    // Reverse two
+    bool isReverseTwoAvailable() override {
+        return current()->model->isReverseTwoAvailable();
+    }
+
+    bool isSparseReverseTwoAvailable() override {
+        return current()->model->isSparseReverseTwoAvailable();
+    }
+
+    void ReverseTwo(ArrayView<const Base> tx,
+                    ArrayView<const Base> ty,
+                    ArrayView<Base> px,
+                    ArrayView<const Base> py) override {
+        current()->model->ReverseTwo(tx, ty, px, py);
+    }
+
+    void ReverseTwo(ArrayView<const Base> x,
+                    size_t tx1Nnz, const size_t idx[], const Base tx1[],
+                    ArrayView<Base> px2,
+                    ArrayView<const Base> py2) override {
+        current()->model->ReverseTwo(x, tx1Nnz, idx, tx1, px2, py2);
+    }
+
+    // Sparse Jacobian
+    bool isSparseJacobianAvailable() override {
+        return current()->model->isSparseJacobianAvailable();
+    }
+
+    void SparseJacobian(ArrayView<const Base> x,
+                        ArrayView<Base> jac) override {
+        current()->model->SparseJacobian(x, jac);
+    }
+
+    void SparseJacobian(const std::vector<Base> &x,
+                        std::vector<Base>& jac,
+                        std::vector<size_t>& row,
+                        std::vector<size_t>& col) override {
+        current()->model->SparseJacobian(x, jac, row, col);
+    }
+
+    /**
+     * The row and column arrays belong to the model version used in this
+     * call and they are only valid until that version is unloaded.
+     */
+    void SparseJacobian(ArrayView<const Base> x,
+                        ArrayView<Base> jac,
+                        size_t const** row,
+                        size_t const** col) override {
+        current()->model->SparseJacobian(x, jac, row, col);
+    }
+
+    void SparseJacobian(const std::vector<const Base*>& x,
+                        ArrayView<Base> jac,
+                        size_t const** row,
+                        size_t const** col) override {
+        current()->model->SparseJacobian(x, jac, row, col);
+    }
+
+    // Sparse Hessian
+    bool isSparseHessianAvailable() override {
+        return current()->model->isSparseHessianAvailable();
+    }
+
+    void SparseHessian(ArrayView<const Base> x,
+                       ArrayView<const Base> w,
+                       ArrayView<Base> hess) override {
+        current()->model->SparseHessian(x, w, hess);
+    }
+
+    void SparseHessian(const std::vector<Base> &x,
+                       const std::vector<Base> &w,
+                       std::vector<Base>& hess,
+                       std::vector<size_t>& row,
+                       std::vector<size_t>& col) override {
+        current()->model->SparseHessian(x, w, hess, row, col);
+    }
+
+    /**
+     * The row and column arrays belong to the model version used in this
+     * call and they are only valid until that version is unloaded.
+     */
+    void SparseHessian(ArrayView<const Base> x,
+                       ArrayView<const Base> w,
+                       ArrayView<Base> hess,
+                       size_t const** row,
+                       size_t const** col) override {
+        current()->model->SparseHessian(x, w, hess, row, col);
+    }
+
+    void SparseHessian(const std::vector<const Base*>& x,
+                       ArrayView<const Base> w,
+                       ArrayView<Base> hess,
+                       size_t const** row,
+                       size_t const** col) override {
+        current()->model->SparseHessian(x, w, hess, row, col);
+    }
+
+protected:
+
+    /**
+     * Provides the version to be used by a new call.
+     * The returned pointer keeps the version loaded until the call ends.
+     */
+    inline std::shared_ptr<Version> current() const {
+        return std::atomic_load(&_current);
+    }
+
+    inline std::shared_ptr<Version> createVersion(std::unique_ptr<ModelLibrary<Base>> library,
+                                                  unsigned long number) const {
+        CPPADCG_ASSERT_KNOWN(library != nullptr, "Invalid model library");
+
+        std::shared_ptr<Version> v(new Version());
+        v->number = number;
+        v->model = library->model(_name);
+        if (v->model == nullptr) {
+            throw CGException("Unable to find model '", _name, "' in the model library");
+        }
+        v->library = std::move(library);
+
+        return v;
+    }
+
+    /**
+     * Must be called while holding the reload lock.
+     */
+    inline size_t unloadRetiredNoLock() {
+        // versions can only be acquired through _current, therefore a
+        // retired version with a single owner is no longer in use
+        auto it = std::remove_if(_retired.begin(), _retired.end(),
+                                 [](const std::shared_ptr<Version>& v) {
+                                     return v.use_count() == 1;
+                                 });
+        _retired.erase(it, _retired.end()); // the versions are unloaded here
+        return _retired.size();
+    }
+
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
@@ -0,0 +1,365 @@
+#ifndef CPPAD_CG_SPARSE_SCATTER_PLAN_INCLUDED
+#define CPPAD_CG_SPARSE_SCATTER_PLAN_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * The storage order of a compressed sparse matrix
+ */
+enum class SparseStorageOrder {
+    ROW_MAJOR, // compressed sparse row (CSR)
+    COLUMN_MAJOR // compressed sparse column (CSC)
+};
+
+/**
+ * A read-only view of a sparsity pattern defined by the row and column of
+ * each element (coordinate format) whose data is owned by someone else
+ * (e.g. a model library).
+ */
+class CoordinateSparsityView {
+public:
+    /// the row of each element
+    ArrayView<const size_t> rows;
+    /// the column of each element
+    ArrayView<const size_t> cols;
+public:
+
+    inline CoordinateSparsityView(ArrayView<const size_t> rows,
+                                  ArrayView<const size_t> cols) :
+        rows(rows),
+        cols(cols) {
+    }
+
+    /**
+     * The number of elements in the sparsity pattern
+     */
+    inline size_t nnz() const {
+        return rows.size();
+    }
+};
+
+/**
+ * A read-only view of the structure of a compressed sparse matrix (CSR or
+ * CSC) whose data is owned by someone else (e.g. a model library).
+ */
+class CompressedSparsityView {
+public:
+    /// the storage order
+    SparseStorageOrder order;
+    /// the outer index array (row pointers for CSR, column pointers for CSC)
+    ArrayView<const size_t> outer;
+    /// the inner index array (column indexes for CSR, row indexes for CSC)
+    ArrayView<const size_t> inner;
+public:
+
+    inline CompressedSparsityView(SparseStorageOrder order,
+                                  ArrayView<const size_t> outer,
+                                  ArrayView<const size_t> inner) :
+        order(order),
+        outer(outer),
+        inner(inner) {
+    }
+
+    /**
+     * The number of elements in the sparse matrix
+     */
+    inline size_t nnz() const {
+        return inner.size();
+    }
+};
+
+/**
+ * Places the elements of a compressed array with a fixed (row, column)
+ * structure, such as the output of the sparse Jacobian and Hessian
+ * functions of a model, into another array (a dense matrix or the values of
+ * a CSR/CSC matrix).
+ * The destination positions are determined only once and sorted so that
+ * the destination array is written sequentially.
+ *
+ * @author Joao Leal
+ */
+class SparseScatterPlan {
+private:
+    /**
+     * The position of each element in the source array sorted by destination
+     */
+    std::vector<size_t> _src;
+    /**
+     * The destination position of each element (ascending order)
+     */
+    std::vector<size_t> _dst;
+    /**
+     * The size of the destination array
+     */
+    size_t _dstSize;
+    /**
+     * Whether or not the source elements are already in the destination
+     * order (and the destination has no other elements)
+     */
+    bool _identity;
+public:
+
+    inline SparseScatterPlan() :
+        _dstSize(0),
+        _identity(true) {
+    }
+
+    /**
+     * Creates a plan to place the elements of a compressed array into a
+     * dense matrix.
+     *
+     * @param nrows the number of rows of the matrix
+     * @param ncols the number of columns of the matrix
+     * @param rows the row of each element in the compressed array
+     * @param cols the column of each element in the compressed array
+     * @param nnz the number of elements in the compressed array
+     * @param order whether the dense matrix is stored in row-major or in
+     *              column-major order
+     */
+    template<class Index>
+    static inline SparseScatterPlan createDense(size_t nrows,
+                                                size_t ncols,
+                                                Index const* rows,
+                                                Index const* cols,
+                                                size_t nnz,
+                                                SparseStorageOrder order = SparseStorageOrder::ROW_MAJOR) {
+        std::vector<size_t> dst(nnz);
+        if (order == SparseStorageOrder::ROW_MAJOR) {
+            for (size_t e = 0; e < nnz; ++e)
+                dst[e] = rows[e] * ncols + cols[e];
+        } else {
+            for (size_t e = 0; e < nnz; ++e)
+                dst[e] = cols[e] * nrows + rows[e];
+        }
+
+        return SparseScatterPlan(dst, nrows * ncols);
+    }
+
+    /**
+     * Creates a plan to place the elements of a compressed array into the
+     * values array of a compressed sparse matrix (CSR or CSC) with a fixed
+     * structure provided by the user (e.g. from an Eigen::SparseMatrix or
+     * the structure required by a linear solver).
+     * Every element of the compressed array must exist in the provided
+     * structure, other elements in the structure are set to zero.
+     *
+     * @param order the storage order of the compressed sparse matrix
+     * @param rows the row of each element in the compressed array
+     * @param cols the column of each element in the compressed array
+     * @param nnz the number of elements in the compressed array
+     * @param outer the outer index array (row pointers for CSR, column
+     *              pointers for CSC) with nOuter + 1 elements
+     * @param inner the inner index array (column indexes for CSR, row
+     *              indexes for CSC)
+     */
+    template<class Index, class Index2>
+    static inline SparseScatterPlan createCompressed(SparseStorageOrder order,
+                                                     Index const* rows,
+                                                     Index const* cols,
+                                                     size_t nnz,
+                                                     ArrayView<const Index2> outer,
+                                                     ArrayView<const Index2> inner) {
+        CPPADCG_ASSERT_KNOWN(outer.size() > 0, "Invalid outer index array size");
+        size_t nOuter = outer.size() - 1;
+        size_t dstSize = outer[nOuter];
+        CPPADCG_ASSERT_KNOWN(inner.size() >= dstSize, "Invalid inner index array size");
+
+        std::vector<size_t> dst(nnz);
+        for (size_t e = 0; e < nnz; ++e) {
+            size_t o, i;
+            if (order == SparseStorageOrder::ROW_MAJOR) {
+                o = rows[e];
+                i = cols[e];
+            } else {
+                o = cols[e];
+                i = rows[e];
+            }
+            CPPADCG_ASSERT_KNOWN(o < nOuter, "Element outside the provided compressed sparse structure");
+
+            const Index2* begin = inner.data() + outer[o];
+            const Index2* end = inner.data() + outer[o + 1];
+            const Index2* it = std::lower_bound(begin, end, Index2(i));
+            if (it == end || size_t(*it) != i) {
+                // inner indexes might not be sorted
+                it = std::find(begin, end, Index2(i));
+            }
+            CPPADCG_ASSERT_KNOWN(it != end, "Element missing in the provided compressed sparse structure");
+
+            dst[e] = it - inner.data();
+        }
+
+        return SparseScatterPlan(dst, dstSize);
+    }
+
+    /**
+     * Creates a plan to place the elements of a compressed array into the
+     * values array of a compressed sparse matrix (CSR or CSC) with the same
+     * elements as the compressed array.
+     *
+     * @param order the storage order of the compressed sparse matrix
+     * @param nrows the number of rows of the matrix
+     * @param ncols the number of columns of the matrix
+     * @param rows the row of each element in the compressed array
+     * @param cols the column of each element in the compressed array
+     * @param nnz the number of elements in the compressed array
+     * @param outer the outer index array which will be created
+     *              (row pointers for CSR, column pointers for CSC)
+     * @param inner the inner index array which will be created
+     *              (column indexes for CSR, row indexes for CSC)
+     */
+    template<class Index, class Index2>
+    static inline SparseScatterPlan createCompressed(SparseStorageOrder order,
+                                                     size_t nrows,
+                                                     size_t ncols,
+                                                     Index const* rows,
+                                                     Index const* cols,
+                                                     size_t nnz,
+                                                     std::vector<Index2>& outer,
+                                                     std::vector<Index2>& inner) {
+        Index const* outerEl = (order == SparseStorageOrder::ROW_MAJOR) ? rows : cols;
+        Index const* innerEl = (order == SparseStorageOrder::ROW_MAJOR) ? cols : rows;
+        size_t nOuter = (order == SparseStorageOrder::ROW_MAJOR) ? nrows : ncols;
+        size_t nInner = (order == SparseStorageOrder::ROW_MAJOR) ? ncols : nrows;
+
+        // sort by the inner index and then (stable) by the outer index
+        std::vector<size_t> byInner = countingSort(innerEl, nInner, nnz, nullptr);
+        std::vector<size_t> perm = countingSort(outerEl, nOuter, nnz, &byInner);
+
+        outer.assign(nOuter + 1, 0);
+        for (size_t e = 0; e < nnz; ++e)
+            outer[outerEl[e] + 1]++;
+        for (size_t o = 0; o < nOuter; ++o)
+            outer[o + 1] += outer[o];
+
+        std::vector<size_t> dst(nnz);
+        inner.resize(nnz);
+        for (size_t p = 0; p < nnz; ++p) {
+            dst[perm[p]] = p;
+            inner[p] = innerEl[perm[p]];
+        }
+
+        return SparseScatterPlan(dst, nnz);
+    }
+
+    /**
+     * Whether or not the source array can be used directly as the
+     * destination array.
+     */
+    inline bool isIdentity() const {
+        return _identity;
+    }
+
+    /**
+     * The number of elements in the source array
+     */
+    inline size_t getSourceSize() const {
+        return _src.size();
+    }
+
+    /**
+     * The number of elements in the destination array
+     */
+    inline size_t getDestinationSize() const {
+        return _dstSize;
+    }
+
+    /**
+     * Places the elements of the source array in the destination array.
+     * All other elements in the destination array are set to zero.
+     * The destination positions are unique and sorted (checked when the
+     * plan is created).
+     *
+     * @param src the source array (e.g. the output of a sparse Jacobian)
+     * @param dst the destination array
+     */
+    template<class Base>
+    inline void scatter(const Base* src,
+                        ArrayView<Base> dst) const {
+        CPPADCG_ASSERT_KNOWN(dst.size() == _dstSize, "Invalid destination array size");
+
+        Base* out = dst.data();
+
+        size_t last = 0;
+        for (size_t e = 0; e < _dst.size(); ++e) {
+            size_t d = _dst[e];
+            std::fill(out + last, out + d, Base(0));
+            out[d] = src[_src[e]];
+            last = d + 1;
+        }
+        std::fill(out + last, out + _dstSize, Base(0));
+    }
+
+private:
+
+    /**
+     * Provides the positions of the elements sorted by a key.
+     *
+     * @param key the key of each element (lower than nKeys)
+     * @param nKeys the number of possible key values
+     * @param nnz the number of elements
+     * @param order the initial element order (nullptr for 0, 1, ...)
+     * @return the element positions sorted by key (stable)
+     */
+    template<class Index>
+    static inline std::vector<size_t> countingSort(Index const* key,
+                                                   size_t nKeys,
+                                                   size_t nnz,
+                                                   const std::vector<size_t>* order) {
+        std::vector<size_t> start(nKeys + 1, 0);
+        for (size_t e = 0; e < nnz; ++e)
+            start[key[e] + 1]++;
+        for (size_t k = 0; k < nKeys; ++k)
+            start[k + 1] += start[k];
+
+        std::vector<size_t> sorted(nnz);
+        for (size_t p = 0; p < nnz; ++p) {
+            size_t e = (order == nullptr) ? p : (*order)[p];
+            sorted[start[key[e]]++] = e;
+        }
+        return sorted;
+    }
+
+    inline SparseScatterPlan(const std::vector<size_t>& dst,
+                             size_t dstSize) :
+        _src(dst.size()),
+        _dst(dst.size()),
+        _dstSize(dstSize),
+        _identity(dst.size() == dstSize) {
+
+        for (size_t e = 0; e < _src.size(); ++e)
+            _src[e] = e;
+
+        std::sort(_src.begin(), _src.end(), [&dst](size_t a, size_t b) {
+            return dst[a] < dst[b];
+        });
+
+        for (size_t e = 0; e < _src.size(); ++e) {
+            _dst[e] = dst[_src[e]];
+            CPPADCG_ASSERT_KNOWN(_dst[e] < dstSize, "Destination position outside the destination array");
+            CPPADCG_ASSERT_KNOWN(e == 0 || _dst[e - 1] < _dst[e], "Repeated destination position (duplicate elements)");
+            if (_src[e] != e || _dst[e] != e)
+                _identity = false;
+        }
+    }
+
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
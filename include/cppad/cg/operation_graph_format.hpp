@@ -0,0 +1,119 @@
+#ifndef CPPAD_CG_OPERATION_GRAPH_FORMAT_INCLUDED
+#define CPPAD_CG_OPERATION_GRAPH_FORMAT_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * Common definitions of the binary format used to save operation graphs
+ * (OperationGraphWriter) and to load them (OperationGraphReader).
+ *
+ * The format is streamed in the following order:
+ *  - header: magic string, version, byte order mark and sizeof(Base);
+ *  - the number of independent variables;
+ *  - the atomic functions used (original ID and name);
+ *  - the index patterns used by loops (each pattern tree is saved
+ *    recursively);
+ *  - the operation nodes in topological order (operation type, name,
+ *    information, arguments and node type specific data);
+ *  - the dependent variables.
+ *
+ * The independent variables are implicitly the first nodes.
+ * All integers are saved as fixed width values using the byte order of
+ * the machine which created the stream.
+ *
+ * @author Joao Leal
+ */
+class OperationGraphFormat {
+protected:
+    /**
+     * The type of an operation argument or dependent variable
+     */
+    enum class ArgumentType : uint8_t {
+        Parameter = 0,
+        Node = 1
+    };
+
+    static inline const char* getMagic() {
+        return "CGGRAPH"; // 8 bytes with the null character
+    }
+
+    static inline uint32_t getVersion() {
+        return 1;
+    }
+
+    static inline uint32_t getByteOrderMark() {
+        return 0x01020304u;
+    }
+
+    template<class T>
+    static inline void write(std::ostream& out,
+                             const T& value) {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    static inline void writeSize(std::ostream& out,
+                                 size_t value) {
+        if (value == (std::numeric_limits<size_t>::max)())
+            write<uint64_t>(out, (std::numeric_limits<uint64_t>::max)());
+        else
+            write<uint64_t>(out, value);
+    }
+
+    static inline void writeString(std::ostream& out,
+                                   const std::string& value) {
+        writeSize(out, value.size());
+        out.write(value.data(), value.size());
+    }
+
+    template<class T>
+    static inline T read(std::istream& in) {
+        T value;
+        in.read(reinterpret_cast<char*>(&value), sizeof(T));
+        if (!in) {
+            throw CGException("Unexpected end of the operation graph stream");
+        }
+        return value;
+    }
+
+    static inline size_t readSize(std::istream& in) {
+        uint64_t value = read<uint64_t>(in);
+        if (value == (std::numeric_limits<uint64_t>::max)())
+            return (std::numeric_limits<size_t>::max)();
+        if (value > (std::numeric_limits<size_t>::max)())
+            throw CGException("Operation graph value too large for this platform: ", value);
+        return size_t(value);
+    }
+
+    static inline std::string readString(std::istream& in) {
+        size_t size = readSize(in);
+        std::string value(size, ' ');
+        if (size > 0) {
+            in.read(&value[0], size);
+            if (!in) {
+                throw CGException("Unexpected end of the operation graph stream");
+            }
+        }
+        return value;
+    }
+
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
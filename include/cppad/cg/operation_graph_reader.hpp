@@ -0,0 +1,393 @@
+#ifndef CPPAD_CG_OPERATION_GRAPH_READER_INCLUDED
+#define CPPAD_CG_OPERATION_GRAPH_READER_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * Loads an operation graph saved with OperationGraphWriter into a
+ * CodeHandler.
+ *
+ * The atomic functions used by the graph must be provided with
+ * addAtomicFunction() since they are identified by name in the saved
+ * graph.
+ * The index patterns created while loading the graph are managed by the
+ * code handler.
+ *
+ * @author Joao Leal
+ */
+template<class Base>
+class OperationGraphReader : protected OperationGraphFormat {
+public:
+    using Node = OperationNode<Base>;
+    using Arg = Argument<Base>;
+    using CGB = CG<Base>;
+protected:
+    /**
+     * the atomic functions which can be used by the loaded graphs
+     */
+    std::map<std::string, CGAbstractAtomicFun<Base>*> _atomics;
+public:
+
+    inline OperationGraphReader() = default;
+
+    OperationGraphReader(const OperationGraphReader& orig) = delete;
+    OperationGraphReader& operator=(const OperationGraphReader& rhs) = delete;
+
+    /**
+     * Defines an atomic function which might be used by the saved graphs.
+     *
+     * @param atomic the atomic function (it is matched by its name)
+     */
+    inline void addAtomicFunction(CGAbstractAtomicFun<Base>& atomic) {
+        _atomics[atomic.afun_name()] = &atomic;
+    }
+
+    /**
+     * Loads an operation graph.
+     *
+     * @param in the input stream (it should be opened in binary mode)
+     * @param handler the code handler where the operation nodes will be
+     *                created (it should not have independent variables)
+     * @param independent the newly created independent variables
+     * @param dependent the dependent variables
+     * @throws CGException if the stream is not a valid operation graph
+     */
+    inline void read(std::istream& in,
+                     CodeHandler<Base>& handler,
+                     std::vector<CGB>& independent,
+                     std::vector<CGB>& dependent) {
+        static_assert(std::is_trivially_copyable<Base>::value,
+                      "Only operation graphs with trivially copyable base types can be loaded");
+
+        /**
+         * header
+         */
+        char magic[8];
+        in.read(magic, 8);
+        if (!in || std::string(magic, 7) != getMagic() || magic[7] != '\0') {
+            throw CGException("The stream does not contain an operation graph");
+        }
+        uint32_t version = read<uint32_t>(in);
+        if (version != getVersion()) {
+            throw CGException("Unsupported operation graph version (", version, ")");
+        }
+        if (read<uint32_t>(in) != getByteOrderMark()) {
+            throw CGException("The operation graph was saved on a machine with a different byte order");
+        }
+        if (read<uint32_t>(in) != sizeof(Base)) {
+            throw CGException("The operation graph was saved with a different base type");
+        }
+
+        size_t n = readSize(in);
+
+        /**
+         * atomic functions
+         */
+        std::map<size_t, size_t> atomicIds; // original ID -> new ID
+        size_t nAtomics = readSize(in);
+        for (size_t i = 0; i < nAtomics; ++i) {
+            size_t id = readSize(in);
+            std::string name = readString(in);
+
+            auto it = _atomics.find(name);
+            if (it == _atomics.end()) {
+                throw CGException("The operation graph uses an atomic function which was not provided: '", name, "'");
+            }
+            handler.registerAtomicFunction(*it->second);
+            atomicIds[id] = it->second->getId();
+        }
+
+        /**
+         * index patterns
+         */
+        size_t nPatterns = readSize(in);
+        std::vector<IndexPattern*> patterns(nPatterns);
+        std::vector<size_t> indepPatternPos(nPatterns, 0); // hints for the handler
+        for (size_t i = 0; i < nPatterns; ++i) {
+            patterns[i] = readPattern(in);
+            handler.manageLoopDependentIndexPattern(patterns[i]);
+        }
+
+        /**
+         * nodes
+         */
+        independent.resize(n);
+        handler.makeVariables(independent);
+
+        size_t nNodes = readSize(in);
+        std::vector<Node*> nodes(n + nNodes);
+        for (size_t j = 0; j < n; ++j) {
+            nodes[j] = independent[j].getOperationNode();
+        }
+
+        std::vector<size_t> info;
+        std::vector<Arg> args;
+        for (size_t p = n; p < nodes.size(); ++p) {
+            CGOpCode op = CGOpCode(read<uint32_t>(in));
+
+            bool hasName = read<uint8_t>(in) != 0;
+            std::string name;
+            if (hasName)
+                name = readString(in);
+
+            info.resize(readSize(in));
+            for (size_t& i : info)
+                i = readSize(in);
+
+            args.resize(readSize(in));
+            for (Arg& a : args) {
+                a = readArgument(in, nodes, p);
+            }
+
+            nodes[p] = makeNode(in, handler, op, name, info, args, patterns, indepPatternPos, atomicIds);
+
+            if (hasName)
+                nodes[p]->setName(name);
+        }
+
+        /**
+         * dependents
+         */
+        dependent.resize(readSize(in));
+        for (CGB& y : dependent) {
+            Arg a = readArgument(in, nodes, nodes.size());
+            if (a.getOperation() == nullptr)
+                y = CGB(*a.getParameter());
+            else
+                y = handler.createCG(a);
+        }
+    }
+
+    /**
+     * Loads an operation graph from a file.
+     *
+     * @param fileName the file path
+     * @param handler the code handler where the operation nodes will be
+     *                created
+     * @param independent the newly created independent variables
+     * @param dependent the dependent variables
+     * @throws CGException if the file is not a valid operation graph
+     */
+    inline void read(const std::string& fileName,
+                     CodeHandler<Base>& handler,
+                     std::vector<CGB>& independent,
+                     std::vector<CGB>& dependent) {
+        std::ifstream in(fileName, std::ios::in | std::ios::binary);
+        if (!in) {
+            throw CGException("Failed to open file '", fileName, "'");
+        }
+        read(in, handler, independent, dependent);
+    }
+
+protected:
+
+    static inline Arg readArgument(std::istream& in,
+                                   const std::vector<Node*>& nodes,
+                                   size_t limit) {
+        ArgumentType type = read<ArgumentType>(in);
+        if (type == ArgumentType::Parameter) {
+            return Arg(read<Base>(in));
+        } else if (type == ArgumentType::Node) {
+            size_t pos = readSize(in);
+            if (pos >= limit) {
+                throw CGException("Invalid operation graph: reference to node ", pos, " which was not defined yet");
+            }
+            return Arg(*nodes[pos]);
+        }
+        throw CGException("Invalid operation graph: unknown argument type");
+    }
+
+    static inline IndexPattern* getPattern(const std::vector<IndexPattern*>& patterns,
+                                           size_t pos) {
+        if (pos >= patterns.size()) {
+            throw CGException("Invalid operation graph: unknown index pattern ", pos);
+        }
+        return patterns[pos];
+    }
+
+    template<class T>
+    static inline T& getNodeArg(const std::vector<Arg>& args,
+                                size_t i,
+                                CGOpCode op) {
+        if (i >= args.size() || args[i].getOperation() == nullptr || args[i].getOperation()->getOperationType() != op) {
+            throw CGException("Invalid operation graph: argument ", i, " must be a ", op, " operation");
+        }
+        return static_cast<T&> (*args[i].getOperation());
+    }
+
+    /**
+     * Creates an operation node using the appropriate node type.
+     */
+    inline Node* makeNode(std::istream& in,
+                          CodeHandler<Base>& handler,
+                          CGOpCode op,
+                          const std::string& name,
+                          std::vector<size_t>& info,
+                          const std::vector<Arg>& args,
+                          const std::vector<IndexPattern*>& patterns,
+                          std::vector<size_t>& indepPatternPos,
+                          const std::map<size_t, size_t>& atomicIds) {
+        switch (op) {
+            case CGOpCode::Inv:
+                throw CGException("Invalid operation graph: unexpected independent variable");
+
+            case CGOpCode::IndexDeclaration:
+                return handler.makeIndexDclrNode(name);
+
+            case CGOpCode::Index: {
+                if (args.size() == 1)
+                    return handler.makeIndexNode(getNodeArg<Node>(args, 0, CGOpCode::IndexDeclaration));
+                else if (args.size() == 2 && args[1].getOperation() != nullptr &&
+                         args[1].getOperation()->getOperationType() == CGOpCode::LoopStart)
+                    return handler.makeIndexNode(getNodeArg<LoopStartOperationNode<Base> >(args, 1, CGOpCode::LoopStart));
+                else
+                    return handler.makeIndexNode(getNodeArg<IndexAssignOperationNode<Base> >(args, 1, CGOpCode::IndexAssign));
+            }
+            case CGOpCode::IndexAssign: {
+                IndexPattern& ip = *getPattern(patterns, readSize(in));
+                Node& index = getNodeArg<Node>(args, 0, CGOpCode::IndexDeclaration);
+                IndexOperationNode<Base>* index1 = nullptr;
+                IndexOperationNode<Base>* index2 = nullptr;
+                if (args.size() > 1)
+                    index1 = &getNodeArg<IndexOperationNode<Base> >(args, 1, CGOpCode::Index);
+                if (args.size() > 2)
+                    index2 = &getNodeArg<IndexOperationNode<Base> >(args, 2, CGOpCode::Index);
+                return handler.makeIndexAssignNode(index, ip, index1, index2);
+            }
+            case CGOpCode::LoopStart: {
+                Node& indexDcl = getNodeArg<Node>(args, 0, CGOpCode::IndexDeclaration);
+                if (!info.empty())
+                    return handler.makeLoopStartNode(indexDcl, info[0]);
+                else
+                    return handler.makeLoopStartNode(indexDcl, getNodeArg<IndexOperationNode<Base> >(args, 1, CGOpCode::Index));
+            }
+            case CGOpCode::LoopEnd: {
+                auto& loopStart = getNodeArg<LoopStartOperationNode<Base> >(args, 0, CGOpCode::LoopStart);
+                std::vector<Arg> endArgs(args.begin() + 1, args.end());
+                return handler.makeLoopEndNode(loopStart, endArgs);
+            }
+            case CGOpCode::Pri: {
+                std::string before = readString(in);
+                std::string after = readString(in);
+                if (args.empty())
+                    throw CGException("Invalid operation graph: print operation without arguments");
+                return handler.makePrintNode(before, args[0], after);
+            }
+            case CGOpCode::LoopIndexedDep:
+                if (info.empty())
+                    throw CGException("Invalid operation graph: missing loop dependent index pattern");
+                info[0] = handler.addLoopDependentIndexPattern(*getPattern(patterns, info[0]));
+                return handler.makeNode(op, info, args);
+
+            case CGOpCode::LoopIndexedIndep: {
+                if (info.size() < 2)
+                    throw CGException("Invalid operation graph: missing loop independent index pattern");
+                size_t pos = info[1];
+                IndexPattern& ip = *getPattern(patterns, pos);
+                info[1] = handler.addLoopIndependentIndexPattern(ip, indepPatternPos[pos]);
+                indepPatternPos[pos] = info[1];
+                return handler.makeNode(op, info, args);
+            }
+
+            case CGOpCode::AtomicForward:
+            case CGOpCode::AtomicReverse: {
+                auto it = info.empty() ? atomicIds.end() : atomicIds.find(info[0]);
+                if (it == atomicIds.end())
+                    throw CGException("Invalid operation graph: unknown atomic function");
+                info[0] = it->second;
+                return handler.makeNode(op, info, args);
+            }
+            default:
+                return handler.makeNode(op, info, args);
+        }
+    }
+
+    static inline IndexPattern* readPattern(std::istream& in) {
+        IndexPatternType type = IndexPatternType(read<uint8_t>(in));
+
+        switch (type) {
+            case IndexPatternType::Linear: {
+                long xOffset = long(read<int64_t>(in));
+                long dy = long(read<int64_t>(in));
+                long dx = long(read<int64_t>(in));
+                long b = long(read<int64_t>(in));
+                return new LinearIndexPattern(xOffset, dy, dx, b);
+            }
+            case IndexPatternType::Sectioned: {
+                std::map<size_t, IndexPattern*> sections;
+                try {
+                    size_t size = readSize(in);
+                    for (size_t i = 0; i < size; ++i) {
+                        size_t start = readSize(in);
+                        sections[start] = readPattern(in);
+                    }
+                } catch (...) {
+                    SectionedIndexPattern::deleteIndexPatterns(sections);
+                    throw;
+                }
+                return new SectionedIndexPattern(sections);
+            }
+            case IndexPatternType::Random1D: {
+                std::string name = readString(in);
+                std::map<size_t, size_t> values;
+                size_t size = readSize(in);
+                for (size_t i = 0; i < size; ++i) {
+                    size_t x = readSize(in);
+                    values[x] = readSize(in);
+                }
+                auto* rip = new Random1DIndexPattern(values);
+                rip->setName(name);
+                return rip;
+            }
+            case IndexPatternType::Random2D: {
+                std::string name = readString(in);
+                std::map<size_t, std::map<size_t, size_t> > values;
+                size_t size = readSize(in);
+                for (size_t i = 0; i < size; ++i) {
+                    std::map<size_t, size_t>& v = values[readSize(in)];
+                    size_t size2 = readSize(in);
+                    for (size_t i2 = 0; i2 < size2; ++i2) {
+                        size_t x = readSize(in);
+                        v[x] = readSize(in);
+                    }
+                }
+                auto* rip = new Random2DIndexPattern(values);
+                rip->setName(name);
+                return rip;
+            }
+            case IndexPatternType::Plane2D: {
+                std::unique_ptr<IndexPattern> sub[2];
+                for (auto& s : sub) {
+                    if (read<uint8_t>(in) != 0)
+                        s.reset(readPattern(in));
+                }
+                if (sub[0] == nullptr && sub[1] == nullptr)
+                    throw CGException("Invalid operation graph: empty 2D plane index pattern");
+                return new Plane2DIndexPattern(sub[0].release(), sub[1].release());
+            }
+            default:
+                throw CGException("Invalid operation graph: unknown index pattern type");
+        }
+    }
+
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
@@ -0,0 +1,401 @@
+#ifndef CPPAD_CG_OPERATION_GRAPH_WRITER_INCLUDED
+#define CPPAD_CG_OPERATION_GRAPH_WRITER_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * Saves an operation graph created with a CodeHandler into a compact
+ * binary stream so that it can be loaded later (possibly by another
+ * process) with OperationGraphReader, for instance to generate source
+ * code without taping the model again.
+ *
+ * Only the nodes required by the dependent variables are saved (and all
+ * the independent variables).
+ * Atomic functions are saved by name and loop index patterns are saved
+ * with the nodes which use them.
+ *
+ * @author Joao Leal
+ */
+template<class Base>
+class OperationGraphWriter : protected OperationGraphFormat {
+public:
+    using Node = OperationNode<Base>;
+    using Arg = Argument<Base>;
+    using CGB = CG<Base>;
+protected:
+    CodeHandler<Base>& _handler;
+    /**
+     * the position of each node in the saved node list
+     */
+    CodeHandlerVector<Base, size_t> _position;
+    /**
+     * the saved nodes (topological order)
+     */
+    std::vector<Node*> _nodes;
+    /**
+     * the saved index patterns
+     */
+    std::vector<const IndexPattern*> _patterns;
+    std::map<const IndexPattern*, size_t> _patternPosition;
+    /**
+     * the names of the atomic functions used (original ID -> name)
+     */
+    std::map<size_t, std::string> _atomics;
+public:
+
+    inline explicit OperationGraphWriter(CodeHandler<Base>& handler) :
+        _handler(handler),
+        _position(handler) {
+    }
+
+    OperationGraphWriter(const OperationGraphWriter& orig) = delete;
+    OperationGraphWriter& operator=(const OperationGraphWriter& rhs) = delete;
+
+    /**
+     * Saves the operation graph.
+     *
+     * @param out the output stream (it should be opened in binary mode)
+     * @param dependent the dependent variables which define the graph
+     *                  (their operations must belong to the code handler)
+     * @throws CGException if the graph cannot be saved
+     */
+    inline void write(std::ostream& out,
+                      ArrayView<const CGB> dependent) {
+        static_assert(std::is_trivially_copyable<Base>::value,
+                      "Only operation graphs with trivially copyable base types can be saved");
+
+        const std::vector<Node*>& indep = _handler.getIndependentVariables();
+
+        _nodes.clear();
+        _patterns.clear();
+        _patternPosition.clear();
+        _atomics.clear();
+
+        _position.adjustSize();
+        _position.fill(notVisited());
+
+        /**
+         * determine the node order (independents first)
+         */
+        for (Node* n : indep) {
+            _position[*n] = _nodes.size();
+            _nodes.push_back(n);
+        }
+
+        for (size_t i = 0; i < dependent.size(); ++i) {
+            Node* n = dependent[i].getOperationNode();
+            if (n != nullptr) {
+                if (n->getCodeHandler() != &_handler) {
+                    throw CGException("The dependent variable ", i, " does not belong to the code handler");
+                }
+                sortNodes(*n);
+            }
+        }
+
+        /**
+         * determine the atomic functions and index patterns
+         */
+        for (const Node* n : _nodes) {
+            CGOpCode op = n->getOperationType();
+            const std::vector<size_t>& info = n->getInfo();
+
+            if (op == CGOpCode::AtomicForward || op == CGOpCode::AtomicReverse) {
+                size_t id = info[0];
+                if (_atomics.find(id) == _atomics.end()) {
+                    std::string name = _handler.getAtomicFunctionName(id);
+                    if (name.empty()) {
+                        throw CGException("Unable to save the operation graph: atomic function ", id, " is not registered in the code handler");
+                    }
+                    _atomics[id] = name;
+                }
+
+            } else if (op == CGOpCode::IndexAssign) {
+                addPattern(&static_cast<const IndexAssignOperationNode<Base>*> (n)->getIndexPattern());
+
+            } else if (op == CGOpCode::LoopIndexedDep) {
+                addPattern(getLoopPattern(_handler.getLoopDependentIndexPatterns(), info[0]));
+
+            } else if (op == CGOpCode::LoopIndexedIndep) {
+                addPattern(getLoopPattern(_handler.getLoopIndependentIndexPatterns(), info[1]));
+            }
+        }
+
+        /**
+         * header
+         */
+        out.write(getMagic(), 8);
+        write<uint32_t>(out, getVersion());
+        write<uint32_t>(out, getByteOrderMark());
+        write<uint32_t>(out, sizeof(Base));
+
+        writeSize(out, indep.size());
+
+        /**
+         * atomic functions
+         */
+        writeSize(out, _atomics.size());
+        for (const auto& it : _atomics) {
+            writeSize(out, it.first);
+            writeString(out, it.second);
+        }
+
+        /**
+         * index patterns
+         */
+        writeSize(out, _patterns.size());
+        for (const IndexPattern* ip : _patterns) {
+            writePattern(out, *ip);
+        }
+
+        /**
+         * nodes
+         */
+        writeSize(out, _nodes.size() - indep.size());
+        for (size_t p = indep.size(); p < _nodes.size(); ++p) {
+            writeNode(out, *_nodes[p]);
+        }
+
+        /**
+         * dependents
+         */
+        writeSize(out, dependent.size());
+        for (size_t i = 0; i < dependent.size(); ++i) {
+            const Node* n = dependent[i].getOperationNode();
+            if (n == nullptr) {
+                write<ArgumentType>(out, ArgumentType::Parameter);
+                write<Base>(out, dependent[i].getValue());
+            } else {
+                write<ArgumentType>(out, ArgumentType::Node);
+                writeSize(out, _position[*n]);
+            }
+        }
+
+        if (!out) {
+            throw CGException("Failed to write the operation graph");
+        }
+    }
+
+    /**
+     * Saves the operation graph into a file.
+     *
+     * @param fileName the file path
+     * @param dependent the dependent variables which define the graph
+     * @throws CGException if the graph cannot be saved
+     */
+    inline void write(const std::string& fileName,
+                      ArrayView<const CGB> dependent) {
+        std::ofstream out(fileName, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!out) {
+            throw CGException("Failed to open file '", fileName, "'");
+        }
+        write(out, dependent);
+    }
+
+protected:
+
+    static inline size_t notVisited() {
+        return (std::numeric_limits<size_t>::max)();
+    }
+
+    static inline size_t visiting() {
+        return (std::numeric_limits<size_t>::max)() - 1;
+    }
+
+    /**
+     * Adds a node and all the nodes it depends on to the node list
+     * (without recursion so that very deep graphs can be saved).
+     */
+    inline void sortNodes(Node& root) {
+        if (_position[root] != notVisited()) {
+            if (_position[root] == visiting())
+                throw CGException("Unable to save an operation graph with cycles");
+            return;
+        }
+
+        std::vector<std::pair<Node*, size_t> > stack;
+        stack.emplace_back(&root, 0);
+        _position[root] = visiting();
+
+        while (!stack.empty()) {
+            Node& node = *stack.back().first;
+            size_t a = stack.back().second;
+            const std::vector<Arg>& args = node.getArguments();
+
+            if (a < args.size()) {
+                stack.back().second++;
+
+                Node* arg = args[a].getOperation();
+                if (arg != nullptr) {
+                    size_t pos = _position[*arg];
+                    if (pos == notVisited()) {
+                        _position[*arg] = visiting();
+                        stack.emplace_back(arg, 0);
+                    } else if (pos == visiting()) {
+                        throw CGException("Unable to save an operation graph with cycles");
+                    }
+                }
+            } else {
+                _position[node] = _nodes.size();
+                _nodes.push_back(&node);
+                stack.pop_back();
+            }
+        }
+    }
+
+    static inline const IndexPattern* getLoopPattern(const std::vector<IndexPattern*>& patterns,
+                                                     size_t pos) {
+        if (pos == (std::numeric_limits<size_t>::max)())
+            return nullptr;
+        CPPADCG_ASSERT_KNOWN(pos < patterns.size(), "Invalid loop index pattern position")
+        return patterns[pos];
+    }
+
+    inline void addPattern(const IndexPattern* ip) {
+        if (ip != nullptr && _patternPosition.find(ip) == _patternPosition.end()) {
+            _patternPosition[ip] = _patterns.size();
+            _patterns.push_back(ip);
+        }
+    }
+
+    inline size_t getPatternPosition(const IndexPattern* ip) const {
+        if (ip == nullptr)
+            return (std::numeric_limits<size_t>::max)();
+        return _patternPosition.at(ip);
+    }
+
+    inline void writeNode(std::ostream& out,
+                          const Node& node) {
+        CGOpCode op = node.getOperationType();
+        write<uint32_t>(out, uint32_t(op));
+
+        const std::string* name = node.getName();
+        write<uint8_t>(out, name != nullptr);
+        if (name != nullptr)
+            writeString(out, *name);
+
+        /**
+         * information (index pattern positions are replaced by their
+         * position in the saved pattern table)
+         */
+        std::vector<size_t> info = node.getInfo();
+        if (op == CGOpCode::LoopIndexedDep) {
+            info[0] = getPatternPosition(getLoopPattern(_handler.getLoopDependentIndexPatterns(), info[0]));
+        } else if (op == CGOpCode::LoopIndexedIndep) {
+            info[1] = getPatternPosition(getLoopPattern(_handler.getLoopIndependentIndexPatterns(), info[1]));
+        }
+        writeSize(out, info.size());
+        for (size_t i : info)
+            writeSize(out, i);
+
+        /**
+         * arguments
+         */
+        const std::vector<Arg>& args = node.getArguments();
+        writeSize(out, args.size());
+        for (const Arg& a : args) {
+            if (a.getOperation() == nullptr) {
+                write<ArgumentType>(out, ArgumentType::Parameter);
+                write<Base>(out, *a.getParameter());
+            } else {
+                write<ArgumentType>(out, ArgumentType::Node);
+                writeSize(out, _position[*a.getOperation()]);
+            }
+        }
+
+        /**
+         * node type specific data
+         */
+        if (op == CGOpCode::Pri) {
+            const auto& pri = static_cast<const PrintOperationNode<Base>&> (node);
+            writeString(out, pri.getBeforeString());
+            writeString(out, pri.getAfterString());
+
+        } else if (op == CGOpCode::IndexAssign) {
+            const auto& assign = static_cast<const IndexAssignOperationNode<Base>&> (node);
+            writeSize(out, getPatternPosition(&assign.getIndexPattern()));
+        }
+    }
+
+    static inline void writePattern(std::ostream& out,
+                                    const IndexPattern& ip) {
+        IndexPatternType type = ip.getType();
+        write<uint8_t>(out, uint8_t(type));
+
+        switch (type) {
+            case IndexPatternType::Linear: {
+                const auto& lip = static_cast<const LinearIndexPattern&> (ip);
+                write<int64_t>(out, lip.getXOffset());
+                write<int64_t>(out, lip.getLinearSlopeDy());
+                write<int64_t>(out, lip.getLinearSlopeDx());
+                write<int64_t>(out, lip.getLinearConstantTerm());
+                break;
+            }
+            case IndexPatternType::Sectioned: {
+                const auto& sip = static_cast<const SectionedIndexPattern&> (ip);
+                const std::map<size_t, IndexPattern*>& sections = sip.getLinearSections();
+                writeSize(out, sections.size());
+                for (const auto& it : sections) {
+                    writeSize(out, it.first);
+                    writePattern(out, *it.second);
+                }
+                break;
+            }
+            case IndexPatternType::Random1D: {
+                const auto& rip = static_cast<const Random1DIndexPattern&> (ip);
+                writeString(out, rip.getName());
+                writeSize(out, rip.getValues().size());
+                for (const auto& it : rip.getValues()) {
+                    writeSize(out, it.first);
+                    writeSize(out, it.second);
+                }
+                break;
+            }
+            case IndexPatternType::Random2D: {
+                const auto& rip = static_cast<const Random2DIndexPattern&> (ip);
+                writeString(out, rip.getName());
+                writeSize(out, rip.getValues().size());
+                for (const auto& it : rip.getValues()) {
+                    writeSize(out, it.first);
+                    writeSize(out, it.second.size());
+                    for (const auto& it2 : it.second) {
+                        writeSize(out, it2.first);
+                        writeSize(out, it2.second);
+                    }
+                }
+                break;
+            }
+            case IndexPatternType::Plane2D: {
+                const auto& pip = static_cast<const Plane2DIndexPattern&> (ip);
+                for (const IndexPattern* sub : {pip.getPattern1(), pip.getPattern2()}) {
+                    write<uint8_t>(out, sub != nullptr);
+                    if (sub != nullptr)
+                        writePattern(out, *sub);
+                }
+                break;
+            }
+            default:
+                throw CGException("Unable to save an unknown index pattern type");
+        }
+    }
+
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
@@ -30,13 +30,16 @@ namespace cg {
  * @param bifurcations the current number of bifurcations in the graph
  * @param maxBifurcations the maximum number of bifurcations allowed
  *                        (this function will return if this value was reached)
+ * @param reaching the nodes which depend on target (if null all arguments
+ *                 are visited)
  */
 template<class Base>
 inline bool findPathGraph(BidirGraph<Base>& foundGraph,
                           OperationNode<Base>& root,
                           OperationNode<Base>& target,
                           size_t& bifurcations,
-                          size_t maxBifurcations = (std::numeric_limits<size_t>::max)()) {
+                          size_t maxBifurcations = (std::numeric_limits<size_t>::max)(),
+                          const std::unordered_set<const OperationNode<Base>*>* reaching = nullptr) {
     if (bifurcations >= maxBifurcations) {
         return false;
     }
@@ -67,7 +70,10 @@ inline bool findPathGraph(BidirGraph<Base>& foundGraph,
         const Argument<Base>& a = args[i];
         if(a.getOperation() != nullptr ) {
             auto& aNode = *a.getOperation();
-            if(findPathGraph(foundGraph, aNode, target, bifurcations, maxBifurcations)) {
+            if (reaching != nullptr && &aNode != &target && reaching->find(&aNode) == reaching->end()) {
+                continue; // target cannot be reached from this argument
+            }
+            if(findPathGraph(foundGraph, aNode, target, bifurcations, maxBifurcations, reaching)) {
                 foundGraph.connect(info, root, i);
                 if(found) {
                     bifurcations++; // multiple ways to get to target
@@ -113,6 +119,98 @@ inline BidirGraph<Base> CodeHandler<Base>::findPathGraph(OperationNode<Base>& ro
 }
 
 
+template<class Base>
+inline const std::unordered_map<const OperationNode<Base>*, std::vector<OperationNode<Base>*> >& CodeHandler<Base>::findExpressionUsage(OperationNode<Base>& expression) {
+    auto it = _pathGraphCache.find(&expression);
+    if (it != _pathGraphCache.end())
+        return it->second;
+
+    auto& usage = _pathGraphCache[&expression];
+    usage[&expression]; // the expression is not used by any other node
+
+    std::vector<Node*> stack;
+    stack.push_back(&expression);
+
+    while (!stack.empty()) {
+        Node* node = stack.back();
+        stack.pop_back();
+
+        for (const Argument<Base>& a : node->getArguments()) {
+            Node* aNode = a.getOperation();
+            if (aNode == nullptr)
+                continue;
+
+            auto itU = usage.find(aNode);
+            if (itU == usage.end()) {
+                usage[aNode].push_back(node);
+                stack.push_back(aNode); // first time this node is found
+            } else if (itU->second.back() != node) {
+                itU->second.push_back(node); // the same node can be used more than once by an operation
+            }
+        }
+    }
+
+    return usage;
+}
+
+template<class Base>
+inline BidirGraph<Base> CodeHandler<Base>::findCachedPathGraph(OperationNode<Base>& expression,
+                                                               OperationNode<Base>& target,
+                                                               size_t& bifurcations,
+                                                               size_t maxBifurcations) {
+    if (&expression == &target) {
+        return findPathGraph(expression, target, bifurcations, maxBifurcations);
+    }
+
+    const auto& usage = findExpressionUsage(expression);
+
+    BidirGraph<Base> foundGraph;
+
+    if (usage.find(&target) == usage.end()) {
+        return foundGraph; // target is not used by the expression
+    }
+
+    /**
+     * determine the nodes which depend on the target
+     */
+    std::unordered_set<const Node*> reaching;
+    std::vector<const Node*> stack;
+    stack.push_back(&target);
+    while (!stack.empty()) {
+        const Node* node = stack.back();
+        stack.pop_back();
+
+        for (Node* user : usage.at(node)) {
+            if (reaching.insert(user).second)
+                stack.push_back(user);
+        }
+    }
+
+    startNewOperationTreeVisit();
+
+    if (bifurcations <= maxBifurcations) {
+        CppAD::cg::findPathGraph<Base>(foundGraph, expression, target, bifurcations, maxBifurcations, &reaching);
+    }
+
+    return foundGraph;
+}
+
+template<class Base>
+inline void CodeHandler<Base>::invalidatePathGraphs(const OperationNode<Base>& node) {
+    for (auto it = _pathGraphCache.begin(); it != _pathGraphCache.end();) {
+        if (it->second.find(&node) != it->second.end()) {
+            it = _pathGraphCache.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+template<class Base>
+inline void CodeHandler<Base>::clearPathGraphCache() {
+    _pathGraphCache.clear();
+}
+
 template<class Base>
 inline std::vector<std::vector<OperationPathNode<Base> > > CodeHandler<Base>::findPaths(OperationNode<Base>& root,
                                                                                         OperationNode<Base>& code,
@@ -59,11 +59,72 @@ private:
         BOTH
     };
     using Indexed2OpCountType = std::pair<INDEXED_OPERATION_TYPE, size_t>;
-    using Dep1Dep2SharedType = std::map<size_t, std::map<size_t, std::map<OperationNode<Base>*, Indexed2OpCountType> > >;
     using DepPairType = std::pair<size_t, size_t>;
-    using TotalOps2validDepsType = std::map<size_t, std::map<DepPairType, const std::map<OperationNode<Base>*, Indexed2OpCountType>* > >;
-    using Eq2totalOps2validDepsType = std::map<UniqueEquationPair<Base>, TotalOps2validDepsType*>;
-    using MaxOps2eq2totalOps2validDepsType = std::map<size_t, Eq2totalOps2validDepsType>;
+
+    /**
+     * A temporary variable shared by two dependents from different
+     * equation patterns
+     */
+    struct SharedTemporary {
+        UniqueEquationPair<Base> eqPair;
+        size_t dep1; // a dependent from eqPair.eq1
+        size_t dep2; // a dependent from eqPair.eq2
+        OperationNode<Base>* node;
+        size_t origNodeId; // used to sort shared variables (reproducibility)
+        Indexed2OpCountType indexedOpCount;
+    };
+
+    /**
+     * The temporary variables shared by two dependents
+     * (a range in equationShared_)
+     */
+    struct DepPairShared {
+        size_t totalOps; // the total number of operations performed by the shared variables
+        DepPairType deps;
+        const SharedTemporary* begin;
+        const SharedTemporary* end;
+    };
+
+    /**
+     * Sorted by descending number of shared operations and then by
+     * ascending dependent pair
+     */
+    using TotalOps2validDepsType = std::vector<DepPairShared>;
+    /**
+     * Maps an equation pair key (see equationPairKey()) to the dependent
+     * pairs with shared variables
+     */
+    using Eq2totalOps2validDepsType = std::unordered_map<size_t, TotalOps2validDepsType>;
+
+    struct EquationPairShared {
+        size_t maxOps; // the maximum number of shared operations between two dependents
+        UniqueEquationPair<Base> eqPair;
+        const TotalOps2validDepsType* totalOps2validDeps;
+    };
+    /**
+     * Sorted by descending maximum number of shared operations and then by
+     * equation pair
+     */
+    using MaxOps2eq2totalOps2validDepsType = std::vector<EquationPairShared>;
+
+    /**
+     * Information on the dependents which use a node
+     */
+    struct NodeDependents {
+        size_t count; // the number of dependents
+        size_t last; // the last dependent
+        size_t min; // the lowest dependent
+        size_t minOther; // the lowest dependent from an equation pattern other than lastEq
+        const EquationPattern<Base>* lastEq; // the equation pattern of the last dependent
+
+        inline NodeDependents() :
+            count(0),
+            last((std::numeric_limits<size_t>::max)()),
+            min((std::numeric_limits<size_t>::max)()),
+            minOther((std::numeric_limits<size_t>::max)()),
+            lastEq(nullptr) {
+        }
+    };
 
 private:
     CodeHandler<Base>* handler_;
@@ -78,27 +139,41 @@ private:
     std::map<EquationPattern<Base>*, Loop<Base>*> equation2Loop_;
     std::vector<Loop<Base>*> loops_;
     /**
-     * Equations which cannot be in the same loop
+     * Equation pairs which cannot be in the same loop
+     * (see equationPairKey())
      */
-    std::map<EquationPattern<Base>*, std::set<EquationPattern<Base>*> > incompatible_;
+    std::unordered_set<size_t> incompatible_;
     /**
-     *
+     * Temporary variables shared between dependents of different equation
+     * patterns (sorted by equation pair, dependent pair, and original node
+     * ID after all equation patterns are processed)
      */
-    std::map<UniqueEquationPair<Base>, Dep1Dep2SharedType> equationShared_;
+    std::vector<SharedTemporary> equationShared_;
     /**
      * maps the original model nodes used as temporary non-indexed variables
      * by the loops to an index k
      */
     std::map<OperationNode<Base>*, size_t> origTemp2Index_;
-    std::vector<std::set<size_t> > id2Deps;
+    /**
+     * The dependents which use each node (indexed by node ID)
+     */
+    std::vector<NodeDependents> id2Deps;
     size_t idCounter_;
     /**
      * the original shared node ID used to sort shared variables to ensure
      * reproducibility between different runs
      */
     CodeHandlerVector<Base, size_t> origShareNodeId_;
-    /// used to mark visited nodes and indexed nodes
-    size_t color_;
+    /**
+     * the number of threads used to determine the equation patterns
+     * (0 means one thread per core)
+     */
+    size_t nThreads_;
+    /**
+     * the minimum number of comparisons with a reference dependent
+     * performed by each thread in large groups of related dependents
+     */
+    static const size_t PARALLEL_COMPARISONS_MIN = 32;
 public:
 
     /**
@@ -121,13 +196,34 @@ public:
         independents_(independents),
         idCounter_(0),
         origShareNodeId_(*handler_),
-        color_(0) {
+        nThreads_(1) {
         CPPADCG_ASSERT_UNKNOWN(independents_.size() > 0)
         CPPADCG_ASSERT_UNKNOWN(independents_[0].getCodeHandler() != nullptr)
         equations_.reserve(relatedDepCandidates_.size());
         origShareNodeId_.adjustSize();
     }
 
+    /**
+     * Defines the number of threads used to determine the equation patterns
+     * in the groups of related dependents.
+     * The results do not depend on the number of threads.
+     *
+     * @param nThreads the number of threads (0 for one thread per core)
+     */
+    inline void setThreadCount(size_t nThreads) {
+        nThreads_ = nThreads;
+    }
+
+    /**
+     * Provides the number of threads used to determine the equation
+     * patterns.
+     */
+    inline size_t getThreadCount() const {
+        if (nThreads_ == 0)
+            return std::max<size_t>(1, std::thread::hardware_concurrency());
+        return nThreads_;
+    }
+
     const std::vector<EquationPattern<Base>*>& getEquationPatterns() const {
         return equations_;
     }
@@ -275,164 +371,145 @@ private:
         /*******************************************************************
          * Attempt to combine loops with shared variables
          ******************************************************************/
+        sortSharedTemporaries();
+
         MaxOps2eq2totalOps2validDepsType maxOps2Eq2totalOps2validDeps;
         Eq2totalOps2validDepsType eq2totalOps2validDeps;
-        SmartListPointer<TotalOps2validDepsType> totalOps2validDepsMem;
 
         /**
          * First organize pairs of equation patterns with shared variables
          * by the maximum number of shared operations among two dependent
          * variables.
          */
-        for (size_t l1 = 0; l1 < loops_.size(); l1++) {
-            Loop<Base>* loop1 = loops_[l1];
-            CPPADCG_ASSERT_UNKNOWN(loop1->equations.size() == 1)
-            EquationPattern<Base>* eq1 = *loop1->equations.begin();
-
-            for (size_t l2 = l1 + 1; l2 < loops_.size(); l2++) {
-                Loop<Base>* loop2 = loops_[l2];
-                CPPADCG_ASSERT_UNKNOWN(loop2->equations.size() == 1)
-                EquationPattern<Base>* eq2 = *loop2->equations.begin();
-
-                UniqueEquationPair<Base> eqRel(eq1, eq2);
-                const auto eqSharedit = equationShared_.find(eqRel);
-                if (eqSharedit == equationShared_.end())
-                    continue; // nothing is shared between eq1 and eq2
-
-                const Dep1Dep2SharedType& dep1Dep2Shared = eqSharedit->second;
-
-                /**
-                 * There are shared variables among the two equation patterns
-                 */
-                auto* totalOps2validDeps = new TotalOps2validDepsType();
-                totalOps2validDepsMem.push_back(totalOps2validDeps);
-                size_t maxOps = 0; // the maximum number of shared operations between two dependents
+        const size_t sharedSize = equationShared_.size();
+        for (size_t s = 0; s < sharedSize;) {
+            const UniqueEquationPair<Base>& eqRel = equationShared_[s].eqPair;
+            size_t eqKey = equationPairKey(eqRel);
 
-                bool canCombine = true;
-
-                /***************************************************
-                 * organize relations between dependents
-                 **************************************************/
-                for (const auto& itDep1Dep2 : dep1Dep2Shared) {
-                    size_t dep1 = itDep1Dep2.first;
-                    const map<size_t, map<OperationNode<Base>*, Indexed2OpCountType> >& dep2Shared = itDep1Dep2.second;
-
-                    // multiple deps2 means multiple choices for a relation (only one dep1<->dep2 can be chosen)
-                    for (const auto& itDep2 : dep2Shared) {
-                        size_t dep2 = itDep2.first;
-                        const map<OperationNode<Base>*, Indexed2OpCountType>& sharedTmps = itDep2.second;
-
-                        size_t totalOps = 0; // the total number of operations performed by shared variables with dep2
-                        for (const auto& itShared : sharedTmps) {
-                            if (itShared.second.first == INDEXED_OPERATION_TYPE::BOTH) {
-                                /**
-                                 * one equation uses this temporary shared
-                                 * variable as an indexed variable while the
-                                 * other equation does not
-                                 */
-                                canCombine = false;
-                                break;
-                            } else {
-                                totalOps += itShared.second.second;
-                            }
-                        }
-
-                        if (!canCombine) break;
-
-                        DepPairType depRel(dep1, dep2);
-                        (*totalOps2validDeps)[totalOps][depRel] = &sharedTmps;
-                        maxOps = std::max<size_t>(maxOps, totalOps);
+            /**
+             * There are shared variables among the two equation patterns
+             */
+            TotalOps2validDepsType totalOps2validDeps;
+            size_t maxOps = 0; // the maximum number of shared operations between two dependents
+
+            bool canCombine = true;
+
+            /***************************************************
+             * organize relations between dependents
+             **************************************************/
+            while (s < sharedSize && equationPairKey(equationShared_[s].eqPair) == eqKey) {
+                // multiple deps2 means multiple choices for a relation (only one dep1<->dep2 can be chosen)
+                DepPairType depRel(equationShared_[s].dep1, equationShared_[s].dep2);
+                size_t first = s;
+
+                size_t totalOps = 0; // the total number of operations performed by shared variables with dep2
+                for (; s < sharedSize && equationShared_[s].dep1 == depRel.first && equationShared_[s].dep2 == depRel.second &&
+                       equationPairKey(equationShared_[s].eqPair) == eqKey; ++s) {
+                    const Indexed2OpCountType& indexedOpCount = equationShared_[s].indexedOpCount;
+                    if (indexedOpCount.first == INDEXED_OPERATION_TYPE::BOTH) {
+                        /**
+                         * one equation uses this temporary shared
+                         * variable as an indexed variable while the
+                         * other equation does not
+                         */
+                        canCombine = false;
+                    } else {
+                        totalOps += indexedOpCount.second;
                     }
-
-                    if (!canCombine) break;
                 }
 
                 if (canCombine) {
-                    maxOps2Eq2totalOps2validDeps[maxOps][eqRel] = totalOps2validDeps;
-                    eq2totalOps2validDeps[eqRel] = totalOps2validDeps;
-                } else {
-                    incompatible_[eq1].insert(eq2);
-                    incompatible_[eq2].insert(eq1);
-                    totalOps2validDepsMem.pop_back();
-                    delete totalOps2validDeps;
+                    totalOps2validDeps.push_back(DepPairShared{totalOps, depRel,
+                                                               equationShared_.data() + first,
+                                                               equationShared_.data() + s});
+                    maxOps = std::max<size_t>(maxOps, totalOps);
                 }
             }
+
+            if (canCombine) {
+                std::stable_sort(totalOps2validDeps.begin(), totalOps2validDeps.end(),
+                                 [](const DepPairShared& a, const DepPairShared& b) {
+                                     return a.totalOps > b.totalOps;
+                                 });
+                const TotalOps2validDepsType& stored = eq2totalOps2validDeps[eqKey] = std::move(totalOps2validDeps);
+                maxOps2Eq2totalOps2validDeps.push_back(EquationPairShared{maxOps, eqRel, &stored});
+            } else {
+                incompatible_.insert(eqKey);
+            }
         }
 
+        // equation pairs are already sorted
+        std::stable_sort(maxOps2Eq2totalOps2validDeps.begin(), maxOps2Eq2totalOps2validDeps.end(),
+                         [](const EquationPairShared& a, const EquationPairShared& b) {
+                             return a.maxOps > b.maxOps;
+                         });
+
         /**
          * Try to merge loops with shared variables
          */
-        typename MaxOps2eq2totalOps2validDepsType::const_reverse_iterator itMaxOps;
-        for (itMaxOps = maxOps2Eq2totalOps2validDeps.rbegin(); itMaxOps != maxOps2Eq2totalOps2validDeps.rend(); ++itMaxOps) {
+        for (const EquationPairShared& itEqPair : maxOps2Eq2totalOps2validDeps) {
+            const UniqueEquationPair<Base>& eqRel = itEqPair.eqPair;
 #ifdef CPPADCG_PRINT_DEBUG
-            std::cout << "\n\nmaxOps: " << itMaxOps->first << "  count:" << itMaxOps->second.size() << std::endl;
+            std::cout << "maxOps: " << itEqPair.maxOps << "  eq1: " << *eqRel.eq1->dependents.begin() << "  eq2: " << *eqRel.eq2->dependents.begin() << std::endl;
 #endif
 
-            for (const auto& itEqPair : itMaxOps->second) {
-                const UniqueEquationPair<Base>& eqRel = itEqPair.first;
-#ifdef CPPADCG_PRINT_DEBUG
-                std::cout << "  eq1: " << *eqRel.eq1->dependents.begin() << "  eq2: " << *eqRel.eq2->dependents.begin() << std::endl;
-#endif
-
-                Loop<Base>* loop1 = equation2Loop_.at(eqRel.eq1);
-                Loop<Base>* loop2 = equation2Loop_.at(eqRel.eq2);
+            Loop<Base>* loop1 = equation2Loop_.at(eqRel.eq1);
+            Loop<Base>* loop2 = equation2Loop_.at(eqRel.eq2);
 
-                if (loop1 == loop2)
-                    continue; // already done
-                if (contains(incompatible_, eqRel.eq1, eqRel.eq2))
-                    continue; // incompatible
+            if (loop1 == loop2)
+                continue; // already done
+            if (isIncompatible(eqRel))
+                continue; // incompatible
 
-                /**
-                 * backup so that it is possible to revert the new relations if
-                 * required
-                 */
-                SmartSetPointer<set<size_t> > dependentRelationsBak;
-                for (const set<size_t>* its : dependentRelations) {
-                    dependentRelationsBak.insert(new set<size_t>(*its));
-                }
+            /**
+             * backup so that it is possible to revert the new relations if
+             * required
+             */
+            SmartSetPointer<set<size_t> > dependentRelationsBak;
+            for (const set<size_t>* its : dependentRelations) {
+                dependentRelationsBak.insert(new set<size_t>(*its));
+            }
 
-                // relationships between dependents for the resulting merged loop
-                set<set<size_t>*> loopRelations;
+            // relationships between dependents for the resulting merged loop
+            set<set<size_t>*> loopRelations;
 
-                set<EquationPattern<Base>*> indexedLoopRelations;
-                std::vector<std::pair<EquationPattern<Base>*, EquationPattern<Base>*> > nonIndexedLoopRelations;
+            set<EquationPattern<Base>*> indexedLoopRelations;
+            std::vector<std::pair<EquationPattern<Base>*, EquationPattern<Base>*> > nonIndexedLoopRelations;
 
-                /**
-                 * All equations from both loops must be compatible
-                 */
-                bool compatible = isCompatible(loop1, loop2,
-                                               eq2totalOps2validDeps,
-                                               dep2Relations, dependentBlackListRelations, dependentRelations,
-                                               loopRelations, indexedLoopRelations, nonIndexedLoopRelations);
+            /**
+             * All equations from both loops must be compatible
+             */
+            bool compatible = isCompatible(loop1, loop2,
+                                           eq2totalOps2validDeps,
+                                           dep2Relations, dependentBlackListRelations, dependentRelations,
+                                           loopRelations, indexedLoopRelations, nonIndexedLoopRelations);
 
-                if (compatible) {
-                    // merge the two loops
+            if (compatible) {
+                // merge the two loops
 
-                    // update the loop of the equations
-                    for (EquationPattern<Base>* itle : loop2->equations) {
-                        equation2Loop_[itle] = loop1;
-                    }
-                    loop1->merge(*loop2, indexedLoopRelations, nonIndexedLoopRelations);
+                // update the loop of the equations
+                for (EquationPattern<Base>* itle : loop2->equations) {
+                    equation2Loop_[itle] = loop1;
+                }
+                loop1->merge(*loop2, indexedLoopRelations, nonIndexedLoopRelations);
 
-                    typename std::vector<Loop<Base>*>::const_iterator it = std::find(loops_.cbegin(), loops_.cend(), loop2);
-                    CPPADCG_ASSERT_UNKNOWN(it != loops_.end())
-                    loops_.erase(it);
-                    delete loop2;
+                typename std::vector<Loop<Base>*>::const_iterator it = std::find(loops_.cbegin(), loops_.cend(), loop2);
+                CPPADCG_ASSERT_UNKNOWN(it != loops_.end())
+                loops_.erase(it);
+                delete loop2;
 
-                    loop1->setLinkedDependents(loopRelations);
+                loop1->setLinkedDependents(loopRelations);
 
-                    // relation between loop1 and loop2 done!
-                } else {
-                    // restore dependent relations
-                    dependentRelations.s.swap(dependentRelationsBak.s);
-                    // map each dependent to the relation set where it is present
-                    std::fill(dep2Relations.begin(), dep2Relations.end(), nullptr);
-                    for (set<size_t>* relation : dependentRelations) {
-                        for (size_t itd : *relation) {
-                            dep2Relations[itd] = relation;
-                        }
+                // relation between loop1 and loop2 done!
+            } else {
+                // restore dependent relations
+                dependentRelations.s.swap(dependentRelationsBak.s);
+                // map each dependent to the relation set where it is present
+                std::fill(dep2Relations.begin(), dep2Relations.end(), nullptr);
+                for (set<size_t>* relation : dependentRelations) {
+                    for (size_t itd : *relation) {
+                        dep2Relations[itd] = relation;
                     }
-
                 }
 
             }
@@ -457,7 +534,7 @@ private:
                     bool canMerge = loop1->getIterationCount() == loop2->getIterationCount();
                     if (canMerge) {
                         // check if there are equations in the blacklist
-                        canMerge = !find(loop1, loop2, incompatible_);
+                        canMerge = !isIncompatible(loop1, loop2);
                     }
 
                     if (canMerge) {
@@ -516,7 +593,7 @@ private:
          * Must order equation pairs property according to the highest
          * number of shared operations
          */
-        map<size_t, map<UniqueEquationPair<Base>, TotalOps2validDepsType*> > totalOp2eq;
+        map<size_t, map<UniqueEquationPair<Base>, const TotalOps2validDepsType*> > totalOp2eq;
 
         for (EquationPattern<Base>* eq1 : loop1->equations) {
 
@@ -524,45 +601,45 @@ private:
 
                 UniqueEquationPair<Base> eqRel(eq1, eq2);
 
-                typename Eq2totalOps2validDepsType::const_iterator eqSharedit = eq2totalOps2validDeps.find(eqRel);
+                typename Eq2totalOps2validDepsType::const_iterator eqSharedit = eq2totalOps2validDeps.find(equationPairKey(eqRel));
                 if (eqSharedit == eq2totalOps2validDeps.end())
                     continue; // nothing is shared between eq1 and eq2
 
 
-                size_t maxOps = eqSharedit->second->rbegin()->first;
-                totalOp2eq[maxOps][eqRel] = eqSharedit->second;
+                size_t maxOps = eqSharedit->second.front().totalOps;
+                totalOp2eq[maxOps][eqRel] = &eqSharedit->second;
             }
         }
 
-        typename map<size_t, map<UniqueEquationPair<Base>, TotalOps2validDepsType*> >::const_reverse_iterator itr;
+        typename map<size_t, map<UniqueEquationPair<Base>, const TotalOps2validDepsType*> >::const_reverse_iterator itr;
         for (itr = totalOp2eq.rbegin(); itr != totalOp2eq.rend(); ++itr) {
             // loop shared operation count
 
             for (const auto& itEq : itr->second) {
                 EquationPattern<Base>* eq1 = itEq.first.eq1;
                 EquationPattern<Base>* eq2 = itEq.first.eq2;
-                TotalOps2validDepsType& totalOps2validDeps = *itEq.second;
+                const TotalOps2validDepsType& totalOps2validDeps = *itEq.second;
 
                 /***************************************************
                  * attempt to combine dependents which share the
                  * highest number of operations first
                  **************************************************/
-                typename map<size_t, map<DepPairType, const map<OperationNode<Base>*, Indexed2OpCountType>* > >::const_reverse_iterator itOp2Dep2Shared;
-                for (itOp2Dep2Shared = totalOps2validDeps.rbegin(); itOp2Dep2Shared != totalOps2validDeps.rend(); ++itOp2Dep2Shared) {
+                const size_t depPairSize = totalOps2validDeps.size();
+                for (size_t p = 0; p < depPairSize;) {
+                    size_t totalOps = totalOps2validDeps[p].totalOps;
 #ifdef CPPADCG_PRINT_DEBUG
-                    std::cout << "    operation count: " << itOp2Dep2Shared->first << "  relations: " << itOp2Dep2Shared->second.size() << std::endl;
+                    std::cout << "    operation count: " << totalOps << std::endl;
 #endif
-                    for (const auto& itDep2Shared : itOp2Dep2Shared->second) {
-                        DepPairType depRel = itDep2Shared.first;
-                        size_t dep1 = depRel.first;
-                        size_t dep2 = depRel.second;
+                    for (; p < depPairSize && totalOps2validDeps[p].totalOps == totalOps; ++p) {
+                        const DepPairShared& depShared = totalOps2validDeps[p];
+                        size_t dep1 = depShared.deps.first;
+                        size_t dep2 = depShared.deps.second;
 
-                        const map<OperationNode<Base>*, Indexed2OpCountType>& shared = *itDep2Shared.second;
                         /**
                          * this dep1 <-> dep2 is used as a reference to combine
                          * the two equations in the same loop
                          */
-                        compatible = findDepRelations(eq1, dep1, eq2, dep2, shared,
+                        compatible = findDepRelations(eq1, dep1, eq2, dep2, depShared.begin, depShared.end,
                                                       dep2Relations, dependentBlackListRelations, dependentRelations);
                         if (!compatible) break;
                     }
@@ -620,8 +697,7 @@ private:
                 }
 
                 if (!compatible) {
-                    incompatible_[eq1].insert(eq2);
-                    incompatible_[eq2].insert(eq1);
+                    incompatible_.insert(equationPairKey(itEq.first));
                     break;
                 } else {
                     indexedLoopRelations.insert(eq1);
@@ -647,14 +723,15 @@ private:
                           size_t dep1,
                           EquationPattern<Base>* eq2,
                           size_t dep2,
-                          const std::map<OperationNode<Base>*, Indexed2OpCountType>& sharedNodes,
+                          const SharedTemporary* sharedBegin,
+                          const SharedTemporary* sharedEnd,
                           std::vector<std::set<size_t>* >& dep2Relations,
                           std::map<size_t, std::set<size_t> >& dependentBlackListRelations,
                           SmartSetPointer<std::set<size_t> >& dependentRelations) {
         using namespace std;
 
-        for (const auto& itShared : sharedNodes) {
-            OperationNode<Base>* sharedNode = itShared.first;
+        for (const SharedTemporary* itShared = sharedBegin; itShared != sharedEnd; ++itShared) {
+            OperationNode<Base>* sharedNode = itShared->node;
 
             // checks independents
             bool compatible = canCombineEquations(*eq1, dep1, *eq2, dep2, *sharedNode,
@@ -666,27 +743,6 @@ private:
         return true;
     }
 
-    void groupByLoopEqOp(EquationPattern<Base>* eq,
-                         std::map<Loop<Base>*, std::map<EquationPattern<Base>*, std::map<size_t, std::pair<OperationNode<Base>*, bool> > > >& loopSharedTemps,
-                         const std::map<OperationNode<Base>*, std::set<size_t> >& opShared,
-                         bool indexed) {
-        using namespace std;
-
-        for (OperationNode<Base>* shared : opShared) {
-            const set<size_t>& deps = id2Deps[varId_[*shared]];
-
-            for (size_t dep : deps) {
-                EquationPattern<Base>* otherEq = dep2Equation_.at(dep);
-                if (eq != otherEq) {
-                    Loop<Base>* loop = equation2Loop_.at(otherEq);
-                    // the original ID (saved in evaluation order) is used to sort shared variables
-                    // to ensure reproducibility between different runs
-                    loopSharedTemps[loop][otherEq][origShareNodeId_[shared]] = std::make_pair(shared, indexed);
-                }
-            }
-        }
-    }
-
     /**
      * Creates a new tape for the model without the equations in the loops
      * and with some extra dependents for the temporary variables used by
@@ -785,64 +841,230 @@ private:
 
     std::vector<EquationPattern<Base>*> findRelatedVariables() {
         eqCurr_ = nullptr;
-        CodeHandlerVector<Base, size_t> varColor(*handler_);
-        color_ = 1; // used to mark visited nodes
-
-        varColor.adjustSize();
-        varColor.fill(0);
 
         size_t rSize = relatedDepCandidates_.size();
+        size_t nThreads = getThreadCount();
+
+        /**
+         * small groups are processed in parallel with each other while the
+         * comparisons in large groups are split among the threads
+         */
+        std::vector<size_t> smallGroups, largeGroups;
         for (size_t r = 0; r < rSize; r++) {
-            const std::set<size_t>& candidates = relatedDepCandidates_[r];
-            std::set<size_t> used;
+            if (nThreads > 1 && relatedDepCandidates_[r].size() > 2 * PARALLEL_COMPARISONS_MIN)
+                largeGroups.push_back(r);
+            else
+                smallGroups.push_back(r);
+        }
+
+        if (largeGroups.empty())
+            nThreads = std::max<size_t>(1, std::min(nThreads, rSize));
+
+        /**
+         * each thread uses its own node colors (used to mark visited nodes)
+         */
+        std::vector<std::unique_ptr<CodeHandlerVector<Base, size_t> > > varColors(nThreads);
+        std::vector<size_t> colors(nThreads, 1);
+        for (auto& varColor : varColors) {
+            varColor.reset(new CodeHandlerVector<Base, size_t>(*handler_));
+            varColor->adjustSize();
+            varColor->fill(0);
+        }
+
+        /**
+         * the groups of candidates are independent from each other
+         */
+        std::vector<std::vector<std::unique_ptr<EquationPattern<Base> > > > candidateEquations(rSize);
 
-            eqCurr_ = nullptr;
+        parallelFor(smallGroups.size(), nThreads, [&](size_t s, size_t thread) {
+            size_t r = smallGroups[s];
+            findRelatedVariables(relatedDepCandidates_[r], candidateEquations[r], colors[thread], *varColors[thread]);
+        });
 
-            std::set<size_t>::const_iterator itRef;
-            for (itRef = candidates.begin(); itRef != candidates.end(); ++itRef) {
-                size_t iDepRef = *itRef;
+        for (size_t r : largeGroups) {
+            findRelatedVariables(relatedDepCandidates_[r], candidateEquations[r], nThreads, colors, varColors);
+        }
+
+        // use the same order as a sequential search (reproducibility)
+        for (auto& eqs : candidateEquations) {
+            for (auto& eq : eqs) {
+                equations_.push_back(eq.release());
+            }
+        }
+
+        /**
+         * Determine the independents that don't change from iteration to
+         * iteration
+         */
+        parallelFor(equations_.size(), nThreads, [this](size_t eq, size_t) {
+            equations_[eq]->detectNonIndexedIndependents();
+        });
 
+        return equations_;
+    }
+
+    /**
+     * Determines the equation patterns in a group of related dependent
+     * candidates.
+     *
+     * @param candidates the dependent variable indexes
+     * @param equations where the new equation patterns are placed
+     * @param color the color used to mark visited nodes
+     *              (increased with every comparison)
+     * @param varColor the node colors
+     */
+    void findRelatedVariables(const std::set<size_t>& candidates,
+                              std::vector<std::unique_ptr<EquationPattern<Base> > >& equations,
+                              size_t& color,
+                              CodeHandlerVector<Base, size_t>& varColor) const {
+        std::set<size_t> used;
+
+        EquationPattern<Base>* eqCurr = nullptr;
+
+        std::set<size_t>::const_iterator itRef;
+        for (itRef = candidates.begin(); itRef != candidates.end(); ++itRef) {
+            size_t iDepRef = *itRef;
+
+            // check if it has already been used
+            if (used.find(iDepRef) != used.end()) {
+                continue;
+            }
+
+            if (eqCurr == nullptr || !used.empty()) {
+                eqCurr = new EquationPattern<Base>(dependents_[iDepRef], iDepRef);
+                equations.emplace_back(eqCurr);
+            }
+
+            auto it = itRef;
+            for (++it; it != candidates.end(); ++it) {
+                size_t iDep = *it;
                 // check if it has already been used
-                if (used.find(iDepRef) != used.end()) {
+                if (used.find(iDep) != used.end()) {
                     continue;
                 }
 
-                if (eqCurr_ == nullptr || !used.empty()) {
-                    eqCurr_ = new EquationPattern<Base>(dependents_[iDepRef], iDepRef);
-                    equations_.push_back(eqCurr_);
+                if (eqCurr->testAdd(iDep, dependents_[iDep], color, varColor)) {
+                    used.insert(iDep);
                 }
+            }
 
-                auto it = itRef;
-                for (++it; it != candidates.end(); ++it) {
-                    size_t iDep = *it;
-                    // check if it has already been used
-                    if (used.find(iDep) != used.end()) {
-                        continue;
-                    }
+            if (eqCurr->dependents.size() == 1) {
+                // nothing found :(
+                eqCurr = nullptr;
+                equations.pop_back();
+            }
+        }
+    }
 
-                    if (eqCurr_->testAdd(iDep, dependents_[iDep], color_, varColor)) {
-                        used.insert(iDep);
-                    }
+    /**
+     * Determines the equation patterns in a large group of related dependent
+     * candidates by splitting the comparisons with each reference dependent
+     * among several threads.
+     * Each thread compares a contiguous range of the remaining candidates
+     * with its own equation pattern and these patterns are merged in the
+     * order of the ranges, therefore the results are the same as in the
+     * sequential search.
+     *
+     * @param candidates the dependent variable indexes
+     * @param equations where the new equation patterns are placed
+     * @param nThreads the maximum number of threads
+     * @param colors the color used to mark visited nodes by each thread
+     * @param varColors the node colors of each thread
+     */
+    void findRelatedVariables(const std::set<size_t>& candidates,
+                              std::vector<std::unique_ptr<EquationPattern<Base> > >& equations,
+                              size_t nThreads,
+                              std::vector<size_t>& colors,
+                              std::vector<std::unique_ptr<CodeHandlerVector<Base, size_t> > >& varColors) const {
+        // the candidates which were not added to an equation pattern yet
+        std::vector<size_t> remaining(candidates.begin(), candidates.end());
+        std::vector<size_t> unused;
+
+        while (!remaining.empty()) {
+            size_t iDepRef = remaining[0];
+            size_t nCmp = remaining.size() - 1;
+            size_t nRanges = std::max<size_t>(1, std::min(nThreads, nCmp / PARALLEL_COMPARISONS_MIN));
+
+            std::vector<std::unique_ptr<EquationPattern<Base> > > patterns(nRanges);
+
+            parallelFor(nRanges, nRanges, [&](size_t c, size_t thread) {
+                patterns[c].reset(new EquationPattern<Base>(dependents_[iDepRef], iDepRef));
+
+                size_t end = 1 + (c + 1) * nCmp / nRanges;
+                for (size_t k = 1 + c * nCmp / nRanges; k < end; ++k) {
+                    size_t iDep = remaining[k];
+                    patterns[c]->testAdd(iDep, dependents_[iDep], colors[thread], *varColors[thread]);
                 }
+            });
 
-                if (eqCurr_->dependents.size() == 1) {
-                    // nothing found :(
-                    delete eqCurr_;
-                    eqCurr_ = nullptr;
-                    equations_.pop_back();
-                }
+            // reduce in a fixed order (reproducibility)
+            EquationPattern<Base>* eqCurr = patterns[0].get();
+            for (size_t c = 1; c < nRanges; ++c) {
+                eqCurr->merge(*patterns[c]);
+            }
+
+            unused.clear();
+            for (size_t k = 1; k < remaining.size(); ++k) {
+                if (eqCurr->dependents.find(remaining[k]) == eqCurr->dependents.end())
+                    unused.push_back(remaining[k]);
             }
+            remaining.swap(unused);
+
+            if (eqCurr->dependents.size() > 1) {
+                equations.push_back(std::move(patterns[0]));
+            } // else nothing found :(
         }
+    }
 
-        /**
-         * Determine the independents that don't change from iteration to
-         * iteration
-         */
-        for (size_t eq = 0; eq < equations_.size(); eq++) {
-            equations_[eq]->detectNonIndexedIndependents();
+    /**
+     * Calls a function for each index in [0, n) using several threads
+     * (the current thread is also used).
+     * The work is distributed dynamically, therefore the function should
+     * only modify data associated with its index or with its thread.
+     *
+     * @param n the number of indexes
+     * @param nThreads the number of threads
+     * @param func the function to call with an index and a thread number
+     *             (lower than nThreads)
+     */
+    template<class Func>
+    static void parallelFor(size_t n,
+                            size_t nThreads,
+                            Func func) {
+        nThreads = std::min(nThreads, n);
+
+        if (nThreads <= 1) {
+            for (size_t i = 0; i < n; ++i)
+                func(i, 0);
+            return;
         }
 
-        return equations_;
+        std::atomic<size_t> next(0);
+        std::vector<std::exception_ptr> errors(nThreads);
+
+        auto work = [&](size_t thread) {
+            try {
+                for (size_t i = next++; i < n; i = next++) {
+                    func(i, thread);
+                }
+            } catch (...) {
+                errors[thread] = std::current_exception();
+                next = n; // stop the other threads
+            }
+        };
+
+        std::vector<std::thread> threads;
+        threads.reserve(nThreads - 1);
+        for (size_t t = 1; t < nThreads; ++t)
+            threads.emplace_back(work, t);
+        work(0);
+
+        for (std::thread& t : threads)
+            t.join();
+
+        for (const std::exception_ptr& e : errors) {
+            if (e) std::rethrow_exception(e);
+        }
     }
 
     /**
@@ -906,39 +1128,28 @@ private:
         varIndexed_[*node] = indexedOperation; // mark this operation as being indexed or not-indexed
 
         size_t id = varId_[*node];
-        std::set<size_t>& deps = id2Deps[id];
+        const NodeDependents& deps = id2Deps[id];
 
-        if (deps.size() > 1 && node->getOperationType() != CGOpCode::Inv) {
+        if (deps.count > 1 && node->getOperationType() != CGOpCode::Inv &&
+            deps.lastEq == eqCurr_ && deps.minOther != (std::numeric_limits<size_t>::max)()) {
             /**
-             * Temporary variable
+             * Temporary variable shared with a different loop
+             * (the lowest dependent from another equation pattern is used)
              */
-            for (size_t otherDep : deps) {
+            size_t otherDep = deps.minOther;
+            EquationPattern<Base>* otherEquation = dep2Equation_.at(otherDep);
 
-                EquationPattern<Base>* otherEquation = dep2Equation_.at(otherDep);
-                if (otherEquation != eqCurr_) {
-                    /**
-                     * temporary variable shared with a different loop
-                     */
-                    UniqueEquationPair<Base> eqPair(eqCurr_, otherEquation);
-                    Dep1Dep2SharedType& relation = equationShared_[eqPair];
-
-                    std::map<OperationNode<Base>*, Indexed2OpCountType>* reldepdep;
-                    if (eqPair.eq1 == eqCurr_)
-                        reldepdep = &relation[depIndex][otherDep];
-                    else
-                        reldepdep = &relation[otherDep][depIndex];
-
-                    INDEXED_OPERATION_TYPE expected = indexedOperation ? INDEXED_OPERATION_TYPE::INDEXED : INDEXED_OPERATION_TYPE::NONINDEXED;
-                    typename std::map<OperationNode<Base>*, Indexed2OpCountType>::iterator itIndexedType = reldepdep->find(node);
-                    if (itIndexedType == reldepdep->end()) {
-                        (*reldepdep)[node] = Indexed2OpCountType(expected, localOpCount);
-                    } else if (itIndexedType->second.first != expected) {
-                        itIndexedType->second.first = INDEXED_OPERATION_TYPE::BOTH;
-                    }
+            UniqueEquationPair<Base> eqPair(eqCurr_, otherEquation);
+            INDEXED_OPERATION_TYPE expected = indexedOperation ? INDEXED_OPERATION_TYPE::INDEXED : INDEXED_OPERATION_TYPE::NONINDEXED;
 
-                    break;
-                }
-            }
+            size_t dep1 = depIndex;
+            size_t dep2 = otherDep;
+            if (eqPair.eq1 != eqCurr_)
+                std::swap(dep1, dep2);
+
+            // duplicates are merged later by sortSharedTemporaries()
+            equationShared_.push_back(SharedTemporary{eqPair, dep1, dep2, node, origShareNodeId_[*node],
+                                                      Indexed2OpCountType(expected, localOpCount)});
         }
 
         return indexedOperation;
@@ -958,16 +1169,24 @@ private:
 
         size_t id = varId_[*node];
 
-        std::set<size_t>& deps = id2Deps[id];
+        NodeDependents& deps = id2Deps[id];
 
-        if (deps.empty()) {
-            deps.insert(dep); // here for the first time
-        } else {
-            auto added = deps.insert(dep);
-            if (!added.second) {
-                return; // already been here
-            }
+        /**
+         * the dependents of an equation pattern are marked one after the
+         * other (and never again afterwards)
+         */
+        if (deps.last == dep) {
+            return; // already been here
+        }
+
+        if (deps.lastEq != eqCurr_) {
+            // the first dependent from a new equation pattern
+            deps.minOther = deps.min;
+            deps.lastEq = eqCurr_;
         }
+        deps.count++;
+        deps.last = dep;
+        deps.min = std::min<size_t>(deps.min, dep);
 
         const std::vector<Argument<Base> >& args = node->getArguments();
         size_t arg_size = args.size();
@@ -1030,17 +1249,31 @@ private:
         }
     }
 
-    static bool find(Loop<Base>* loop1, Loop<Base>* loop2,
-                     const std::map<EquationPattern<Base>*, std::set<EquationPattern<Base>*> >& blackList) {
-        for (EquationPattern<Base>* iteq1 : loop1->equations) {
+    /**
+     * Provides a unique key for a pair of equation patterns using the
+     * reference dependent index of each equation pattern.
+     */
+    inline size_t equationPairKey(const UniqueEquationPair<Base>& eqPair) const {
+        return eqPair.eq1->depRefIndex * dependents_.size() + eqPair.eq2->depRefIndex;
+    }
 
-            const auto itBlack = blackList.find(iteq1);
-            if (itBlack != blackList.end()) {
+    inline bool isIncompatible(const UniqueEquationPair<Base>& eqPair) const {
+        return incompatible_.find(equationPairKey(eqPair)) != incompatible_.end();
+    }
 
-                for (EquationPattern<Base>* iteq2 : loop2->equations) {
-                    if (itBlack->second.find(iteq2) != itBlack->second.end()) {
-                        return true; // found
-                    }
+    /**
+     * Determines whether or not there are equation patterns in the two
+     * loops which cannot be in the same loop.
+     */
+    inline bool isIncompatible(Loop<Base>* loop1,
+                               Loop<Base>* loop2) const {
+        if (incompatible_.empty())
+            return false;
+
+        for (EquationPattern<Base>* eq1 : loop1->equations) {
+            for (EquationPattern<Base>* eq2 : loop2->equations) {
+                if (isIncompatible(UniqueEquationPair<Base>(eq1, eq2))) {
+                    return true; // found
                 }
             }
         }
@@ -1048,16 +1281,39 @@ private:
         return false;
     }
 
-    template<class T>
-    static inline bool contains(const std::map<T, std::set<T> >& map, T eq1, T eq2) {
-        typename std::map<T, std::set<T> >::const_iterator itb1;
-        itb1 = map.find(eq1);
-        if (itb1 != map.end()) {
-            if (itb1->second.find(eq2) != itb1->second.end()) {
-                return true;
+    /**
+     * Sorts the shared temporary variables by equation pair, dependent
+     * pair, and original node ID (to ensure reproducibility between
+     * different runs) and merges repeated entries.
+     */
+    inline void sortSharedTemporaries() {
+        std::sort(equationShared_.begin(), equationShared_.end(),
+                  [](const SharedTemporary& a, const SharedTemporary& b) {
+                      if (a.eqPair.eq1->depRefIndex != b.eqPair.eq1->depRefIndex)
+                          return a.eqPair.eq1->depRefIndex < b.eqPair.eq1->depRefIndex;
+                      if (a.eqPair.eq2->depRefIndex != b.eqPair.eq2->depRefIndex)
+                          return a.eqPair.eq2->depRefIndex < b.eqPair.eq2->depRefIndex;
+                      if (a.dep1 != b.dep1)
+                          return a.dep1 < b.dep1;
+                      if (a.dep2 != b.dep2)
+                          return a.dep2 < b.dep2;
+                      return a.origNodeId < b.origNodeId;
+                  });
+
+        size_t last = 0;
+        for (size_t s = 1; s < equationShared_.size(); ++s) {
+            SharedTemporary& prev = equationShared_[last];
+            const SharedTemporary& curr = equationShared_[s];
+            if (curr.node == prev.node && curr.dep1 == prev.dep1 && curr.dep2 == prev.dep2 &&
+                curr.eqPair.eq1 == prev.eqPair.eq1 && curr.eqPair.eq2 == prev.eqPair.eq2) {
+                if (curr.indexedOpCount.first != prev.indexedOpCount.first)
+                    prev.indexedOpCount.first = INDEXED_OPERATION_TYPE::BOTH;
+            } else {
+                equationShared_[++last] = curr;
             }
         }
-        return false;
+        if (!equationShared_.empty())
+            equationShared_.resize(last + 1);
     }
 
     bool canCombineEquations(const EquationPattern<Base>& eq1,
@@ -132,6 +132,36 @@ public:
         }
     }
 
+    /**
+     * Adds the dependents of another equation pattern with the same
+     * reference dependent (e.g. created by another thread).
+     * The result is the same as adding the dependents of the other
+     * pattern with testAdd().
+     *
+     * @param other an equation pattern with the same reference dependent
+     */
+    void merge(const EquationPattern<Base>& other) {
+        CPPADCG_ASSERT_UNKNOWN(other.depRefIndex == depRefIndex)
+        CPPADCG_ASSERT_UNKNOWN(constOperationIndependents.empty() && other.constOperationIndependents.empty())
+
+        dependents.insert(other.dependents.begin(), other.dependents.end());
+
+        for (const auto& itDep : other.operationEO2Reference) {
+            operationEO2Reference[itDep.first].insert(itDep.second.begin(), itDep.second.end());
+        }
+
+        for (const auto& itOp : other.indexedOpIndep.op2Arguments) {
+            std::vector<std::map<size_t, const OperationNode<Base>*> >& arg2Indeps = indexedOpIndep.op2Arguments[itOp.first].arg2Independents;
+            const std::vector<std::map<size_t, const OperationNode<Base>*> >& otherArg2Indeps = itOp.second.arg2Independents;
+            if (arg2Indeps.size() < otherArg2Indeps.size())
+                arg2Indeps.resize(otherArg2Indeps.size());
+
+            for (size_t a = 0; a < otherArg2Indeps.size(); a++) {
+                arg2Indeps[a].insert(otherArg2Indeps[a].begin(), otherArg2Indeps[a].end());
+            }
+        }
+    }
+
     inline void findIndexedPath(size_t dep,
                                 const std::vector<CG<Base> >& depVals,
                                 CodeHandlerVector<Base, bool>& varIndexed,
@@ -0,0 +1,204 @@
+#ifndef CPPAD_CG_RELATED_DEPENDENTS_FINDER_INCLUDED
+#define CPPAD_CG_RELATED_DEPENDENTS_FINDER_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * Determines groups of dependent variables which are likely to be computed
+ * by the same equation pattern (the related dependent candidates used by
+ * DependentPatternMatcher).
+ * Dependents are grouped according to a hash of the shape of their
+ * expression trees where the independent variables are abstracted away,
+ * that is, dependents which only differ in the independent variables they
+ * use are placed in the same group.
+ * The hash is only used to select candidates: the equation patterns are
+ * still verified by DependentPatternMatcher and therefore hash collisions
+ * do not lead to wrong results.
+ *
+ * @author Joao Leal
+ */
+template<class Base>
+class RelatedDependentsFinder {
+private:
+    /**
+     * The hash of the expression tree of each visited node
+     */
+    std::unordered_map<const OperationNode<Base>*, size_t> _hashes;
+    /**
+     * The minimum number of dependents in a group
+     */
+    size_t _minGroupSize;
+public:
+
+    /**
+     * @param minGroupSize the minimum number of dependents in a group
+     *                     (smaller groups are discarded)
+     */
+    explicit RelatedDependentsFinder(size_t minGroupSize = 2) :
+        _minGroupSize(minGroupSize) {
+    }
+
+    /**
+     * Determines the groups of related dependent candidates.
+     * The groups are sorted by their lowest dependent index.
+     *
+     * @param dependents the dependent variables
+     * @return the groups of dependent variable indexes
+     */
+    inline std::vector<std::set<size_t> > find(const std::vector<CG<Base> >& dependents) {
+        std::unordered_map<size_t, std::set<size_t> > groups;
+        std::vector<size_t> order; // the hashes in the order they were found
+
+        for (size_t i = 0; i < dependents.size(); ++i) {
+            OperationNode<Base>* node = dependents[i].getOperationNode();
+            if (node == nullptr)
+                continue; // constant dependent
+
+            size_t h = hash(*node);
+            std::set<size_t>& group = groups[h];
+            if (group.empty())
+                order.push_back(h);
+            group.insert(i);
+        }
+
+        std::vector<std::set<size_t> > related;
+        for (size_t h : order) {
+            std::set<size_t>& group = groups[h];
+            if (group.size() >= _minGroupSize && group.size() > 1) {
+                related.push_back(std::move(group));
+            }
+        }
+
+        return related;
+    }
+
+    /**
+     * Provides the hash of the expression tree of a node where the
+     * independent variables are abstracted away.
+     * Nodes are only visited once (the hashes are cached).
+     *
+     * @param root the root of the expression tree
+     * @return the hash value
+     */
+    inline size_t hash(const OperationNode<Base>& root) {
+        const OperationNode<Base>* rootNode = skipAliases(&root);
+
+        auto it = _hashes.find(rootNode);
+        if (it != _hashes.end())
+            return it->second;
+
+        /**
+         * iterative post-order traversal (expression trees can be deep)
+         */
+        std::vector<std::pair<const OperationNode<Base>*, bool> > stack;
+        stack.emplace_back(rootNode, false);
+
+        while (!stack.empty()) {
+            const OperationNode<Base>* node = stack.back().first;
+            if (_hashes.find(node) != _hashes.end()) {
+                stack.pop_back();
+                continue;
+            }
+
+            if (!stack.back().second) {
+                stack.back().second = true;
+                for (const Argument<Base>& a : node->getArguments()) {
+                    const OperationNode<Base>* arg = argumentNode(a);
+                    if (arg != nullptr && _hashes.find(arg) == _hashes.end())
+                        stack.emplace_back(arg, false);
+                }
+            } else {
+                stack.pop_back();
+                _hashes[node] = hashNode(*node);
+            }
+        }
+
+        return _hashes[rootNode];
+    }
+
+private:
+
+    /**
+     * Combines the hash of an element with an existing hash value.
+     */
+    static inline void combine(size_t& seed,
+                               size_t value) {
+        seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    }
+
+    /**
+     * Follows alias operations (as DependentPatternMatcher does) unless
+     * they point to an independent variable.
+     */
+    static inline const OperationNode<Base>* skipAliases(const OperationNode<Base>* node) {
+        while (node->getOperationType() == CGOpCode::Alias) {
+            const Argument<Base>& a = node->getArguments()[0];
+            OperationNode<Base>* arg = a.getOperation();
+            if (arg == nullptr || arg->getOperationType() == CGOpCode::Inv)
+                break;
+            node = arg;
+        }
+        return node;
+    }
+
+    /**
+     * Provides the node of an argument whose hash must be determined
+     * (nullptr for parameters and independent variables).
+     */
+    static inline const OperationNode<Base>* argumentNode(const Argument<Base>& a) {
+        const OperationNode<Base>* arg = a.getOperation();
+        if (arg == nullptr || arg->getOperationType() == CGOpCode::Inv)
+            return nullptr;
+        return skipAliases(arg);
+    }
+
+    /**
+     * Determines the hash of a node whose arguments have already been
+     * visited.
+     */
+    inline size_t hashNode(const OperationNode<Base>& node) const {
+        size_t h = size_t(node.getOperationType());
+
+        const std::vector<size_t>& info = node.getInfo();
+        combine(h, info.size());
+        for (size_t i : info)
+            combine(h, i);
+
+        const std::vector<Argument<Base> >& args = node.getArguments();
+        combine(h, args.size());
+        for (const Argument<Base>& a : args) {
+            const OperationNode<Base>* arg = a.getOperation();
+            if (arg == nullptr) {
+                combine(h, 1);
+                combine(h, std::hash<Base>()(*a.getParameter()));
+            } else if (arg->getOperationType() == CGOpCode::Inv) {
+                combine(h, 2); // any independent variable
+            } else {
+                combine(h, 3);
+                combine(h, _hashes.at(skipAliases(arg)));
+            }
+        }
+
+        return h;
+    }
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
@@ -42,7 +42,11 @@ inline CG<Base> CodeHandler<Base>::solveFor(OperationNode<Base>& expression,
         // find possible paths from expression to var
         size_t oldBif = bifurcations;
         bifurcations = 0;
-        foundGraph = findPathGraph(*root, var, bifurcations, 50000);
+        if (root == &expression) {
+            foundGraph = findCachedPathGraph(*root, var, bifurcations, 50000);
+        } else {
+            foundGraph = findPathGraph(*root, var, bifurcations, 50000); // a new expression created by collectVariable()
+        }
         CPPADCG_ASSERT_UNKNOWN(oldBif > bifurcations);
 
         if (!foundGraph.contains(var)) {
@@ -192,7 +196,7 @@ template<class Base>
 inline bool CodeHandler<Base>::isSolvable(OperationNode<Base>& expression,
                                           OperationNode<Base>& var) {
     size_t bifurcations = 0;
-    BidirGraph<Base> g = findPathGraph(expression, var, bifurcations);
+    BidirGraph<Base> g = findCachedPathGraph(expression, var, bifurcations);
 
     if(bifurcations == 0) {
         size_t bifIndex = 0;
@@ -0,0 +1,109 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+/**
+ * Compares the time required by the augment path and the Hopcroft-Karp
+ * matching algorithms to determine the equations to differentiate in the
+ * Pantelides and Soares-Secchi methods for a chain of pendulums.
+ *
+ * usage: speed_bipartite_matching [number of pendulums]
+ */
+#include <chrono>
+#include <cppad/cg/dae_index_reduction/pantelides.hpp>
+#include <cppad/cg/dae_index_reduction/soares_secchi.hpp>
+#include "../../../../test/cppad/cg/dae_index_reduction/model/pendulum_chain.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+using CGD = CG<double>;
+
+inline size_t parseProgramArgument(int pos, int argc, char **argv, size_t defaultValue) {
+    if (argc > pos) {
+        std::istringstream is(argv[pos]);
+        size_t value;
+        is >> value;
+        return value;
+    }
+    return defaultValue;
+}
+
+/**
+ * Provides access to the detection of the equations to differentiate
+ */
+template<class Method>
+class MatchingBenchmark : public Method {
+public:
+    using Method::Method;
+    using Method::detectSubset2Dif;
+};
+
+/**
+ * Determines how many times each original equation must be differentiated
+ * and the time spent.
+ */
+template<class Method>
+std::vector<size_t> differentiations(ADFun<CGD>& fun,
+                                     const std::vector<DaeVarInfo>& daeVar,
+                                     const std::vector<double>& x,
+                                     BipartiteMatching matching,
+                                     double& elapsed) {
+    std::vector<std::string> eqName; // empty
+
+    MatchingBenchmark<Method> method(fun, daeVar, eqName, x);
+    method.setMatching(matching);
+
+    auto start = std::chrono::steady_clock::now();
+    method.detectSubset2Dif();
+    elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const auto& enodes = method.getGraph().equations();
+    std::vector<size_t> order(fun.Range(), 0);
+    for (size_t i = 0; i < order.size(); i++) {
+        for (const Enode<double>* e = enodes[i]->derivative(); e != nullptr; e = e->derivative()) {
+            order[i]++;
+        }
+    }
+
+    return order;
+}
+
+template<class Method>
+void compare(const std::string& name,
+             ADFun<CGD>& fun,
+             const std::vector<DaeVarInfo>& daeVar,
+             const std::vector<double>& x) {
+    double tAugment, tHK;
+    std::vector<size_t> orderAugment = differentiations<Method>(fun, daeVar, x, BipartiteMatching::AugmentPath, tAugment);
+    std::vector<size_t> orderHK = differentiations<Method>(fun, daeVar, x, BipartiteMatching::HopcroftKarp, tHK);
+
+    std::cout << name << " (" << fun.Range() << " equations):\n"
+            "   augment path (s):  " << tAugment << "\n"
+            "   Hopcroft-Karp (s): " << tHK << "\n"
+            "   same equations: " << (orderAugment == orderHK ? "yes" : "no") << std::endl;
+}
+
+int main(int argc, char **argv) {
+    size_t nPend = parseProgramArgument(1, argc, argv, 200);
+
+    std::vector<DaeVarInfo> daeVar;
+    std::vector<double> x;
+    std::unique_ptr<ADFun<CGD>> fun(PendulumChain<CGD>(nPend, daeVar, x));
+
+    compare<Pantelides<double> >("Pantelides", *fun, daeVar, x);
+    compare<SoaresSecchi<double> >("Soares Secchi", *fun, daeVar, x);
+
+    return 0;
+}
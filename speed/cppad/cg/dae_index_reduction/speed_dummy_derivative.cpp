@@ -0,0 +1,117 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+/**
+ * Compares the time required to select the dummy derivatives of a chain of
+ * pendulums with the dense and the sparse QR factorizations.
+ *
+ * usage: speed_dummy_derivative [number of pendulums]
+ */
+#include <chrono>
+#include <cppad/cg/dae_index_reduction/dummy_deriv.hpp>
+#include "../../../../test/cppad/cg/dae_index_reduction/model/pendulum_chain.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+using CGD = CG<double>;
+
+inline size_t parseProgramArgument(int pos, int argc, char **argv, size_t defaultValue) {
+    if (argc > pos) {
+        std::istringstream is(argv[pos]);
+        size_t value;
+        is >> value;
+        return value;
+    }
+    return defaultValue;
+}
+
+/**
+ * Measures the time spent selecting dummy derivatives
+ */
+class TimedDummyDerivatives : public DummyDerivatives<double> {
+public:
+    double elapsed;
+
+    TimedDummyDerivatives(DaeStructuralIndexReduction<double>& idxIdentify,
+                          const std::vector<double>& x,
+                          const std::vector<double>& normVar,
+                          const std::vector<double>& normEq) :
+        DummyDerivatives<double>(idxIdentify, x, normVar, normEq),
+        elapsed(0) {
+    }
+
+protected:
+
+    void addDummyDerivatives(const std::vector<DaeVarInfo>& varInfo,
+                             const std::vector<DaeEquationInfo>& eqInfo,
+                             std::vector<DaeVarInfo>& newVarInfo) override {
+        auto start = std::chrono::steady_clock::now();
+        DummyDerivatives<double>::addDummyDerivatives(varInfo, eqInfo, newVarInfo);
+        elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+};
+
+/**
+ * Performs the index reduction and provides the number of differential
+ * variables in the reduced model and the time spent selecting the dummy
+ * derivatives.
+ */
+size_t reduceIndex(ADFun<CGD>& fun,
+                   const std::vector<DaeVarInfo>& daeVar,
+                   const std::vector<double>& x,
+                   bool sparse,
+                   double& elapsed) {
+    std::vector<double> normVar(daeVar.size(), 1.0);
+    std::vector<double> normEq(fun.Range(), 1.0);
+    std::vector<std::string> eqName; // empty
+
+    Pantelides<double> pantelides(fun, daeVar, eqName, x);
+    TimedDummyDerivatives dummyD(pantelides, x, normVar, normEq);
+    dummyD.setReduceEquations(false);
+    dummyD.setSparseSelection(sparse);
+
+    std::vector<DaeVarInfo> newDaeVar;
+    std::vector<DaeEquationInfo> newEqInfo;
+    std::unique_ptr<ADFun<CGD>> reducedFun = dummyD.reduceIndex(newDaeVar, newEqInfo);
+
+    elapsed = dummyD.elapsed;
+
+    size_t differential = 0;
+    for (const DaeVarInfo& v : newDaeVar) {
+        if (v.getAntiDerivative() >= 0)
+            differential++;
+    }
+    return differential;
+}
+
+int main(int argc, char **argv) {
+    size_t nPend = parseProgramArgument(1, argc, argv, 100);
+
+    std::vector<DaeVarInfo> daeVar;
+    std::vector<double> x;
+    std::unique_ptr<ADFun<CGD>> fun(PendulumChain<CGD>(nPend, daeVar, x));
+
+    double tDense, tSparse;
+    size_t diffDense = reduceIndex(*fun, daeVar, x, false, tDense);
+    size_t diffSparse = reduceIndex(*fun, daeVar, x, true, tSparse);
+
+    std::cout << "Dummy derivative selection (" << fun->Range() << " equations):\n"
+            "   dense QR (s):  " << tDense << "\n"
+            "   sparse QR (s): " << tSparse << "\n"
+            "   same number of differential variables: " << (diffDense == diffSparse ? "yes" : "no") << std::endl;
+
+    return 0;
+}
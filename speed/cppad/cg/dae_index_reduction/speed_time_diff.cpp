@@ -0,0 +1,101 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+/**
+ * Compares the time required by the Pantelides method to create the reduced
+ * model of a chain of pendulums when the new equations are differentiated
+ * with respect to time using an increasing number of threads.
+ *
+ * usage: speed_time_diff [number of pendulums] [maximum number of threads]
+ */
+#include <chrono>
+#include <thread>
+#include <cppad/cg/dae_index_reduction/pantelides.hpp>
+#include "../../../../test/cppad/cg/dae_index_reduction/model/pendulum_chain.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+using CGD = CG<double>;
+
+inline size_t parseProgramArgument(int pos, int argc, char **argv, size_t defaultValue) {
+    if (argc > pos) {
+        std::istringstream is(argv[pos]);
+        size_t value;
+        is >> value;
+        return value;
+    }
+    return defaultValue;
+}
+
+/**
+ * Performs the index reduction, evaluates the reduced model, and provides
+ * the time spent.
+ */
+std::vector<double> reduceIndex(ADFun<CGD>& fun,
+                                const std::vector<DaeVarInfo>& daeVar,
+                                const std::vector<double>& x,
+                                size_t nThreads,
+                                double& elapsed) {
+    std::vector<std::string> eqName; // empty
+
+    Pantelides<double> pantelides(fun, daeVar, eqName, x);
+    pantelides.setTimeDiffThreadCount(nThreads);
+
+    std::vector<DaeVarInfo> newDaeVar;
+    std::vector<DaeEquationInfo> equationInfo;
+
+    auto start = std::chrono::steady_clock::now();
+    std::unique_ptr<ADFun<CGD>> reducedFun = pantelides.reduceIndex(newDaeVar, equationInfo);
+    elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<CGD> indep(reducedFun->Domain());
+    for (size_t j = 0; j < indep.size(); j++) {
+        indep[j] = 0.5 + 0.01 * j;
+    }
+
+    std::vector<CGD> dep = reducedFun->Forward(0, indep);
+
+    std::vector<double> values(dep.size());
+    for (size_t i = 0; i < dep.size(); i++) {
+        values[i] = dep[i].getValue();
+    }
+    return values;
+}
+
+int main(int argc, char **argv) {
+    size_t nPend = parseProgramArgument(1, argc, argv, 50);
+    size_t maxThreads = parseProgramArgument(2, argc, argv, std::max<size_t>(1, std::thread::hardware_concurrency()));
+
+    std::vector<DaeVarInfo> daeVar;
+    std::vector<double> x;
+    std::unique_ptr<ADFun<CGD>> fun(PendulumChain<CGD>(nPend, daeVar, x));
+
+    std::cout << "Pantelides (" << fun->Range() << " equations):" << std::endl;
+
+    std::vector<double> yRef;
+    for (size_t nThreads = 1; nThreads <= maxThreads; nThreads *= 2) {
+        double elapsed;
+        std::vector<double> y = reduceIndex(*fun, daeVar, x, nThreads, elapsed);
+        if (nThreads == 1)
+            yRef = y;
+
+        std::cout << "   threads: " << nThreads
+                << "  time (s): " << elapsed
+                << "  same results: " << (y == yRef ? "yes" : "no") << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,251 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+/**
+ * Compares the time required by the recursive and the iterative modes of
+ * the Evaluator for the plug flow model and for a long recurrence.
+ * The time required by the EvaluatorParallel (for double) is also
+ * determined for an increasing number of threads, as well as the time
+ * required to evaluate several points using lanes (LaneArray).
+ *
+ * usage: speed_evaluator [number of elements] [recurrence length] [number of executions] [number of points]
+ */
+#include <cppad/cg/cppadcg.hpp>
+#include "../../../../test/cppad/cg/models/plug_flow.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+using Base = double;
+using CGD = CppAD::cg::CG<Base>;
+using ADCGD = CppAD::AD<CGD>;
+
+inline size_t parseProgramArgument(int pos, int argc, char **argv, size_t defaultValue) {
+    if (argc > pos) {
+        std::istringstream is(argv[pos]);
+        size_t value;
+        is >> value;
+        return value;
+    }
+    return defaultValue;
+}
+
+/**
+ * Evaluates an operation graph into a new CodeHandler and returns the
+ * minimum evaluation time.
+ */
+inline std::chrono::duration<double> measure(CodeHandler<Base>& handler,
+                                             const std::vector<CGD>& y,
+                                             const std::vector<Base>& xb,
+                                             bool iterative,
+                                             size_t nTimes,
+                                             std::vector<Base>& yb) {
+    using namespace std::chrono;
+
+    duration<double> minTime = duration<double>::max();
+
+    for (size_t r = 0; r < nTimes; r++) {
+        CodeHandler<Base> handlerNew;
+        std::vector<CGD> xNew(xb.size());
+        handlerNew.makeVariables(xNew);
+        for (size_t j = 0; j < xb.size(); j++)
+            xNew[j].setValue(xb[j]);
+
+        Evaluator<Base, Base, CGD> evaluator(handler);
+        evaluator.setIterative(iterative);
+
+        steady_clock::time_point start = steady_clock::now();
+
+        std::vector<CGD> yNew = evaluator.evaluate(xNew, y);
+
+        duration<double> dt = steady_clock::now() - start;
+        minTime = std::min(minTime, dt);
+
+        yb.resize(yNew.size());
+        for (size_t i = 0; i < yNew.size(); i++)
+            yb[i] = yNew[i].getValue();
+    }
+
+    return minTime;
+}
+
+inline void compare(const std::string& name,
+                    CodeHandler<Base>& handler,
+                    const std::vector<CGD>& y,
+                    const std::vector<Base>& xb,
+                    size_t nTimes) {
+    std::vector<Base> yRec, yIt;
+    auto tRec = measure(handler, y, xb, false, nTimes, yRec);
+    auto tIt = measure(handler, y, xb, true, nTimes, yIt);
+
+    std::cout << name << "  operations: " << handler.getManagedNodesCount()
+            << "  recursive (s): " << tRec.count()
+            << "  iterative (s): " << tIt.count()
+            << "  same results: " << (yRec == yIt ? "yes" : "no") << std::endl;
+}
+
+/**
+ * Determines the minimum evaluation time of the EvaluatorParallel using
+ * 1 up to the number of cores threads.
+ */
+inline void compareParallel(const std::string& name,
+                            CodeHandler<Base>& handler,
+                            const std::vector<CGD>& y,
+                            const std::vector<Base>& xb,
+                            size_t nTimes) {
+    using namespace std::chrono;
+
+    EvaluatorParallel<Base> evaluator(handler, y);
+
+    std::cout << name << "  levels: " << evaluator.getLevelCount()
+            << "  stages: " << evaluator.getStageCount() << std::endl;
+
+    std::vector<Base> yRef;
+    size_t maxThreads = std::max<size_t>(1, std::thread::hardware_concurrency());
+
+    for (size_t nThreads = 1; nThreads <= maxThreads; nThreads *= 2) {
+        evaluator.setThreadCount(nThreads);
+
+        duration<double> minTime = duration<double>::max();
+        std::vector<Base> yb;
+
+        for (size_t r = 0; r < nTimes; r++) {
+            steady_clock::time_point start = steady_clock::now();
+
+            yb = evaluator.evaluate(xb);
+
+            duration<double> dt = steady_clock::now() - start;
+            minTime = std::min(minTime, dt);
+        }
+
+        if (nThreads == 1)
+            yRef = yb;
+
+        std::cout << "  threads: " << nThreads
+                << "  parallel (s): " << minTime.count()
+                << "  same results: " << (yRef == yb ? "yes" : "no") << std::endl;
+    }
+}
+
+/**
+ * Determines the minimum time required to evaluate several points with
+ * W lanes per traversal of the operation graph.
+ */
+template<size_t W>
+inline std::chrono::duration<double> measureLanes(CodeHandler<Base>& handler,
+                                                  const std::vector<CGD>& y,
+                                                  const std::vector<Base>& xPoints,
+                                                  size_t nPoints,
+                                                  size_t nTimes,
+                                                  std::vector<Base>& yPoints) {
+    using namespace std::chrono;
+
+    duration<double> minTime = duration<double>::max();
+
+    Evaluator<Base, Base, LaneArray<Base, W> > evaluator(handler);
+
+    for (size_t r = 0; r < nTimes; r++) {
+        steady_clock::time_point start = steady_clock::now();
+
+        yPoints = evaluator.evaluatePoints(nPoints, xPoints, y);
+
+        duration<double> dt = steady_clock::now() - start;
+        minTime = std::min(minTime, dt);
+    }
+
+    return minTime;
+}
+
+inline void compareLanes(const std::string& name,
+                         CodeHandler<Base>& handler,
+                         const std::vector<CGD>& y,
+                         const std::vector<Base>& xb,
+                         size_t nPoints,
+                         size_t nTimes) {
+    std::vector<Base> xPoints(nPoints * xb.size());
+    for (size_t p = 0; p < nPoints; p++) {
+        for (size_t j = 0; j < xb.size(); j++)
+            xPoints[p * xb.size() + j] = xb[j] * (1.0 + 0.001 * p);
+    }
+
+    std::vector<Base> y1, y4, y8;
+    auto t1 = measureLanes<1>(handler, y, xPoints, nPoints, nTimes, y1);
+    auto t4 = measureLanes<4>(handler, y, xPoints, nPoints, nTimes, y4);
+    auto t8 = measureLanes<8>(handler, y, xPoints, nPoints, nTimes, y8);
+
+    std::cout << name << "  points: " << nPoints
+            << "  1 lane (s): " << t1.count()
+            << "  4 lanes (s): " << t4.count()
+            << "  8 lanes (s): " << t8.count()
+            << "  same results: " << (y1 == y4 && y1 == y8 ? "yes" : "no") << std::endl;
+}
+
+int main(int argc, char **argv) {
+    size_t nEls = parseProgramArgument(1, argc, argv, 100);
+    size_t length = parseProgramArgument(2, argc, argv, 20000);
+    size_t nTimes = parseProgramArgument(3, argc, argv, 10);
+    size_t nPoints = parseProgramArgument(4, argc, argv, 64);
+
+    /**
+     * plug flow model
+     */
+    {
+        std::vector<Base> xb = PlugFlowModel<Base>::getTypicalValues(nEls);
+
+        std::vector<ADCGD> x(xb.size());
+        for (size_t j = 0; j < xb.size(); j++)
+            x[j] = xb[j];
+        CppAD::Independent(x);
+
+        PlugFlowModel<CGD> model;
+        std::vector<ADCGD> y = model.model2(x, nEls);
+
+        ADFun<CGD> fun;
+        fun.Dependent(y);
+
+        CodeHandler<Base> handler;
+        std::vector<CGD> xx(fun.Domain());
+        handler.makeVariables(xx);
+        for (size_t j = 0; j < xx.size(); j++)
+            xx[j].setValue(xb[j]);
+        std::vector<CGD> yy = fun.Forward(0, xx);
+
+        compare("plug flow", handler, yy, xb, nTimes);
+        compareParallel("plug flow", handler, yy, xb, nTimes);
+        compareLanes("plug flow", handler, yy, xb, nPoints, nTimes);
+    }
+
+    /**
+     * long recurrence (deep operation graph)
+     */
+    {
+        std::vector<Base> xb{0.5, 0.25};
+
+        CodeHandler<Base> handler;
+        std::vector<CGD> xx(xb.size());
+        handler.makeVariables(xx);
+
+        CGD a = xx[0];
+        for (size_t k = 0; k < length; k++) {
+            a = a * 0.5 + xx[1];
+        }
+        std::vector<CGD> yy{a};
+
+        compare("recurrence", handler, yy, xb, nTimes);
+        compareParallel("recurrence", handler, yy, xb, nTimes);
+    }
+
+    return 0;
+}
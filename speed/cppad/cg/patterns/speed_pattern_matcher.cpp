@@ -0,0 +1,155 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+/**
+ * Measures the time and the peak memory required by the loop detection
+ * (DependentPatternMatcher) for the plug flow model and compares it with
+ * the previous implementation (baseline::DependentPatternMatcher).
+ *
+ * usage: speed_pattern_matcher [number of elements] [number of executions] [current|baseline|both]
+ *
+ * The peak memory can only be compared when a single implementation is
+ * executed by each process.
+ */
+#include <cppad/cg/cppadcg.hpp>
+#include <sys/resource.h>
+#include "../../../../test/cppad/cg/models/plug_flow.hpp"
+#include "dependent_pattern_matcher_baseline.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+using Base = double;
+using CGD = CppAD::cg::CG<Base>;
+using ADCGD = CppAD::AD<CGD>;
+
+/**
+ * The peak resident memory of this process in kB
+ */
+inline long peakMemory() {
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+inline size_t parseProgramArgument(int pos, int argc, char **argv, size_t defaultValue) {
+    if (argc > pos) {
+        std::istringstream is(argv[pos]);
+        size_t value;
+        is >> value;
+        return value;
+    }
+    return defaultValue;
+}
+
+/**
+ * Runs the loop detection several times.
+ *
+ * @return the minimum time
+ */
+template<class Matcher>
+std::chrono::duration<double> measure(const std::string& name,
+                                      ADFun<CGD>& fun,
+                                      const std::vector<Base>& xb,
+                                      const std::vector<std::set<size_t> >& relations,
+                                      size_t nTimes) {
+    using namespace std::chrono;
+
+    long memBefore = peakMemory();
+
+    std::cout << "\n" << name << "\n"
+            "run  time (s)  loops  peak memory (kB)" << std::endl;
+
+    duration<double> minTime = duration<double>::max();
+    duration<double> totalTime(0);
+
+    for (size_t r = 0; r < nTimes; r++) {
+        CodeHandler<Base> handler;
+
+        std::vector<CGD> xx(fun.Domain());
+        handler.makeVariables(xx);
+        for (size_t j = 0; j < xx.size(); j++) {
+            xx[j].setValue(xb[j]);
+        }
+
+        std::vector<CGD> yy = fun.Forward(0, xx);
+
+        LoopFreeModel<Base>* nonLoopTape = nullptr;
+        SmartSetPointer<LoopModel<Base> > loopTapes;
+
+        steady_clock::time_point start = steady_clock::now();
+
+        Matcher matcher(relations, yy, xx);
+        matcher.generateTapes(nonLoopTape, loopTapes.s);
+
+        duration<double> dt = steady_clock::now() - start;
+        minTime = std::min(minTime, dt);
+        totalTime += dt;
+
+        std::cout << r << "  " << dt.count() << "  " << loopTapes.size() << "  " << peakMemory() << std::endl;
+
+        delete nonLoopTape;
+    }
+
+    std::cout << "min time (s): " << minTime.count() << "\n"
+            "average time (s): " << totalTime.count() / nTimes << "\n"
+            "peak memory increase (kB): " << (peakMemory() - memBefore) << std::endl;
+
+    return minTime;
+}
+
+int main(int argc, char **argv) {
+    size_t nEls = parseProgramArgument(1, argc, argv, 100);
+    size_t nTimes = parseProgramArgument(2, argc, argv, 10);
+    std::string version = argc > 3 ? argv[3] : "both";
+
+    if (version != "current" && version != "baseline" && version != "both") {
+        std::cerr << "invalid version '" << version << "' (expected current, baseline or both)" << std::endl;
+        return 1;
+    }
+
+    std::vector<Base> xb = PlugFlowModel<Base>::getTypicalValues(nEls);
+    std::vector<std::set<size_t> > relations = PlugFlowModel<Base>::getRelatedCandidates(nEls);
+
+    /**
+     * tape the model
+     */
+    std::vector<ADCGD> x(xb.size());
+    for (size_t j = 0; j < xb.size(); j++)
+        x[j] = xb[j];
+    CppAD::Independent(x);
+
+    PlugFlowModel<CGD> model;
+    std::vector<ADCGD> y = model.model2(x, nEls);
+
+    ADFun<CGD> fun;
+    fun.Dependent(y);
+
+    std::cout << "elements: " << nEls << "  equations: " << fun.Range() << "  variables: " << fun.Domain() << std::endl;
+
+    std::chrono::duration<double> tCurrent(0), tBaseline(0);
+
+    if (version != "baseline")
+        tCurrent = measure<DependentPatternMatcher<Base> >("current", fun, xb, relations, nTimes);
+
+    if (version != "current")
+        tBaseline = measure<baseline::DependentPatternMatcher<Base> >("baseline", fun, xb, relations, nTimes);
+
+    if (version == "both") {
+        std::cout << "\nspeedup (min baseline time / min current time): " << tBaseline.count() / tCurrent.count() << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,124 @@
+#ifndef CPPAD_CG_TEST_CHECKPOINTARRAYFUNCTION_INCLUDED
+#define CPPAD_CG_TEST_CHECKPOINTARRAYFUNCTION_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+#include "CppADCGTest.hpp"
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * A checkpoint atomic function which also receives the arrays of compiled
+ * models directly.
+ * The array methods are implemented using the Taylor coefficients of the
+ * checkpoint so that the results can be compared with CppAD.
+ *
+ * @tparam ArrayFunction the array interface (AtomicArrayFunction or one
+ *                       of its subclasses)
+ */
+template<class ArrayFunction = AtomicArrayFunction<double> >
+class CheckpointArrayFunction : public checkpoint<double>, public ArrayFunction {
+public:
+    using ADVector = std::vector<AD<double> >;
+public:
+    size_t n;
+    size_t m;
+    size_t denseCalls;
+
+    CheckpointArrayFunction(const char* name,
+                            void (*algo)(const ADVector& ax, ADVector& ay),
+                            const ADVector& ax,
+                            ADVector& ay) :
+        checkpoint<double>(name, algo, ax, ay),
+        n(ax.size()),
+        m(ay.size()),
+        denseCalls(0) {
+    }
+
+    bool forwardZero(ArrayView<const double> x,
+                     ArrayView<double> y) override {
+        denseCalls++;
+        CppAD::vector<bool> vx, vy;
+        CppAD::vector<double> tx(n), ty(m);
+        std::copy(x.begin(), x.end(), tx.data());
+        if (!this->forward(0, 0, vx, vy, tx, ty))
+            return false;
+        std::copy(ty.data(), ty.data() + m, y.data());
+        return true;
+    }
+
+    bool forwardOne(ArrayView<const double> x,
+                    ArrayView<const double> tx1,
+                    ArrayView<double> ty1) override {
+        denseCalls++;
+        CppAD::vector<bool> vx, vy;
+        CppAD::vector<double> tx = taylor(x, tx1), ty(2 * m);
+        if (!this->forward(0, 1, vx, vy, tx, ty))
+            return false;
+        for (size_t i = 0; i < m; i++)
+            ty1[i] = ty[i * 2 + 1];
+        return true;
+    }
+
+    bool reverseOne(ArrayView<const double> x,
+                    ArrayView<double> px,
+                    ArrayView<const double> py) override {
+        denseCalls++;
+        CppAD::vector<bool> vx, vy;
+        CppAD::vector<double> tx(n), ty(m), pxb(n), pyb(m);
+        std::copy(x.begin(), x.end(), tx.data());
+        std::copy(py.begin(), py.end(), pyb.data());
+        if (!this->forward(0, 0, vx, vy, tx, ty) || !this->reverse(0, tx, ty, pxb, pyb))
+            return false;
+        std::copy(pxb.data(), pxb.data() + n, px.data());
+        return true;
+    }
+
+    bool reverseTwo(ArrayView<const double> x,
+                    ArrayView<const double> tx1,
+                    ArrayView<double> px2,
+                    ArrayView<const double> py2) override {
+        denseCalls++;
+        CppAD::vector<bool> vx, vy;
+        CppAD::vector<double> tx = taylor(x, tx1), ty(2 * m), px(2 * n), py(2 * m);
+        for (size_t i = 0; i < m; i++) {
+            py[i * 2] = 0;
+            py[i * 2 + 1] = py2[i];
+        }
+        if (!this->forward(0, 1, vx, vy, tx, ty) || !this->reverse(1, tx, ty, px, py))
+            return false;
+        for (size_t j = 0; j < n; j++)
+            px2[j] = px[j * 2];
+        return true;
+    }
+
+private:
+
+    CppAD::vector<double> taylor(ArrayView<const double> x,
+                                 ArrayView<const double> tx1) const {
+        CppAD::vector<double> tx(2 * n);
+        for (size_t j = 0; j < n; j++) {
+            tx[j * 2] = x[j];
+            tx[j * 2 + 1] = tx1[j];
+        }
+        return tx;
+    }
+};
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
@@ -37,6 +37,7 @@ protected:
     bool forwardOne = true;
     bool reverseOne = true;
     bool reverseTwo = true;
+    bool directModelCalls = false;
 public:
 
     inline CppADCGDynamicAtomicNestedTest(const std::string& modelName,
@@ -175,7 +176,8 @@ private:
         const size_t n = _fun2->Domain();
         const size_t m = _fun2->Range();
 
-        modelLibOuter->addExternalModel(*modelLib);
+        // models called directly by the compiled code are not required
+        ASSERT_EQ(modelLibOuter->addExternalModel(*modelLib), !directModelCalls);
 
 
         /**
@@ -630,7 +632,8 @@ private:
          * generate source code
          */
         ModelLibraryCSourceGen<double> compDynHelp(compHelp1, compHelp2);
-        std::string folder = std::string("nested_sources_atomiclibmodelbridge_") + (createOuterReverse2 ? "rev2_" : "dir_") + _modelName;
+        compDynHelp.setDirectModelCalls(directModelCalls);
+        std::string folder = std::string("nested_sources_atomiclibmodelbridge_") + (createOuterReverse2 ? "rev2_" : "dir_") + (directModelCalls ? "calls_" : "") + _modelName;
         SaveFilesModelLibraryProcessor<double>::saveLibrarySourcesTo(compDynHelp, folder);
 
         /**
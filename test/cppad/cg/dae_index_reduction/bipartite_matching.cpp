@@ -0,0 +1,116 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include <cppad/cg/dae_index_reduction/pantelides.hpp>
+#include <cppad/cg/dae_index_reduction/soares_secchi.hpp>
+
+#include "CppADCGIndexReductionTest.hpp"
+#include "model/pendulum_chain.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+using namespace std;
+
+using CGD = CG<double>;
+
+namespace {
+
+/**
+ * Provides access to the detection of the equations to differentiate
+ */
+template<class Method>
+class MatchingSubset2Dif : public Method {
+public:
+    using Method::Method;
+    using Method::detectSubset2Dif;
+};
+
+/**
+ * Determines how many times each original equation must be differentiated.
+ */
+template<class Method>
+std::vector<size_t> differentiations(ADFun<CGD>& fun,
+                                     const std::vector<DaeVarInfo>& daeVar,
+                                     const std::vector<double>& x,
+                                     BipartiteMatching matching) {
+    std::vector<std::string> eqName; // empty
+
+    MatchingSubset2Dif<Method> method(fun, daeVar, eqName, x);
+    method.setMatching(matching);
+
+    method.detectSubset2Dif();
+
+    const auto& enodes = method.getGraph().equations();
+    std::vector<size_t> order(fun.Range(), 0);
+    for (size_t i = 0; i < order.size(); i++) {
+        for (const Enode<double>* e = enodes[i]->derivative(); e != nullptr; e = e->derivative()) {
+            order[i]++;
+        }
+    }
+
+    return order;
+}
+
+} // END namespace
+
+/**
+ * @test the Hopcroft-Karp matching determines the same equations to
+ *       differentiate as the augment path algorithm
+ *       (see speed/cppad/cg/dae_index_reduction for the time spent by each one)
+ */
+TEST_F(IndexReductionTest, BipartiteMatchingPendulumChain) {
+    const size_t nPend = 10;
+
+    std::vector<DaeVarInfo> daeVar;
+    std::vector<double> x;
+    std::unique_ptr<ADFun<CGD>> fun(PendulumChain<CGD>(nPend, daeVar, x));
+
+    // Pantelides
+    std::vector<size_t> orderAugment = differentiations<Pantelides<double>>(*fun, daeVar, x, BipartiteMatching::AugmentPath);
+    std::vector<size_t> orderHK = differentiations<Pantelides<double>>(*fun, daeVar, x, BipartiteMatching::HopcroftKarp);
+
+    ASSERT_EQ(orderAugment, orderHK);
+    for (size_t p = 0; p < nPend; p++) {
+        ASSERT_EQ(size_t(2), orderHK[5 * p + 4]); // the constraint of each pendulum
+    }
+
+    // Soares Secchi
+    orderAugment = differentiations<SoaresSecchi<double>>(*fun, daeVar, x, BipartiteMatching::AugmentPath);
+    orderHK = differentiations<SoaresSecchi<double>>(*fun, daeVar, x, BipartiteMatching::HopcroftKarp);
+
+    ASSERT_EQ(orderAugment, orderHK);
+}
+
+/**
+ * @test the complete index reduction with the Hopcroft-Karp matching
+ */
+TEST_F(IndexReductionTest, PantelidesHopcroftKarpPendulum) {
+    std::vector<DaeVarInfo> daeVar;
+    std::vector<double> x;
+    std::unique_ptr<ADFun<CGD>> fun(PendulumChain<CGD>(3, daeVar, x));
+
+    std::vector<std::string> eqName; // empty
+
+    Pantelides<double> pantelides(*fun, daeVar, eqName, x);
+    pantelides.setMatching(BipartiteMatching::HopcroftKarp);
+
+    std::vector<DaeVarInfo> newDaeVar;
+    std::vector<DaeEquationInfo> equationInfo;
+    std::unique_ptr<ADFun<CGD>> reducedFun;
+    ASSERT_NO_THROW(reducedFun = pantelides.reduceIndex(newDaeVar, equationInfo));
+
+    ASSERT_TRUE(reducedFun != nullptr);
+
+    ASSERT_EQ(size_t(3), pantelides.getStructuralIndex());
+}
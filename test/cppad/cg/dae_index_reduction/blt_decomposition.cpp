@@ -0,0 +1,113 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include <cppad/cg/dae_index_reduction/blt_decomposition.hpp>
+
+#include "CppADCGIndexReductionTest.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+using namespace std;
+
+/**
+ * @test the BLT decomposition of an index 1 DAE with an explicit algebraic
+ *       equation, an algebraic loop, and a differential equation
+ */
+TEST_F(IndexReductionTest, BltDecomposition) {
+    using CGD = CG<double>;
+    using ADCG = AD<CGD>;
+
+    std::vector<ADCG> u(6);
+    Independent(u);
+
+    ADCG x = u[0];
+    ADCG a = u[1];
+    ADCG b = u[2];
+    ADCG c = u[3];
+    ADCG dxdt = u[5];
+
+    std::vector<ADCG> res(4);
+    res[0] = dxdt - (a + x);
+    res[1] = a - 2 * x;
+    res[2] = b * b + c - x;
+    res[3] = c - sin(b) - a;
+
+    ADFun<CGD> fun(u, res);
+
+    std::vector<DaeVarInfo> daeVar(6);
+    daeVar[0] = DaeVarInfo("x");
+    daeVar[1] = DaeVarInfo("a");
+    daeVar[2] = DaeVarInfo("b");
+    daeVar[3] = DaeVarInfo("c");
+    daeVar[4].makeIntegratedVariable();
+    daeVar[5] = 0;
+
+    std::vector<DaeEquationInfo> eqInfo{DaeEquationInfo(0, 0, -1, 5),
+                                        DaeEquationInfo(1, 1, -1, 1),
+                                        DaeEquationInfo(2, 2, -1, 3),
+                                        DaeEquationInfo(3, 3, -1, 2)};
+
+    std::vector<double> xTypical(6, 1.0);
+
+    BltDecomposition<double> blt(fun, daeVar, eqInfo, xTypical);
+    const std::vector<DaeBlock>& blocks = blt.decompose();
+
+    ASSERT_EQ(blocks.size(), 3u);
+
+    ASSERT_EQ(blocks[0].getEquations(), std::vector<size_t>{1});
+    ASSERT_EQ(blocks[0].getVariables(), std::vector<size_t>{1});
+    ASSERT_TRUE(blocks[0].isExplicit());
+
+    ASSERT_EQ(blocks[1].getEquations(), std::vector<size_t>{0});
+    ASSERT_EQ(blocks[1].getVariables(), std::vector<size_t>{5});
+    ASSERT_TRUE(blocks[1].isExplicit());
+
+    ASSERT_EQ(blocks[2].getEquations(), (std::vector<size_t>{2, 3}));
+    ASSERT_EQ(blocks[2].getVariables(), (std::vector<size_t>{3, 2}));
+    ASSERT_FALSE(blocks[2].isExplicit());
+
+    /**
+     * block models
+     */
+    std::vector<std::unique_ptr<ADFun<CGD>>> models = blt.generateBlockModels();
+    ASSERT_EQ(models.size(), blocks.size());
+
+    std::vector<CGD> v{0.5, 1.0, 0.3, 0.2, 0.0, 7.0};
+
+    std::vector<CGD> y = models[0]->Forward(0, v);
+    ASSERT_EQ(y.size(), 1u);
+    ASSERT_TRUE(nearEqual(y[0].getValue(), 2 * 0.5)); // a
+
+    y = models[1]->Forward(0, v);
+    ASSERT_EQ(y.size(), 1u);
+    ASSERT_TRUE(nearEqual(y[0].getValue(), 1.0 + 0.5)); // dxdt
+
+    y = models[2]->Forward(0, v);
+    ASSERT_EQ(y.size(), 2u);
+    ASSERT_TRUE(nearEqual(y[0].getValue(), 0.3 * 0.3 + 0.2 - 0.5));
+    ASSERT_TRUE(nearEqual(y[1].getValue(), 0.2 - std::sin(0.3) - 1.0));
+
+    /**
+     * the Jacobian is only generated for algebraic loops
+     */
+    ModelCSourceGen<double> sourceGen0(*models[0], "block0");
+    blt.configureSourceGen(0, sourceGen0);
+    ASSERT_TRUE(sourceGen0.isCreateForwardZero());
+    ASSERT_FALSE(sourceGen0.isCreateSparseJacobian());
+
+    ModelCSourceGen<double> sourceGen2(*models[2], "block2");
+    blt.configureSourceGen(2, sourceGen2);
+    ASSERT_TRUE(sourceGen2.isCreateForwardZero());
+    ASSERT_TRUE(sourceGen2.isCreateSparseJacobian());
+}
@@ -0,0 +1,82 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include <cppad/cg/dae_index_reduction/dummy_deriv.hpp>
+
+#include "CppADCGIndexReductionTest.hpp"
+#include "model/pendulum_chain.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+using CGD = CG<double>;
+
+namespace {
+
+/**
+ * Performs the index reduction and provides the number of differential
+ * variables in the reduced model.
+ */
+size_t reduceIndex(ADFun<CGD>& fun,
+                   const std::vector<DaeVarInfo>& daeVar,
+                   const std::vector<double>& x,
+                   bool sparse) {
+    std::vector<double> normVar(daeVar.size(), 1.0);
+    std::vector<double> normEq(fun.Range(), 1.0);
+    std::vector<std::string> eqName; // empty
+
+    Pantelides<double> pantelides(fun, daeVar, eqName, x);
+    DummyDerivatives<double> dummyD(pantelides, x, normVar, normEq);
+    dummyD.setReduceEquations(false);
+    dummyD.setSparseSelection(sparse);
+
+    std::vector<DaeVarInfo> newDaeVar;
+    std::vector<DaeEquationInfo> newEqInfo;
+    std::unique_ptr<ADFun<CGD>> reducedFun = dummyD.reduceIndex(newDaeVar, newEqInfo);
+
+    EXPECT_TRUE(reducedFun != nullptr);
+    EXPECT_EQ(size_t(3), pantelides.getStructuralIndex());
+    EXPECT_EQ(newEqInfo.size(), reducedFun->Range());
+
+    size_t differential = 0;
+    for (const DaeVarInfo& v : newDaeVar) {
+        if (v.getAntiDerivative() >= 0)
+            differential++;
+    }
+    return differential;
+}
+
+} // END namespace
+
+/**
+ * @test the selection of dummy derivatives with a sparse QR factorization
+ *       in a larger system
+ *       (see speed/cppad/cg/dae_index_reduction for the time spent compared
+ *       to the dense factorization)
+ */
+TEST_F(IndexReductionTest, DummyDerivSparsePendulumChain) {
+    const size_t nPend = 10;
+
+    std::vector<DaeVarInfo> daeVar;
+    std::vector<double> x;
+    std::unique_ptr<ADFun<CGD>> fun(PendulumChain<CGD>(nPend, daeVar, x));
+
+    size_t diffDense, diffSparse;
+    ASSERT_NO_THROW(diffDense = reduceIndex(*fun, daeVar, x, false));
+    ASSERT_NO_THROW(diffSparse = reduceIndex(*fun, daeVar, x, true));
+
+    // the same number of dummy derivatives
+    ASSERT_GT(diffDense, 0u);
+    ASSERT_EQ(diffDense, diffSparse);
+}
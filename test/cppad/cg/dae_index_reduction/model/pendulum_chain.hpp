@@ -0,0 +1,87 @@
+#ifndef CPPAD_CG_TEST_PENDULUM_CHAIN_INCLUDED
+#define CPPAD_CG_TEST_PENDULUM_CHAIN_INCLUDED
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+namespace CppAD {
+namespace cg {
+
+/**
+ * A chain of 2D pendulums connected by springs (index 3) which can be used
+ * to create large systems.
+ *
+ * @param nPend the number of pendulums
+ * @param daeVar the variable information
+ * @param x typical variable values
+ */
+template<class Base>
+inline CppAD::ADFun<Base>* PendulumChain(size_t nPend,
+                                         std::vector<DaeVarInfo>& daeVar,
+                                         std::vector<double>& x) {
+    using ADB = CppAD::AD<Base>;
+
+    const size_t nStates = 5 * nPend;
+    const size_t lIndex = nStates;
+    const size_t tIndex = nStates + 1;
+    const size_t dStart = nStates + 2;
+
+    std::vector<ADB> u(dStart + 4 * nPend);
+    Independent(u);
+
+    daeVar.resize(u.size());
+    x.resize(u.size());
+
+    daeVar[lIndex].makeConstant();
+    daeVar[tIndex].makeIntegratedVariable();
+    x[lIndex] = 1.0;
+    x[tIndex] = 0.0;
+
+    double g = 9.80665; // gravity constant
+    double k = 0.1; // spring constant
+
+    std::vector<ADB> z(5 * nPend);
+    for (size_t p = 0; p < nPend; p++) {
+        size_t s = 5 * p;
+        size_t d = dStart + 4 * p;
+        for (size_t j = 0; j < 4; j++) {
+            daeVar[d + j] = int(s + j);
+        }
+
+        x[s] = -1.0; // x
+        x[s + 1] = 0.0; // y
+        x[s + 2] = 0.0; // vx
+        x[s + 3] = 0.0; // vy
+        x[s + 4] = 1.0; // tension
+        x[d] = 0.0; // dxdt
+        x[d + 1] = 0.0; // dydt
+        x[d + 2] = -1.0; // dvxdt
+        x[d + 3] = g; // dvydt
+
+        ADB spring = (p > 0) ? k * (u[s - 5] - u[s]) : ADB(0.0);
+
+        z[s] = u[d] - u[s + 2];
+        z[s + 1] = u[d + 1] - u[s + 3];
+        z[s + 2] = u[d + 2] - u[s + 4] * u[s] - spring;
+        z[s + 3] = u[d + 3] - (u[s + 4] * u[s + 1] - g);
+        z[s + 4] = u[s] * u[s] + u[s + 1] * u[s + 1] - u[lIndex] * u[lIndex];
+    }
+
+    return new ADFun<Base>(u, z);
+}
+
+} // END cg namespace
+} // END CppAD namespace
+
+#endif
@@ -0,0 +1,120 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include <cppad/cg/dae_index_reduction/pantelides.hpp>
+
+#include "CppADCGIndexReductionTest.hpp"
+#include "model/pendulum_chain.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+using CGD = CG<double>;
+
+namespace {
+
+/**
+ * Performs the index reduction and evaluates the reduced model.
+ *
+ * @param operations the number of variables in the operation sequence of
+ *                   the reduced model
+ */
+std::vector<double> reduceIndex(ADFun<CGD>& fun,
+                                const std::vector<DaeVarInfo>& daeVar,
+                                const std::vector<double>& x,
+                                size_t nThreads,
+                                size_t& operations) {
+    std::vector<std::string> eqName; // empty
+
+    Pantelides<double> pantelides(fun, daeVar, eqName, x);
+    pantelides.setTimeDiffThreadCount(nThreads);
+
+    std::vector<DaeVarInfo> newDaeVar;
+    std::vector<DaeEquationInfo> equationInfo;
+
+    std::unique_ptr<ADFun<CGD>> reducedFun = pantelides.reduceIndex(newDaeVar, equationInfo);
+
+    EXPECT_TRUE(reducedFun != nullptr);
+    EXPECT_EQ(size_t(3), pantelides.getStructuralIndex());
+    if (reducedFun == nullptr)
+        return std::vector<double>();
+
+    operations = reducedFun->size_var();
+
+    std::vector<CGD> indep(reducedFun->Domain());
+    for (size_t j = 0; j < indep.size(); j++) {
+        indep[j] = 0.5 + 0.01 * j;
+    }
+
+    std::vector<CGD> dep = reducedFun->Forward(0, indep);
+
+    std::vector<double> values(dep.size());
+    for (size_t i = 0; i < dep.size(); i++) {
+        values[i] = dep[i].getValue();
+    }
+    return values;
+}
+
+} // END namespace
+
+/**
+ * @test the differentiation of equations with respect to time using several
+ *       threads creates the same reduced model as a single thread, without
+ *       repeating the operations shared by the equations
+ *       (see speed/cppad/cg/dae_index_reduction for the time spent)
+ */
+TEST_F(IndexReductionTest, PantelidesParallelTimeDiff) {
+    const size_t nPend = 10;
+
+    std::vector<DaeVarInfo> daeVar;
+    std::vector<double> x;
+    std::unique_ptr<ADFun<CGD>> fun(PendulumChain<CGD>(nPend, daeVar, x));
+
+    size_t opSerial, opParallel;
+    std::vector<double> ySerial = reduceIndex(*fun, daeVar, x, 1, opSerial);
+    std::vector<double> yParallel = reduceIndex(*fun, daeVar, x, 4, opParallel);
+
+    ASSERT_EQ(opSerial, opParallel);
+    ASSERT_EQ(ySerial.size(), yParallel.size());
+    for (size_t i = 0; i < ySerial.size(); i++) {
+        ASSERT_TRUE(nearEqual(ySerial[i], yParallel[i]));
+    }
+
+    ASSERT_EQ(thread_alloc::num_threads(), 1u);
+}
+
+/**
+ * @test more threads than the equations differentiated in each step
+ *       (some threads might not differentiate any equation)
+ */
+TEST_F(IndexReductionTest, PantelidesParallelTimeDiffIdleThreads) {
+    std::vector<DaeVarInfo> daeVar;
+    std::vector<double> x;
+    std::unique_ptr<ADFun<CGD>> fun(PendulumChain<CGD>(1, daeVar, x));
+
+    size_t opSerial, opParallel;
+    std::vector<double> ySerial = reduceIndex(*fun, daeVar, x, 1, opSerial);
+
+    for (size_t r = 0; r < 10; r++) {
+        std::vector<double> yParallel = reduceIndex(*fun, daeVar, x, 16, opParallel);
+
+        ASSERT_EQ(opSerial, opParallel);
+        ASSERT_EQ(ySerial.size(), yParallel.size());
+        for (size_t i = 0; i < ySerial.size(); i++) {
+            ASSERT_TRUE(nearEqual(ySerial[i], yParallel[i]));
+        }
+    }
+
+    ASSERT_EQ(thread_alloc::num_threads(), 1u);
+}
@@ -49,8 +49,9 @@ protected:
         /**
          * Test with scalars only
          */
-        {
+        for (bool iterative : {false, true}) {
             Evaluator<Base, Base, CGD> evaluator(handlerOrig);
+            evaluator.setIterative(iterative);
 
             std::vector<CGD> xNew(xOrig.size());
             for (size_t j = 0; j < xOrig.size(); j++)
@@ -74,7 +75,7 @@ protected:
         /**
          * Test with active variables from CppAD
          */
-        {
+        for (bool iterative : {false, true}) {
             std::vector<AD<Base> > xNew(xOrig.size());
             for (size_t j = 0; j < xOrig.size(); j++)
                 xNew[j] = testValues[j];
@@ -83,6 +84,7 @@ protected:
 
             //
             Evaluator<Base, Base, AD<Base> > evaluator(handlerOrig);
+            evaluator.setIterative(iterative);
             std::vector<AD<Base> > yNew = evaluator.evaluate(xNew, yOrig);
 
             ASSERT_EQ(yNew.size(), yOrig.size());
@@ -106,7 +108,7 @@ protected:
         /**
          * Test with active variables from CppAD<CG>
          */
-        {
+        for (bool iterative : {false, true}) {
             std::vector<ADCGD> xNew(xOrig.size());
             for (size_t j = 0; j < xOrig.size(); j++)
                 xNew[j] = testValues[j];
@@ -115,6 +117,7 @@ protected:
 
             //
             Evaluator<Base, CGD, ADCGD> evaluator(handlerOrig);
+            evaluator.setIterative(iterative);
             std::vector<ADCGD> yNew = evaluator.evaluate(xNew, yOrig);
 
             ASSERT_EQ(yNew.size(), yOrig.size());
@@ -169,20 +172,23 @@ protected:
         assert(yOrig[0].getOperationNode()->getCodeHandler() != nullptr);
         CodeHandler<double>& handlerOrig = *yOrig[0].getOperationNode()->getCodeHandler();
 
-        CodeHandler<double> handlerNew;
+        for (bool iterative : {false, true}) {
+            CodeHandler<double> handlerNew;
 
-        std::vector<CGD> xNew(testValues.size());
-        handlerNew.makeVariables(xNew);
-        for (size_t j = 0; j < testValues.size(); j++)
-            xNew[j].setValue(testValues[j]);
+            std::vector<CGD> xNew(testValues.size());
+            handlerNew.makeVariables(xNew);
+            for (size_t j = 0; j < testValues.size(); j++)
+                xNew[j].setValue(testValues[j]);
 
-        Evaluator<Base, Base, CGD> evaluator(handlerOrig);
-        std::vector<CGD> yNew = evaluator.evaluate(xNew, yOrig);
+            Evaluator<Base, Base, CGD> evaluator(handlerOrig);
+            evaluator.setIterative(iterative);
+            std::vector<CGD> yNew = evaluator.evaluate(xNew, yOrig);
 
-        ASSERT_EQ(yNew.size(), yOrig.size());
-        for (size_t i = 0; i < yOrig.size(); i++) {
-            ASSERT_EQ(yNew[i].isVariable(), yOrig[i].isVariable());
-            ASSERT_EQ(yNew[i].getValue(), yOrig[i].getValue());
+            ASSERT_EQ(yNew.size(), yOrig.size());
+            for (size_t i = 0; i < yOrig.size(); i++) {
+                ASSERT_EQ(yNew[i].isVariable(), yOrig[i].isVariable());
+                ASSERT_EQ(yNew[i].getValue(), yOrig[i].getValue());
+            }
         }
 
     }
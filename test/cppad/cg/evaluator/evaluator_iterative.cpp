@@ -0,0 +1,97 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include "CppADCGEvaluatorTest.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+namespace {
+
+std::string generateSource(CodeHandler<double>& handler,
+                           std::vector<CGD>& y) {
+    LanguageC<double> langC("double");
+    LangCDefaultVariableNameGenerator<double> nameGen;
+
+    std::ostringstream code;
+    handler.generateCode(code, langC, y, nameGen);
+    return code.str();
+}
+
+}
+
+/**
+ * @test a long recurrence which would require a very deep recursion
+ */
+TEST_F(CppADCGEvaluatorTest, IterativeDeepGraph) {
+    const size_t depth = 200000;
+
+    CodeHandler<double> handlerOrig;
+    std::vector<CGD> xOrig(2);
+    handlerOrig.makeVariables(xOrig);
+    xOrig[0].setValue(0.5);
+    xOrig[1].setValue(0.25);
+
+    CGD a = xOrig[0];
+    double expected = 0.5;
+    for (size_t k = 0; k < depth; k++) {
+        a = a * 0.5 + xOrig[1];
+        expected = expected * 0.5 + 0.25;
+    }
+    std::vector<CGD> yOrig{a};
+
+    CodeHandler<double> handlerNew;
+    std::vector<CGD> xNew(2);
+    handlerNew.makeVariables(xNew);
+    xNew[0].setValue(0.5);
+    xNew[1].setValue(0.25);
+
+    Evaluator<Base, Base, CGD> evaluator(handlerOrig);
+    evaluator.setIterative(true);
+    std::vector<CGD> yNew = evaluator.evaluate(xNew, yOrig);
+
+    ASSERT_EQ(yNew.size(), 1u);
+    ASSERT_TRUE(yNew[0].isVariable());
+    ASSERT_EQ(yNew[0].getValue(), expected);
+}
+
+/**
+ * @test the iterative and the recursive modes create the same operations
+ */
+TEST_F(CppADCGEvaluatorTest, IterativeSameOperations) {
+    CodeHandler<double> handlerOrig;
+    std::vector<CGD> xOrig(3);
+    handlerOrig.makeVariables(xOrig);
+
+    CGD a = xOrig[0] * xOrig[1];
+    std::vector<CGD> yOrig(3);
+    yOrig[0] = sin(a) + cos(xOrig[2]) * a;
+    yOrig[1] = CondExpGt(xOrig[0], xOrig[2], a / xOrig[2], exp(xOrig[1]));
+    yOrig[2] = 2.0;
+
+    std::string source[2];
+    for (bool iterative : {false, true}) {
+        CodeHandler<double> handlerNew;
+        std::vector<CGD> xNew(3);
+        handlerNew.makeVariables(xNew);
+
+        Evaluator<Base, Base, CGD> evaluator(handlerOrig);
+        evaluator.setIterative(iterative);
+        std::vector<CGD> yNew = evaluator.evaluate(xNew, yOrig);
+
+        source[iterative] = generateSource(handlerNew, yNew);
+    }
+
+    ASSERT_EQ(source[0], source[1]);
+}
@@ -0,0 +1,99 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include "CppADCGEvaluatorTest.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+namespace {
+
+std::vector<CGD> modelLanes(const std::vector<CGD>& x) {
+    std::vector<CGD> y(4);
+    CGD a = x[0] * x[1];
+    y[0] = sin(a) + cos(x[2]) * a - exp(x[1]) / x[2];
+    y[1] = CondExpGt(x[0], x[2], sqrt(a) * tanh(x[1]), pow(x[2], x[0]) + abs(x[1]));
+    y[2] = -log(x[2]) * sign(x[1] - x[0]) + atan(x[0]) * cosh(x[1]);
+    y[3] = 2.0;
+    return y;
+}
+
+}
+
+/**
+ * @test evaluation at several points using lanes
+ */
+TEST_F(CppADCGEvaluatorTest, LanesPoints) {
+    const size_t n = 3;
+    const size_t nPoints = 10; // not a multiple of the number of lanes
+
+    CodeHandler<double> handler;
+    std::vector<CGD> x(n);
+    handler.makeVariables(x);
+    std::vector<CGD> y = modelLanes(x);
+    const size_t m = y.size();
+
+    std::vector<double> xb(nPoints * n);
+    for (size_t p = 0; p < nPoints; p++) {
+        xb[p * n] = 0.5 + 0.1 * p;
+        xb[p * n + 1] = 1.5 - 0.2 * p;
+        xb[p * n + 2] = 0.2 + 0.15 * p;
+    }
+
+    Evaluator<double, double, LaneArray<double, 4> > evaluator(handler);
+    std::vector<double> yb = evaluator.evaluatePoints(nPoints, xb, y);
+
+    ASSERT_EQ(yb.size(), nPoints * m);
+
+    for (size_t p = 0; p < nPoints; p++) {
+        // reference values determined by the CG operations
+        CodeHandler<double> handlerP;
+        std::vector<CGD> xp(n);
+        handlerP.makeVariables(xp);
+        for (size_t j = 0; j < n; j++)
+            xp[j].setValue(xb[p * n + j]);
+        std::vector<CGD> yp = modelLanes(xp);
+
+        for (size_t i = 0; i < m; i++) {
+            ASSERT_DOUBLE_EQ(yb[p * m + i], yp[i].getValue());
+        }
+    }
+}
+
+/**
+ * @test direct evaluation with lanes as independent variables
+ */
+TEST_F(CppADCGEvaluatorTest, LanesDirect) {
+    using Lanes = LaneArray<double, 2>;
+
+    CodeHandler<double> handler;
+    std::vector<CGD> x(2);
+    handler.makeVariables(x);
+    std::vector<CGD> y{x[0] * x[1] + 1.0, x[1]};
+
+    std::vector<Lanes> xl(2);
+    xl[0][0] = 2.0;
+    xl[0][1] = 3.0;
+    xl[1] = Lanes(4.0);
+
+    Evaluator<double, double, Lanes> evaluator(handler);
+    std::vector<Lanes> yl = evaluator.evaluate(xl, y);
+
+    ASSERT_EQ(yl[0][0], 9.0);
+    ASSERT_EQ(yl[0][1], 13.0);
+    ASSERT_EQ(yl[1], Lanes(4.0));
+
+    std::vector<double> xb(3);
+    ASSERT_THROW(evaluator.evaluatePoints(2, xb, y), CGException);
+}
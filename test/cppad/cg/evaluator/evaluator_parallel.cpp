@@ -0,0 +1,102 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include "CppADCGEvaluatorTest.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+/**
+ * @test many independent outputs evaluated with several threads
+ */
+TEST_F(CppADCGEvaluatorTest, ParallelIndependentOutputs) {
+    const size_t n = 50;
+    const size_t m = 500;
+
+    CodeHandler<double> handler;
+    std::vector<CGD> x(n);
+    handler.makeVariables(x);
+    for (size_t j = 0; j < n; j++)
+        x[j].setValue(0.1 + 0.01 * j);
+
+    std::vector<CGD> y(m + 2);
+    for (size_t i = 0; i < m; i++) {
+        CGD a = x[i % n] * x[(i + 1) % n];
+        CGD b = sin(a) + exp(x[(i + 7) % n]) / (1.0 + a);
+        y[i] = CondExpGt(a, x[(i + 3) % n], b * a, pow(b, 1.5) - a);
+    }
+    y[m] = x[2];
+    y[m + 1] = 3.0;
+
+    std::vector<double> xb(n);
+    for (size_t j = 0; j < n; j++)
+        xb[j] = x[j].getValue();
+
+    EvaluatorParallel<double> evaluator(handler, y);
+    evaluator.setMinimumParallelLevelSize(16);
+    ASSERT_GT(evaluator.getLevelCount(), 1u);
+
+    for (size_t nThreads : {1, 4, 2}) { // the worker pool is recreated when the number of threads changes
+        evaluator.setThreadCount(nThreads);
+
+        for (size_t r = 0; r < 3; r++) { // the evaluator (and its worker threads) can be reused
+            std::vector<double> yb = evaluator.evaluate(xb);
+
+            ASSERT_EQ(yb.size(), y.size());
+            for (size_t i = 0; i < y.size(); i++) {
+                ASSERT_EQ(yb[i], y[i].getValue());
+            }
+        }
+    }
+}
+
+/**
+ * @test a deep operation graph (one operation per level)
+ */
+TEST_F(CppADCGEvaluatorTest, ParallelDeepGraph) {
+    const size_t depth = 200000;
+
+    CodeHandler<double> handler;
+    std::vector<CGD> x(2);
+    handler.makeVariables(x);
+    x[0].setValue(0.5);
+    x[1].setValue(0.25);
+
+    CGD a = x[0];
+    for (size_t k = 0; k < depth; k++) {
+        a = a * 0.5 + x[1];
+    }
+    std::vector<CGD> y{a};
+
+    EvaluatorParallel<double> evaluator(handler, y);
+    evaluator.setThreadCount(4);
+    ASSERT_EQ(evaluator.getStageCount(), 1u);
+
+    std::vector<double> xb{0.5, 0.25};
+    std::vector<double> yb = evaluator.evaluate(xb);
+    ASSERT_EQ(yb[0], a.getValue());
+}
+
+/**
+ * @test unsupported operations are detected when the schedule is created
+ */
+TEST_F(CppADCGEvaluatorTest, ParallelUnsupported) {
+    CodeHandler<double> handler;
+    std::vector<CGD> x(2);
+    handler.makeVariables(x);
+
+    std::vector<CGD> y{x[0] + handler.createCG(*handler.makeNode(CGOpCode::Tmp))};
+
+    ASSERT_THROW((EvaluatorParallel<double>(handler, y)), CGException);
+}
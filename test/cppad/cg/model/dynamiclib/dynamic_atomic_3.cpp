@@ -99,6 +99,11 @@ TEST_F(CppADCGDynamicAtomicSmallerNestedTest, AtomicLibModelBridge) {
     this->testAtomicLibModelBridge(xOuter, xInner, xNorm, eqNorm, 1e-14, 1e-13);
 }
 
+TEST_F(CppADCGDynamicAtomicSmallerNestedTest, AtomicLibModelDirectCalls) {
+    this->directModelCalls = true;
+    this->testAtomicLibModelBridge(xOuter, xInner, xNorm, eqNorm, 1e-14, 1e-13);
+}
+
 TEST_F(CppADCGDynamicAtomicSmallerNestedTest, AtomicLibModelBridgeCustomRev2) {
     this->testAtomicLibModelBridgeCustom(xOuter, xInner, xNorm, eqNorm,
                                          jacInner, hessInner,
@@ -0,0 +1,205 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include "CppADCGTest.hpp"
+#include "CheckpointArrayFunction.hpp"
+#include "gccCompilerFlags.hpp"
+
+namespace CppAD {
+namespace cg {
+
+namespace {
+
+void atomicArrayModel(const std::vector<AD<double> >& ax, std::vector<AD<double> >& ay) {
+    ay[0] = cos(ax[0]);
+    ay[1] = ax[1] * ax[2] + sin(ax[0]);
+    ay[2] = ax[2] * ax[2] + sin(ax[1]);
+    ay[3] = ax[0] / ax[2] + ax[1] * ax[2] + 5.0;
+}
+
+/**
+ * A checkpoint atomic function which also receives sparse arrays and counts
+ * the dense and sparse calls.
+ */
+class ArrayCheckpoint : public CheckpointArrayFunction<AtomicSparseArrayFunction<double> > {
+public:
+    using Super = CheckpointArrayFunction<AtomicSparseArrayFunction<double> >;
+    using Super::forwardOne;
+    using Super::reverseOne;
+    using Super::reverseTwo;
+
+    size_t sparseCalls;
+
+    ArrayCheckpoint(const std::vector<AD<double> >& ax,
+                    std::vector<AD<double> >& ay) :
+        Super("func", atomicArrayModel, ax, ay),
+        sparseCalls(0) {
+    }
+
+    bool forwardOne(ArrayView<const double> x,
+                    size_t tx1Nnz, const size_t idx[], const double tx1[],
+                    ArrayView<double> ty1) override {
+        sparseCalls++;
+        std::vector<double> tx1Dense = dense(n, tx1Nnz, idx, tx1);
+        return forwardOne(x, tx1Dense, ty1);
+    }
+
+    bool reverseOne(ArrayView<const double> x,
+                    ArrayView<double> px,
+                    size_t pyNnz, const size_t idx[], const double py[]) override {
+        sparseCalls++;
+        std::vector<double> pyDense = dense(m, pyNnz, idx, py);
+        return reverseOne(x, px, pyDense);
+    }
+
+    bool reverseTwo(ArrayView<const double> x,
+                    size_t tx1Nnz, const size_t idx[], const double tx1[],
+                    ArrayView<double> px2,
+                    ArrayView<const double> py2) override {
+        sparseCalls++;
+        std::vector<double> tx1Dense = dense(n, tx1Nnz, idx, tx1);
+        return reverseTwo(x, tx1Dense, px2, py2);
+    }
+
+private:
+
+    static std::vector<double> dense(size_t size,
+                                     size_t nnz, const size_t idx[], const double values[]) {
+        std::vector<double> d(size, 0.0);
+        for (size_t e = 0; e < nnz; e++)
+            d[idx[e]] = values[e];
+        return d;
+    }
+};
+
+} // END namespace
+
+class CppADCGDynamicAtomicArrayTest : public CppADCGTest {
+protected:
+    const static std::string MODEL_NAME;
+    const static size_t m;
+    const static size_t n;
+    std::vector<double> x;
+    std::unique_ptr<checkpoint<double>> _atomicFun;
+    std::unique_ptr<ArrayCheckpoint> _arrayAtomicFun;
+    std::unique_ptr<CGAtomicFun<double>> _cgAtomicFun;
+    std::unique_ptr<ADFun<CGD>> _fun;
+    std::unique_ptr<DynamicLib<double>> _dynamicLib;
+public:
+
+    inline CppADCGDynamicAtomicArrayTest(bool verbose = false, bool printValues = false) :
+        CppADCGTest(verbose, printValues),
+        x(n) {
+    }
+
+    void SetUp() override {
+        using ADCG = AD<CGD>;
+        using ADD = AD<double>;
+
+        std::vector<ADD> ax(n);
+        std::vector<ADD> ay(m);
+
+        for (size_t j = 0; j < n; j++) {
+            x[j] = j + 2;
+            ax[j] = x[j];
+        }
+
+        std::vector<ADCG> u(n);
+        for (size_t j = 0; j < n; j++) {
+            u[j] = x[j];
+        }
+
+        CppAD::Independent(u);
+
+        std::vector<ADCG> z(m);
+
+        _atomicFun.reset(new checkpoint<double>("func", atomicArrayModel, ax, ay));
+        _arrayAtomicFun.reset(new ArrayCheckpoint(ax, ay));
+        _cgAtomicFun.reset(new CGAtomicFun<double>(*_atomicFun, x, true));
+
+        (*_cgAtomicFun)(u, z);
+
+        _fun.reset(new ADFun<CGD>(u, z));
+
+        ModelCSourceGen<double> compHelp(*_fun, MODEL_NAME);
+        compHelp.setCreateForwardZero(true);
+        compHelp.setCreateReverseOne(true);
+        compHelp.setCreateSparseJacobian(true);
+        compHelp.setCreateSparseHessian(true);
+
+        ModelLibraryCSourceGen<double> compDynHelp(compHelp);
+
+        DynamicModelLibraryProcessor<double> p(compDynHelp, "cppad_cg_atomic_array");
+        GccCompiler<double> compiler;
+        prepareTestCompilerFlags(compiler);
+
+        _dynamicLib = p.createDynamicLibrary(compiler);
+    }
+
+    void TearDown() override {
+        _dynamicLib.reset();
+        _fun.reset();
+        _cgAtomicFun.reset();
+        _arrayAtomicFun.reset();
+        _atomicFun.reset();
+    }
+};
+
+const std::string CppADCGDynamicAtomicArrayTest::MODEL_NAME = "dynamicAtomicArray";
+const size_t CppADCGDynamicAtomicArrayTest::n = 3;
+const size_t CppADCGDynamicAtomicArrayTest::m = 4;
+
+} // END cg namespace
+} // END CppAD namespace
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+/**
+ * @test the arrays of the compiled model are provided directly to atomic
+ *       functions implementing AtomicSparseArrayFunction and the results
+ *       are the same as with atomic_base
+ */
+TEST_F(CppADCGDynamicAtomicArrayTest, AtomicArray) {
+    std::unique_ptr<GenericModel<double>> model = _dynamicLib->model(MODEL_NAME);
+    model->addAtomicFunction(*_atomicFun);
+
+    std::unique_ptr<GenericModel<double>> arrayModel = _dynamicLib->model(MODEL_NAME);
+    arrayModel->addAtomicFunction(*_arrayAtomicFun);
+
+    std::vector<double> w{1.0, 2.0, 3.0, 4.0};
+
+    // zero order
+    std::vector<double> y = model->ForwardZero(x);
+    std::vector<double> yArray = arrayModel->ForwardZero(x);
+    ASSERT_TRUE(compareValues(yArray, y));
+    ASSERT_GT(_arrayAtomicFun->denseCalls, 0u);
+
+    // first order reverse
+    std::vector<double> px = model->ReverseOne(x, y, w);
+    std::vector<double> pxArray = arrayModel->ReverseOne(x, yArray, w);
+    ASSERT_TRUE(compareValues(pxArray, px));
+
+    // Jacobian (first order forward)
+    std::vector<double> jac = model->SparseJacobian(x);
+    std::vector<double> jacArray = arrayModel->SparseJacobian(x);
+    ASSERT_TRUE(compareValues(jacArray, jac));
+
+    // Hessian (second order reverse)
+    std::vector<double> hess = model->SparseHessian(x, w);
+    std::vector<double> hessArray = arrayModel->SparseHessian(x, w);
+    ASSERT_TRUE(compareValues(hessArray, hess));
+
+    ASSERT_GT(_arrayAtomicFun->sparseCalls, 0u);
+}
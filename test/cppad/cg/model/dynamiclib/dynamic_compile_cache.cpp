@@ -0,0 +1,126 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include "CppADCGTest.hpp"
+#include "gccCompilerFlags.hpp"
+
+namespace CppAD {
+namespace cg {
+
+class CppADCGDynamicCompileCacheTest : public CppADCGTest {
+protected:
+    const static std::string MODEL_NAME;
+public:
+
+    inline CppADCGDynamicCompileCacheTest(bool verbose = false, bool printValues = false) :
+        CppADCGTest(verbose, printValues) {
+    }
+
+    /**
+     * Creates a library where only the first equation depends on a
+     */
+    std::unique_ptr<DynamicLib<double>> createLibrary(GccCompiler<double>& compiler,
+                                                      const std::string& libName,
+                                                      double a) {
+        using ADCG = AD<CGD>;
+
+        std::vector<ADCG> u(3, 1.0);
+        CppAD::Independent(u);
+
+        std::vector<ADCG> y(3);
+        y[0] = a * u[0] * u[1];
+        y[1] = sin(u[1]) * u[0];
+        y[2] = u[2] * u[2];
+
+        ADFun<CGD> fun(u, y);
+
+        ModelCSourceGen<double> compHelp(fun, MODEL_NAME);
+        compHelp.setCreateForwardZero(true);
+        compHelp.setCreateSparseJacobian(true);
+        compHelp.setCreateReverseOne(true);
+        compHelp.setJacobianADMode(JacobianADMode::Reverse);
+        compHelp.setSparseJacobianReuse1stOrderPasses(true);
+
+        ModelLibraryCSourceGen<double> compDynHelp(compHelp);
+
+        DynamicModelLibraryProcessor<double> p(compDynHelp, libName);
+
+        return p.createDynamicLibrary(compiler);
+    }
+};
+
+const std::string CppADCGDynamicCompileCacheTest::MODEL_NAME = "compile_cache";
+
+} // END cg namespace
+} // END CppAD namespace
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+TEST_F(CppADCGDynamicCompileCacheTest, CompileCache) {
+    std::vector<double> x{2.0, 3.0, 4.0};
+
+    GccCompiler<double> compiler;
+    prepareTestCompilerFlags(compiler);
+    compiler.setTemporaryFolder("cppadcg_tmp_compile_cache");
+    compiler.setCompileCache(true);
+
+    std::unique_ptr<DynamicLib<double>> lib = createLibrary(compiler, "cppad_cg_compile_cache_v0", 1.0);
+    size_t compiled = compiler.getCompiledSourceCount();
+    ASSERT_GT(compiled, 0u);
+    ASSERT_EQ(compiler.getReusedSourceCount(), 0u);
+
+    /**
+     * nothing changed
+     */
+    lib = createLibrary(compiler, "cppad_cg_compile_cache_v1", 1.0);
+    ASSERT_EQ(compiler.getCompiledSourceCount(), compiled);
+    ASSERT_EQ(compiler.getReusedSourceCount(), compiled);
+
+    /**
+     * only the first equation changed
+     */
+    size_t reused = compiler.getReusedSourceCount();
+    lib = createLibrary(compiler, "cppad_cg_compile_cache_v2", 10.0);
+    ASSERT_GT(compiler.getCompiledSourceCount(), compiled);
+    ASSERT_GT(compiler.getReusedSourceCount(), reused);
+    ASSERT_LT(compiler.getCompiledSourceCount() - compiled, compiled);
+
+    std::unique_ptr<GenericModel<double>> model = lib->model(MODEL_NAME);
+
+    std::vector<double> y = model->ForwardZero(x);
+    ASSERT_TRUE(nearEqual(y[0], 60.0));
+    ASSERT_TRUE(nearEqual(y[1], std::sin(3.0) * 2.0));
+    ASSERT_TRUE(nearEqual(y[2], 16.0));
+
+    std::vector<double> jac = model->SparseJacobian(x); // dense format
+    ASSERT_EQ(jac.size(), 9u);
+    ASSERT_TRUE(nearEqual(jac[0], 30.0));
+    ASSERT_TRUE(nearEqual(jac[1], 20.0));
+    ASSERT_TRUE(nearEqual(jac[2], 0.0));
+    ASSERT_TRUE(nearEqual(jac[3], std::sin(3.0)));
+    ASSERT_TRUE(nearEqual(jac[4], std::cos(3.0) * 2.0));
+    ASSERT_TRUE(nearEqual(jac[5], 0.0));
+    ASSERT_TRUE(nearEqual(jac[8], 8.0));
+
+    /**
+     * different library compilation flags
+     */
+    compiled = compiler.getCompiledSourceCount();
+    reused = compiler.getReusedSourceCount();
+    compiler.addCompileLibFlag("-O2");
+    lib = createLibrary(compiler, "cppad_cg_compile_cache_v3", 10.0);
+    ASSERT_GT(compiler.getCompiledSourceCount(), compiled);
+    ASSERT_EQ(compiler.getReusedSourceCount(), reused);
+}
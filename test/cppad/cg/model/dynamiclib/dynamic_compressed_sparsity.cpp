@@ -0,0 +1,133 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include "CppADCGTest.hpp"
+#include "gccCompilerFlags.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+TEST_F(CppADCGTest, DynamicCompressedSparsity) {
+    using ADCG = AD<CGD>;
+    const std::string modelName = "compressed";
+
+    std::vector<ADCG> u(3, 1.0);
+    CppAD::Independent(u);
+
+    std::vector<ADCG> y(3);
+    y[0] = u[2] * u[0];
+    y[1] = u[1] * u[1] + u[0];
+    y[2] = 3.0 * u[2];
+
+    ADFun<CGD> fun(u, y);
+
+    ModelCSourceGen<double> compHelp(fun, modelName);
+    compHelp.setCreateForwardZero(true);
+    compHelp.setCreateSparseJacobian(true);
+    compHelp.setCreateSparseHessian(true);
+    compHelp.setCompressedSparseJacobian(true, SparseStorageOrder::COLUMN_MAJOR);
+    compHelp.setCompressedSparseHessian(true, SparseStorageOrder::ROW_MAJOR);
+
+    ModelLibraryCSourceGen<double> compDynHelp(compHelp);
+
+    DynamicModelLibraryProcessor<double> p(compDynHelp, "cppad_cg_compressed");
+    GccCompiler<double> compiler;
+    prepareTestCompilerFlags(compiler);
+
+    std::unique_ptr<DynamicLib<double>> dynamicLib = p.createDynamicLibrary(compiler);
+    std::unique_ptr<FunctorGenericModel<double>> model = dynamicLib->modelFunctor(modelName);
+
+    /**
+     * Jacobian (CSC)
+     */
+    ASSERT_TRUE(model->isJacobianSparsityCompressedAvailable());
+    CompressedSparsityView jacStruct = model->JacobianSparsityCompressed();
+    ASSERT_TRUE(jacStruct.order == SparseStorageOrder::COLUMN_MAJOR);
+    ASSERT_EQ(jacStruct.outer.size(), 4u);
+    ASSERT_EQ(jacStruct.nnz(), 5u);
+
+    std::vector<size_t> outer(jacStruct.outer.begin(), jacStruct.outer.end());
+    std::vector<size_t> inner(jacStruct.inner.begin(), jacStruct.inner.end());
+    ASSERT_EQ(outer, std::vector<size_t>({0, 2, 3, 5}));
+    ASSERT_EQ(inner, std::vector<size_t>({0, 1, 1, 0, 2}));
+
+    std::vector<double> x{2.0, 3.0, 4.0};
+    std::vector<double> jac(jacStruct.nnz());
+    size_t const* row;
+    size_t const* col;
+    model->SparseJacobian(ArrayView<const double>(x), ArrayView<double>(jac), &row, &col);
+    ASSERT_EQ(jac, std::vector<double>({4.0, 1.0, 6.0, 2.0, 3.0}));
+
+    // no permutation is required for the same structure
+    std::vector<size_t> outer2, inner2;
+    SparseScatterPlan jacPlan = model->createJacobianScatterPlan(SparseStorageOrder::COLUMN_MAJOR, outer2, inner2);
+    ASSERT_TRUE(jacPlan.isIdentity());
+    ASSERT_EQ(outer2, outer);
+    ASSERT_EQ(inner2, inner);
+
+    /**
+     * Hessian (CSR)
+     */
+    ASSERT_TRUE(model->isHessianSparsityCompressedAvailable());
+    CompressedSparsityView hessStruct = model->HessianSparsityCompressed();
+    ASSERT_TRUE(hessStruct.order == SparseStorageOrder::ROW_MAJOR);
+    ASSERT_EQ(hessStruct.outer.size(), 4u);
+
+    for (size_t o = 0; o < 3; ++o) {
+        for (size_t e = hessStruct.outer[o] + 1; e < hessStruct.outer[o + 1]; ++e) {
+            ASSERT_LT(hessStruct.inner[e - 1], hessStruct.inner[e]);
+        }
+    }
+
+    std::vector<double> w{1.0, 2.0, 1.0};
+    std::vector<double> hess(hessStruct.nnz());
+    model->SparseHessian(ArrayView<const double>(x), ArrayView<const double>(w), ArrayView<double>(hess), &row, &col);
+
+    for (size_t o = 0; o < 3; ++o) {
+        for (size_t e = hessStruct.outer[o]; e < hessStruct.outer[o + 1]; ++e) {
+            ASSERT_EQ(row[e], o);
+            ASSERT_EQ(col[e], hessStruct.inner[e]);
+            double expected = 0;
+            if ((o == 0 && col[e] == 2) || (o == 2 && col[e] == 0))
+                expected = 1.0;
+            else if (o == 1 && col[e] == 1)
+                expected = 4.0;
+            ASSERT_TRUE(nearEqual(hess[e], expected));
+        }
+    }
+
+    /**
+     * sparsity views (no copies)
+     */
+    CoordinateSparsityView jacView = model->JacobianSparsityView();
+    std::vector<size_t> jacRows, jacCols;
+    model->JacobianSparsity(jacRows, jacCols);
+    ASSERT_EQ(jacView.nnz(), jacRows.size());
+    ASSERT_TRUE(std::equal(jacRows.begin(), jacRows.end(), jacView.rows.begin()));
+    ASSERT_TRUE(std::equal(jacCols.begin(), jacCols.end(), jacView.cols.begin()));
+
+    CoordinateSparsityView hessView = model->HessianSparsityView();
+    ASSERT_EQ(hessView.nnz(), hessStruct.nnz());
+
+    CppAD::vector<bool> vx(3), vy(3);
+    vx[0] = false;
+    vx[1] = true;
+    vx[2] = false;
+    vy[0] = vy[1] = vy[2] = false;
+    std::vector<double> y(3);
+    model->ForwardZero(vx, vy, ArrayView<const double>(x), ArrayView<double>(y));
+    ASSERT_FALSE(vy[0]);
+    ASSERT_TRUE(vy[1]);
+    ASSERT_FALSE(vy[2]);
+}
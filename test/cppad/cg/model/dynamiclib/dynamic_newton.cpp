@@ -0,0 +1,105 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include "CppADCGTest.hpp"
+#include "gccCompilerFlags.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+TEST_F(CppADCGTest, DynamicNewtonSolver) {
+    using ADCG = AD<CGD>;
+    const std::string modelName = "newton";
+
+    std::vector<ADCG> u(4, 1.0);
+    CppAD::Independent(u);
+
+    std::vector<ADCG> y(3);
+    y[0] = u[0] * u[0] + u[1] - 3.0;
+    y[1] = u[1] * u[1] - 4.0 * u[0];
+    y[2] = exp(u[2]) - u[3];
+
+    ADFun<CGD> fun(u, y);
+
+    ModelCSourceGen<double> compHelp(fun, modelName);
+    compHelp.setCreateForwardZero(true);
+    compHelp.setCreateSparseJacobian(true);
+    ASSERT_EQ(compHelp.addNewtonSolverBlock({0, 1}, {0, 1}, NewtonLinearSolver::DenseLU), 0u);
+    ASSERT_EQ(compHelp.addNewtonSolverBlock({1, 0}, {1, 0}, NewtonLinearSolver::SparseLU), 1u);
+    ASSERT_EQ(compHelp.addNewtonSolverBlock({2}, {2}), 2u);
+
+    ModelLibraryCSourceGen<double> compDynHelp(compHelp);
+
+    DynamicModelLibraryProcessor<double> p(compDynHelp, "cppad_cg_newton");
+    GccCompiler<double> compiler;
+    prepareTestCompilerFlags(compiler);
+    compiler.setSourcesFolder("sources_newton");
+    compiler.setSaveToDiskFirst(true);
+
+    std::unique_ptr<DynamicLib<double>> dynamicLib = p.createDynamicLibrary(compiler);
+    std::unique_ptr<GenericModel<double>> model = dynamicLib->model(modelName);
+
+    ASSERT_EQ(model->getNewtonSolverBlockCount(), 3u);
+
+    /**
+     * the solvers only evaluate the equations of their blocks
+     */
+    std::ifstream file("sources_newton/newton_newton_solve.c");
+    ASSERT_TRUE(file.is_open());
+    std::stringstream source;
+    source << file.rdbuf();
+    ASSERT_NE(source.str().find("newton_newton_solve_residual0("), std::string::npos);
+    ASSERT_EQ(source.str().find("newton_forward_zero("), std::string::npos);
+    ASSERT_EQ(source.str().find("newton_sparse_jacobian("), std::string::npos);
+
+    std::vector<size_t> equations, variables;
+    model->getNewtonSolverBlock(1, equations, variables);
+    ASSERT_EQ(equations, std::vector<size_t>({1, 0}));
+    ASSERT_EQ(variables, std::vector<size_t>({1, 0}));
+
+    const double tol = 1e-10;
+    std::vector<double> res(3);
+
+    /**
+     * maximum number of iterations
+     */
+    std::vector<double> x{1.5, 1.5, 0.0, 2.0};
+    size_t it = 10;
+    ASSERT_TRUE(model->NewtonSolve(0, x, ArrayView<const double>(), 0, tol, &it) == NewtonSolverStatus::MaxIterations);
+    ASSERT_EQ(it, 0u);
+    ASSERT_EQ(x, std::vector<double>({1.5, 1.5, 0.0, 2.0}));
+
+    /**
+     * dense and sparse LU
+     */
+    for (size_t block = 0; block < 2; ++block) {
+        x = {1.5, 1.5, 0.0, 2.0};
+        ASSERT_TRUE(model->NewtonSolve(block, x, ArrayView<const double>(), 50, tol, &it) == NewtonSolverStatus::Converged);
+        ASSERT_GT(it, 0u);
+        ASSERT_NEAR(x[0], 1.0, 1e-8);
+        ASSERT_NEAR(x[1], 2.0, 1e-8);
+        ASSERT_EQ(x[2], 0.0); // not in the block
+        ASSERT_EQ(x[3], 2.0);
+
+        model->ForwardZero(ArrayView<const double>(x), res);
+        ASSERT_LE(std::abs(res[0]), tol);
+        ASSERT_LE(std::abs(res[1]), tol);
+    }
+
+    /**
+     * block with a single equation
+     */
+    ASSERT_TRUE(model->NewtonSolve(2, x, ArrayView<const double>(), 50, tol) == NewtonSolverStatus::Converged);
+    ASSERT_NEAR(x[2], std::log(2.0), 1e-8);
+}
@@ -0,0 +1,142 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include "CppADCGTest.hpp"
+#include "gccCompilerFlags.hpp"
+
+namespace CppAD {
+namespace cg {
+
+class CppADCGDynamicParametersTest : public CppADCGTest {
+protected:
+    const static std::string MODEL_NAME;
+    std::unique_ptr<ADFun<CGD>> _fun;
+public:
+
+    inline CppADCGDynamicParametersTest(bool verbose = false, bool printValues = false) :
+        CppADCGTest(verbose, printValues) {
+    }
+
+    void SetUp() override {
+        using ADCG = AD<CGD>;
+
+        std::vector<ADCG> u(2, 1.0);
+        std::vector<ADCG> p(2, 1.0);
+        CppAD::Independent(u, 0, true, p);
+
+        std::vector<ADCG> y(2);
+        y[0] = p[0] * u[0] * u[1];
+        y[1] = sin(u[1]) + p[1] * u[0] * u[0];
+
+        _fun.reset(new ADFun<CGD>(u, y));
+    }
+
+    void TearDown() override {
+        _fun.reset();
+    }
+
+    static std::vector<double> jacobian(const std::vector<double>& x,
+                                        const std::vector<double>& p) {
+        return {p[0] * x[1], p[0] * x[0],
+                2 * p[1] * x[0], std::cos(x[1])};
+    }
+
+    static std::vector<double> hessian(const std::vector<double>& x,
+                                       const std::vector<double>& p,
+                                       const std::vector<double>& w) {
+        return {2 * w[1] * p[1], w[0] * p[0],
+                w[0] * p[0], -w[1] * std::sin(x[1])};
+    }
+};
+
+const std::string CppADCGDynamicParametersTest::MODEL_NAME = "parameters";
+
+} // END cg namespace
+} // END CppAD namespace
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+TEST_F(CppADCGDynamicParametersTest, Parameters) {
+    ModelCSourceGen<double> compHelp(*_fun, MODEL_NAME);
+    compHelp.setCreateForwardZero(true);
+    compHelp.setCreateSparseJacobian(true);
+    compHelp.setCreateSparseHessian(true);
+    ASSERT_EQ(compHelp.getParameterCount(), 2u);
+
+    ModelLibraryCSourceGen<double> compDynHelp(compHelp);
+
+    DynamicModelLibraryProcessor<double> p(compDynHelp, "cppad_cg_parameters");
+
+    GccCompiler<double> compiler;
+    prepareTestCompilerFlags(compiler);
+    std::unique_ptr<DynamicLib<double>> lib = p.createDynamicLibrary(compiler);
+
+    std::unique_ptr<GenericModel<double>> model = lib->model(MODEL_NAME);
+    ASSERT_EQ(model->getParameterCount(), 2u);
+
+    /**
+     * the source generation must not change the parameters of the taped model
+     */
+    std::vector<CGD> xTape{2.0, 3.0};
+    std::vector<CGD> yTape = _fun->Forward(0, xTape);
+    ASSERT_TRUE(yTape[0].isValueDefined());
+    ASSERT_TRUE(nearEqual(yTape[0].getValue(), 6.0));
+    ASSERT_TRUE(nearEqual(yTape[1].getValue(), std::sin(3.0) + 4.0));
+
+    std::vector<double> x{2.0, 3.0};
+    std::vector<double> w{0.5, 1.5};
+
+    /**
+     * the same library is used with different parameter values
+     */
+    for (const std::vector<double>& par : {std::vector<double>{2.0, 3.0}, std::vector<double>{-5.0, 7.0}}) {
+        std::vector<double> y(2);
+        model->ForwardZero(x, par, y);
+        ASSERT_TRUE(nearEqual(y[0], par[0] * x[0] * x[1]));
+        ASSERT_TRUE(nearEqual(y[1], std::sin(x[1]) + par[1] * x[0] * x[0]));
+
+        std::vector<double> jacDense = jacobian(x, par);
+        std::vector<double> jac(4);
+        size_t const* row;
+        size_t const* col;
+        model->SparseJacobian(x, par, jac, &row, &col);
+        for (size_t e = 0; e < jac.size(); e++) {
+            ASSERT_TRUE(nearEqual(jac[e], jacDense[row[e] * 2 + col[e]]));
+        }
+
+        std::vector<double> hessDense = hessian(x, par, w);
+        std::vector<size_t> hessRow, hessCol;
+        model->HessianSparsity(hessRow, hessCol);
+        std::vector<double> hess(hessRow.size());
+        model->SparseHessian(x, par, w, hess, &row, &col);
+        for (size_t e = 0; e < hess.size(); e++) {
+            ASSERT_TRUE(nearEqual(hess[e], hessDense[row[e] * 2 + col[e]]));
+        }
+    }
+}
+
+TEST_F(CppADCGDynamicParametersTest, Unsupported) {
+    ModelCSourceGen<double> compHelp(*_fun, MODEL_NAME);
+    compHelp.setCreateForwardZero(true);
+    compHelp.setCreateReverseOne(true);
+
+    ModelLibraryCSourceGen<double> compDynHelp(compHelp);
+
+    DynamicModelLibraryProcessor<double> p(compDynHelp, "cppad_cg_parameters_unsupported");
+
+    GccCompiler<double> compiler;
+    prepareTestCompilerFlags(compiler);
+    ASSERT_THROW(p.createDynamicLibrary(compiler), CGException);
+}
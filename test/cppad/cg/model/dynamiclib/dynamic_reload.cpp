@@ -0,0 +1,139 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include "CppADCGTest.hpp"
+#include "gccCompilerFlags.hpp"
+
+#include <atomic>
+
+namespace CppAD {
+namespace cg {
+
+class CppADCGDynamicReloadTest : public CppADCGTest {
+protected:
+    const static std::string MODEL_NAME;
+public:
+
+    inline CppADCGDynamicReloadTest(bool verbose = false, bool printValues = false) :
+        CppADCGTest(verbose, printValues) {
+    }
+
+    /**
+     * Creates a library with a model y = a * x
+     */
+    std::unique_ptr<DynamicLib<double>> createLibrary(const std::string& libName,
+                                                      double a) {
+        using ADCG = AD<CGD>;
+
+        std::vector<ADCG> u(2, 1.0);
+        CppAD::Independent(u);
+
+        std::vector<ADCG> y(2);
+        y[0] = a * u[0];
+        y[1] = a * u[0] * u[1];
+
+        ADFun<CGD> fun(u, y);
+
+        ModelCSourceGen<double> compHelp(fun, MODEL_NAME);
+        compHelp.setCreateForwardZero(true);
+        compHelp.setCreateSparseJacobian(true);
+
+        ModelLibraryCSourceGen<double> compDynHelp(compHelp);
+
+        DynamicModelLibraryProcessor<double> p(compDynHelp, libName);
+        GccCompiler<double> compiler;
+        prepareTestCompilerFlags(compiler);
+
+        return p.createDynamicLibrary(compiler);
+    }
+};
+
+const std::string CppADCGDynamicReloadTest::MODEL_NAME = "reload";
+
+} // END cg namespace
+} // END CppAD namespace
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+TEST_F(CppADCGDynamicReloadTest, Reload) {
+    std::vector<double> x{2.0, 3.0};
+
+    ReloadableGenericModel<double> model(createLibrary("cppad_cg_reload_v0", 1.0), MODEL_NAME);
+    ASSERT_EQ(model.getVersion(), 0u);
+    ASSERT_EQ(model.Domain(), 2u);
+    ASSERT_EQ(model.Range(), 2u);
+
+    std::vector<double> y = model.ForwardZero(x);
+    ASSERT_TRUE(nearEqual(y[0], 2.0));
+    ASSERT_TRUE(nearEqual(y[1], 6.0));
+
+    // simulates a call still using the first version
+    std::shared_ptr<GenericModel<double>> inUse = model.getCurrentModel();
+
+    ASSERT_EQ(model.reload(createLibrary("cppad_cg_reload_v1", 10.0)), 1u);
+    ASSERT_EQ(model.getVersion(), 1u);
+
+    y = model.ForwardZero(x);
+    ASSERT_TRUE(nearEqual(y[0], 20.0));
+    ASSERT_TRUE(nearEqual(y[1], 60.0));
+
+    std::vector<double> jac = model.SparseJacobian(x);
+    ASSERT_TRUE(nearEqual(jac[0], 10.0));
+    ASSERT_TRUE(nearEqual(jac[1], 0.0));
+    ASSERT_TRUE(nearEqual(jac[2], 30.0));
+    ASSERT_TRUE(nearEqual(jac[3], 20.0));
+
+    // the old version must still be loaded
+    y = inUse->ForwardZero(x);
+    ASSERT_TRUE(nearEqual(y[0], 2.0));
+    ASSERT_EQ(model.unloadRetired(), 1u);
+
+    inUse.reset();
+    ASSERT_EQ(model.unloadRetired(), 0u);
+}
+
+TEST_F(CppADCGDynamicReloadTest, ReloadConcurrent) {
+    std::vector<double> x{2.0, 3.0};
+
+    ReloadableGenericModel<double> model(createLibrary("cppad_cg_reload_c0", 1.0), MODEL_NAME);
+    std::unique_ptr<DynamicLib<double>> lib1 = createLibrary("cppad_cg_reload_c1", 10.0);
+
+    std::atomic<bool> stop(false);
+    std::atomic<bool> valid(true);
+
+    std::thread evaluator([&]() {
+        std::vector<double> y(2);
+        while (!stop) {
+            model.ForwardZero(ArrayView<const double>(x), ArrayView<double>(y));
+            if (!((nearEqual(y[0], 2.0) && nearEqual(y[1], 6.0)) ||
+                  (nearEqual(y[0], 20.0) && nearEqual(y[1], 60.0)))) {
+                valid = false;
+            }
+        }
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    model.reload(std::move(lib1));
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+
+    stop = true;
+    evaluator.join();
+
+    ASSERT_TRUE(valid);
+    ASSERT_EQ(model.unloadRetired(), 0u);
+
+    std::vector<double> y = model.ForwardZero(x);
+    ASSERT_TRUE(nearEqual(y[0], 20.0));
+}
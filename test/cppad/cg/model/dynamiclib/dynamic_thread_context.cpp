@@ -0,0 +1,100 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include "CppADCGTest.hpp"
+#include "gccCompilerFlags.hpp"
+
+#include <atomic>
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+TEST_F(CppADCGTest, DynamicThreadContext) {
+    using ADCG = AD<CGD>;
+    const std::string modelName = "thread_context";
+
+    std::vector<ADCG> u(2, 1.0);
+    CppAD::Independent(u);
+
+    std::vector<ADCG> y(2);
+    y[0] = u[0] * u[1];
+    y[1] = u[0] / u[1] + 2.0 * u[1];
+
+    ADFun<CGD> fun(u, y);
+
+    ModelCSourceGen<double> compHelp(fun, modelName);
+    compHelp.setCreateForwardZero(true);
+    compHelp.setCreateSparseJacobian(true);
+    compHelp.setCreateSparseHessian(true);
+
+    ModelLibraryCSourceGen<double> compDynHelp(compHelp);
+
+    DynamicModelLibraryProcessor<double> p(compDynHelp, "cppad_cg_thread_context");
+    GccCompiler<double> compiler;
+    prepareTestCompilerFlags(compiler);
+
+    std::unique_ptr<DynamicLib<double>> dynamicLib = p.createDynamicLibrary(compiler);
+    dynamicLib->setThreadPoolDisabled(true);
+    std::unique_ptr<FunctorGenericModel<double>> model = dynamicLib->modelFunctor(modelName);
+    ASSERT_TRUE(model != nullptr);
+
+    const size_t nThreads = 4;
+    const size_t nEvals = 2000;
+    std::atomic<bool> valid(true);
+
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < nThreads; ++t) {
+        threads.emplace_back([&, t]() {
+            std::unique_ptr<FunctorGenericModelContext<double>> ctx = model->createContext();
+
+            std::vector<double> x(2), dep(2), jac(3), w{1.0, 1.0}, hess(3);
+            size_t const* row;
+            size_t const* col;
+
+            for (size_t e = 0; e < nEvals; ++e) {
+                x[0] = 1.0 + t;
+                x[1] = 2.0 + e % 10;
+
+                model->ForwardZero(*ctx, x, dep);
+                if (!nearEqual(dep[0], x[0] * x[1]) ||
+                    !nearEqual(dep[1], x[0] / x[1] + 2.0 * x[1])) {
+                    valid = false;
+                }
+
+                model->SparseJacobian(*ctx, x, jac, &row, &col);
+                std::vector<double> jacDense(4, 0.0);
+                for (size_t i = 0; i < jac.size(); ++i)
+                    jacDense[row[i] * 2 + col[i]] = jac[i];
+
+                if (!nearEqual(jacDense[0], x[1]) ||
+                    !nearEqual(jacDense[1], x[0]) ||
+                    !nearEqual(jacDense[2], 1.0 / x[1]) ||
+                    !nearEqual(jacDense[3], -x[0] / (x[1] * x[1]) + 2.0)) {
+                    valid = false;
+                }
+            }
+        });
+    }
+
+    for (auto& th: threads)
+        th.join();
+
+    ASSERT_TRUE(valid);
+
+    // the internal context is still usable
+    std::vector<double> x{2.0, 3.0};
+    GenericModel<double>& genModel = *model;
+    std::vector<double> dep = genModel.ForwardZero(x);
+    ASSERT_TRUE(nearEqual(dep[0], 6.0));
+}
@@ -0,0 +1,127 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include "CppADCGTest.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+using Base = double;
+using CGD = CG<Base>;
+using ADCGD = AD<CGD>;
+
+namespace {
+
+template<class T>
+std::vector<T> modelBytecode(const std::vector<T>& x) {
+    std::vector<T> y(5);
+
+    T a = x[0] * x[1] + 2.0;
+    y[0] = sin(a) / (x[2] + 3.0) + exp(x[0]);
+    y[1] = CondExpLt(x[0], x[1], a * a, pow(x[2], 2.5));
+    y[2] = x[1]; // a dependent which is also an independent
+    y[3] = 4.0; // a constant dependent
+    y[4] = sqrt(a) - log(x[2] + 10.0) * a + cos(x[1]) * a;
+
+    return y;
+}
+
+}
+
+TEST_F(CppADCGTest, BytecodeModel) {
+    size_t n = 3;
+
+    std::vector<ADCGD> ax(n, 1.0);
+    Independent(ax);
+    std::vector<ADCGD> ay = modelBytecode(ax);
+    ADFun<CGD> fun(ax, ay);
+
+    BytecodeGenericModel<double> model(fun, "bytecode");
+    model.createForwardZero();
+    model.createJacobian();
+    model.createHessian();
+    model.createSparseJacobian();
+    model.createSparseHessian();
+
+    ASSERT_EQ(model.Domain(), n);
+    ASSERT_EQ(model.Range(), ay.size());
+    ASSERT_GT(model.getForwardZeroProgram()->getInstructionCount(), 0u);
+
+    /**
+     * the original model
+     */
+    std::vector<AD<double> > adx(n, 1.0);
+    Independent(adx);
+    std::vector<AD<double> > ady = modelBytecode(adx);
+    ADFun<double> funD(adx, ady);
+
+    std::vector<double> w(ay.size());
+    for (size_t i = 0; i < w.size(); i++)
+        w[i] = 1.0 + 0.5 * i;
+
+    for (const std::vector<double>& x : {std::vector<double>{0.5, 1.5, 2.5},
+                                         std::vector<double>{2.0, 1.0, 0.25}}) {
+        std::vector<double> yOrig = funD.Forward(0, x);
+        std::vector<double> y = model.ForwardZero(x);
+        ASSERT_TRUE(compareValues(y, yOrig));
+
+        std::vector<double> jacOrig = funD.Jacobian(x);
+        ASSERT_TRUE(compareValues(model.Jacobian(x), jacOrig));
+        ASSERT_TRUE(compareValues(model.SparseJacobian(x), jacOrig));
+
+        std::vector<double> hessOrig = funD.Hessian(x, w);
+        ASSERT_TRUE(compareValues(model.Hessian(x, w), hessOrig));
+        ASSERT_TRUE(compareValues(model.SparseHessian(x, w), hessOrig));
+    }
+
+    // not supported by the interpreter
+    ASSERT_FALSE(model.isForwardOneAvailable());
+    ASSERT_FALSE(model.isReverseTwoAvailable());
+}
+
+TEST_F(CppADCGTest, BytecodeProgramNoReuse) {
+    std::vector<ADCGD> ax(3, 1.0);
+    Independent(ax);
+    std::vector<ADCGD> ay = modelBytecode(ax);
+    ADFun<CGD> fun(ax, ay);
+
+    CodeHandler<double> handler;
+    handler.setReuseVariableIDs(false);
+
+    std::vector<CGD> x(3);
+    handler.makeVariables(x);
+    std::vector<CGD> y = fun.Forward(0, x);
+
+    LanguageBytecode<double> lang;
+    LangCDefaultVariableNameGenerator<double> nameGen;
+    std::ostringstream code;
+    handler.generateCode(code, lang, y, nameGen);
+
+    std::unique_ptr<BytecodeProgram<double> > program = lang.releaseProgram();
+    ASSERT_TRUE(program != nullptr);
+
+    std::vector<double> registers;
+    program->initRegisters(registers);
+
+    std::vector<double> xv{0.5, 1.5, 2.5};
+    std::vector<double> yv(y.size());
+    program->evaluate(registers, xv, yv);
+
+    std::vector<AD<double> > adx(3, 1.0);
+    Independent(adx);
+    std::vector<AD<double> > ady = modelBytecode(adx);
+    ADFun<double> funD(adx, ady);
+
+    ASSERT_TRUE(compareValues(yv, funD.Forward(0, xv)));
+}
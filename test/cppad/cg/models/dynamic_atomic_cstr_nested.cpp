@@ -232,6 +232,11 @@ TEST_F(CppADCGDynamicAtomicCstrNestedTest, AtomicLibModelBridge) {
     this->testAtomicLibModelBridge(xOuter, xInner, xNorm, eqNorm, 1e-14, 1e-13);
 }
 
+TEST_F(CppADCGDynamicAtomicCstrNestedTest, AtomicLibModelDirectCalls) {
+    this->directModelCalls = true;
+    this->testAtomicLibModelBridge(xOuter, xInner, xNorm, eqNorm, 1e-14, 1e-13);
+}
+
 TEST_F(CppADCGDynamicAtomicCstrNestedTest, AtomicLibModelBridgeCustomRev2) {
     this->testAtomicLibModelBridgeCustom(xOuter, xInner, xNorm, eqNorm,
                                          jacInner, hessInner,
@@ -0,0 +1,189 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+#include "CppADCGTest.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+using Base = double;
+using CGD = CG<Base>;
+using ADCGD = AD<CGD>;
+
+namespace {
+
+void atomicFunction(const std::vector<AD<double> >& x,
+                    std::vector<AD<double> >& y) {
+    y[0] = x[0] * x[1];
+    y[1] = 2 * x[1] * x[1];
+}
+
+std::vector<ADCGD> modelGraph(const std::vector<ADCGD>& x,
+                              atomic_base<CGD>& atomic) {
+    std::vector<ADCGD> y(5), ax(2), ay(2);
+
+    ax[0] = x[0];
+    ax[1] = x[2];
+    atomic(ax, ay);
+
+    y[0] = sin(x[0]) * x[1] + ay[0];
+    y[1] = CondExpLt(x[0], x[1], exp(x[2]), ay[1] / x[1]);
+    y[2] = x[1];
+    y[3] = 4.0;
+    y[4] = pow(x[2], 2.5) + ay[0];
+
+    return y;
+}
+
+/**
+ * A loop with indexed independents/dependents using linear, random and
+ * sectioned index patterns (similar to the graphs created by
+ * ModelCSourceGen for zero order forward mode)
+ */
+void makeLoopGraph(CodeHandler<double>& handler,
+                   std::vector<CGD>& x,
+                   std::vector<CGD>& y,
+                   std::vector<std::unique_ptr<IndexPattern> >& patterns) {
+    const size_t nIter = 3;
+
+    x.resize(2 * nIter);
+    handler.makeVariables(x);
+
+    OperationNode<double>* indexDcl = handler.makeIndexDclrNode("j");
+    LoopStartOperationNode<double>* loopStart = handler.makeLoopStartNode(*indexDcl, nIter);
+    IndexOperationNode<double>* iterationIndex = handler.makeIndexNode(*loopStart);
+
+    patterns.emplace_back(new LinearIndexPattern(0, 2, 1, 0));
+    patterns.emplace_back(new Random1DIndexPattern(std::map<size_t, size_t>{{0, 5}, {1, 3}, {2, 1}}));
+
+    std::vector<CGD> xl(2);
+    for (size_t k = 0; k < xl.size(); k++) {
+        std::vector<size_t> info{0, handler.addLoopIndependentIndexPattern(*patterns[k], k)};
+        xl[k] = CGD(*handler.makeNode(CGOpCode::LoopIndexedIndep, info, {*iterationIndex}));
+    }
+
+    CGD yl = sin(xl[0]) * xl[1] + 2.0;
+
+    std::map<size_t, IndexPattern*> sections{{0, new LinearIndexPattern(0, 1, 1, 0)},
+                                             {2, new LinearIndexPattern(2, 0, 1, 4)}};
+    patterns.emplace_back(new SectionedIndexPattern(sections));
+
+    std::vector<size_t> depInfo{handler.addLoopDependentIndexPattern(*patterns[2]), 0};
+    OperationNode<double>* yIndexed = handler.makeNode(CGOpCode::LoopIndexedDep, depInfo, {asArgument(yl), *iterationIndex});
+    LoopEndOperationNode<double>* loopEnd = handler.makeLoopEndNode(*loopStart, {*yIndexed});
+
+    y.resize(5);
+    for (size_t e : {0, 1, 4}) {
+        y[e] = handler.createCG(*handler.makeNode(CGOpCode::DependentRefRhs, {e}, {*loopEnd}));
+    }
+    y[2] = x[0] * x[1];
+    y[3] = 3.0;
+}
+
+std::string generateSource(CodeHandler<double>& handler,
+                           std::vector<CGD>& y) {
+    LanguageC<double> langC("double");
+    LangCDefaultVariableNameGenerator<double> nameGen;
+
+    std::ostringstream code;
+    handler.generateCode(code, langC, y, nameGen);
+    return code.str();
+}
+
+}
+
+TEST_F(CppADCGTest, OperationGraphRoundTrip) {
+    size_t n = 3;
+
+    std::vector<AD<double> > ax(2), ay(2);
+    checkpoint<double> atomicFun("graphAtomic", atomicFunction, ax, ay);
+    CGAtomicFun<double> cgAtomicFun(atomicFun, ax, true);
+
+    std::vector<ADCGD> u(n, 1.0);
+    Independent(u);
+    std::vector<ADCGD> v = modelGraph(u, cgAtomicFun);
+    ADFun<CGD> fun(u, v);
+
+    CodeHandler<double> handler;
+    std::vector<CGD> x(n);
+    handler.makeVariables(x);
+    std::vector<CGD> y = fun.Forward(0, x);
+
+    std::stringstream stream(std::ios::in | std::ios::out | std::ios::binary);
+    OperationGraphWriter<double> writer(handler);
+    writer.write(stream, y);
+
+    /**
+     * load the graph in a new handler
+     */
+    CodeHandler<double> handler2;
+    std::vector<CGD> x2, y2;
+
+    OperationGraphReader<double> reader;
+    reader.addAtomicFunction(cgAtomicFun);
+    reader.read(stream, handler2, x2, y2);
+
+    ASSERT_EQ(x2.size(), n);
+    ASSERT_EQ(y2.size(), y.size());
+    ASSERT_TRUE(y2[3].isParameter());
+    ASSERT_EQ(y2[3].getValue(), 4.0);
+
+    ASSERT_EQ(generateSource(handler2, y2), generateSource(handler, y));
+
+    /**
+     * atomic functions must be provided
+     */
+    stream.clear();
+    stream.seekg(0);
+    CodeHandler<double> handler3;
+    OperationGraphReader<double> reader2;
+    ASSERT_THROW(reader2.read(stream, handler3, x2, y2), CGException);
+}
+
+TEST_F(CppADCGTest, OperationGraphLoops) {
+    std::vector<std::unique_ptr<IndexPattern> > patterns;
+    CodeHandler<double> handler;
+    std::vector<CGD> x, y;
+    makeLoopGraph(handler, x, y, patterns);
+
+    std::stringstream stream(std::ios::in | std::ios::out | std::ios::binary);
+    OperationGraphWriter<double> writer(handler);
+    writer.write(stream, y);
+
+    CodeHandler<double> handler2;
+    std::vector<CGD> x2, y2;
+    OperationGraphReader<double> reader;
+    reader.read(stream, handler2, x2, y2);
+
+    ASSERT_EQ(x2.size(), x.size());
+    ASSERT_EQ(y2.size(), y.size());
+    ASSERT_EQ(handler2.getLoopDependentIndexPatterns().size(), 1u);
+    ASSERT_EQ(handler2.getLoopIndependentIndexPatterns().size(), 2u);
+    ASSERT_EQ(handler2.getLoopIndependentIndexPatterns()[1]->getType(), IndexPatternType::Random1D);
+    ASSERT_EQ(handler2.getLoopDependentIndexPatterns()[0]->getType(), IndexPatternType::Sectioned);
+
+    std::string source = generateSource(handler, y);
+    ASSERT_NE(source.find("for("), std::string::npos);
+    ASSERT_EQ(generateSource(handler2, y2), source);
+}
+
+TEST_F(CppADCGTest, OperationGraphInvalid) {
+    std::stringstream stream("not an operation graph");
+
+    CodeHandler<double> handler;
+    std::vector<CGD> x, y;
+    OperationGraphReader<double> reader;
+    ASSERT_THROW(reader.read(stream, handler, x, y), CGException);
+}
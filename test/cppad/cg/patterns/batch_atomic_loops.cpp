@@ -0,0 +1,207 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include "CppADCGPatternTest.hpp"
+#include "CheckpointArrayFunction.hpp"
+
+using Base = double;
+using CGD = CppAD::cg::CG<Base>;
+using ADCGD = CppAD::AD<CGD>;
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+namespace {
+
+template<class T, class Atomic>
+std::vector<T> modelBatch(const std::vector<T>& x, size_t repeat, Atomic& atomic) {
+    size_t m = 3;
+    size_t n = 2;
+
+    std::vector<T> y(repeat * m), ax(n), ay(2);
+
+    for (size_t i = 0; i < repeat; i++) {
+        ax[0] = x[i * n];
+        ax[1] = x[i * n + 1];
+        atomic(ax, ay);
+        y[i * m] = ay[0];
+        y[i * m + 1] = ay[1] * x[i * n];
+        y[i * m + 2] = cos(x[i * n + 1]);
+    }
+
+    return y;
+}
+
+void atomicBatchModel(const std::vector<AD<double> >& x, std::vector<AD<double> >& y) {
+    y[0] = x[0] * x[1];
+    y[1] = sin(x[0]) + x[1] * x[1];
+}
+
+/**
+ * A checkpoint atomic function which counts the batched evaluations.
+ */
+class BatchCheckpoint : public CheckpointArrayFunction<AtomicBatchArrayFunction<double> > {
+public:
+    size_t batchCalls;
+
+    BatchCheckpoint(const std::vector<AD<double> >& ax,
+                    std::vector<AD<double> >& ay) :
+        CheckpointArrayFunction<AtomicBatchArrayFunction<double> >("batchFunc", atomicBatchModel, ax, ay),
+        batchCalls(0) {
+    }
+
+    bool forwardZeroBatch(size_t nBatch,
+                          ArrayView<const double> x,
+                          ArrayView<double> y) override {
+        batchCalls++;
+        return AtomicBatchArrayFunction<double>::forwardZeroBatch(nBatch, x, y);
+    }
+
+    bool forwardOneBatch(size_t nBatch,
+                         ArrayView<const double> x,
+                         ArrayView<const double> tx1,
+                         ArrayView<double> ty1) override {
+        batchCalls++;
+        return AtomicBatchArrayFunction<double>::forwardOneBatch(nBatch, x, tx1, ty1);
+    }
+
+    bool reverseOneBatch(size_t nBatch,
+                         ArrayView<const double> x,
+                         ArrayView<double> px,
+                         ArrayView<const double> py) override {
+        batchCalls++;
+        return AtomicBatchArrayFunction<double>::reverseOneBatch(nBatch, x, px, py);
+    }
+
+    bool reverseTwoBatch(size_t nBatch,
+                         ArrayView<const double> x,
+                         ArrayView<const double> tx1,
+                         ArrayView<double> px2,
+                         ArrayView<const double> py2) override {
+        batchCalls++;
+        return AtomicBatchArrayFunction<double>::reverseTwoBatch(nBatch, x, tx1, px2, py2);
+    }
+};
+
+} // END namespace
+
+class CppADCGBatchAtomicLoopsTest : public CppADCGPatternTest {
+protected:
+
+    /**
+     * Creates a model with an atomic function inside a loop and compares
+     * the results of the batched calls with CppAD
+     *
+     * @param name the model name
+     * @param maxBatchValues the maximum number of values in the batch buffers
+     * @param chunked whether or not the iterations are expected to be split
+     *                into several atomic function calls
+     */
+    void testBatchAtomicLoops(const std::string& name,
+                              size_t maxBatchValues,
+                              bool chunked) {
+        size_t m = 3;
+        size_t n = 2;
+        size_t repeat = 6;
+
+        std::vector<AD<double> > ax(n, 1.0), ay(m - 1);
+        BatchCheckpoint atomic(ax, ay);
+        CGAtomicFun<double> cgAtomic(atomic, std::vector<double>(n, 1.0), true);
+
+        std::vector<ADCGD> x(n * repeat, 1.0);
+        Independent(x);
+        std::vector<ADCGD> y = modelBatch(x, repeat, cgAtomic);
+        ADFun<CGD> fun(x, y);
+
+        std::vector<double> xTypical(x.size(), 1.0);
+
+        ModelCSourceGen<double> compHelp(fun, name);
+        compHelp.setCreateForwardZero(true);
+        compHelp.setCreateSparseJacobian(true);
+        compHelp.setCreateSparseHessian(true);
+        compHelp.setRelatedDependents(createRelatedDepCandidates(m, repeat));
+        compHelp.setTypicalIndependentValues(xTypical);
+        compHelp.setBatchAtomicLoops(true);
+        compHelp.setMaxBatchAtomicValues(maxBatchValues);
+
+        ModelLibraryCSourceGen<double> compDynHelp(compHelp);
+
+        DynamicModelLibraryProcessor<double> p(compDynHelp, "cppad_cg_" + name);
+        GccCompiler<double> compiler;
+        prepareTestCompilerFlags(compiler);
+        compiler.setSourcesFolder("sources_" + name);
+        compiler.setSaveToDiskFirst(true);
+        std::unique_ptr<DynamicLib<double>> dynamicLib = p.createDynamicLibrary(compiler);
+        std::unique_ptr<GenericModel<double>> model = dynamicLib->model(name);
+        model->addAtomicFunction(atomic);
+
+        /**
+         * the loop in the zero order forward mode calls the atomic function once
+         * (or once per chunk of iterations)
+         */
+        std::ifstream file("sources_" + name + "/" + name + "_forward_zero.c");
+        ASSERT_TRUE(file.is_open());
+        std::stringstream source;
+        source << file.rdbuf();
+        ASSERT_NE(source.str().find("atomicFun.forwardBatch("), std::string::npos);
+        ASSERT_EQ(source.str().find("atomicFun.forward("), std::string::npos);
+        ASSERT_EQ(source.str().find("batchStart") != std::string::npos, chunked);
+
+        /**
+         * compare results
+         */
+        std::vector<AD<double> > xd(x.size());
+        for (size_t j = 0; j < xd.size(); j++)
+            xd[j] = 0.5 + j;
+        Independent(xd);
+        std::vector<AD<double> > yd = modelBatch(xd, repeat, atomic);
+        ADFun<double> funD(xd, yd);
+
+        std::vector<double> xv(x.size());
+        for (size_t j = 0; j < xv.size(); j++)
+            xv[j] = 0.5 + j;
+        std::vector<double> w(y.size());
+        for (size_t i = 0; i < w.size(); i++)
+            w[i] = 1.0 + i;
+
+        std::vector<double> yOrig = funD.Forward(0, xv);
+        std::vector<double> yLib = model->ForwardZero(xv);
+        ASSERT_TRUE(compareValues(yLib, yOrig));
+        ASSERT_GT(atomic.batchCalls, chunked ? 1u : 0u);
+
+        std::vector<double> jacOrig = funD.Jacobian(xv);
+        std::vector<double> jacLib = model->SparseJacobian(xv);
+        ASSERT_TRUE(compareValues(jacLib, jacOrig));
+
+        std::vector<double> hessOrig = funD.Hessian(xv, w);
+        std::vector<double> hessLib = model->SparseHessian(xv, w);
+        ASSERT_TRUE(compareValues(hessLib, hessOrig));
+    }
+};
+
+/**
+ * @test the atomic function inside a loop is called once for all the
+ *       iterations and the results are the same as with CppAD
+ */
+TEST_F(CppADCGBatchAtomicLoopsTest, BatchAtomicLoops) {
+    testBatchAtomicLoops("batch_atomic_loops", 4096, false);
+}
+
+/**
+ * @test the atomic function inside a loop is called for chunks of
+ *       iterations when the buffers for all iterations would be too large
+ */
+TEST_F(CppADCGBatchAtomicLoopsTest, BatchAtomicLoopsChunks) {
+    testBatchAtomicLoops("batch_atomic_loops_chunks", 8, true);
+}
@@ -0,0 +1,161 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include "CppADCGPatternTest.hpp"
+
+using Base = double;
+using CGD = CppAD::cg::CG<Base>;
+using ADCGD = CppAD::AD<CGD>;
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+namespace {
+
+/**
+ * The dependents of each equation pattern and of each loop
+ */
+struct PatternResults {
+    std::vector<std::set<size_t> > equations;
+    std::vector<std::set<size_t> > loops;
+    size_t nonLoopDeps;
+};
+
+PatternResults detectPatterns(ADFun<CGD>& fun,
+                              const std::vector<std::set<size_t> >& depCandidates,
+                              size_t nThreads) {
+    CodeHandler<Base> h;
+
+    std::vector<CGD> xx(fun.Domain());
+    h.makeVariables(xx);
+    for (size_t j = 0; j < xx.size(); j++) {
+        xx[j].setValue(j);
+    }
+
+    std::vector<CGD> yy = fun.Forward(0, xx);
+
+    DependentPatternMatcher<Base> matcher(depCandidates, yy, xx);
+    matcher.setThreadCount(nThreads);
+
+    LoopFreeModel<Base>* nonLoopTape;
+    SmartSetPointer<LoopModel<Base> > loopTapes;
+    matcher.generateTapes(nonLoopTape, loopTapes.s);
+
+    PatternResults results;
+    results.nonLoopDeps = nonLoopTape != nullptr ? nonLoopTape->getTapeDependentCount() : 0;
+    delete nonLoopTape;
+
+    for (const EquationPattern<Base>* eq : matcher.getEquationPatterns()) {
+        results.equations.push_back(eq->dependents);
+    }
+
+    for (const Loop<Base>* loop : matcher.getLoops()) {
+        std::set<size_t> deps;
+        for (const EquationPattern<Base>* eq : loop->equations) {
+            deps.insert(eq->dependents.begin(), eq->dependents.end());
+        }
+        results.loops.push_back(deps);
+    }
+
+    return results;
+}
+
+}
+
+/**
+ * @test several equation patterns with shared temporary variables
+ */
+std::vector<ADCGD> modelParallel(const std::vector<ADCGD>& x, size_t repeat) {
+    size_t m = 4;
+    size_t n = 2;
+
+    std::vector<ADCGD> y(repeat * m);
+
+    for (size_t i = 0; i < repeat; i++) {
+        ADCGD tmp = x[i * n] * x[i * n + 1];
+        y[i * m] = cos(x[i * n]);
+        y[i * m + 1] = tmp + x[i * n];
+        y[i * m + 2] = 2.0 * tmp;
+        y[i * m + 3] = exp(x[0]) * x[i * n + 1];
+    }
+
+    return y;
+}
+
+TEST_F(CppADCGPatternTest, ParallelPatternMatcher) {
+    size_t m = 4;
+    size_t repeat = 40;
+
+    std::vector<ADCGD> x(2 * repeat, 1.0);
+    Independent(x);
+    std::vector<ADCGD> y = modelParallel(x, repeat);
+    ADFun<CGD> fun(x, y);
+
+    std::vector<std::set<size_t> > depCandidates = createRelatedDepCandidates(m, repeat);
+
+    PatternResults sequential = detectPatterns(fun, depCandidates, 1);
+    ASSERT_EQ(sequential.equations.size(), m);
+
+    for (size_t nThreads : {2, 3, 8}) {
+        PatternResults parallel = detectPatterns(fun, depCandidates, nThreads);
+
+        ASSERT_EQ(parallel.equations, sequential.equations);
+        ASSERT_EQ(parallel.loops, sequential.loops);
+        ASSERT_EQ(parallel.nonLoopDeps, sequential.nonLoopDeps);
+    }
+}
+
+/**
+ * @test a single large group of candidates with several equation patterns
+ *       (the comparisons inside the group are split among the threads)
+ */
+std::vector<ADCGD> modelParallelSingleGroup(const std::vector<ADCGD>& x, size_t repeat) {
+    size_t m = 3;
+
+    std::vector<ADCGD> y(repeat * m);
+
+    for (size_t i = 0; i < repeat; i++) {
+        y[i * m] = cos(x[i]);
+        y[i * m + 1] = x[i] * x[i + 1];
+        y[i * m + 2] = exp(x[i]) + x[0];
+    }
+
+    return y;
+}
+
+TEST_F(CppADCGPatternTest, ParallelPatternMatcherSingleGroup) {
+    size_t m = 3;
+    size_t repeat = 100;
+
+    std::vector<ADCGD> x(repeat + 1, 1.0);
+    Independent(x);
+    std::vector<ADCGD> y = modelParallelSingleGroup(x, repeat);
+    ADFun<CGD> fun(x, y);
+
+    std::vector<std::set<size_t> > depCandidates(1);
+    for (size_t i = 0; i < y.size(); i++) {
+        depCandidates[0].insert(i);
+    }
+
+    PatternResults sequential = detectPatterns(fun, depCandidates, 1);
+    ASSERT_EQ(sequential.equations.size(), m);
+
+    for (size_t nThreads : {2, 3, 8}) {
+        PatternResults parallel = detectPatterns(fun, depCandidates, nThreads);
+
+        ASSERT_EQ(parallel.equations, sequential.equations);
+        ASSERT_EQ(parallel.loops, sequential.loops);
+        ASSERT_EQ(parallel.nonLoopDeps, sequential.nonLoopDeps);
+    }
+}
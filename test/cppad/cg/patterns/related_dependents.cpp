@@ -0,0 +1,149 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include "CppADCGPatternTest.hpp"
+
+using Base = double;
+using CGD = CppAD::cg::CG<Base>;
+using ADCGD = CppAD::AD<CGD>;
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+namespace {
+
+std::vector<std::set<size_t> > findRelated(ADFun<CGD>& fun) {
+    CodeHandler<Base> h;
+
+    std::vector<CGD> xx(fun.Domain());
+    h.makeVariables(xx);
+    for (size_t j = 0; j < xx.size(); j++) {
+        xx[j].setValue(j);
+    }
+
+    std::vector<CGD> yy = fun.Forward(0, xx);
+
+    RelatedDependentsFinder<Base> finder;
+    return finder.find(yy);
+}
+
+}
+
+/**
+ * @test two equation patterns and an equation which is not repeated
+ */
+std::vector<ADCGD> modelRelated(const std::vector<ADCGD>& x, size_t repeat) {
+    size_t m = 2;
+    size_t n = 2;
+
+    std::vector<ADCGD> y(repeat * m + 1);
+
+    for (size_t i = 0; i < repeat; i++) {
+        y[i * m] = cos(x[i * n]);
+        y[i * m + 1] = x[i * n + 1] * x[i * n];
+    }
+    y[repeat * m] = x[0] + 5.0;
+
+    return y;
+}
+
+TEST_F(CppADCGPatternTest, RelatedDependentsFinder) {
+    size_t repeat = 4;
+    std::vector<ADCGD> x(2 * repeat, 1.0);
+    Independent(x);
+    std::vector<ADCGD> y = modelRelated(x, repeat);
+    ADFun<CGD> fun(x, y);
+
+    std::vector<std::set<size_t> > related = findRelated(fun);
+
+    ASSERT_EQ(related.size(), 2u);
+    ASSERT_EQ(related[0], std::set<size_t>({0, 2, 4, 6}));
+    ASSERT_EQ(related[1], std::set<size_t>({1, 3, 5, 7}));
+
+    std::vector<std::vector<std::set<size_t> > > loops{{{0, 2, 4, 6}, {1, 3, 5, 7}}};
+    testPatternDetectionResults(fun, repeat, related, loops, 1);
+}
+
+TEST_F(CppADCGPatternTest, RelatedDependentsFinderParameters) {
+    std::vector<ADCGD> x(3, 1.0);
+    Independent(x);
+    std::vector<ADCGD> y(3);
+    y[0] = 2.0 * x[0];
+    y[1] = 3.0 * x[1];
+    y[2] = 2.0 * x[2];
+    ADFun<CGD> fun(x, y);
+
+    std::vector<std::set<size_t> > related = findRelated(fun);
+
+    ASSERT_EQ(related.size(), 1u);
+    ASSERT_EQ(related[0], std::set<size_t>({0, 2}));
+}
+
+TEST_F(CppADCGPatternTest, RelatedDependentsFinderDeep) {
+    // deep expression trees must not exhaust the stack
+    size_t depth = 100000;
+    std::vector<ADCGD> x(2, 1.0);
+    Independent(x);
+    std::vector<ADCGD> y(x);
+    for (size_t k = 0; k < depth; k++) {
+        y[0] = sin(y[0]);
+        y[1] = sin(y[1]);
+    }
+    ADFun<CGD> fun(x, y);
+
+    std::vector<std::set<size_t> > related = findRelated(fun);
+
+    ASSERT_EQ(related.size(), 1u);
+    ASSERT_EQ(related[0], std::set<size_t>({0, 1}));
+}
+
+TEST_F(CppADCGPatternTest, RelatedDependentsAutomatic) {
+    size_t repeat = 4;
+    std::vector<ADCGD> x(2 * repeat, 1.0);
+    Independent(x);
+    std::vector<ADCGD> y = modelRelated(x, repeat);
+    ADFun<CGD> fun(x, y);
+
+    std::vector<double> xTypical(x.size(), 1.0);
+
+    ModelCSourceGen<double> compHelp(fun, "related_auto");
+    compHelp.setCreateForwardZero(true);
+    compHelp.setAutomaticRelatedDependents(true);
+    compHelp.setTypicalIndependentValues(xTypical);
+
+    ModelLibraryCSourceGen<double> compDynHelp(compHelp);
+
+    DynamicModelLibraryProcessor<double> p(compDynHelp, "cppad_cg_related_auto");
+    GccCompiler<double> compiler;
+    prepareTestCompilerFlags(compiler);
+    std::unique_ptr<DynamicLib<double>> dynamicLib = p.createDynamicLibrary(compiler);
+    std::unique_ptr<GenericModel<double>> model = dynamicLib->model("related_auto");
+
+    // the user provided groups are not modified
+    ASSERT_TRUE(compHelp.getRelatedDependents().empty());
+
+    std::vector<double> xv(x.size());
+    for (size_t j = 0; j < xv.size(); j++)
+        xv[j] = 0.5 + j;
+
+    std::vector<double> yOrig(y.size());
+    for (size_t i = 0; i < repeat; i++) {
+        yOrig[i * 2] = std::cos(xv[i * 2]);
+        yOrig[i * 2 + 1] = xv[i * 2 + 1] * xv[i * 2];
+    }
+    yOrig[repeat * 2] = xv[0] + 5.0;
+
+    std::vector<double> yLib = model->ForwardZero(xv);
+    ASSERT_TRUE(compareValues(yLib, yOrig));
+}
@@ -0,0 +1,105 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include "CppADCGPatternTest.hpp"
+
+using Base = double;
+using CGD = CppAD::cg::CG<Base>;
+using ADCGD = CppAD::AD<CGD>;
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+/**
+ * @test a loop with temporary variables used several times per iteration
+ */
+template<class T>
+std::vector<T> modelSimd(const std::vector<T>& x, size_t repeat) {
+    size_t m = 2;
+    size_t n = 2;
+
+    std::vector<T> y(repeat * m);
+
+    for (size_t i = 0; i < repeat; i++) {
+        T a = x[i * n] * x[i * n + 1];
+        y[i * m] = a + sin(a);
+        y[i * m + 1] = a * x[i * n];
+    }
+
+    return y;
+}
+
+TEST_F(CppADCGPatternTest, SimdLoops) {
+    size_t m = 2;
+    size_t n = 2;
+    size_t repeat = 10;
+
+    std::vector<ADCGD> x(n * repeat, 1.0);
+    Independent(x);
+    std::vector<ADCGD> y = modelSimd(x, repeat);
+    ADFun<CGD> fun(x, y);
+
+    std::vector<double> xTypical(x.size(), 1.0);
+
+    ModelCSourceGen<double> compHelp(fun, "simd_loops");
+    compHelp.setCreateForwardZero(true);
+    compHelp.setCreateSparseJacobian(true);
+    compHelp.setRelatedDependents(createRelatedDepCandidates(m, repeat));
+    compHelp.setTypicalIndependentValues(xTypical);
+    compHelp.setRestrictPointers(true);
+    compHelp.setSimdLoops(true);
+
+    ModelLibraryCSourceGen<double> compDynHelp(compHelp);
+
+    DynamicModelLibraryProcessor<double> p(compDynHelp, "cppad_cg_simd_loops");
+    GccCompiler<double> compiler;
+    prepareTestCompilerFlags(compiler);
+    compiler.addCompileFlag("-fopenmp-simd");
+    compiler.setSourcesFolder("sources_simd_loops");
+    compiler.setSaveToDiskFirst(true);
+    std::unique_ptr<DynamicLib<double>> dynamicLib = p.createDynamicLibrary(compiler);
+    std::unique_ptr<GenericModel<double>> model = dynamicLib->model("simd_loops");
+
+    /**
+     * the loop in the zero order forward mode can be vectorized
+     */
+    std::ifstream file("sources_simd_loops/simd_loops_forward_zero.c");
+    ASSERT_TRUE(file.is_open());
+    std::stringstream source;
+    source << file.rdbuf();
+    ASSERT_NE(source.str().find("#pragma omp simd"), std::string::npos);
+    ASSERT_NE(source.str().find("double* restrict y"), std::string::npos);
+
+    /**
+     * compare results
+     */
+    std::vector<AD<double> > xd(x.size());
+    for (size_t j = 0; j < xd.size(); j++)
+        xd[j] = 0.5 + j;
+    Independent(xd);
+    std::vector<AD<double> > yd = modelSimd(xd, repeat);
+    ADFun<double> funD(xd, yd);
+
+    std::vector<double> xv(x.size());
+    for (size_t j = 0; j < xv.size(); j++)
+        xv[j] = 0.5 + j;
+
+    std::vector<double> yOrig = funD.Forward(0, xv);
+    std::vector<double> yLib = model->ForwardZero(xv);
+    ASSERT_TRUE(compareValues(yLib, yOrig));
+
+    std::vector<double> jacOrig = funD.Jacobian(xv);
+    std::vector<double> jacLib = model->SparseJacobian(xv);
+    ASSERT_TRUE(compareValues(jacLib, jacOrig));
+}
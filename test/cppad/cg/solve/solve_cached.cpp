@@ -0,0 +1,83 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+#include "CppADCGSolveTest.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+namespace {
+
+/**
+ * Determines which variables can be solved for in each expression.
+ *
+ * @param useCache whether or not to use the information saved by the
+ *                 handler in previous calls
+ */
+std::vector<bool> solvable(CodeHandler<double>& handler,
+                           std::vector<CG<double>>& res,
+                           std::vector<CG<double>>& x,
+                           const std::vector<size_t>& vars,
+                           bool useCache) {
+    std::vector<bool> s;
+    for (auto& r : res) {
+        for (size_t j : vars) {
+            if (!useCache)
+                handler.clearPathGraphCache();
+            s.push_back(handler.isSolvable(*r.getOperationNode(), *x[j].getOperationNode()));
+        }
+    }
+    return s;
+}
+
+} // END namespace
+
+/**
+ * @test the information saved by isSolvable() is updated when an independent
+ *       variable is substituted
+ */
+TEST_F(CppADCGSolveTest, SolveCachedSubstitution) {
+    CodeHandler<double> handler;
+
+    std::vector<CGD> x(4);
+    handler.makeVariables(x);
+
+    std::vector<CGD> res(3);
+    res[0] = x[0] * x[1] + x[2] - 3.0;
+    res[1] = exp(x[1]) - 2.0 * x[2];
+    res[2] = x[3] - x[0] * x[0] + x[1];
+
+    std::vector<size_t> vars{0, 1, 2, 3};
+
+    std::vector<bool> cached = solvable(handler, res, x, vars, true);
+    ASSERT_EQ(cached, solvable(handler, res, x, vars, false));
+    ASSERT_EQ(cached, solvable(handler, res, x, vars, true)); // reuse saved information
+    ASSERT_TRUE(cached[0 * 4 + 1]);
+    ASSERT_FALSE(cached[0 * 4 + 3]);
+
+    // x[2] now depends on x[1] in all the expressions
+    handler.substituteIndependent(x[2], res[1], false);
+
+    vars = {0, 1, 3};
+    cached = solvable(handler, res, x, vars, true);
+    ASSERT_EQ(cached, solvable(handler, res, x, vars, false));
+
+    // recover the original expressions
+    handler.undoSubstituteIndependent(*x[2].getOperationNode());
+
+    vars = {0, 1, 2, 3};
+    cached = solvable(handler, res, x, vars, true);
+    ASSERT_EQ(cached, solvable(handler, res, x, vars, false));
+    ASSERT_TRUE(cached[0 * 4 + 2]);
+}
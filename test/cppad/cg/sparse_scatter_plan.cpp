@@ -0,0 +1,94 @@
+/* --------------------------------------------------------------------------
+ *  CppADCodeGen: C++ Algorithmic Differentiation with Source Code Generation:
+ *    Copyright (C) 2019 Joao Leal
+ *
+ *  CppADCodeGen is distributed under multiple licenses:
+ *
+ *   - Eclipse Public License Version 1.0 (EPL1), and
+ *   - GNU General Public License Version 3 (GPL3).
+ *
+ *  EPL1 terms and conditions can be found in the file "epl-v10.txt", while
+ *  terms and conditions for the GPL3 can be found in the file "gpl3.txt".
+ * ----------------------------------------------------------------------------
+ * Author: Joao Leal
+ */
+
+#include "CppADCGTest.hpp"
+
+using namespace CppAD;
+using namespace CppAD::cg;
+
+namespace {
+// a 3x4 matrix in an arbitrary (color-like) element order
+const unsigned long rows[] = {2, 0, 1, 0, 2};
+const unsigned long cols[] = {3, 2, 0, 0, 1};
+const double values[] = {1.0, 2.0, 3.0, 4.0, 5.0};
+const size_t nnz = 5;
+}
+
+TEST_F(CppADCGTest, SparseScatterPlanDense) {
+    SparseScatterPlan plan = SparseScatterPlan::createDense(3, 4, rows, cols, nnz);
+    ASSERT_FALSE(plan.isIdentity());
+
+    std::vector<double> dense(12, -1.0);
+    plan.scatter(values, ArrayView<double>(dense));
+
+    std::vector<double> expected{4.0, 0.0, 2.0, 0.0,
+                                 3.0, 0.0, 0.0, 0.0,
+                                 0.0, 5.0, 0.0, 1.0};
+    ASSERT_EQ(dense, expected);
+
+    SparseScatterPlan planCol = SparseScatterPlan::createDense(3, 4, rows, cols, nnz, SparseStorageOrder::COLUMN_MAJOR);
+    planCol.scatter(values, ArrayView<double>(dense));
+    for (size_t e = 0; e < nnz; ++e) {
+        ASSERT_EQ(dense[cols[e] * 3 + rows[e]], values[e]);
+    }
+}
+
+TEST_F(CppADCGTest, SparseScatterPlanCompressed) {
+    std::vector<int> outer, inner;
+    SparseScatterPlan plan = SparseScatterPlan::createCompressed(SparseStorageOrder::ROW_MAJOR, 3, 4, rows, cols, nnz,
+                                                                 outer, inner);
+
+    ASSERT_EQ(outer, std::vector<int>({0, 2, 3, 5}));
+    ASSERT_EQ(inner, std::vector<int>({0, 2, 0, 1, 3}));
+
+    std::vector<double> csr(nnz);
+    plan.scatter(values, ArrayView<double>(csr));
+    ASSERT_EQ(csr, std::vector<double>({4.0, 2.0, 3.0, 5.0, 1.0}));
+
+    SparseScatterPlan planCsc = SparseScatterPlan::createCompressed(SparseStorageOrder::COLUMN_MAJOR, 3, 4, rows, cols, nnz,
+                                                                    outer, inner);
+    ASSERT_EQ(outer, std::vector<int>({0, 2, 3, 4, 5}));
+    ASSERT_EQ(inner, std::vector<int>({0, 1, 2, 0, 2}));
+
+    std::vector<double> csc(nnz);
+    planCsc.scatter(values, ArrayView<double>(csc));
+    ASSERT_EQ(csc, std::vector<double>({4.0, 3.0, 5.0, 2.0, 1.0}));
+}
+
+TEST_F(CppADCGTest, SparseScatterPlanUserStructure) {
+    // CSR structure with an additional element (1, 1)
+    std::vector<long> outer{0, 2, 4, 6};
+    std::vector<long> inner{0, 2, 0, 1, 1, 3};
+
+    SparseScatterPlan plan = SparseScatterPlan::createCompressed(SparseStorageOrder::ROW_MAJOR, rows, cols, nnz,
+                                                                 ArrayView<const long>(outer),
+                                                                 ArrayView<const long>(inner));
+    ASSERT_FALSE(plan.isIdentity());
+    ASSERT_EQ(plan.getDestinationSize(), 6u);
+
+    std::vector<double> csr(6, -1.0);
+    plan.scatter(values, ArrayView<double>(csr));
+    ASSERT_EQ(csr, std::vector<double>({4.0, 2.0, 3.0, 0.0, 5.0, 1.0}));
+
+    // elements already in the destination order
+    const unsigned long rowsCsr[] = {0, 0, 1, 2, 2};
+    const unsigned long colsCsr[] = {0, 2, 0, 1, 3};
+    std::vector<long> outer2{0, 2, 3, 5};
+    std::vector<long> inner2{0, 2, 0, 1, 3};
+    SparseScatterPlan identity = SparseScatterPlan::createCompressed(SparseStorageOrder::ROW_MAJOR, rowsCsr, colsCsr, nnz,
+                                                                     ArrayView<const long>(outer2),
+                                                                     ArrayView<const long>(inner2));
+    ASSERT_TRUE(identity.isIdentity());
+}